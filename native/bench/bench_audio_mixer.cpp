@@ -0,0 +1,254 @@
+// Priority audio mixer on a null audio device, without sound hardware.
+//
+// First a synchronous check of the ducking: the coach lane plays a steady
+// tone, team radio talks for one second in the middle, and the coach gain is
+// traced per period to measure how fast it ducks and comes back.
+//
+// Then a real-time run: a NullAudioDevice thread calls the mixer every
+// --period frames at 48 kHz while three producers feed it as the app would:
+// team radio in 20 ms frames during talk spurts, spotter callouts every few
+// seconds and whole coaching TTS clips written at once. The report gives the
+// callback time distribution against --budget-us, late periods (where a
+// sound card would glitch), per-lane samples played and dropped, and how
+// much of the time each lane was ducked. Finally the budget is squeezed to
+// zero to show that lower lanes give way first, and a mono mixer must be
+// refused by the stereo device.
+//
+//   bench_audio_mixer [--seconds 20] [--period 256] [--budget-us 1000] [--realtime 70]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "trackpro/audio/audio_mixer.h"
+#include "trackpro/audio/null_audio_device.h"
+#include "trackpro/common/clock.h"
+#include "trackpro/common/latency_histogram.h"
+#include "trackpro/voice/synthetic_voice.h"
+
+using namespace trackpro;
+using namespace trackpro::audio;
+
+namespace {
+
+constexpr uint32_t kRate = 48'000;
+constexpr double kPi = 3.14159265358979323846;
+
+float gain_db(float gain) { return 20.0f * std::log10(std::max(gain, 1e-6f)); }
+
+void tone(std::vector<float>& out, size_t samples, float hz, float level, double& phase) {
+  out.resize(samples);
+  for (size_t i = 0; i < samples; ++i) {
+    out[i] = level * static_cast<float>(std::sin(phase));
+    phase += 2.0 * kPi * hz / kRate;
+  }
+}
+
+void ducking_check(uint32_t period) {
+  NullAudioDeviceOptions device_options;
+  device_options.format.frames_per_callback = period;
+  NullAudioDevice device(device_options);
+  AudioMixerOptions options;
+  auto mixer = std::make_unique<AudioMixer>(options);
+
+  const double period_ms = 1e3 * period / kRate;
+  const size_t radio_from = static_cast<size_t>(1000.0 / period_ms);
+  const size_t radio_to = static_cast<size_t>(2000.0 / period_ms);
+  const size_t total = static_cast<size_t>(3500.0 / period_ms);
+  const float target_db = options.duck_db[static_cast<size_t>(AudioLane::Coach)];
+
+  std::vector<float> coach;
+  std::vector<float> radio;
+  double coach_phase = 0.0;
+  double radio_phase = 0.0;
+  double ducked_ms = -1.0;
+  double restored_ms = -1.0;
+  for (size_t p = 0; p < total; ++p) {
+    tone(coach, period, 440.0f, 0.3f, coach_phase);
+    mixer->write(AudioLane::Coach, coach.data(), coach.size());
+    if (p >= radio_from && p < radio_to) {
+      tone(radio, period, 180.0f, 0.3f, radio_phase);
+      mixer->write(AudioLane::TeamRadio, radio.data(), radio.size());
+    }
+    device.pump(*mixer, 1);
+    const float db = gain_db(mixer->counters().gain[static_cast<size_t>(AudioLane::Coach)]);
+    if (ducked_ms < 0.0 && p >= radio_from && db <= target_db + 1.0f) {
+      ducked_ms = static_cast<double>(p + 1 - radio_from) * period_ms;
+    }
+    if (restored_ms < 0.0 && p >= radio_to && db >= -1.0f) {
+      restored_ms = static_cast<double>(p + 1 - radio_to) * period_ms;
+    }
+  }
+  std::printf("ducking: coach reaches %.0f dB %.1f ms after team radio starts, back within 1 dB %.0f ms after it stops\n"
+              "         (attack %.0f ms, hold %.0f ms, release %.0f ms)\n",
+              target_db + 1.0f, ducked_ms, restored_ms, options.attack_ms, options.hold_ms, options.release_ms);
+}
+
+struct Producers {
+  std::atomic<bool> running{true};
+  std::vector<std::thread> threads;
+
+  void stop() {
+    running.store(false);
+    for (std::thread& t : threads) {
+      t.join();
+    }
+  }
+};
+
+// Team radio: 20 ms frames at real time, only inside talk spurts (the jitter
+// buffer plays nothing between them).
+void radio_producer(AudioMixer& mixer, Producers& p) {
+  voice::SyntheticVoiceOptions options;
+  options.seed = 11;
+  options.mean_talk_s = 3.0;
+  options.mean_pause_s = 5.0;
+  voice::SyntheticVoice voice(options);
+  float frame[voice::kVoiceFrameSamples];
+  uint64_t next = now_ns();
+  while (p.running.load()) {
+    voice.next(frame);
+    if (voice.talking()) {
+      mixer.write(AudioLane::TeamRadio, frame, voice::kVoiceFrameSamples);
+    }
+    next += voice::kVoiceFrameNs;
+    sleep_until_ns(next);
+  }
+}
+
+// Spotter and coach: clips of `clip_s` seconds of speech written in one go
+// every `every_s` seconds, retrying what did not fit.
+void clip_producer(AudioMixer& mixer, Producers& p, AudioLane lane, uint32_t seed, double clip_s,
+                   double every_s) {
+  voice::SyntheticVoiceOptions options;
+  options.seed = seed;
+  voice::SyntheticVoice voice(options);
+  const size_t frames = static_cast<size_t>(clip_s * 1e3 / 20.0);
+  std::vector<float> clip(frames * voice::kVoiceFrameSamples);
+  uint64_t next = now_ns() + static_cast<uint64_t>(every_s * 0.5 * kNanosPerSecond);
+  while (p.running.load()) {
+    if (now_ns() < next) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      continue;
+    }
+    next += static_cast<uint64_t>(every_s * kNanosPerSecond);
+    for (size_t f = 0; f < frames; ++f) {
+      voice.next(clip.data() + f * voice::kVoiceFrameSamples);
+    }
+    size_t written = 0;
+    while (written < clip.size() && p.running.load()) {
+      written += mixer.write(lane, clip.data() + written, clip.size() - written);
+      if (written < clip.size()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      }
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const double seconds = bench::arg_double(argc, argv, "--seconds", 20.0);
+  const auto period = static_cast<uint32_t>(bench::arg_int(argc, argv, "--period", 256));
+  const double budget_us = bench::arg_double(argc, argv, "--budget-us", 1000.0);
+  const int realtime = static_cast<int>(bench::arg_int(argc, argv, "--realtime", 70));
+
+  ducking_check(period);
+
+  LatencyHistogram callback_ns;
+  AudioMixerOptions options;
+  options.budget_ns = static_cast<uint64_t>(budget_us * 1e3);
+  options.callback_ns = &callback_ns;
+  auto mixer = std::make_unique<AudioMixer>(options);
+
+  NullAudioDeviceOptions device_options;
+  device_options.format.frames_per_callback = period;
+  device_options.realtime_priority = realtime;
+  NullAudioDevice device(device_options);
+  device.start(*mixer);
+
+  Producers producers;
+  producers.threads.emplace_back([&] { radio_producer(*mixer, producers); });
+  producers.threads.emplace_back([&] { clip_producer(*mixer, producers, AudioLane::Spotter, 21, 0.6, 4.0); });
+  producers.threads.emplace_back([&] { clip_producer(*mixer, producers, AudioLane::Coach, 31, 2.5, 6.0); });
+
+  // Sample the lane gains to see how much of the time each lane was ducked.
+  uint64_t samples = 0;
+  uint64_t ducked[kAudioLaneCount] = {};
+  const uint64_t end = now_ns() + static_cast<uint64_t>(seconds * kNanosPerSecond);
+  for (uint64_t next = now_ns(); next < end; next += 10 * kNanosPerMilli) {
+    sleep_until_ns(next);
+    const AudioMixerCounters c = mixer->counters();
+    ++samples;
+    for (size_t i = 0; i < kAudioLaneCount; ++i) {
+      ducked[i] += gain_db(c.gain[i]) < -6.0f ? 1 : 0;
+    }
+  }
+  producers.stop();
+  device.stop();
+
+  const AudioMixerCounters c = mixer->counters();
+  const AudioDeviceCounters d = device.counters();
+  const HistogramSnapshot h = callback_ns.snapshot();
+  const double period_us = 1e6 * period / kRate;
+  std::printf("\nreal time: %.0f s, %u-frame periods (%.0f us), budget %.0f us, audio thread %s\n", seconds, period,
+              period_us, budget_us, device.realtime() ? "SCHED_FIFO" : "best effort");
+  std::printf("callback  n=%-8llu p50=%7.2fus p99=%7.2fus p99.9=%7.2fus max=%7.2fus (%.3f%% of the period at p99)\n",
+              static_cast<unsigned long long>(h.count), h.percentile(0.5) / 1e3, h.percentile(0.99) / 1e3,
+              h.percentile(0.999) / 1e3, static_cast<double>(h.max) / 1e3,
+              100.0 * static_cast<double>(h.percentile(0.99)) / 1e3 / period_us);
+  std::printf("over budget %llu, lane chunks shed %llu, limited %llu, late periods %llu of %llu\n",
+              static_cast<unsigned long long>(c.over_budget), static_cast<unsigned long long>(c.shed),
+              static_cast<unsigned long long>(c.limited), static_cast<unsigned long long>(d.late),
+              static_cast<unsigned long long>(d.callbacks));
+  for (size_t i = 0; i < kAudioLaneCount; ++i) {
+    std::printf("  %-10s played %6.1f s, dropped %llu samples, ducked %4.1f%% of the time\n",
+                lane_name(static_cast<AudioLane>(i)), static_cast<double>(c.played[i]) / kRate,
+                static_cast<unsigned long long>(c.dropped[i]),
+                samples == 0 ? 0.0 : 100.0 * static_cast<double>(ducked[i]) / static_cast<double>(samples));
+  }
+
+  // No budget at all: only team radio is mixed.
+  AudioMixerOptions squeezed;
+  squeezed.budget_ns = 0;
+  auto starved = std::make_unique<AudioMixer>(squeezed);
+  NullAudioDevice headless(device_options);
+  std::vector<float> pcm;
+  double phase = 0.0;
+  for (int p = 0; p < 100; ++p) {
+    tone(pcm, period, 300.0f, 0.2f, phase);
+    for (size_t i = 0; i < kAudioLaneCount; ++i) {
+      starved->write(static_cast<AudioLane>(i), pcm.data(), pcm.size());
+    }
+    headless.pump(*starved, 1);
+  }
+  const AudioMixerCounters s = starved->counters();
+  std::printf("\nzero budget: played team_radio %llu, spotter %llu, coach %llu samples; %llu lane chunks shed\n",
+              static_cast<unsigned long long>(s.played[0]), static_cast<unsigned long long>(s.played[1]),
+              static_cast<unsigned long long>(s.played[2]), static_cast<unsigned long long>(s.shed));
+
+  // A mixer set up for another format would write past the device buffer.
+  AudioMixerOptions mono;
+  mono.channels = 1;
+  auto mismatched = std::make_unique<AudioMixer>(mono);
+  bool refused = false;
+  try {
+    headless.start(*mismatched);
+  } catch (const std::invalid_argument& e) {
+    refused = !headless.running();
+    std::printf("mono mixer on a stereo device: refused (%s)\n", e.what());
+  }
+  if (!refused) {
+    std::printf("FAIL: the device started a mixer with the wrong channel count\n");
+    headless.stop();
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,169 @@
+// Column codecs on sim-racing channels: drives a synthetic session, cuts
+// every channel into per-lap chunks like the lap store does, and encodes
+// each chunk with every codec. Reports bytes per sample per codec and the
+// one encode_column() picks, the overall ratio against raw columns and
+// against delta-varint alone, encode cost, and decode throughput per codec.
+// --disk-mbps sets the read bandwidth decode is compared against.
+//
+//   bench_column_codec [--laps 40] [--rate 60] [--disk-mbps 2000]
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "bench_util.h"
+#include "trackpro/common/clock.h"
+#include "trackpro/telemetry/column_codec.h"
+#include "trackpro/telemetry/synthetic_session.h"
+
+using namespace trackpro;
+using namespace trackpro::telemetry;
+
+namespace {
+
+constexpr ColumnCodec kCodecs[] = {ColumnCodec::Raw,       ColumnCodec::DeltaVarint,
+                                   ColumnCodec::PackedDelta, ColumnCodec::PackedDeltaDelta,
+                                   ColumnCodec::Xor,       ColumnCodec::RunLength};
+constexpr size_t kCodecCount = sizeof(kCodecs) / sizeof(kCodecs[0]);
+
+struct Channel {
+  const char* name;
+  ChannelType type;
+  std::vector<std::vector<uint8_t>> laps;  // raw values, one chunk per lap
+  void push(const void* v) {
+    const auto* p = static_cast<const uint8_t*>(v);
+    laps.back().insert(laps.back().end(), p, p + channel_type_size(type));
+  }
+  size_t count(size_t lap) const { return laps[lap].size() / channel_type_size(type); }
+};
+
+struct Tally {
+  size_t bytes = 0;
+  uint64_t encode_ns = 0;
+  uint64_t decode_ns = 0;
+  size_t decoded_bytes = 0;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int laps = static_cast<int>(bench::arg_int(argc, argv, "--laps", 40));
+  const double disk_mbps = bench::arg_double(argc, argv, "--disk-mbps", 2000.0);
+  SyntheticSessionOptions options;
+  options.tick_rate = static_cast<int>(bench::arg_int(argc, argv, "--rate", 60));
+  SyntheticSession session(options);
+
+  std::vector<Channel> channels = {
+      {"SessionTime", ChannelType::Float64, {}}, {"LapDist", ChannelType::Float32, {}},
+      {"LapDistPct", ChannelType::Float32, {}},  {"LapCurrentLapTime", ChannelType::Float32, {}},
+      {"Speed", ChannelType::Float32, {}},       {"RPM", ChannelType::Float32, {}},
+      {"Gear", ChannelType::Int32, {}},          {"Throttle", ChannelType::Float32, {}},
+      {"Brake", ChannelType::Float32, {}},       {"Clutch", ChannelType::Float32, {}},
+      {"SteeringWheelAngle", ChannelType::Float32, {}},
+      {"Lat", ChannelType::Float64, {}},         {"Lon", ChannelType::Float64, {}},
+      {"VelocityX", ChannelType::Float32, {}},   {"VelocityY", ChannelType::Float32, {}},
+      {"Yaw", ChannelType::Float32, {}},         {"OnPitRoad", ChannelType::Int32, {}},
+      {"IsOnTrack", ChannelType::Int32, {}},
+  };
+  TelemetrySample s;
+  session.next(s);
+  size_t samples = 0;
+  for (int lap = 0; lap < laps; ++lap) {
+    for (Channel& c : channels) c.laps.emplace_back();
+    const int32_t number = s.lap;
+    while (s.lap == number) {
+      const int32_t pit = s.on_pit_road ? 1 : 0;
+      const int32_t on_track = s.is_on_track ? 1 : 0;
+      const void* values[] = {&s.session_time, &s.lap_dist,  &s.lap_dist_pct, &s.lap_current_lap_time,
+                              &s.speed,        &s.rpm,       &s.gear,         &s.throttle,
+                              &s.brake,        &s.clutch,    &s.steering,     &s.lat,
+                              &s.lon,          &s.velocity_x, &s.velocity_y,  &s.yaw,
+                              &pit,            &on_track};
+      for (size_t c = 0; c < channels.size(); ++c) channels[c].push(values[c]);
+      ++samples;
+      session.next(s);
+    }
+  }
+  std::printf("%d laps, %zu samples x %zu channels\n\n", laps, samples, channels.size());
+
+  std::printf("%-20s %4s %12s", "channel", "type", "picked");
+  for (ColumnCodec codec : kCodecs) std::printf(" %12s", codec_name(codec));
+  std::printf("   (bytes/sample)\n");
+
+  Tally per_codec[kCodecCount];
+  Tally picked;
+  size_t raw_bytes = 0;
+  std::vector<uint8_t> encoded;
+  std::vector<uint8_t> decoded;
+  bool exact = true;
+  for (const Channel& c : channels) {
+    size_t bytes[kCodecCount] = {};
+    size_t picked_bytes = 0;
+    ColumnCodec choice = ColumnCodec::Raw;
+    for (size_t lap = 0; lap < c.laps.size(); ++lap) {
+      const size_t n = c.count(lap);
+      raw_bytes += c.laps[lap].size();
+      decoded.resize(c.laps[lap].size());
+      for (size_t k = 0; k < kCodecCount; ++k) {
+        encoded.clear();
+        uint64_t t0 = now_ns();
+        if (!encode_column_as(kCodecs[k], c.type, c.laps[lap].data(), n, encoded)) {
+          bytes[k] = SIZE_MAX;
+          continue;
+        }
+        per_codec[k].encode_ns += now_ns() - t0;
+        if (bytes[k] != SIZE_MAX) bytes[k] += encoded.size();
+        per_codec[k].bytes += encoded.size();
+        t0 = now_ns();
+        const bool ok = decode_column(kCodecs[k], c.type, encoded.data(), encoded.size(), n, decoded.data());
+        per_codec[k].decode_ns += now_ns() - t0;
+        per_codec[k].decoded_bytes += decoded.size();
+        exact = exact && ok && decoded == c.laps[lap];
+      }
+      encoded.clear();
+      uint64_t t0 = now_ns();
+      choice = encode_column(c.type, c.laps[lap].data(), n, encoded);
+      picked.encode_ns += now_ns() - t0;
+      picked_bytes += encoded.size();
+      t0 = now_ns();
+      const bool ok = decode_column(choice, c.type, encoded.data(), encoded.size(), n, decoded.data());
+      picked.decode_ns += now_ns() - t0;
+      picked.decoded_bytes += decoded.size();
+      exact = exact && ok && decoded == c.laps[lap];
+    }
+    picked.bytes += picked_bytes;
+    std::printf("%-20s %4s %12s", c.name, channel_type_name(c.type), codec_name(choice));
+    for (size_t k = 0; k < kCodecCount; ++k) {
+      if (bytes[k] == SIZE_MAX) {
+        std::printf(" %12s", "-");
+      } else {
+        std::printf(" %12.2f", static_cast<double>(bytes[k]) / static_cast<double>(samples));
+      }
+    }
+    std::printf("\n");
+  }
+
+  std::printf("\n%-14s %10s %8s %12s %12s\n", "codec", "MB", "ratio", "encode MB/s", "decode MB/s");
+  auto row = [&](const char* name, const Tally& t) {
+    std::printf("%-14s %10.2f %7.2fx %12.0f %12.0f\n", name, static_cast<double>(t.bytes) / 1e6,
+                static_cast<double>(t.decoded_bytes) / static_cast<double>(t.bytes),
+                static_cast<double>(t.decoded_bytes) * 1e3 / static_cast<double>(std::max<uint64_t>(t.encode_ns, 1)),
+                static_cast<double>(t.decoded_bytes) * 1e3 / static_cast<double>(std::max<uint64_t>(t.decode_ns, 1)));
+  };
+  for (size_t k = 0; k < kCodecCount; ++k) row(codec_name(kCodecs[k]), per_codec[k]);
+  row("picked", picked);
+  std::printf("picked vs delta-varint alone: %.2fx smaller\n",
+              static_cast<double>(per_codec[1].bytes) / static_cast<double>(picked.bytes));
+
+  // Reading raw columns at disk speed against reading the encoded bytes and
+  // then decoding them (no overlap assumed).
+  const double decode_s = static_cast<double>(picked.decode_ns) / 1e9;
+  const double raw_read_s = static_cast<double>(raw_bytes) / (disk_mbps * 1e6);
+  const double encoded_read_s = static_cast<double>(picked.bytes) / (disk_mbps * 1e6);
+  std::printf("at %.0f MB/s disk: raw columns %.1f ms; encoded %.1f ms read + %.1f ms decode = %.0f MB/s of "
+              "values\n",
+              disk_mbps, raw_read_s * 1e3, encoded_read_s * 1e3, decode_s * 1e3,
+              static_cast<double>(raw_bytes) / 1e6 / (encoded_read_s + decode_s));
+  std::printf("round trip: %s\n", exact ? "exact" : "MISMATCH");
+  return exact ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+// Per-corner metrics over a whole history: writes --laps synthetic laps into
+// session stores of --per-store laps, then computes braking point, minimum
+// speed, throttle pickup, trail braking and coasting for every corner of
+// every lap through CornerMetricsCache. Reports the full computation on the
+// pool against one thread, a refresh after one new session, and a refresh
+// with nothing new (the per-view cost once cached).
+//
+//   bench_corner_metrics [--laps 2000] [--per-store 100] [--threads 0]
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "trackpro/common/clock.h"
+#include "trackpro/common/thread_pool.h"
+#include "trackpro/telemetry/corner_metrics.h"
+#include "trackpro/telemetry/synthetic_session.h"
+#include "trackpro/telemetry/track_model.h"
+
+using namespace trackpro;
+using namespace trackpro::telemetry;
+
+namespace {
+
+struct Lap {
+  std::vector<float> distance, speed, throttle, brake;
+};
+
+std::vector<Lap> make_laps(SyntheticSession& session, int count) {
+  std::vector<Lap> laps(static_cast<size_t>(count));
+  TelemetrySample s;
+  session.next(s);
+  while (s.lap_dist > 1.0f) session.next(s);
+  for (Lap& lap : laps) {
+    const int32_t number = s.lap;
+    while (s.lap == number) {
+      lap.distance.push_back(s.lap_dist);
+      lap.speed.push_back(s.speed);
+      lap.throttle.push_back(s.throttle);
+      lap.brake.push_back(s.brake);
+      session.next(s);
+    }
+  }
+  return laps;
+}
+
+void write_store(const std::string& path, const std::vector<Lap>& laps, int count, int offset) {
+  LapStoreWriter writer(path, {{"LapDist", ChannelType::Float32, "m"},
+                               {"Speed", ChannelType::Float32, "m/s"},
+                               {"Throttle", ChannelType::Float32, "%"},
+                               {"Brake", ChannelType::Float32, "%"}});
+  for (int i = 0; i < count; ++i) {
+    const Lap& lap = laps[static_cast<size_t>(offset + i) % laps.size()];
+    LapInfo info;
+    info.lap_number = i + 1;
+    info.sample_count = static_cast<uint32_t>(lap.distance.size());
+    info.flags = i % 10 == 0 ? kLapOutLap : kLapValid;
+    writer.add_lap(info, {lap.distance.data(), lap.speed.data(), lap.throttle.data(), lap.brake.data()});
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int total = static_cast<int>(bench::arg_int(argc, argv, "--laps", 2000));
+  const int per_store = static_cast<int>(bench::arg_int(argc, argv, "--per-store", 100));
+  const auto threads = static_cast<unsigned>(bench::arg_int(argc, argv, "--threads", 0));
+
+  SyntheticSessionOptions options;
+  SyntheticSession session(options);
+  const SyntheticTrack& track = session.track();
+
+  // Corner model from the exact centreline.
+  std::vector<Point2> line;
+  std::vector<float> line_distance, line_speed;
+  for (size_t i = 0; i <= track.x.size(); ++i) {
+    const size_t j = i % track.x.size();
+    line.push_back({static_cast<float>(track.x[j]), static_cast<float>(track.y[j])});
+    line_distance.push_back(static_cast<float>(static_cast<double>(i) * track.step_m));
+    line_speed.push_back(static_cast<float>(track.speed[j]));
+  }
+  TrackModelBuilder builder("synthetic", track.length_m);
+  builder.add_lap({line_distance.data(), line.data(), line_speed.data(), line.size()});
+  const TrackModel model = builder.build();
+
+  const std::vector<Lap> laps = make_laps(session, 40);
+  std::vector<std::string> paths;
+  for (int written = 0; written < total; written += per_store) {
+    paths.push_back("/tmp/trackpro_bench_metrics_" + std::to_string(paths.size()) + ".tpl");
+    write_store(paths.back(), laps, std::min(per_store, total - written), written);
+  }
+  std::vector<LapStore> stores;
+  for (const std::string& p : paths) stores.push_back(LapStore::open(p));
+  std::vector<std::pair<std::string, const LapStore*>> refs;
+  for (size_t i = 0; i < stores.size(); ++i) refs.emplace_back(paths[i], &stores[i]);
+  std::printf("%d laps in %zu stores, %zu corners\n", total, stores.size(), model.corners.size());
+
+  ThreadPool one(1);
+  ThreadPool pool(threads);
+  CornerMetricsCache serial_cache(one);
+  CornerMetricsCache cache(pool);
+  uint64_t t0 = now_ns();
+  const CornerMetricsTable& serial = serial_cache.update("synthetic", "gt3", model, refs);
+  const double serial_ms = static_cast<double>(now_ns() - t0) / 1e6;
+  t0 = now_ns();
+  const CornerMetricsTable& table = cache.update("synthetic", "gt3", model, refs);
+  const double parallel_ms = static_cast<double>(now_ns() - t0) / 1e6;
+  std::printf("full history: %zu rows, %.1f ms on 2 threads, %.1f ms on %zu+1 threads (%.0f laps/s)\n",
+              table.rows().size(), serial_ms, parallel_ms, pool.size(), total / (parallel_ms / 1e3));
+  const bool same = serial.rows().size() == table.rows().size() &&
+                    std::memcmp(serial.rows().data(), table.rows().data(),
+                                table.rows().size() * sizeof(CornerMetrics)) == 0;
+
+  // A new session arrives.
+  paths.push_back("/tmp/trackpro_bench_metrics_new.tpl");
+  write_store(paths.back(), laps, 25, 3);
+  stores.push_back(LapStore::open(paths.back()));
+  refs.clear();
+  for (size_t i = 0; i < stores.size(); ++i) refs.emplace_back(paths[i], &stores[i]);
+  t0 = now_ns();
+  cache.update("synthetic", "gt3", model, refs);
+  const double incremental_ms = static_cast<double>(now_ns() - t0) / 1e6;
+  std::vector<uint64_t> cached_ns;
+  for (int i = 0; i < 200; ++i) {
+    t0 = now_ns();
+    cache.update("synthetic", "gt3", model, refs);
+    cached_ns.push_back(now_ns() - t0);
+  }
+  std::printf("new session of 25 laps: %.2f ms incremental (%zu laps in table)\n", incremental_ms,
+              table.lap_count());
+  bench::print_latency_row("cached view refresh", cached_ns);
+
+  std::printf("%-6s %6s %9s %9s %9s %9s %8s %8s %8s\n", "corner", "laps", "brake m", "min km/h", "at m",
+              "throttle", "trail s", "coast s", "time s");
+  for (size_t c = 0; c < table.corners().size(); ++c) {
+    const CornerSummary& s = table.summary(c);
+    std::printf("T%-5d %6u %9.1f %9.1f %9.1f %9.1f %8.2f %8.2f %8.2f\n", table.corners()[c].number, s.laps,
+                s.mean_brake_point_m, s.mean_min_speed * 3.6f, table.corners()[c].apex_m, s.mean_throttle_point_m,
+                s.mean_trail_brake_s, s.mean_coasting_s, s.mean_corner_time_s);
+  }
+  std::printf("parallel rows %s serial rows\n", same ? "match" : "DIFFER from");
+  for (const std::string& p : paths) std::remove(p.c_str());
+  return same ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+// Cost and accuracy of pedal curve evaluation: control-point search versus
+// the compiled CurveBank, scalar per axis and four axes at once.
+//
+//   bench_curve_lut [--samples 10000000]
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "bench_util.h"
+#include "trackpro/common/clock.h"
+#include "trackpro/pedals/curve_lut.h"
+
+using namespace trackpro;
+using namespace trackpro::pedals;
+
+namespace {
+
+template <typename Fn>
+double time_per_sample_ns(size_t samples, Fn&& fn) {
+  const uint64_t t0 = now_ns();
+  fn();
+  return static_cast<double>(now_ns() - t0) / static_cast<double>(samples);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const auto samples = static_cast<size_t>(bench::arg_int(argc, argv, "--samples", 10'000'000));
+
+  const std::array<ResponseCurve, kPedalAxisCount> curves = {
+      ResponseCurve::preset("aggressive"), ResponseCurve::preset("progressive"),
+      ResponseCurve::preset("s-curve"),
+      ResponseCurve({{0.0f, 0.0f}, {0.1f, 0.02f}, {0.3f, 0.2f}, {0.45f, 0.31f}, {0.6f, 0.5f},
+                     {0.8f, 0.77f}, {0.9f, 0.9f}, {1.0f, 1.0f}})};
+  CurveBank bank;
+  bank.compile(curves);
+
+  // 4K distinct inputs cycled: enough to defeat branch memorisation without
+  // measuring main-memory bandwidth.
+  constexpr size_t kInputs = 4096;
+  std::vector<std::array<float, 4>> inputs(kInputs);
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+  for (auto& in : inputs) {
+    for (float& v : in) {
+      v = dist(rng);
+    }
+  }
+
+  volatile float sink = 0.0f;
+  const double exact_ns = time_per_sample_ns(samples, [&] {
+    float acc = 0.0f;
+    for (size_t i = 0; i < samples; ++i) {
+      const auto& in = inputs[i & (kInputs - 1)];
+      for (size_t a = 0; a < 4; ++a) {
+        acc += curves[a].evaluate(in[a]);
+      }
+    }
+    sink = acc;
+  });
+  const double scalar_ns = time_per_sample_ns(samples, [&] {
+    float acc = 0.0f;
+    for (size_t i = 0; i < samples; ++i) {
+      const auto& in = inputs[i & (kInputs - 1)];
+      for (size_t a = 0; a < 4; ++a) {
+        acc += bank.evaluate(static_cast<PedalAxis>(a), in[a]);
+      }
+    }
+    sink = acc;
+  });
+  const double simd_ns = time_per_sample_ns(samples, [&] {
+    float acc = 0.0f;
+    float out[4];
+    for (size_t i = 0; i < samples; ++i) {
+      bank.evaluate4(inputs[i & (kInputs - 1)].data(), out);
+      acc += out[0] + out[1] + out[2] + out[3];
+    }
+    sink = acc;
+  });
+  (void)sink;
+
+  float max_error = 0.0f;
+  for (int i = 0; i <= 100000; ++i) {
+    const float x = static_cast<float>(i) / 100000.0f;
+    const float in[4] = {x, x, x, x};
+    float out[4];
+    bank.evaluate4(in, out);
+    for (size_t a = 0; a < 4; ++a) {
+      max_error = std::max(max_error, std::fabs(out[a] - curves[a].evaluate(x)));
+    }
+  }
+
+  std::printf("curve evaluation, 4 axes per sample, %zu samples\n", samples);
+  std::printf("  control-point search : %6.2f ns/sample\n", exact_ns);
+  std::printf("  LUT scalar           : %6.2f ns/sample\n", scalar_ns);
+  std::printf("  LUT evaluate4 (SIMD) : %6.2f ns/sample\n", simd_ns);
+  std::printf("  max |LUT - exact|    : %.2e (%zu segments)\n", max_error, CurveBank::kSegments);
+  return 0;
+}
@@ -0,0 +1,92 @@
+// Streaming .ibt import: synthesises an .ibt of the requested size (about
+// 250 variables per record, like a real iRacing file), imports it into a lap
+// store and reports throughput and peak resident memory. The file is read
+// once beforehand, so MB/s measures the importer rather than the disk.
+//
+//   bench_ibt_import [--size-mb 1024] [--threads 0] [--chunk 4096] [--ibt file.ibt] [--keep 1]
+
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#endif
+
+#include "bench_util.h"
+#include "trackpro/telemetry/ibt_file.h"
+#include "trackpro/telemetry/ibt_importer.h"
+#include "trackpro/telemetry/lap_store.h"
+#include "trackpro/telemetry/synthetic_session.h"
+
+using namespace trackpro;
+using namespace trackpro::telemetry;
+
+namespace {
+
+double peak_rss_mb() {
+#if defined(__linux__)
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return static_cast<double>(usage.ru_maxrss) / 1024.0;
+#else
+  return 0.0;
+#endif
+}
+
+void warm_page_cache(const std::string& path) {
+  std::FILE* f = std::fopen(path.c_str(), "rb");
+  std::vector<char> buffer(1 << 20);
+  while (std::fread(buffer.data(), 1, buffer.size(), f) == buffer.size()) {
+  }
+  std::fclose(f);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const double size_mb = bench::arg_double(argc, argv, "--size-mb", 1024.0);
+  std::string ibt = bench::arg(argc, argv, "--ibt", "");
+  const std::string store_path = "/tmp/trackpro_bench_import.tpl";
+  const bool generated = ibt.empty();
+  if (generated) {
+    ibt = "/tmp/trackpro_bench_import.ibt";
+    SyntheticSessionOptions options;
+    const double record_bytes = 1232.0;  // 241 vars, see write_synthetic_ibt()
+    const double seconds = size_mb * 1e6 / record_bytes / options.tick_rate;
+    write_synthetic_ibt(ibt, seconds, options);
+  }
+  warm_page_cache(ibt);
+  const IbtLayout layout = IbtLayout::read(ibt);
+  std::printf("%s: %.1f MB, %zu records x %zu bytes, %zu vars, %d Hz\n", ibt.c_str(),
+              static_cast<double>(std::filesystem::file_size(ibt)) / 1e6, layout.record_count(),
+              layout.record_size(), layout.vars().size(), layout.header().tickRate);
+
+  IbtImportOptions options;
+  options.threads = static_cast<unsigned>(bench::arg_int(argc, argv, "--threads", 0));
+  options.chunk_records = static_cast<size_t>(bench::arg_int(argc, argv, "--chunk", 4096));
+  const double rss_before = peak_rss_mb();
+  IbtImporter importer(options);
+  const IbtImportStats stats = importer.import(ibt, store_path);
+  const double rss_after = peak_rss_mb();
+
+  const LapStore store = LapStore::open(store_path);
+  uint64_t samples = 0;
+  for (size_t l = 0; l < store.lap_count(); ++l) {
+    samples += store.lap(l).sample_count;
+  }
+  std::printf("imported %llu records into %llu laps x %zu channels in %.2f s: %.0f MB/s, %.2f M records/s\n",
+              static_cast<unsigned long long>(stats.records), static_cast<unsigned long long>(stats.laps),
+              store.channel_count(), stats.seconds, stats.mb_per_second(),
+              static_cast<double>(stats.records) / stats.seconds / 1e6);
+  std::printf("lap store %.1f MB (%.1fx smaller than the .ibt)\n", static_cast<double>(stats.bytes_written) / 1e6,
+              static_cast<double>(stats.bytes_read) / static_cast<double>(stats.bytes_written));
+  std::printf("peak RSS: %.1f MB before import, %.1f MB after (threads=%u, chunk=%zu records)\n", rss_before,
+              rss_after, options.threads, options.chunk_records);
+  std::printf("sample count check: %s\n", samples == stats.records ? "ok" : "MISMATCH");
+
+  if (bench::arg_int(argc, argv, "--keep", 0) == 0 && generated) {
+    std::filesystem::remove(ibt);
+  }
+  return samples == stats.records ? 0 : 1;
+}
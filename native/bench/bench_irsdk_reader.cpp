@@ -0,0 +1,217 @@
+// irsdk telemetry read path without iRacing: synthesises an .ibt session,
+// replays it into an irsdk-layout shared-memory region, and measures the
+// per-tick cost of reading ~24 channels through IrsdkReader against the
+// copy-and-box approach (snapshot the row, build a name -> value map) that
+// Python-style wrappers use. Counts heap allocations on the hot path, then
+// runs the producer on its own thread at sim pace and checks no tick is
+// skipped or torn.
+//
+//   bench_irsdk_reader [--ticks 200000] [--rate 360] [--live-seconds 3]
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "trackpro/common/clock.h"
+#include "trackpro/telemetry/ibt_replay_producer.h"
+#include "trackpro/telemetry/irsdk_reader.h"
+#include "trackpro/telemetry/synthetic_session.h"
+
+using namespace trackpro;
+using namespace trackpro::telemetry;
+
+namespace {
+
+std::atomic<uint64_t> g_allocations{0};
+
+const char* const kFloatChannels[] = {
+    "LapDistPct", "LapDist", "LapCurrentLapTime", "Speed", "RPM", "Throttle", "Brake", "Clutch",
+    "SteeringWheelAngle", "VelocityX", "VelocityY", "Yaw", "Aux000", "Aux001", "Aux002", "Aux003",
+    "Aux004", "Aux005",
+};
+const char* const kIntChannels[] = {"SessionTick", "Lap", "Gear"};
+const char* const kDoubleChannels[] = {"SessionTime", "Lat", "Lon"};
+
+#if defined(__linux__)
+const char* const kRegionPath = "/dev/shm/trackpro_bench_irsdk";
+#else
+const char* const kRegionPath = "Local\\TrackProBenchIrsdk";
+#endif
+
+struct Channels {
+  std::vector<IrsdkVar<float>> floats;
+  std::vector<IrsdkVar<int32_t>> ints;
+  std::vector<IrsdkVar<double>> doubles;
+
+  void bind(const IrsdkReader& reader) {
+    floats.clear();
+    ints.clear();
+    doubles.clear();
+    for (const char* name : kFloatChannels) floats.push_back(reader.var<float>(name));
+    for (const char* name : kIntChannels) ints.push_back(reader.var<int32_t>(name));
+    for (const char* name : kDoubleChannels) doubles.push_back(reader.var<double>(name));
+  }
+
+  double read(const IrsdkFrame& frame) const {
+    double sum = 0.0;
+    for (const auto& v : floats) sum += v.get(frame);
+    for (const auto& v : ints) sum += v.get(frame);
+    for (const auto& v : doubles) sum += v.get(frame);
+    return sum;
+  }
+};
+
+// Baseline: copy the row out and box every variable into a map keyed by
+// name, then look channels up by string.
+double read_boxed(const IrsdkReader& reader, const IrsdkFrame& frame, const std::vector<std::string>& names,
+                  size_t row_bytes) {
+  std::vector<uint8_t> row(frame.row, frame.row + row_bytes);
+  std::map<std::string, double> values;
+  for (const std::string& name : names) {
+    const IrsdkVarHeader* h = reader.find(name);
+    double v = 0.0;
+    switch (h->type) {
+      case IrsdkVarType::Float: {
+        float f;
+        std::memcpy(&f, row.data() + h->offset, sizeof(f));
+        v = f;
+        break;
+      }
+      case IrsdkVarType::Double:
+        std::memcpy(&v, row.data() + h->offset, sizeof(v));
+        break;
+      default: {
+        int32_t i;
+        std::memcpy(&i, row.data() + h->offset, sizeof(i));
+        v = i;
+        break;
+      }
+    }
+    values.emplace(name, v);
+  }
+  double sum = 0.0;
+  for (const std::string& name : names) sum += values[name];
+  return sum;
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+int main(int argc, char** argv) {
+  const long long ticks = bench::arg_int(argc, argv, "--ticks", 200'000);
+  const double rate = bench::arg_double(argc, argv, "--rate", 360.0);
+  const double live_seconds = bench::arg_double(argc, argv, "--live-seconds", 3.0);
+
+  const std::string ibt_path = "/tmp/trackpro_bench_irsdk.ibt";
+  SyntheticSessionOptions session;
+  session.tick_rate = 60;
+  const size_t records = write_synthetic_ibt(ibt_path, 600.0, session);
+  auto file = std::make_shared<const IbtFile>(IbtFile::open(ibt_path));
+  std::printf("session %s: %zu records x %zu bytes, %zu vars\n", ibt_path.c_str(), records,
+              file->layout().record_size(), file->layout().vars().size());
+
+  std::vector<std::string> names;
+  for (const char* n : kFloatChannels) names.emplace_back(n);
+  for (const char* n : kIntChannels) names.emplace_back(n);
+  for (const char* n : kDoubleChannels) names.emplace_back(n);
+
+  // Unpaced: producer and reader on this thread, one publish per read.
+  {
+    IbtReplayProducer producer(file, kRegionPath);
+    IrsdkReader reader(MappedRegion::open_read(kRegionPath));
+    Channels channels;
+    IrsdkFrame frame;
+    producer.step(true);
+    reader.poll(frame);
+    channels.bind(reader);
+
+    double sink = 0.0;
+    uint64_t read_ns = 0;
+    const uint64_t allocs_before = g_allocations.load();
+    for (long long i = 0; i < ticks; ++i) {
+      producer.step(true);
+      const uint64_t t0 = now_ns();
+      if (reader.poll(frame) == IrsdkPoll::NewFrame) {
+        sink += channels.read(frame);
+      }
+      read_ns += now_ns() - t0;
+    }
+    const uint64_t zero_copy_allocs = g_allocations.load() - allocs_before;
+
+    uint64_t boxed_ns = 0;
+    const uint64_t boxed_before = g_allocations.load();
+    for (long long i = 0; i < ticks; ++i) {
+      producer.step(true);
+      const uint64_t t0 = now_ns();
+      if (reader.poll(frame) == IrsdkPoll::NewFrame) {
+        sink += read_boxed(reader, frame, names, file->layout().record_size());
+      }
+      boxed_ns += now_ns() - t0;
+    }
+    const uint64_t boxed_allocs = g_allocations.load() - boxed_before;
+
+    const double n = static_cast<double>(ticks);
+    std::printf("zero-copy  poll+%zu reads: %8.1f ns/tick, %.2f allocs/tick\n", names.size(),
+                static_cast<double>(read_ns) / n, static_cast<double>(zero_copy_allocs) / n);
+    std::printf("copy+box   poll+%zu reads: %8.1f ns/tick, %.2f allocs/tick (%.1fx slower)\n", names.size(),
+                static_cast<double>(boxed_ns) / n, static_cast<double>(boxed_allocs) / n,
+                static_cast<double>(boxed_ns) / static_cast<double>(read_ns));
+    std::printf("(checksum %.3f)\n", sink);
+  }
+
+  // Paced: producer thread at `rate` Hz, reader waiting for frames.
+  if (live_seconds > 0.0) {
+    IbtReplayProducer producer(file, kRegionPath);
+    IrsdkReader reader(MappedRegion::open_read(kRegionPath));
+    Channels channels;
+    IrsdkFrame frame;
+    producer.start(rate / session.tick_rate, true);
+
+    std::vector<uint64_t> read_ns;
+    uint64_t torn = 0;
+    double sink = 0.0;
+    uint32_t revision = 0;
+    const uint64_t end = now_ns() + static_cast<uint64_t>(live_seconds * 1e9);
+    while (now_ns() < end) {
+      if (reader.wait_for_frame(frame, 50 * kNanosPerMilli) != IrsdkPoll::NewFrame) {
+        continue;
+      }
+      if (revision != reader.layout_revision()) {
+        channels.bind(reader);
+        revision = reader.layout_revision();
+      }
+      const uint64_t t0 = now_ns();
+      sink += channels.read(frame);
+      if (!frame.still_valid()) {
+        ++torn;
+      }
+      read_ns.push_back(now_ns() - t0);
+    }
+    producer.stop();
+    const IrsdkReaderCounters& c = reader.counters();
+    std::printf("paced %.0f Hz for %.1f s: published=%llu frames=%llu skipped=%llu torn=%llu\n", rate,
+                live_seconds, static_cast<unsigned long long>(producer.published()),
+                static_cast<unsigned long long>(c.frames), static_cast<unsigned long long>(c.skipped_ticks),
+                static_cast<unsigned long long>(torn));
+    bench::print_latency_row("read 24 channels", read_ns);
+    std::printf("(checksum %.3f)\n", sink);
+  }
+  std::remove(kRegionPath);
+  return 0;
+}
@@ -0,0 +1,219 @@
+// Adaptive jitter buffer over a lossy, jittery UDP link on localhost. A
+// sender captures synthetic speech in 20 ms frames, ADPCM-encodes it and
+// passes each packet through a link model before it goes out on a real
+// socket: Gilbert loss bursts and exponential jitter whose mean alternates
+// between a calm and a congested level every --phase-s seconds.
+// A receiver thread hands packets to the playout thread through a SpscRing;
+// the playout thread feeds the same packets to an adaptive buffer and to
+// fixed-delay buffers, pulls 20 ms every 20 ms, and reports mouth-to-ear
+// latency (capture to playout), underruns (concealed frames) and
+// time-stretching for each.
+//
+//   bench_jitter_buffer [--seconds 60] [--loss 0.02] [--burst 2] [--base-ms 20] [--jitter-ms 3]
+//                       [--congested-ms 25] [--phase-s 10] [--drift-ppm 100] [--seed 1]
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <queue>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "trackpro/common/clock.h"
+#include "trackpro/common/realtime.h"
+#include "trackpro/common/spsc_ring.h"
+#include "trackpro/voice/jitter_buffer.h"
+#include "trackpro/voice/synthetic_voice.h"
+#include "trackpro/voice/udp_socket.h"
+#include "trackpro/voice/voice_codec.h"
+
+using namespace trackpro;
+using namespace trackpro::voice;
+
+namespace {
+
+constexpr size_t kPacketBytes = kVoiceHeaderSize + kAdpcmFrameBytes;
+
+struct Datagram {
+  uint64_t arrival_ns;
+  uint16_t size;
+  uint8_t data[kPacketBytes];
+};
+
+struct InFlight {
+  uint64_t due_ns;
+  Datagram packet;
+  bool operator>(const InFlight& o) const { return due_ns > o.due_ns; }
+};
+
+struct LinkStats {
+  uint64_t sent = 0;
+  uint64_t lost = 0;
+  std::vector<uint64_t> delay_ns;
+};
+
+struct Receiver {
+  const char* name;
+  JitterBuffer buffer;
+  std::vector<uint64_t> mouth_to_ear_ns;
+  uint64_t played = 0;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const double seconds = bench::arg_double(argc, argv, "--seconds", 60.0);
+  const double loss = bench::arg_double(argc, argv, "--loss", 0.02);
+  const double burst = std::max(1.0, bench::arg_double(argc, argv, "--burst", 2.0));
+  const double base_ms = bench::arg_double(argc, argv, "--base-ms", 20.0);
+  const double jitter_ms = bench::arg_double(argc, argv, "--jitter-ms", 3.0);
+  const double congested_ms = bench::arg_double(argc, argv, "--congested-ms", 25.0);
+  const double phase_s = std::max(0.1, bench::arg_double(argc, argv, "--phase-s", 10.0));
+  const double drift_ppm = bench::arg_double(argc, argv, "--drift-ppm", 100.0);
+  const auto seed = static_cast<uint32_t>(bench::arg_int(argc, argv, "--seed", 1));
+
+  UdpSocket rx;
+  UdpSocket tx;
+  rx.set_buffer_sizes(1 << 20);
+  const UdpAddress to = rx.local_address();
+  const auto frames = static_cast<uint32_t>(seconds * 1e9 / static_cast<double>(kVoiceFrameNs));
+  const auto capture_period =
+      static_cast<uint64_t>(static_cast<double>(kVoiceFrameNs) * (1.0 + drift_ppm * 1e-6));
+  const uint64_t start = now_ns() + 50 * kNanosPerMilli;
+  std::atomic<bool> done{false};
+
+  // Sender and link model: one thread that captures on schedule and
+  // releases delayed packets when they fall due.
+  LinkStats link;
+  std::thread sender([&] {
+    promote_current_thread_realtime(50);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::exponential_distribution<double> exponential(1.0);
+    const double to_bad = loss / burst / std::max(1.0 - loss, 1e-9);
+    bool bad = false;
+    SyntheticVoice voice;
+    AdpcmEncoder encoder;
+    float pcm[kVoiceFrameSamples];
+    std::priority_queue<InFlight, std::vector<InFlight>, std::greater<>> queue;
+    uint32_t sequence = 0;
+    while (sequence < frames || !queue.empty()) {
+      const uint64_t capture = start + sequence * capture_period;
+      const uint64_t next = sequence < frames ? capture : UINT64_MAX;
+      if (!queue.empty() && queue.top().due_ns <= next) {
+        sleep_until_ns(queue.top().due_ns, 20'000);
+        const InFlight& f = queue.top();
+        tx.send_to(to, f.packet.data, f.packet.size);
+        queue.pop();
+        continue;
+      }
+      sleep_until_ns(capture, 20'000);
+      voice.next(pcm);
+      InFlight f;
+      VoicePacketHeader header;
+      header.stream = 1;
+      header.sequence = sequence;
+      header.capture_ns = capture;
+      write_voice_header(header, f.packet.data);
+      f.packet.size = static_cast<uint16_t>(kVoiceHeaderSize + encoder.encode(pcm, f.packet.data + kVoiceHeaderSize));
+      ++sequence;
+      ++link.sent;
+      bad = bad ? unit(rng) >= 1.0 / burst : unit(rng) < to_bad;
+      if (bad) {
+        ++link.lost;
+        continue;
+      }
+      const auto phase = static_cast<uint64_t>(static_cast<double>(capture - start) / 1e9 / phase_s);
+      const double delay_ms = base_ms + exponential(rng) * (phase % 2 == 0 ? jitter_ms : congested_ms);
+      f.due_ns = capture + static_cast<uint64_t>(delay_ms * 1e6);
+      link.delay_ns.push_back(f.due_ns - capture);
+      queue.push(f);
+    }
+  });
+
+  SpscRing<Datagram, 1024> ring;
+  std::thread receiver([&] {
+    Datagram d;
+    while (!done.load(std::memory_order_relaxed)) {
+      const long n = rx.receive(d.data, sizeof(d.data), nullptr, now_ns() + 50 * kNanosPerMilli);
+      if (n > 0) {
+        d.arrival_ns = now_ns();
+        d.size = static_cast<uint16_t>(n);
+        ring.try_push(d);
+      }
+    }
+  });
+
+  JitterBufferOptions fixed60;
+  fixed60.min_delay_ns = fixed60.max_delay_ns = 60 * kNanosPerMilli;
+  JitterBufferOptions fixed200;
+  fixed200.min_delay_ns = fixed200.max_delay_ns = 200 * kNanosPerMilli;
+  std::vector<Receiver> receivers;
+  receivers.push_back({"adaptive", JitterBuffer(), {}, 0});
+  receivers.push_back({"fixed 60 ms", JitterBuffer(fixed60), {}, 0});
+  receivers.push_back({"fixed 200 ms", JitterBuffer(fixed200), {}, 0});
+
+  // Playout: the audio device's 20 ms clock, on the receiver's own crystal.
+  std::vector<uint64_t> target_ns[2];  // adaptive target in calm / congested phases
+  uint64_t late_ticks = 0;
+  {
+    promote_current_thread_realtime(60);
+    float out[kVoiceFrameSamples];
+    const uint64_t end = start + frames * capture_period + 600 * kNanosPerMilli;
+    for (uint64_t tick = start; tick < end; tick += kVoiceFrameNs) {
+      sleep_until_ns(tick, 20'000);
+      late_ticks += now_ns() > tick + 2 * kNanosPerMilli ? 1 : 0;
+      Datagram d;
+      while (ring.try_pop(d)) {
+        VoicePacketHeader header;
+        const uint8_t* payload;
+        size_t size;
+        if (!parse_voice_packet(d.data, d.size, header, payload, size)) continue;
+        for (Receiver& r : receivers) r.buffer.push(header.sequence, payload, size, d.arrival_ns);
+      }
+      for (Receiver& r : receivers) {
+        const PlayoutInfo info = r.buffer.pull(out);
+        if (!info.voiced) continue;
+        ++r.played;
+        if (info.concealed) continue;
+        const uint64_t captured = start + info.sequence * capture_period +
+                                  info.offset * kNanosPerSecond / kVoiceSampleRate;
+        r.mouth_to_ear_ns.push_back(tick - captured);
+      }
+      const auto phase = static_cast<size_t>(static_cast<double>(tick - start) / 1e9 / phase_s) % 2;
+      target_ns[phase].push_back(receivers[0].buffer.target_delay_ns());
+    }
+  }
+  done = true;
+  sender.join();
+  receiver.join();
+
+  std::printf("link: %llu frames over %.0f s, %.2f%% lost (mean burst %.1f), drift %+.0f ppm\n",
+              static_cast<unsigned long long>(link.sent), seconds,
+              100.0 * static_cast<double>(link.lost) / static_cast<double>(link.sent), burst, drift_ppm);
+  std::printf("one-way delay: p50 %.1f ms, p95 %.1f ms, p99 %.1f ms, max %.1f ms; playout ticks late: %llu\n",
+              bench::percentile(link.delay_ns, 0.5) / 1e6, bench::percentile(link.delay_ns, 0.95) / 1e6,
+              bench::percentile(link.delay_ns, 0.99) / 1e6, bench::percentile(link.delay_ns, 1.0) / 1e6,
+              static_cast<unsigned long long>(late_ticks));
+  std::printf("adaptive target: p50 %.0f ms calm, %.0f ms congested; max %.0f ms\n\n",
+              bench::percentile(target_ns[0], 0.5) / 1e6, bench::percentile(target_ns[1], 0.5) / 1e6,
+              std::max(bench::percentile(target_ns[0], 1.0), bench::percentile(target_ns[1], 1.0)) / 1e6);
+  std::printf("%-14s %8s %8s %8s %10s %6s %6s %7s %7s\n", "buffer", "m2e p50", "p95", "p99", "underruns", "late",
+              "dups", "accel", "expand");
+  for (Receiver& r : receivers) {
+    const JitterBufferCounters& c = r.buffer.counters();
+    std::printf("%-14s %6.1fms %6.1fms %6.1fms %9.2f%% %6llu %6llu %7llu %7llu\n", r.name,
+                bench::percentile(r.mouth_to_ear_ns, 0.5) / 1e6, bench::percentile(r.mouth_to_ear_ns, 0.95) / 1e6,
+                bench::percentile(r.mouth_to_ear_ns, 0.99) / 1e6,
+                100.0 * static_cast<double>(c.concealed) / static_cast<double>(std::max<uint64_t>(r.played, 1)),
+                static_cast<unsigned long long>(c.late), static_cast<unsigned long long>(c.duplicates),
+                static_cast<unsigned long long>(c.accelerated), static_cast<unsigned long long>(c.expanded));
+  }
+  std::printf("(underruns include the %.2f%% of frames the link lost outright)\n",
+              100.0 * static_cast<double>(link.lost) / static_cast<double>(link.sent));
+  return 0;
+}
@@ -0,0 +1,200 @@
+// Lap query over a long history: writes --laps synthetic laps into session
+// stores of --per-store laps (every fifth store a different car), then asks
+// for valid laps of one car whose minimum speed through the slowest corner
+// beats a threshold. Compares a naive scan that decodes every channel of
+// every lap, run_query with metadata pushdown only, and run_query with zone
+// maps, and checks that all three return the same laps.
+//
+//   bench_lap_query [--laps 50000] [--per-store 1000] [--rate 20] [--threads 0]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "trackpro/common/clock.h"
+#include "trackpro/common/thread_pool.h"
+#include "trackpro/telemetry/lap_query.h"
+#include "trackpro/telemetry/synthetic_session.h"
+
+using namespace trackpro;
+using namespace trackpro::telemetry;
+
+namespace {
+
+const std::vector<ChannelInfo> kChannels = {{"LapDist", ChannelType::Float32, "m"},
+                                            {"Speed", ChannelType::Float32, "m/s"},
+                                            {"Throttle", ChannelType::Float32, "%"},
+                                            {"Brake", ChannelType::Float32, "%"}};
+
+struct Lap {
+  std::vector<float> distance, speed, throttle, brake;
+};
+
+std::vector<Lap> make_laps(SyntheticSession& session, int count) {
+  std::vector<Lap> laps(static_cast<size_t>(count));
+  TelemetrySample s;
+  session.next(s);
+  while (s.lap_dist > 1.0f) session.next(s);
+  for (Lap& lap : laps) {
+    const int32_t number = s.lap;
+    while (s.lap == number) {
+      lap.distance.push_back(s.lap_dist);
+      lap.speed.push_back(s.speed);
+      lap.throttle.push_back(s.throttle);
+      lap.brake.push_back(s.brake);
+      session.next(s);
+    }
+  }
+  return laps;
+}
+
+float window_min(const std::vector<float>& d, const std::vector<float>& v, float from, float to) {
+  float m = INFINITY;
+  for (size_t i = 0; i < d.size(); ++i) {
+    if (d[i] >= from && d[i] < to) m = std::min(m, v[i]);
+  }
+  return m;
+}
+
+bool same_hits(const QueryResult& a, const QueryResult& b) {
+  if (a.hits.size() != b.hits.size()) return false;
+  for (size_t i = 0; i < a.hits.size(); ++i) {
+    if (a.hits[i].source != b.hits[i].source || a.hits[i].lap != b.hits[i].lap) return false;
+  }
+  return true;
+}
+
+void print_row(const char* name, double ms, const QueryResult& r) {
+  std::printf("%-22s %9.1f %8zu %10zu %10zu %10zu %10zu\n", name, ms, r.hits.size(), r.stats.pruned_metadata,
+              r.stats.decided_by_stats, r.stats.decoded_laps, r.stats.decoded_chunks);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int total = static_cast<int>(bench::arg_int(argc, argv, "--laps", 50000));
+  const int per_store = static_cast<int>(bench::arg_int(argc, argv, "--per-store", 1000));
+  const auto threads = static_cast<unsigned>(bench::arg_int(argc, argv, "--threads", 0));
+
+  SyntheticSessionOptions options;
+  options.tick_rate = static_cast<int>(bench::arg_int(argc, argv, "--rate", 20));
+  options.lap_time_spread = 0.03;
+  SyntheticSession session(options);
+  const double length = session.track().length_m;
+
+  // A pool of distinct laps, encoded once and written over and over.
+  const std::vector<Lap> laps = make_laps(session, 200);
+  std::vector<EncodedLap> encoded;
+  for (const Lap& lap : laps) {
+    LapInfo info;
+    info.sample_count = static_cast<uint32_t>(lap.distance.size());
+    info.sample_rate_hz = static_cast<float>(options.tick_rate);
+    info.lap_time_s = static_cast<float>(lap.distance.size()) / static_cast<float>(options.tick_rate);
+    encoded.push_back(encode_lap(kChannels, info,
+                                 {lap.distance.data(), lap.speed.data(), lap.throttle.data(), lap.brake.data()}));
+  }
+
+  // The slowest corner of the first lap, and a threshold only the quickest
+  // tenth of laps carry more speed than.
+  const auto slowest = std::min_element(laps[0].speed.begin(), laps[0].speed.end()) - laps[0].speed.begin();
+  const float apex = laps[0].distance[static_cast<size_t>(slowest)];
+  const float from = std::max(0.0f, apex - 150.0f);
+  const float to = apex + 150.0f;
+  std::vector<float> mins;
+  for (const Lap& lap : laps) mins.push_back(window_min(lap.distance, lap.speed, from, to));
+  std::vector<float> sorted = mins;
+  std::sort(sorted.begin(), sorted.end());
+  const float threshold = sorted[sorted.size() * 9 / 10];
+
+  uint64_t t0 = now_ns();
+  std::vector<std::string> paths;
+  for (int written = 0; written < total; written += per_store) {
+    const int store = static_cast<int>(paths.size());
+    paths.push_back("/tmp/trackpro_bench_query_" + std::to_string(store) + ".tpl");
+    LapStoreMetadata meta;
+    meta.track = "spa";
+    meta.car = store % 5 == 4 ? "gt4" : "gt3";
+    LapStoreWriter writer(paths.back(), kChannels, meta);
+    for (int i = 0; i < std::min(per_store, total - written); ++i) {
+      EncodedLap lap = encoded[static_cast<size_t>(written + i) * 7 % encoded.size()];
+      lap.info.lap_number = i + 1;
+      lap.info.flags = i % 10 == 0 ? kLapOutLap : kLapValid;
+      writer.write_lap(lap);
+    }
+  }
+  std::vector<LapStore> stores;
+  for (const std::string& p : paths) stores.push_back(LapStore::open(p));
+  std::printf("%d laps in %zu stores written in %.1f s; window %.0f-%.0f m, min speed > %.2f m/s\n", total,
+              stores.size(), static_cast<double>(now_ns() - t0) / 1e9, from, to, threshold);
+
+  ThreadPool pool(threads);
+  t0 = now_ns();
+  std::vector<LapZoneIndex> indexes;
+  for (const LapStore& store : stores) {
+    indexes.emplace_back(length, std::vector<std::string>{"Speed", "Throttle", "Brake"});
+    indexes.back().update(store, &pool);
+  }
+  const double index_ms = static_cast<double>(now_ns() - t0) / 1e6;
+  size_t index_bytes = 0;
+  for (const LapZoneIndex& index : indexes) index_bytes += index.memory_bytes();
+  const std::string sidecar = "/tmp/trackpro_bench_query.tpz";
+  const bool round_trip = indexes[0].save(sidecar) && LapZoneIndex::load(sidecar).lap_count() == indexes[0].lap_count();
+  std::printf("zone index: %.1f ms to build, %.1f MB for %zu zones per lap, sidecar round trip %s\n", index_ms,
+              static_cast<double>(index_bytes) / 1e6, indexes[0].zone_count(), round_trip ? "ok" : "FAILED");
+
+  LapQuery query;
+  query.track = "spa";
+  query.car = "gt3";
+  query.where.push_back({"Speed", Aggregate::Min, from, to, Compare::Greater, threshold});
+
+  // Naive: decode every channel of every lap, then filter.
+  t0 = now_ns();
+  QueryResult naive;
+  std::vector<float> columns[4];
+  for (size_t s = 0; s < stores.size(); ++s) {
+    for (size_t l = 0; l < stores[s].lap_count(); ++l) {
+      ++naive.stats.laps;
+      ++naive.stats.decoded_laps;
+      for (size_t c = 0; c < 4; ++c) stores[s].read(l, c, columns[c]);
+      naive.stats.decoded_chunks += 4;
+      const LapInfo info = stores[s].lap(l);
+      if (stores[s].metadata().car != query.car || (info.flags & kLapValid) == 0) continue;
+      if (window_min(columns[0], columns[1], from, to) > threshold) {
+        naive.hits.push_back({static_cast<uint32_t>(s), static_cast<uint32_t>(l)});
+      }
+    }
+  }
+  const double naive_ms = static_cast<double>(now_ns() - t0) / 1e6;
+
+  std::vector<QuerySource> plain, zoned;
+  for (size_t s = 0; s < stores.size(); ++s) {
+    plain.push_back({&stores[s], nullptr});
+    zoned.push_back({&stores[s], &indexes[s]});
+  }
+  t0 = now_ns();
+  const QueryResult pushdown = run_query(plain, query);
+  const double pushdown_ms = static_cast<double>(now_ns() - t0) / 1e6;
+  t0 = now_ns();
+  const QueryResult zone = run_query(zoned, query);
+  const double zone_ms = static_cast<double>(now_ns() - t0) / 1e6;
+  t0 = now_ns();
+  const QueryResult zone_pool = run_query(zoned, query, &pool);
+  const double zone_pool_ms = static_cast<double>(now_ns() - t0) / 1e6;
+
+  std::printf("%-22s %9s %8s %10s %10s %10s %10s\n", "strategy", "ms", "hits", "pruned", "by stats", "decoded",
+              "chunks");
+  print_row("decode everything", naive_ms, naive);
+  print_row("metadata pushdown", pushdown_ms, pushdown);
+  print_row("zone maps", zone_ms, zone);
+  print_row("zone maps + pool", zone_pool_ms, zone_pool);
+  std::printf("zone maps %.1fx faster than decoding everything\n", naive_ms / zone_ms);
+
+  const bool same = same_hits(naive, pushdown) && same_hits(naive, zone) && same_hits(naive, zone_pool);
+  std::printf("results %s\n", same ? "match" : "DIFFER");
+  for (const std::string& p : paths) std::remove(p.c_str());
+  std::remove(sidecar.c_str());
+  return same && round_trip ? 0 : 1;
+}
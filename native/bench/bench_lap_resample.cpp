@@ -0,0 +1,178 @@
+// Distance-aligned resampling: maps 1000 synthetic laps x 20 channels onto a
+// 0.5 m grid with DistanceResampler, checks the result against a scalar
+// binary-search reference, and times a lap-vs-lap comparison on the grid.
+// Also checks a lap whose first tick still carries the previous lap's
+// LapDist, as iRacing's often does just after the line.
+//
+//   bench_lap_resample [--laps 1000] [--channels 20] [--step 0.5] [--distinct 40]
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "bench_util.h"
+#include "trackpro/common/clock.h"
+#include "trackpro/telemetry/lap_resampler.h"
+#include "trackpro/telemetry/synthetic_session.h"
+
+using namespace trackpro;
+using namespace trackpro::telemetry;
+
+namespace {
+
+struct Lap {
+  std::vector<float> distance;
+  std::vector<std::vector<float>> channels;
+};
+
+// Distinct laps from the synthetic session; the timed loop cycles through
+// them so the working set resembles a real history (and the planner cannot
+// reuse anything between laps).
+std::vector<Lap> make_laps(int distinct, int channels, SyntheticSessionOptions options) {
+  SyntheticSession session(options);
+  std::vector<Lap> laps;
+  TelemetrySample s;
+  session.next(s);
+  while (static_cast<int>(laps.size()) < distinct) {
+    Lap lap;
+    lap.channels.resize(static_cast<size_t>(channels));
+    const int32_t number = s.lap;
+    while (s.lap == number) {
+      const float base[] = {s.speed,      s.rpm,        s.throttle, s.brake,
+                            s.clutch,     s.steering,   static_cast<float>(s.gear),
+                            s.velocity_x, s.velocity_y, s.yaw,      s.lap_dist_pct,
+                            s.lap_current_lap_time};
+      lap.distance.push_back(s.lap_dist);
+      for (int c = 0; c < channels; ++c) {
+        const float v = base[c % 12] * (1.0f + 0.01f * static_cast<float>(c / 12));
+        lap.channels[static_cast<size_t>(c)].push_back(v);
+      }
+      session.next(s);
+    }
+    laps.push_back(std::move(lap));
+  }
+  return laps;
+}
+
+float reference_at(const std::vector<float>& distance, const std::vector<float>& channel, float x) {
+  std::vector<float> mono(distance.size());
+  float running = distance[0];
+  for (size_t i = 0; i < distance.size(); ++i) {
+    running = std::max(running, distance[i]);
+    mono[i] = running;
+  }
+  if (x <= mono.front()) return channel.front();
+  if (x >= mono.back()) return channel.back();
+  const size_t hi = static_cast<size_t>(std::upper_bound(mono.begin(), mono.end(), x) - mono.begin());
+  const size_t lo = hi - 1;
+  const float w = (x - mono[lo]) / (mono[hi] - mono[lo]);
+  return channel[lo] + w * (channel[hi] - channel[lo]);
+}
+
+// Prepends a tick at the end of the previous lap (LapDist just short of the
+// track length, channel value -1) and checks the resampled lap still
+// matches the clean one from its first real sample on.
+bool lagging_start_check(const Lap& lap, double track_length, double step) {
+  std::vector<float> distance = lap.distance;
+  std::vector<float> channel = lap.channels[0];
+  distance.insert(distance.begin(), static_cast<float>(track_length - 1.0));
+  channel.insert(channel.begin(), -1.0f);
+  DistanceResampler resampler(track_length, step);
+  std::vector<float> out(resampler.points());
+  resampler.plan(distance.data(), distance.size());
+  resampler.apply(channel.data(), out.data());
+  double max_error = 0.0;
+  for (size_t g = 0; g < resampler.points(); ++g) {
+    const auto x = static_cast<float>(static_cast<double>(g) * step);
+    if (x < lap.distance.front()) {
+      continue;  // between the lagging tick and the first real one
+    }
+    const float expected = reference_at(lap.distance, lap.channels[0], x);
+    max_error = std::max(max_error, static_cast<double>(std::fabs(expected - out[g])) /
+                                        std::max(1.0f, std::fabs(expected)));
+  }
+  const bool ok = max_error < 1e-4;
+  std::printf("lagging first LapDist (%.0f m): max relative error %.2e, %s\n", track_length - 1.0, max_error,
+              ok ? "ok" : "FAIL");
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int laps_total = static_cast<int>(bench::arg_int(argc, argv, "--laps", 1000));
+  const int channels = static_cast<int>(bench::arg_int(argc, argv, "--channels", 20));
+  const double step = bench::arg_double(argc, argv, "--step", 0.5);
+  const int distinct = static_cast<int>(bench::arg_int(argc, argv, "--distinct", 40));
+
+  SyntheticSessionOptions options;
+  const std::vector<Lap> laps = make_laps(distinct, channels, options);
+  DistanceResampler resampler(options.track_length_m, step);
+  std::vector<std::vector<float>> grid(static_cast<size_t>(channels), std::vector<float>(resampler.points()));
+  std::vector<float*> out;
+  for (auto& g : grid) {
+    out.push_back(g.data());
+  }
+  std::printf("%d laps x %d channels, ~%zu samples/lap -> %zu grid points at %.2f m\n", laps_total, channels,
+              laps[0].distance.size(), resampler.points(), step);
+
+  // Correctness against the scalar reference on one lap.
+  {
+    const Lap& lap = laps[1];
+    resampler.plan(lap.distance.data(), lap.distance.size());
+    std::vector<const float*> in;
+    for (const auto& c : lap.channels) in.push_back(c.data());
+    resampler.apply(in, out);
+    double max_error = 0.0;
+    for (size_t g = 0; g < resampler.points(); g += 7) {
+      const auto x = static_cast<float>(static_cast<double>(g) * step);
+      for (int c = 0; c < channels; c += 5) {
+        const float expected = reference_at(lap.distance, lap.channels[static_cast<size_t>(c)], x);
+        max_error = std::max(max_error, static_cast<double>(std::fabs(expected - grid[static_cast<size_t>(c)][g])) /
+                                            std::max(1.0f, std::fabs(expected)));
+      }
+    }
+    std::printf("max relative error vs scalar reference: %.2e\n", max_error);
+  }
+  const bool lagging_ok = lagging_start_check(laps[1], options.track_length_m, step);
+
+  double sink = 0.0;
+  uint64_t plan_ns = 0;
+  const uint64_t start = now_ns();
+  for (int i = 0; i < laps_total; ++i) {
+    const Lap& lap = laps[static_cast<size_t>(i % distinct)];
+    const uint64_t t0 = now_ns();
+    resampler.plan(lap.distance.data(), lap.distance.size());
+    plan_ns += now_ns() - t0;
+    std::vector<const float*> in;
+    in.reserve(lap.channels.size());
+    for (const auto& c : lap.channels) in.push_back(c.data());
+    resampler.apply(in, out);
+    sink += grid[0][resampler.points() / 2];
+  }
+  const double total_s = static_cast<double>(now_ns() - start) / 1e9;
+  const double outputs = static_cast<double>(laps_total) * channels * static_cast<double>(resampler.points());
+  std::printf("resampled in %.3f s (plan %.3f s): %.2f ns/output point, %.0f laps/s\n", total_s,
+              static_cast<double>(plan_ns) / 1e9, total_s * 1e9 / outputs, laps_total / total_s);
+
+  // Lap-vs-lap on the grid: speed difference and time delta between two laps.
+  std::vector<float> speed_a(resampler.points()), speed_b(resampler.points()), diff(resampler.points());
+  std::vector<float> time_a(resampler.points()), time_b(resampler.points()), delta(resampler.points());
+  const Lap& a = laps[1];
+  const Lap& b = laps[2];
+  resampler.plan(a.distance.data(), a.distance.size());
+  resampler.apply(a.channels[0].data(), speed_a.data());
+  resampler.apply(a.channels[11].data(), time_a.data());
+  resampler.plan(b.distance.data(), b.distance.size());
+  resampler.apply(b.channels[0].data(), speed_b.data());
+  resampler.apply(b.channels[11].data(), time_b.data());
+  const uint64_t d0 = now_ns();
+  subtract(speed_a.data(), speed_b.data(), diff.data(), diff.size());
+  subtract(time_a.data(), time_b.data(), delta.data(), delta.size());
+  const double diff_us = static_cast<double>(now_ns() - d0) / 1e3;
+  std::printf("lap-vs-lap compare (2 channels, %zu points): %.1f us; delta at finish %+.3f s\n", diff.size(),
+              diff_us, delta[delta.size() - 2]);
+  std::printf("(checksum %.3f)\n", sink);
+  return lagging_ok ? 0 : 1;
+}
@@ -0,0 +1,165 @@
+// Incremental lap segmentation: drives LapSegmenter with a scripted session
+// (clean laps, a tow to the pits, a reset that relocates the car, a pit
+// stop), checks every lap is classified as expected and lap/sector times are
+// exact to interpolation accuracy, then measures the per-sample cost.
+//
+//   bench_lap_segmenter [--cycles 200] [--rate 60] [--lap-seconds 90]
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "bench_util.h"
+#include "trackpro/common/clock.h"
+#include "trackpro/telemetry/lap_segmenter.h"
+
+using namespace trackpro;
+using namespace trackpro::telemetry;
+
+namespace {
+
+class Script {
+ public:
+  Script(double rate, double lap_seconds) : dt_(1.0 / rate), step_(1.0 / (lap_seconds * rate)) {}
+
+  // Advances until LapDistPct passes `target`, wrapping at most once.
+  void drive_to(double target, double speed = 1.0, bool pit = false) {
+    double d = target - pct_;
+    if (d <= 0.0) {
+      d += 1.0;
+    }
+    const auto ticks = static_cast<long>(std::ceil(d / (step_ * speed)));
+    for (long i = 0; i < ticks; ++i) {
+      emit(step_ * speed, pit, true);
+    }
+  }
+  void hold(long ticks, bool pit, bool on_track) {
+    for (long i = 0; i < ticks; ++i) {
+      emit(0.0, pit, on_track);
+    }
+  }
+  void teleport(double pct, bool pit) {
+    pct_ = pct;
+    emit(0.0, pit, true);
+  }
+
+  std::vector<TelemetrySample> samples;
+
+ private:
+  void emit(double advance, bool pit, bool on_track) {
+    pct_ += advance;
+    if (pct_ >= 1.0) {
+      pct_ -= 1.0;
+      ++lap_;
+    }
+    TelemetrySample s;
+    s.session_time = time_;
+    s.lap = lap_;
+    s.lap_dist_pct = static_cast<float>(pct_);
+    s.on_pit_road = pit;
+    s.is_on_track = on_track;
+    samples.push_back(s);
+    time_ += dt_;
+  }
+
+  double dt_;
+  double step_;
+  double pct_ = 0.5;  // the stream joins mid-lap
+  double time_ = 0.0;
+  int32_t lap_ = 1;
+};
+
+struct Tally : LapListener {
+  void on_lap(const SegmentedLap& lap) override {
+    ++laps;
+    if (lap.end == LapEnd::Reset) {
+      ++aborted;
+    } else if ((lap.info.flags & kLapValid) != 0) {
+      ++valid;
+      max_lap_error = std::max(max_lap_error, std::fabs(lap.info.lap_time_s - expected_lap));
+      for (int i = 0; i < lap.sector_count; ++i) {
+        max_sector_error = std::max(max_sector_error, std::fabs(lap.sector_times[static_cast<size_t>(i)] -
+                                                                expected_lap / lap.sector_count));
+      }
+    } else if ((lap.info.flags & kLapInLap) != 0) {
+      ++in_laps;
+    } else if ((lap.info.flags & kLapOutLap) != 0) {
+      ++out_laps;
+    } else {
+      ++other;
+    }
+    samples_in_laps += lap.info.sample_count;
+  }
+  void on_sector(const SectorTime&) override { ++sectors; }
+
+  double expected_lap = 0.0;
+  long laps = 0, valid = 0, in_laps = 0, out_laps = 0, aborted = 0, other = 0, sectors = 0;
+  uint64_t samples_in_laps = 0;
+  double max_lap_error = 0.0;
+  double max_sector_error = 0.0;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const long cycles = bench::arg_int(argc, argv, "--cycles", 200);
+  const double rate = bench::arg_double(argc, argv, "--rate", 60.0);
+  const double lap_seconds = bench::arg_double(argc, argv, "--lap-seconds", 90.0);
+
+  Script script(rate, lap_seconds);
+  for (long c = 0; c < cycles; ++c) {
+    script.drive_to(1e-6);  // two clean laps
+    script.drive_to(1e-6);
+    script.drive_to(0.5);  // tow: off track, then parked in the pits, then out
+    script.hold(static_cast<long>(3 * rate), false, false);
+    script.teleport(0.92, true);
+    script.hold(static_cast<long>(5 * rate), true, true);
+    script.drive_to(0.06, 0.5, true);
+    script.drive_to(1e-6);
+    script.drive_to(0.3);  // reset: relocated further round the lap
+    script.teleport(0.55, false);
+    script.drive_to(1e-6);
+    script.drive_to(0.9);  // pit stop across the line
+    script.drive_to(0.97, 0.5, true);
+    script.hold(static_cast<long>(10 * rate), true, true);
+    script.drive_to(0.06, 0.5, true);
+    script.drive_to(1e-6);
+  }
+
+  LapSegmenterOptions options;
+  options.sector_splits = {1.0f / 3.0f, 2.0f / 3.0f};
+  options.sample_rate_hz = static_cast<float>(rate);
+  Tally tally;
+  tally.expected_lap = lap_seconds;
+  LapSegmenter segmenter(tally, options);
+  for (const TelemetrySample& s : script.samples) {
+    segmenter.push(s);
+  }
+  segmenter.finish();
+
+  // Per cycle: 2 clean, tow -> aborted + out lap, reset -> aborted, pit stop
+  // -> in lap + out lap. The very first lap is joined mid-stream and the
+  // last is cut by finish(), so both are incomplete ("other").
+  const bool ok = tally.valid == 2 * cycles - 1 && tally.aborted == 2 * cycles && tally.in_laps == cycles &&
+                  tally.out_laps == 2 * cycles && tally.other == 2;
+  std::printf("%zu samples, %ld laps: valid=%ld (expect %ld) out=%ld (%ld) in=%ld (%ld) aborted=%ld (%ld) "
+              "other=%ld (2) -> %s\n",
+              script.samples.size(), tally.laps, tally.valid, 2 * cycles - 1, tally.out_laps, 2 * cycles,
+              tally.in_laps, cycles, tally.aborted, 2 * cycles, tally.other, ok ? "ok" : "MISMATCH");
+  std::printf("valid lap time error max %.2e s, sector error max %.2e s (%ld sector events)\n",
+              tally.max_lap_error, tally.max_sector_error, tally.sectors);
+
+  // Throughput: replay the script repeatedly.
+  Tally sink;
+  LapSegmenter timed(sink, options);
+  const int passes = 10;
+  const uint64_t t0 = now_ns();
+  for (int pass = 0; pass < passes; ++pass) {
+    for (const TelemetrySample& s : script.samples) {
+      timed.push(s);
+    }
+  }
+  const double ns = static_cast<double>(now_ns() - t0) / static_cast<double>(passes * script.samples.size());
+  std::printf("push(): %.2f ns/sample (%.0f M samples/s, %ld laps emitted)\n", ns, 1e3 / ns, sink.laps);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,211 @@
+// Columnar lap store: writes a synthetic session lap by lap, reports the
+// compression against raw columns, then measures random single-channel reads
+// on a freshly opened file (latency and page faults, to show only the
+// requested chunk is touched) and whole-lap decodes.
+//
+//   bench_lap_store [--laps 300] [--rate 60] [--reads 2000] [--path /tmp/x.tpl]
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#endif
+
+#include "bench_util.h"
+#include "trackpro/common/clock.h"
+#include "trackpro/telemetry/lap_store.h"
+#include "trackpro/telemetry/synthetic_session.h"
+
+using namespace trackpro;
+using namespace trackpro::telemetry;
+
+namespace {
+
+const std::vector<ChannelInfo> kChannels = {
+    {"SessionTime", ChannelType::Float64, "s"},  {"LapDist", ChannelType::Float32, "m"},
+    {"LapDistPct", ChannelType::Float32, "%"},   {"LapCurrentLapTime", ChannelType::Float32, "s"},
+    {"Speed", ChannelType::Float32, "m/s"},      {"RPM", ChannelType::Float32, "revs/min"},
+    {"Gear", ChannelType::Int32, ""},            {"Throttle", ChannelType::Float32, "%"},
+    {"Brake", ChannelType::Float32, "%"},        {"Clutch", ChannelType::Float32, "%"},
+    {"SteeringWheelAngle", ChannelType::Float32, "rad"},
+    {"Lat", ChannelType::Float64, "deg"},        {"Lon", ChannelType::Float64, "deg"},
+    {"VelocityX", ChannelType::Float32, "m/s"},  {"VelocityY", ChannelType::Float32, "m/s"},
+    {"Yaw", ChannelType::Float32, "rad"},
+};
+
+struct LapColumns {
+  std::vector<double> session_time, lat, lon;
+  std::vector<float> lap_dist, lap_dist_pct, lap_time, speed, rpm, throttle, brake, clutch, steering, vx, vy, yaw;
+  std::vector<int32_t> gear;
+
+  void clear() { *this = LapColumns(); }
+  void push(const TelemetrySample& s) {
+    session_time.push_back(s.session_time);
+    lap_dist.push_back(s.lap_dist);
+    lap_dist_pct.push_back(s.lap_dist_pct);
+    lap_time.push_back(s.lap_current_lap_time);
+    speed.push_back(s.speed);
+    rpm.push_back(s.rpm);
+    gear.push_back(s.gear);
+    throttle.push_back(s.throttle);
+    brake.push_back(s.brake);
+    clutch.push_back(s.clutch);
+    steering.push_back(s.steering);
+    lat.push_back(s.lat);
+    lon.push_back(s.lon);
+    vx.push_back(s.velocity_x);
+    vy.push_back(s.velocity_y);
+    yaw.push_back(s.yaw);
+  }
+  std::vector<const void*> pointers() const {
+    return {session_time.data(), lap_dist.data(), lap_dist_pct.data(), lap_time.data(), speed.data(),
+            rpm.data(),          gear.data(),     throttle.data(),     brake.data(),    clutch.data(),
+            steering.data(),     lat.data(),      lon.data(),          vx.data(),       vy.data(),
+            yaw.data()};
+  }
+};
+
+long minor_faults() {
+#if defined(__linux__)
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_minflt + usage.ru_majflt;
+#else
+  return 0;
+#endif
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int laps = static_cast<int>(bench::arg_int(argc, argv, "--laps", 300));
+  const int rate = static_cast<int>(bench::arg_int(argc, argv, "--rate", 60));
+  const int reads = static_cast<int>(bench::arg_int(argc, argv, "--reads", 2000));
+  const std::string path = bench::arg(argc, argv, "--path", "/tmp/trackpro_bench_laps.tpl");
+
+  SyntheticSessionOptions options;
+  options.tick_rate = rate;
+  SyntheticSession session(options);
+  LapColumns columns;
+  size_t raw_bytes = 0;
+  size_t samples = 0;
+  const uint64_t write_start = now_ns();
+  {
+    LapStoreMetadata meta;
+    meta.track = "synthetic";
+    meta.car = "bench";
+    LapStoreWriter writer(path, kChannels, meta);
+    TelemetrySample s;
+    session.next(s);
+    int lap = s.lap;
+    double lap_start = s.session_time;
+    while (static_cast<int>(writer.lap_count()) < laps) {
+      columns.push(s);
+      session.next(s);
+      if (s.lap != lap) {
+        LapInfo info;
+        info.lap_number = lap;
+        info.sample_count = static_cast<uint32_t>(columns.speed.size());
+        info.sample_rate_hz = static_cast<float>(rate);
+        info.lap_time_s = s.session_time - lap_start;
+        info.start_session_time = lap_start;
+        info.flags = kLapValid;
+        writer.add_lap(info, columns.pointers());
+        writer.commit();
+        samples += info.sample_count;
+        for (const ChannelInfo& c : kChannels) {
+          raw_bytes += info.sample_count * channel_type_size(c.type);
+        }
+        columns.clear();
+        lap = s.lap;
+        lap_start = s.session_time;
+      }
+    }
+  }
+  const double write_s = static_cast<double>(now_ns() - write_start) / 1e9;
+
+  const uint64_t open_start = now_ns();
+  const LapStore store = LapStore::open(path);
+  const double open_us = static_cast<double>(now_ns() - open_start) / 1e3;
+  std::printf("%zu laps x %zu channels, %zu samples/channel: raw %.1f MB -> file %.2f MB (%.1fx), "
+              "written+committed per lap in %.2f s total\n",
+              store.lap_count(), store.channel_count(), samples, raw_bytes / 1e6, store.file_size() / 1e6,
+              static_cast<double>(raw_bytes) / static_cast<double>(store.file_size()), write_s);
+  std::printf("open: %.1f us (directory used in place)\n", open_us);
+
+  std::printf("%-20s %5s %12s %8s\n", "channel", "type", "codec", "B/sample");
+  for (size_t c = 0; c < store.channel_count(); ++c) {
+    size_t bytes = 0;
+    for (size_t l = 0; l < store.lap_count(); ++l) {
+      bytes += store.chunk(l, c).encoded_bytes;
+    }
+    std::printf("%-20s %5s %12s %8.2f\n", store.channels()[c].name.c_str(),
+                channel_type_name(store.channels()[c].type), codec_name(store.chunk(0, c).codec),
+                static_cast<double>(bytes) / static_cast<double>(samples));
+  }
+
+  // Random single-channel reads, each on a freshly mapped file so the page
+  // fault count reflects exactly what one plot request touches.
+  std::mt19937 rng(3);
+  std::uniform_int_distribution<size_t> pick_lap(0, store.lap_count() - 1);
+  std::uniform_int_distribution<size_t> pick_channel(0, store.channel_count() - 1);
+  std::vector<uint64_t> cold_ns;
+  std::vector<uint64_t> warm_ns;
+  long faults = 0;
+  size_t chunk_pages = 0;
+  std::vector<float> out;
+  for (int i = 0; i < reads / 10; ++i) {
+    const LapStore fresh = LapStore::open(path);
+    const size_t l = pick_lap(rng);
+    const size_t c = pick_channel(rng);
+    const long before = minor_faults();
+    const uint64_t t0 = now_ns();
+    fresh.read(l, c, out);
+    cold_ns.push_back(now_ns() - t0);
+    faults += minor_faults() - before;
+    chunk_pages += fresh.chunk(l, c).encoded_bytes / 4096 + 2;
+  }
+  double sink = 0.0;
+  for (int i = 0; i < reads; ++i) {
+    const size_t l = pick_lap(rng);
+    const size_t c = pick_channel(rng);
+    const uint64_t t0 = now_ns();
+    store.read(l, c, out);
+    warm_ns.push_back(now_ns() - t0);
+    sink += out.empty() ? 0.0 : out[out.size() / 2];
+  }
+  bench::print_latency_row("one channel (cold map)", cold_ns);
+  bench::print_latency_row("one channel (warm)", warm_ns);
+  std::printf("page faults per cold read: %.1f (chunk spans <= %.1f pages incl. directory)\n",
+              static_cast<double>(faults) / (reads / 10),
+              static_cast<double>(chunk_pages) / (reads / 10));
+
+  std::vector<uint64_t> lap_ns;
+  for (int i = 0; i < 200; ++i) {
+    const size_t l = pick_lap(rng);
+    const uint64_t t0 = now_ns();
+    for (size_t c = 0; c < store.channel_count(); ++c) {
+      store.read(l, c, out);
+    }
+    lap_ns.push_back(now_ns() - t0);
+  }
+  bench::print_latency_row("whole lap, 16 channels", lap_ns);
+
+  // Round trip check against a regenerated lap.
+  {
+    SyntheticSession check(options);
+    TelemetrySample s;
+    std::vector<float> speed;
+    check.next(s);
+    const int first = s.lap;
+    while (s.lap == first) {
+      speed.push_back(s.speed);
+      check.next(s);
+    }
+    store.read(0, static_cast<size_t>(store.find_channel("Speed")), out);
+    std::printf("round trip lap 0 Speed: %s (checksum %.3f)\n", out == speed ? "exact" : "MISMATCH", sink);
+    return out == speed ? 0 : 1;
+  }
+}
@@ -0,0 +1,216 @@
+// Live dashboard stress test: an IbtReplayProducer publishes a synthetic
+// session at 360 Hz (times --speed) while the dashboard draws 60 fps with a
+// deliberately slow renderer (--render-ms of busy work per frame, plus
+// pyramid queries for every channel over the whole session).
+//
+// Decoupled: TelemetryCapture on its own thread, LiveDashboard on another.
+// Under load: the same with a renderer that fits its frame budget while a
+// normal-priority thread spins on the CPU, as a browser or encoder would;
+// the dashboard must still reach --fps. --background opts the dashboard
+// thread into its lowered priority for both.
+// Inline: the old single loop that draws between ticks. For each, reports
+// ticks published vs captured, ticks the capture side missed, gaps in the
+// captured SessionTick sequence, frames drawn and capture-to-frame latency.
+//
+//   bench_live_dashboard [--seconds 10] [--speed 2] [--fps 60] [--render-ms 25] [--pixels 1920] [--background 0]
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bench_util.h"
+#include "trackpro/common/clock.h"
+#include "trackpro/telemetry/ibt_replay_producer.h"
+#include "trackpro/telemetry/live_dashboard.h"
+#include "trackpro/telemetry/synthetic_session.h"
+
+using namespace trackpro;
+using namespace trackpro::telemetry;
+
+namespace {
+
+const char* const kRegionPath = "/dev/shm/trackpro_bench_dashboard";
+
+// Queries every channel like a real plot would, then burns the rest of the
+// frame budget (and more) as painting.
+class SlowRenderer final : public DashboardRenderer {
+ public:
+  SlowRenderer(size_t pixels, uint64_t busy_ns) : columns_(pixels), busy_ns_(busy_ns) {}
+
+  void render(const DashboardView& view) override {
+    const uint64_t start = now_ns();
+    if (view.snapshot.samples > 0) {
+      latency_ns.push_back(start - view.snapshot.capture_ns);
+    }
+    for (const MinMaxPyramid& channel : view.history) {
+      if (channel.size() > 0) {
+        channel.columns(0, channel.size(), columns_.size(), columns_.data());
+        sink += columns_[columns_.size() / 2].max;
+      }
+    }
+    while (now_ns() - start < busy_ns_) {
+    }
+  }
+
+  std::vector<uint64_t> latency_ns;
+  double sink = 0.0;
+
+ private:
+  std::vector<MinMax> columns_;
+  uint64_t busy_ns_;
+};
+
+uint64_t tick_gaps(const SampleLog& log) {
+  uint64_t gaps = 0;
+  for (size_t i = 1; i < log.size(); ++i) {
+    // Looping replays restart SessionTick; only forward jumps are gaps.
+    if (log[i].session_tick > log[i - 1].session_tick + 1) {
+      gaps += static_cast<uint64_t>(log[i].session_tick - log[i - 1].session_tick - 1);
+    }
+  }
+  return gaps;
+}
+
+void report(const char* mode, uint64_t published, uint64_t captured, uint64_t missed, uint64_t gaps,
+            uint64_t frames, uint64_t dropped_frames, double seconds, std::vector<uint64_t> latency) {
+  std::printf("%-10s published=%llu captured=%llu missed=%llu tick_gaps=%llu frames=%llu (%.1f fps, %llu dropped)\n",
+              mode, static_cast<unsigned long long>(published), static_cast<unsigned long long>(captured),
+              static_cast<unsigned long long>(missed), static_cast<unsigned long long>(gaps),
+              static_cast<unsigned long long>(frames), static_cast<double>(frames) / seconds,
+              static_cast<unsigned long long>(dropped_frames));
+  bench::print_latency_row("  capture->frame", std::move(latency));
+}
+
+struct DecoupledRun {
+  const char* mode;
+  double seconds;
+  double speed;
+  uint64_t busy_ns;
+  size_t pixels;
+  LiveDashboardOptions options;
+  bool hog;
+};
+
+// Returns false if capture lost ticks, or if the dashboard missed its frame
+// rate under load.
+bool run_decoupled(const std::shared_ptr<const IbtFile>& file, const DecoupledRun& run) {
+  IbtReplayProducer producer(file, kRegionPath);
+  TelemetryCapture capture(std::make_unique<IrsdkTelemetrySource>(MappedRegion::open_read(kRegionPath)));
+  SlowRenderer renderer(run.pixels, run.busy_ns);
+  LiveDashboard dashboard(capture, renderer, run.options);
+  std::atomic<bool> hogging{run.hog};
+  std::thread hog([&hogging] {
+    volatile uint64_t spin = 0;
+    while (hogging.load(std::memory_order_relaxed)) {
+      spin = spin + 1;
+    }
+  });
+  capture.start();
+  sleep_until_ns(now_ns() + 20 * kNanosPerMilli);
+  producer.start(run.speed, true);
+  dashboard.start();
+  sleep_until_ns(now_ns() + static_cast<uint64_t>(run.seconds * 1e9));
+  producer.stop();
+  sleep_until_ns(now_ns() + 50 * kNanosPerMilli);
+  dashboard.stop();
+  capture.stop();
+  hogging.store(false, std::memory_order_relaxed);
+  hog.join();
+  const TelemetryCaptureCounters c = capture.counters();
+  const LiveDashboardCounters d = dashboard.counters();
+  const uint64_t gaps = tick_gaps(capture.log());
+  std::printf("capture thread realtime: %s, dashboard thread lowered: %s, cpu hog: %s\n",
+              capture.realtime() ? "yes" : "no (best effort)", dashboard.background() ? "yes" : "no",
+              run.hog ? "yes" : "no");
+  report(run.mode, producer.published(), c.samples, c.source_dropped, gaps, d.frames, d.dropped_frames, run.seconds,
+         renderer.latency_ns);
+  bool ok = true;
+  if (c.samples != producer.published() || c.source_dropped != 0 || gaps != 0) {
+    std::printf("FAIL: capture dropped samples with the dashboard open\n");
+    ok = false;
+  }
+  const double fps = static_cast<double>(d.frames) / run.seconds;
+  if (run.hog && fps < 0.9 * run.options.max_fps) {
+    std::printf("FAIL: dashboard drew %.1f fps of %.0f under a CPU hog\n", fps, run.options.max_fps);
+    ok = false;
+  }
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const double seconds = bench::arg_double(argc, argv, "--seconds", 10.0);
+  const double speed = bench::arg_double(argc, argv, "--speed", 2.0);
+  const double fps = bench::arg_double(argc, argv, "--fps", 60.0);
+  const auto busy_ns = static_cast<uint64_t>(bench::arg_double(argc, argv, "--render-ms", 25.0) * 1e6);
+  const auto pixels = static_cast<size_t>(bench::arg_int(argc, argv, "--pixels", 1920));
+
+  const std::string ibt_path = "/tmp/trackpro_bench_dashboard.ibt";
+  SyntheticSessionOptions session;
+  session.tick_rate = 360;
+  write_synthetic_ibt(ibt_path, 300.0, session, 20);
+  auto file = std::make_shared<const IbtFile>(IbtFile::open(ibt_path));
+  std::printf("%.0f Hz x %.1f, %.0f fps cap, %.1f ms render, %.1f s per mode\n", 360.0, speed, fps,
+              static_cast<double>(busy_ns) / 1e6, seconds);
+  const auto run_ns = static_cast<uint64_t>(seconds * 1e9);
+  int status = 0;
+
+  LiveDashboardOptions options;
+  options.max_fps = fps;
+  options.background = bench::arg_int(argc, argv, "--background", 0) != 0;
+  if (!run_decoupled(file, DecoupledRun{"decoupled", seconds, speed, busy_ns, pixels, options, false})) {
+    status = 1;
+  }
+  // A quarter of the frame budget: the dashboard needs that share of the core
+  // against the hog's.
+  const auto fitting_ns = std::min(busy_ns, static_cast<uint64_t>(0.25e9 / fps));
+  std::printf("under load: %.1f ms render\n", static_cast<double>(fitting_ns) / 1e6);
+  if (!run_decoupled(file, DecoupledRun{"under load", seconds, speed, fitting_ns, pixels, options, true})) {
+    status = 1;
+  }
+
+  {
+    IbtReplayProducer producer(file, kRegionPath);
+    IrsdkTelemetrySource source(MappedRegion::open_read(kRegionPath));
+    SampleLog log(static_cast<size_t>(seconds * 360.0 * speed * 2) + SampleLog::kBlockSamples);
+    SlowRenderer renderer(pixels, busy_ns);
+    const std::vector<DashboardChannel> channels = default_dashboard_channels();
+    std::vector<MinMaxPyramid> history(channels.size());
+    const auto period = static_cast<uint64_t>(1e9 / fps);
+    uint64_t frames = 0;
+    uint64_t dropped_frames = 0;
+    producer.start(speed, true);
+    TelemetrySample sample;
+    CaptureSnapshot snap;
+    uint64_t next_frame = now_ns();
+    const uint64_t end = now_ns() + run_ns;
+    while (now_ns() < end) {
+      if (source.next(sample, std::min(end, next_frame))) {
+        log.append(sample);
+        for (size_t c = 0; c < channels.size(); ++c) {
+          history[c].append(sample.*channels[c].field);
+        }
+        snap.latest = sample;
+        snap.capture_ns = now_ns();
+        snap.samples = log.size();
+      }
+      if (now_ns() >= next_frame) {
+        renderer.render(DashboardView{snap, channels, history, frames++, next_frame});
+        const uint64_t missed = (now_ns() - next_frame) / period;
+        dropped_frames += missed;
+        next_frame += (missed + 1) * period;
+      }
+    }
+    producer.stop();
+    report("inline", producer.published(), log.size(), source.dropped(), tick_gaps(log), frames, dropped_frames, seconds, renderer.latency_ns);
+  }
+  std::remove(kRegionPath);
+  std::remove(ibt_path.c_str());
+  return status;
+}
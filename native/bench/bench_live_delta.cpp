@@ -0,0 +1,202 @@
+// Live delta at full telemetry rate: runs a synthetic 360 Hz session through
+// LapSegmenter and LiveDelta, with two reader threads (dashboard, voice
+// coach) polling snapshots. Reports the per-tick update cost against a
+// linear rescan of the reference, how closely the delta at the line matches
+// the real lap-time difference, and checks readers never see a torn snapshot.
+// Also checks that a reference whose first tick still carries the previous
+// lap's distance reads like a clean one, and that a lap too long for the
+// trace is counted and never promoted to best.
+//
+//   bench_live_delta [--laps 30] [--rate 360]
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bench_util.h"
+#include "trackpro/common/clock.h"
+#include "trackpro/telemetry/live_delta.h"
+#include "trackpro/telemetry/synthetic_session.h"
+
+using namespace trackpro;
+using namespace trackpro::telemetry;
+
+namespace {
+
+// Forwards segmenter events to LiveDelta and remembers the last closed lap.
+struct Fanout : LapListener {
+  explicit Fanout(LiveDelta& d) : delta(d) {}
+  void on_lap_start(const LapInfo& lap) override { delta.on_lap_start(lap); }
+  void on_lap(const SegmentedLap& lap) override {
+    // The delta just before the line predicts this lap against the best.
+    if ((lap.info.flags & kLapValid) != 0 && had_best) {
+      const double actual = lap.info.lap_time_s - best_time;
+      max_line_error = std::max(max_line_error, std::fabs(actual - last_delta));
+      ++compared;
+    }
+    delta.on_lap(lap);
+    if (delta.best() != nullptr) {
+      had_best = true;
+      best_time = delta.best()->lap_time();
+    }
+  }
+  LiveDelta& delta;
+  bool had_best = false;
+  double best_time = 0.0;
+  double last_delta = 0.0;
+  double max_line_error = 0.0;
+  int compared = 0;
+};
+
+// Baseline: no table, scan the reference trace every tick.
+double scan_time_at(const std::vector<float>& distance, const std::vector<float>& elapsed, float d) {
+  for (size_t i = 1; i < distance.size(); ++i) {
+    if (distance[i] >= d) {
+      const float span = distance[i] - distance[i - 1];
+      const float w = span > 0.0f ? (d - distance[i - 1]) / span : 0.0f;
+      return elapsed[i - 1] + w * (elapsed[i] - elapsed[i - 1]);
+    }
+  }
+  return elapsed.back();
+}
+
+// The same lap with one tick just before the line prepended, as when LapDist
+// lags the lap change. Returns the largest time_at() difference.
+double lagging_reference_error(const std::vector<float>& distance, const std::vector<float>& elapsed,
+                               const ReferenceLap& clean) {
+  std::vector<float> lagging_distance{distance.back() - 1.0f};
+  std::vector<float> lagging_elapsed{elapsed.front()};
+  lagging_distance.insert(lagging_distance.end(), distance.begin(), distance.end());
+  lagging_elapsed.insert(lagging_elapsed.end(), elapsed.begin(), elapsed.end());
+  const ReferenceLap lagging(std::move(lagging_distance), std::move(lagging_elapsed), clean.lap_time());
+  double error = 0.0;
+  for (double d = distance.front(); d < clean.length(); d += 10.0) {
+    error = std::max(error, std::fabs(lagging.time_at(d) - clean.time_at(d)));
+  }
+  return error;
+}
+
+// Drives one valid lap an hour long through a fresh LiveDelta. It must not
+// become the best, since its trace stops after ten minutes.
+bool truncated_lap_check() {
+  LiveDelta delta;
+  LapInfo info;
+  info.lap_number = 1;
+  info.flags = kLapValid;
+  delta.on_lap_start(info);
+  TelemetrySample s;
+  const int ticks = 360 * 3600;
+  for (int i = 0; i < ticks; ++i) {
+    s.session_time = i / 360.0;
+    s.lap_dist = static_cast<float>(i) * 0.01f;
+    delta.update(s);
+  }
+  SegmentedLap lap;
+  lap.info = info;
+  lap.info.lap_time_s = 3600.0;
+  delta.on_lap(lap);
+  delta.update(s);
+  const DeltaSnapshot snap = delta.snapshot();
+  std::printf("hour-long lap: best %s, truncated laps %llu\n", snap.has_best ? "set" : "not set",
+              static_cast<unsigned long long>(snap.truncated_laps));
+  return !snap.has_best && snap.truncated_laps == 1;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int laps = static_cast<int>(bench::arg_int(argc, argv, "--laps", 30));
+  const int rate = static_cast<int>(bench::arg_int(argc, argv, "--rate", 360));
+
+  SyntheticSessionOptions options;
+  options.tick_rate = rate;
+  options.lap_time_spread = 0.01;
+
+  // A separate session supplies the user's chosen reference (e.g. a coach lap).
+  std::vector<float> ref_distance;
+  std::vector<float> ref_elapsed;
+  {
+    SyntheticSessionOptions other = options;
+    other.seed = 99;
+    SyntheticSession session(other);
+    TelemetrySample s;
+    session.next(s);
+    while (s.lap == 1) {
+      ref_distance.push_back(s.lap_dist);
+      ref_elapsed.push_back(s.lap_current_lap_time);
+      session.next(s);
+    }
+  }
+  auto coach = std::make_shared<const ReferenceLap>(ref_distance, ref_elapsed, ref_elapsed.back());
+
+  LiveDelta delta;
+  delta.set_reference(coach);
+  Fanout fanout(delta);
+  LapSegmenterOptions seg_options;
+  seg_options.sample_rate_hz = static_cast<float>(rate);
+  LapSegmenter segmenter(fanout, seg_options);
+
+  std::atomic<bool> running{true};
+  std::atomic<uint64_t> torn{0};
+  std::atomic<uint64_t> reads{0};
+  auto reader = [&](int period_us) {
+    uint64_t last = 0;
+    while (running.load(std::memory_order_relaxed)) {
+      const DeltaSnapshot snap = delta.snapshot();
+      if (snap.sequence != last) {
+        last = snap.sequence;
+        reads.fetch_add(1, std::memory_order_relaxed);
+        if (snap.has_best && snap.timing && snap.predicted_lap_s != snap.best_lap_s + snap.delta_best_s) {
+          torn.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(period_us));
+    }
+  };
+  std::thread dashboard(reader, 1000);
+  std::thread coach_reader(reader, 5000);
+
+  SyntheticSession session(options);
+  TelemetrySample s;
+  std::vector<uint64_t> update_ns;
+  double scan_sink = 0.0;
+  uint64_t scan_ns = 0;
+  uint64_t ticks = 0;
+  while (segmenter.samples() == 0 || s.lap <= laps) {
+    session.next(s);
+    segmenter.push(s);
+    const uint64_t t0 = now_ns();
+    delta.update(s);
+    update_ns.push_back(now_ns() - t0);
+    fanout.last_delta = delta.snapshot().delta_best_s;
+
+    const uint64_t t1 = now_ns();
+    scan_sink += scan_time_at(ref_distance, ref_elapsed, s.lap_dist);
+    scan_ns += now_ns() - t1;
+    ++ticks;
+  }
+  running.store(false);
+  dashboard.join();
+  coach_reader.join();
+
+  const DeltaSnapshot last = delta.snapshot();
+  std::printf("%d laps at %d Hz (%llu ticks), reference table %zu samples\n", laps, rate,
+              static_cast<unsigned long long>(ticks), coach->size());
+  bench::print_latency_row("update() per tick", update_ns);
+  std::printf("linear rescan of the reference: %.1f ns/tick (checksum %.1f)\n",
+              static_cast<double>(scan_ns) / static_cast<double>(ticks), scan_sink);
+  std::printf("delta at the line vs actual lap-time difference: max error %.4f s over %d laps\n",
+              fanout.max_line_error, fanout.compared);
+  std::printf("best %.3f s, last delta-to-best %+.3f s, delta-to-coach %+.3f s\n", last.best_lap_s,
+              last.delta_best_s, last.delta_reference_s);
+  std::printf("readers: %llu snapshots, torn=%llu\n", static_cast<unsigned long long>(reads.load()),
+              static_cast<unsigned long long>(torn.load()));
+  const double lagging_error = lagging_reference_error(ref_distance, ref_elapsed, *coach);
+  std::printf("reference with a lagging first LapDist: max time_at error %.2e s\n", lagging_error);
+  const bool truncated_ok = truncated_lap_check();
+  return torn.load() == 0 && lagging_error < 1e-4 && truncated_ok ? 0 : 1;
+}
@@ -0,0 +1,195 @@
+// Live recalibration while the pedals are in use. Three measurements:
+//
+//  1. hot-loop cost of process() when settings are published through a
+//     mutex (the old path) versus the triple-buffered snapshot, while a UI
+//     thread drags sliders continuously;
+//  2. a torn-read check: the UI alternates between two configs and every
+//     output must match one of them exactly;
+//  3. the full engine's input-to-output latency, idle versus under
+//     continuous updates.
+//
+//   bench_live_recalibration [--seconds 2]
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "trackpro/common/clock.h"
+#include "trackpro/common/triple_buffer.h"
+#include "trackpro/pedals/pedal_engine.h"
+#include "trackpro/pedals/synthetic_pedal_source.h"
+
+using namespace trackpro;
+using namespace trackpro::pedals;
+
+namespace {
+
+// A slider position mapped onto a whole config, as the calibration page does.
+PedalConfig config_for_slider(int step) {
+  PedalConfig config;
+  for (size_t axis = 0; axis < kPedalAxisCount; ++axis) {
+    AxisCalibration& cal = config.calibration[axis];
+    cal.min = static_cast<uint16_t>(1000 + (step % 500) * 4);
+    cal.max = static_cast<uint16_t>(64000 - (step % 300) * 3);
+    cal.deadzone_low = 0.01f * static_cast<float>(step % 5);
+  }
+  const float knee = 0.2f + 0.6f * static_cast<float>(step % 100) / 100.0f;
+  config.curves[axis_index(PedalAxis::Brake)] =
+      ResponseCurve({{0.0f, 0.0f}, {knee, knee * 0.5f}, {1.0f, 1.0f}});
+  return config;
+}
+
+struct LoopResult {
+  std::vector<uint64_t> cost_ns;
+  uint64_t updates = 0;
+};
+
+// Runs a 1 kHz processing loop for `seconds` with a UI thread updating as
+// fast as it can through `publish`; `process` is the hot-loop body.
+template <typename Publish, typename Process>
+LoopResult run_loop(double seconds, Publish&& publish, Process&& process) {
+  LoopResult result;
+  result.cost_ns.reserve(static_cast<size_t>(seconds * 1000) + 16);
+  std::atomic<bool> running{true};
+  std::atomic<uint64_t> updates{0};
+  std::thread ui([&] {
+    for (int step = 0; running.load(std::memory_order_relaxed); ++step) {
+      publish(config_for_slider(step));
+      updates.fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+  RawPedalSample sample = SyntheticPedalSource::generate(0.3);
+  const uint64_t end = now_ns() + static_cast<uint64_t>(seconds * 1e9);
+  for (uint64_t tick = now_ns(); tick < end; tick += kNanosPerMilli) {
+    sleep_until_ns(tick);
+    const uint64_t t0 = now_ns();
+    process(sample);
+    result.cost_ns.push_back(now_ns() - t0);
+  }
+  running.store(false);
+  ui.join();
+  result.updates = updates.load();
+  return result;
+}
+
+class LatencySink final : public PedalOutputSink {
+ public:
+  LatencySink() { latencies_.reserve(1 << 20); }
+  void emit(const PedalOutput& out) override {
+    if (latencies_.size() < latencies_.capacity()) {
+      latencies_.push_back(out.output_timestamp_ns - out.input_timestamp_ns);
+    }
+  }
+  std::vector<uint64_t> latencies_;
+};
+
+std::vector<uint64_t> run_engine(double seconds, bool with_updates) {
+  LatencySink sink;
+  PedalEngine engine(std::make_unique<SyntheticPedalSource>(), sink, PedalConfig{});
+  std::atomic<bool> running{true};
+  engine.start();
+  std::thread ui([&] {
+    for (int step = 0; with_updates && running.load(std::memory_order_relaxed); ++step) {
+      engine.update_config(config_for_slider(step));
+    }
+  });
+  std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+  running.store(false);
+  ui.join();
+  engine.stop();
+  return sink.latencies_;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const double seconds = bench::arg_double(argc, argv, "--seconds", 2.0);
+
+  // 1. Mutex versus snapshot in the hot loop.
+  {
+    std::mutex mutex;
+    PedalPipeline shared;
+    FilterState filter_state;
+    PedalOutput out;
+    LoopResult r = run_loop(
+        seconds,
+        [&](PedalConfig config) {
+          std::lock_guard<std::mutex> lock(mutex);
+          shared.set_config(std::move(config));  // compiles curves under the lock
+        },
+        [&](const RawPedalSample& s) {
+          std::lock_guard<std::mutex> lock(mutex);
+          shared.process(s, out, filter_state);
+        });
+    std::printf("mutex-guarded config: %llu updates\n", static_cast<unsigned long long>(r.updates));
+    bench::print_latency_row("  process() cost", r.cost_ns);
+  }
+  {
+    std::mutex writer_mutex;
+    TripleBuffer<PedalPipeline> pipelines;
+    FilterState filter_state;
+    PedalOutput out;
+    LoopResult r = run_loop(
+        seconds,
+        [&](PedalConfig config) {
+          std::lock_guard<std::mutex> lock(writer_mutex);
+          pipelines.write_buffer().set_config(std::move(config));
+          pipelines.publish();
+        },
+        [&](const RawPedalSample& s) {
+          pipelines.update();
+          pipelines.read_buffer().process(s, out, filter_state);
+        });
+    std::printf("triple-buffered snapshot: %llu updates\n", static_cast<unsigned long long>(r.updates));
+    bench::print_latency_row("  process() cost", r.cost_ns);
+  }
+
+  // 2. Torn-read check.
+  {
+    const PedalConfig a = config_for_slider(17);
+    const PedalConfig b = config_for_slider(263);
+    const RawPedalSample sample = SyntheticPedalSource::generate(0.3);
+    PedalOutput expect_a;
+    PedalOutput expect_b;
+    FilterState filter_state;
+    PedalPipeline(a).process(sample, expect_a, filter_state);
+    PedalPipeline(b).process(sample, expect_b, filter_state);
+
+    TripleBuffer<PedalPipeline> pipelines{PedalPipeline(a)};
+    std::atomic<bool> running{true};
+    std::thread ui([&] {
+      for (uint64_t i = 0; running.load(std::memory_order_relaxed); ++i) {
+        pipelines.write_buffer().set_config(i & 1 ? b : a);
+        pipelines.publish();
+      }
+    });
+    uint64_t checked = 0;
+    uint64_t torn = 0;
+    const uint64_t end = now_ns() + static_cast<uint64_t>(seconds * 1e9);
+    while (now_ns() < end) {
+      for (int i = 0; i < 1000; ++i) {
+        pipelines.update();
+        PedalOutput out;
+        pipelines.read_buffer().process(sample, out, filter_state);
+        if (out.value != expect_a.value && out.value != expect_b.value) {
+          ++torn;
+        }
+        ++checked;
+      }
+    }
+    running.store(false);
+    ui.join();
+    std::printf("torn-read check: %llu samples, %llu inconsistent\n",
+                static_cast<unsigned long long>(checked), static_cast<unsigned long long>(torn));
+  }
+
+  // 3. Full engine.
+  std::printf("engine input->output latency\n");
+  bench::print_latency_row("  no slider updates", run_engine(seconds, false));
+  bench::print_latency_row("  continuous updates", run_engine(seconds, true));
+  return 0;
+}
@@ -0,0 +1,120 @@
+// Min/max pyramid for plotting: records a synthetic stint's speed channel
+// sample by sample through MinMaxPyramid::append, then asks for one pair per
+// pixel column at zoom levels from the whole stint down to a few seconds.
+// Every column is checked against a brute-force scan, and the pyramid's query
+// time is compared with scanning every visible sample.
+//
+//   bench_minmax_pyramid [--minutes 90] [--rate 360] [--pixels 1920] [--frames 200]
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "bench_util.h"
+#include "trackpro/common/clock.h"
+#include "trackpro/telemetry/minmax_pyramid.h"
+#include "trackpro/telemetry/synthetic_session.h"
+
+using namespace trackpro;
+using namespace trackpro::telemetry;
+
+namespace {
+
+// What the plotter did before: walk every visible sample into its column.
+void naive_columns(const std::vector<float>& v, size_t begin, size_t end, size_t pixels, MinMax* out) {
+  const double per_pixel = static_cast<double>(end - begin) / static_cast<double>(pixels);
+  for (size_t p = 0; p < pixels; ++p) {
+    const size_t a = std::min(begin + static_cast<size_t>(static_cast<double>(p) * per_pixel), end - 1);
+    size_t b = begin + static_cast<size_t>(static_cast<double>(p + 1) * per_pixel);
+    b = std::min(std::max(b, a + 1), end);
+    MinMax m{v[a], v[a]};
+    for (size_t i = a + 1; i < b; ++i) {
+      m.min = std::min(m.min, v[i]);
+      m.max = std::max(m.max, v[i]);
+    }
+    out[p] = m;
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const double minutes = bench::arg_double(argc, argv, "--minutes", 90.0);
+  const int rate = static_cast<int>(bench::arg_int(argc, argv, "--rate", 360));
+  const auto pixels = static_cast<size_t>(bench::arg_int(argc, argv, "--pixels", 1920));
+  const int frames = static_cast<int>(bench::arg_int(argc, argv, "--frames", 200));
+
+  SyntheticSessionOptions options;
+  options.tick_rate = rate;
+  SyntheticSession session(options);
+  const auto count = static_cast<size_t>(minutes * 60.0 * rate);
+  std::vector<float> speed(count);
+  TelemetrySample s;
+  for (size_t i = 0; i < count; ++i) {
+    session.next(s);
+    // A one-sample spike now and then: the kind of detail decimation loses.
+    speed[i] = (i % 100003 == 7) ? s.speed + 40.0f : s.speed;
+  }
+
+  // Incremental build, as the recorder does it.
+  MinMaxPyramid live;
+  live.reserve(count);
+  std::vector<uint64_t> append_ns;
+  append_ns.reserve(count / 64 + 1);
+  const uint64_t b0 = now_ns();
+  for (size_t i = 0; i < count; ++i) {
+    if (i % 64 == 0) {
+      const uint64_t t0 = now_ns();
+      live.append(speed[i]);
+      append_ns.push_back(now_ns() - t0);
+    } else {
+      live.append(speed[i]);
+    }
+  }
+  const double build_s = static_cast<double>(now_ns() - b0) / 1e9;
+  const uint64_t k0 = now_ns();
+  const MinMaxPyramid bulk = MinMaxPyramid::build(speed.data(), speed.size());
+  const double bulk_s = static_cast<double>(now_ns() - k0) / 1e9;
+  std::printf("%zu samples (%.0f min at %d Hz), %zu levels, %.1f MB (samples alone %.1f MB)\n", count, minutes,
+              rate, live.levels(), static_cast<double>(live.memory_bytes()) / 1e6,
+              static_cast<double>(count * sizeof(float)) / 1e6);
+  std::printf("incremental build %.1f ns/sample, bulk build %.1f ns/sample\n", build_s * 1e9 / count,
+              bulk_s * 1e9 / count);
+  bench::print_latency_row("append (1 in 64)", append_ns);
+
+  std::vector<MinMax> got(pixels), want(pixels), got_bulk(pixels);
+  size_t mismatches = 0;
+  std::printf("%-12s %10s %14s %14s %9s\n", "visible", "samples", "pyramid us", "scan us", "speedup");
+  for (const double fraction : {1.0, 0.25, 1.0 / 30.0, 1.0 / 900.0, 1.0 / 20000.0}) {
+    const auto visible = std::max<size_t>(1, static_cast<size_t>(static_cast<double>(count) * fraction));
+    std::vector<uint64_t> fast_ns, scan_ns;
+    double sink = 0.0;
+    for (int f = 0; f < frames; ++f) {
+      // Pan across the stint so every frame hits different samples.
+      const size_t begin = (count - visible) * static_cast<size_t>(f) / static_cast<size_t>(std::max(1, frames - 1));
+      const size_t end = begin + visible;
+      uint64_t t0 = now_ns();
+      live.columns(begin, end, pixels, got.data());
+      fast_ns.push_back(now_ns() - t0);
+      t0 = now_ns();
+      naive_columns(speed, begin, end, pixels, want.data());
+      scan_ns.push_back(now_ns() - t0);
+      bulk.columns(begin, end, pixels, got_bulk.data());
+      for (size_t p = 0; p < pixels; ++p) {
+        if (got[p].min != want[p].min || got[p].max != want[p].max || got_bulk[p].min != want[p].min ||
+            got_bulk[p].max != want[p].max) {
+          ++mismatches;
+        }
+      }
+      sink += got[pixels / 2].max;
+    }
+    const double fast = static_cast<double>(bench::percentile(fast_ns, 0.5)) / 1e3;
+    const double scan = static_cast<double>(bench::percentile(scan_ns, 0.5)) / 1e3;
+    char label[32];
+    std::snprintf(label, sizeof(label), "%.4g%%", fraction * 100.0);
+    std::printf("%-12s %10zu %14.1f %14.1f %8.1fx  (checksum %.0f)\n", label, visible, fast, scan, scan / fast,
+                sink);
+  }
+  std::printf("column mismatches vs brute force: %zu\n", mismatches);
+  return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,73 @@
+// Runs the pedal engine against the synthetic source and reports the
+// input-to-output latency distribution.
+//
+//   bench_pedal_engine [--seconds 5] [--rate 1000] [--cpu -1]
+
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "trackpro/common/clock.h"
+#include "trackpro/pedals/pedal_engine.h"
+#include "trackpro/pedals/synthetic_pedal_source.h"
+
+using namespace trackpro;
+using namespace trackpro::pedals;
+
+namespace {
+
+class RecordingSink final : public PedalOutputSink {
+ public:
+  explicit RecordingSink(size_t capacity) { latencies_.reserve(capacity); }
+
+  void emit(const PedalOutput& out) override {
+    if (latencies_.size() < latencies_.capacity()) {
+      latencies_.push_back(out.output_timestamp_ns - out.input_timestamp_ns);
+    }
+  }
+
+  const std::vector<uint64_t>& latencies() const { return latencies_; }
+
+ private:
+  std::vector<uint64_t> latencies_;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const double seconds = bench::arg_double(argc, argv, "--seconds", 5.0);
+  const auto rate = static_cast<uint32_t>(bench::arg_int(argc, argv, "--rate", 1000));
+
+  PedalEngineOptions options;
+  options.rate_hz = rate;
+  options.cpu = static_cast<int>(bench::arg_int(argc, argv, "--cpu", -1));
+
+  SyntheticPedalOptions source_options;
+  source_options.report_rate_hz = rate;
+
+  PedalConfig config;
+  config.curves[axis_index(PedalAxis::Brake)] = ResponseCurve::preset("progressive");
+
+  RecordingSink sink(static_cast<size_t>(seconds * rate * 2) + 1024);
+  PedalEngine engine(std::make_unique<SyntheticPedalSource>(source_options), sink, config, options);
+
+  engine.start();
+  std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+  engine.stop();
+
+  const PedalEngineCounters c = engine.counters();
+  std::printf("pedal engine: rate=%u Hz, %.1f s, realtime=%s\n", rate, seconds,
+              engine.realtime() ? "yes" : "no (unprivileged)");
+  std::printf("reports=%llu ticks=%llu idle_ticks=%llu late_ticks=%llu output_rate=%.1f Hz\n",
+              static_cast<unsigned long long>(c.reports), static_cast<unsigned long long>(c.ticks),
+              static_cast<unsigned long long>(c.idle_ticks),
+              static_cast<unsigned long long>(c.late_ticks), c.reports / seconds);
+  bench::print_latency_row("input->output", sink.latencies());
+
+  std::vector<uint64_t> sorted = sink.latencies();
+  const uint64_t p99 = bench::percentile(sorted, 0.99);
+  std::printf("p99 %s 1 ms target\n", p99 < kNanosPerMilli ? "meets" : "MISSES");
+  return 0;
+}
@@ -0,0 +1,208 @@
+// Smoothness versus latency of the pedal filter stage on a brake trace.
+//
+// With --trace, reads a .tpr pedal recording or a CSV of
+// "t_seconds,throttle,brake,clutch,handbrake" raw counts recorded from real
+// pedals; the reference signal is then the trace itself. Without it, a synthetic load-cell trace is generated: the
+// clean synthetic motion plus gaussian noise and occasional spikes, with the
+// clean signal as ground truth.
+//
+//   bench_pedal_filters [--trace brake.csv] [--seconds 60] [--noise 250]
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "trackpro/common/clock.h"
+#include "trackpro/common/realtime.h"
+#include "trackpro/pedals/pedal_pipeline.h"
+#include "trackpro/pedals/pedal_recording.h"
+#include "trackpro/pedals/synthetic_pedal_source.h"
+
+using namespace trackpro;
+using namespace trackpro::pedals;
+
+namespace {
+
+struct Trace {
+  std::vector<RawPedalSample> noisy;
+  std::vector<float> reference;  // brake ground truth in [0, 1]
+};
+
+Trace synthetic_trace(double seconds, float noise_counts) {
+  Trace t;
+  std::mt19937 rng(3);
+  std::normal_distribution<float> noise(0.0f, noise_counts);
+  std::uniform_int_distribution<int> spike(0, 499);
+  const size_t n = static_cast<size_t>(seconds * 1000.0);
+  for (size_t i = 0; i < n; ++i) {
+    RawPedalSample s = SyntheticPedalSource::generate(static_cast<double>(i) / 1000.0);
+    s.timestamp_ns = i * kNanosPerMilli;
+    t.reference.push_back(static_cast<float>(s.raw[1]) / 65535.0f);
+    float brake = static_cast<float>(s.raw[1]) + noise(rng);
+    if (spike(rng) == 0) {
+      brake += (i & 1) ? 4000.0f : -4000.0f;
+    }
+    s.raw[1] = static_cast<uint16_t>(std::clamp(brake, 0.0f, 65535.0f));
+    t.noisy.push_back(s);
+  }
+  return t;
+}
+
+Trace recorded_trace(const std::string& path) {
+  Trace t;
+  if (path.size() > 4 && path.compare(path.size() - 4, 4, ".tpr") == 0) {
+    t.noisy = PedalRecording::load(path).samples();
+    for (const RawPedalSample& s : t.noisy) {
+      t.reference.push_back(static_cast<float>(s.raw[1]) / 65535.0f);
+    }
+    return t;
+  }
+  std::ifstream in(path);
+  std::string line;
+  while (std::getline(in, line)) {
+    std::istringstream row(line);
+    double ts;
+    char comma;
+    unsigned v[4];
+    if (!(row >> ts >> comma >> v[0] >> comma >> v[1] >> comma >> v[2] >> comma >> v[3])) {
+      continue;  // header or malformed line
+    }
+    RawPedalSample s;
+    s.timestamp_ns = static_cast<uint64_t>(ts * 1e9);
+    for (int a = 0; a < 4; ++a) {
+      s.raw[a] = static_cast<uint16_t>(v[a]);
+    }
+    t.noisy.push_back(s);
+    t.reference.push_back(static_cast<float>(v[1]) / 65535.0f);
+  }
+  return t;
+}
+
+// Pedal speed of the reference at every sample, in full travels per second,
+// over 10 ms steps.
+std::vector<float> pedal_speeds(const Trace& trace) {
+  constexpr size_t kStep = 10;
+  std::vector<float> speeds;
+  for (size_t i = kStep; i < trace.reference.size(); ++i) {
+    const double dt_s = static_cast<double>(trace.noisy[i].timestamp_ns - trace.noisy[i - kStep].timestamp_ns) /
+                        static_cast<double>(kNanosPerSecond);
+    if (dt_s > 0.0) {
+      speeds.push_back(static_cast<float>((trace.reference[i] - trace.reference[i - kStep]) / dt_s));
+    }
+  }
+  return speeds;
+}
+
+// group_delay_ms() averaged over the trace's pedal speeds, weighted by speed
+// squared: a lag costs error in proportion to speed, so this is the delay
+// the measured lag reflects.
+float moving_delay_ms(const FilterBank& filters, const std::vector<float>& speeds) {
+  double weight = 0.0;
+  double delay = 0.0;
+  for (const float v : speeds) {
+    const double w = static_cast<double>(v) * v;
+    weight += w;
+    delay += w * filters.group_delay_ms(PedalAxis::Brake, v);
+  }
+  return weight == 0.0 ? filters.group_delay_ms(PedalAxis::Brake) : static_cast<float>(delay / weight);
+}
+
+struct Result {
+  double ns_per_sample = 0.0;
+  float rest_delay_ms = 0.0f;    // reported with the pedal still
+  float moving_delay_ms = 0.0f;  // reported at the trace's pedal speeds
+  int measured_lag_samples = 0;
+  double residual_rms = 0.0;  // error left after removing the lag
+};
+
+Result evaluate(const Trace& trace, FilterSettings settings, const std::vector<float>& speeds) {
+  PedalConfig config;
+  config.filters.fill(settings);
+  const PedalPipeline pipeline(config);
+  FilterState state;
+  std::vector<float> out(trace.noisy.size());
+  PedalOutput o;
+
+  const uint64_t t0 = now_ns();
+  for (size_t i = 0; i < trace.noisy.size(); ++i) {
+    pipeline.process(trace.noisy[i], o, state);
+    out[i] = o.value[1];
+  }
+  Result r;
+  r.ns_per_sample = static_cast<double>(now_ns() - t0) / static_cast<double>(trace.noisy.size());
+  r.rest_delay_ms = pipeline.filters().group_delay_ms(PedalAxis::Brake);
+  r.moving_delay_ms = moving_delay_ms(pipeline.filters(), speeds);
+
+  double best = 1e300;
+  for (int lag = 0; lag <= 60; ++lag) {
+    double err = 0.0;
+    for (size_t i = static_cast<size_t>(lag); i < out.size(); ++i) {
+      const double d = out[i] - trace.reference[i - static_cast<size_t>(lag)];
+      err += d * d;
+    }
+    if (err < best) {
+      best = err;
+      r.measured_lag_samples = lag;
+    }
+  }
+  r.residual_rms = std::sqrt(best / static_cast<double>(out.size()));
+  return r;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  enable_flush_denormals();  // as the engine thread does
+  const std::string path = bench::arg(argc, argv, "--trace", "");
+  const Trace trace = path.empty()
+                          ? synthetic_trace(bench::arg_double(argc, argv, "--seconds", 60.0),
+                                            static_cast<float>(bench::arg_double(argc, argv, "--noise", 250.0)))
+                          : recorded_trace(path);
+  if (trace.noisy.empty()) {
+    std::fprintf(stderr, "no samples in trace\n");
+    return 1;
+  }
+  const std::vector<float> speeds = pedal_speeds(trace);
+  std::printf("brake trace: %zu samples (%s)\n", trace.noisy.size(),
+              path.empty() ? "synthetic load cell" : path.c_str());
+
+  auto make = [](FilterKind kind, float a, float b) {
+    FilterSettings s;
+    s.kind = kind;
+    if (kind == FilterKind::Biquad) {
+      s.cutoff_hz = a;
+    } else if (kind == FilterKind::OneEuro) {
+      s.min_cutoff_hz = a;
+      s.beta = b;
+    }
+    return s;
+  };
+  const std::pair<const char*, FilterSettings> configs[] = {
+      {"none", make(FilterKind::None, 0, 0)},
+      {"median3", make(FilterKind::Median3, 0, 0)},
+      {"biquad 120 Hz", make(FilterKind::Biquad, 120, 0)},
+      {"biquad 60 Hz", make(FilterKind::Biquad, 60, 0)},
+      {"biquad 30 Hz", make(FilterKind::Biquad, 30, 0)},
+      {"one-euro 5 Hz b=2", make(FilterKind::OneEuro, 5, 2)},
+      {"one-euro 2 Hz b=5", make(FilterKind::OneEuro, 2, 5)},
+  };
+
+  std::printf("%-20s %10s %14s %14s %14s %12s\n", "filter", "ns/sample", "at rest(ms)", "moving(ms)",
+              "measured(ms)", "residual");
+  for (const auto& [name, settings] : configs) {
+    const Result r = evaluate(trace, settings, speeds);
+    std::printf("%-20s %10.1f %14.2f %14.2f %14.2f %12.5f\n", name, r.ns_per_sample,
+                static_cast<double>(r.rest_delay_ms), static_cast<double>(r.moving_delay_ms),
+                static_cast<double>(r.measured_lag_samples), r.residual_rms);
+  }
+  std::printf("(at rest = group_delay_ms() with the pedal still; moving = group_delay_ms() over the\n"
+              " trace's pedal speeds, weighted by speed squared as the lag fit is; measured = lag that\n"
+              " best fits the reference; residual = RMS brake error after removing that lag;\n"
+              " full-scale = 1.0)\n");
+  return 0;
+}
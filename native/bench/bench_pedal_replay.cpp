@@ -0,0 +1,178 @@
+// Deterministic pedal benchmark without hardware: replays a .tpr recording
+// through the full pipeline faster than real time, checks the output is
+// bit-identical across runs, then plays it through the live engine and vJoy
+// stage at 1x.
+//
+// Without --recording, a synthetic noisy session is generated first. On
+// Linux a recorder is also killed mid-session to check that the unclosed
+// file still loads.
+//
+//   bench_pedal_replay [--recording session.tpr] [--minutes 10] [--live-seconds 2]
+
+#include <csignal>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <thread>
+
+#if defined(__linux__)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "bench_util.h"
+#include "trackpro/common/clock.h"
+#include "trackpro/common/realtime.h"
+#include "trackpro/pedals/pedal_engine.h"
+#include "trackpro/pedals/pedal_recording.h"
+#include "trackpro/pedals/pedal_replay.h"
+#include "trackpro/pedals/synthetic_pedal_source.h"
+#include "trackpro/pedals/vjoy_output_stage.h"
+
+using namespace trackpro;
+using namespace trackpro::pedals;
+
+namespace {
+
+RawPedalSample synthetic_sample(uint64_t i, std::mt19937& rng, std::normal_distribution<float>& noise) {
+  RawPedalSample s = SyntheticPedalSource::generate(static_cast<double>(i) / 1000.0);
+  // USB polling is never perfectly regular.
+  s.timestamp_ns = i * kNanosPerMilli + static_cast<uint64_t>(std::abs(noise(rng)) * 50.0f);
+  s.raw[1] = static_cast<uint16_t>(std::clamp(s.raw[1] + noise(rng), 0.0f, 65535.0f));
+  return s;
+}
+
+std::string write_synthetic(double minutes) {
+  const std::string path = "/tmp/trackpro_bench_pedals.tpr";
+  PedalRecorder recorder(path, 1000);
+  std::mt19937 rng(11);
+  std::normal_distribution<float> noise(0.0f, 120.0f);
+  const uint64_t n = static_cast<uint64_t>(minutes * 60'000.0);
+  for (uint64_t i = 0; i < n; ++i) {
+    recorder.append(synthetic_sample(i, rng, noise));
+  }
+  recorder.close();
+  return path;
+}
+
+// Records in a child process that is SIGKILLed without close(), then loads
+// what reached the disk: the stdio buffer's tail is lost, everything before
+// it must decode exactly.
+bool crash_recovery_check() {
+#if defined(__linux__)
+  const std::string path = "/tmp/trackpro_bench_pedals_killed.tpr";
+  constexpr uint64_t kReports = 60'000;
+  const pid_t child = fork();
+  if (child == 0) {
+    PedalRecorder recorder(path, 1000);
+    std::mt19937 rng(5);
+    std::normal_distribution<float> noise(0.0f, 120.0f);
+    for (uint64_t i = 0; i < kReports; ++i) {
+      recorder.append(synthetic_sample(i, rng, noise));
+    }
+    std::raise(SIGKILL);
+  }
+  int status = 0;
+  waitpid(child, &status, 0);
+
+  std::mt19937 rng(5);
+  std::normal_distribution<float> noise(0.0f, 120.0f);
+  bool ok = false;
+  size_t recovered = 0;
+  try {
+    const PedalRecording rec = PedalRecording::load(path);
+    recovered = rec.samples().size();
+    ok = recovered > 0 && rec.header().start_timestamp_ns == synthetic_sample(0, rng, noise).timestamp_ns;
+    rng.seed(5);
+    noise.reset();
+    for (size_t i = 0; ok && i < recovered; ++i) {
+      const RawPedalSample expected = synthetic_sample(i, rng, noise);
+      ok = rec.samples()[i].timestamp_ns == expected.timestamp_ns && rec.samples()[i].raw == expected.raw;
+    }
+  } catch (const std::exception& e) {
+    std::printf("killed recorder: %s\n", e.what());
+  }
+  std::printf("killed recorder: %llu reports appended, %zu recovered without close() -> %s\n",
+              static_cast<unsigned long long>(kReports), recovered, ok ? "ok" : "FAIL");
+  return ok;
+#else
+  return true;
+#endif
+}
+
+PedalConfig bench_config() {
+  PedalConfig config;
+  config.curves[axis_index(PedalAxis::Brake)] = ResponseCurve::preset("progressive");
+  config.filters[axis_index(PedalAxis::Brake)].kind = FilterKind::OneEuro;
+  config.filters[axis_index(PedalAxis::Throttle)].kind = FilterKind::Biquad;
+  config.filters[axis_index(PedalAxis::Clutch)].kind = FilterKind::Median3;
+  return config;
+}
+
+void print_stats(const PipelineStats& stats) {
+  const PipelineStatsSnapshot snap = stats.snapshot();
+  for (size_t i = 0; i < kPedalStageCount; ++i) {
+    const auto stage = static_cast<PedalStage>(i);
+    const StageSummary s = snap.summary(stage);
+    if (s.count == 0) {
+      continue;
+    }
+    std::printf("  %-14s n=%-9llu p50=%8.2fus p99=%8.2fus p99.9=%8.2fus max=%8.2fus\n",
+                stage_name(stage), static_cast<unsigned long long>(s.count), s.p50_ns / 1e3,
+                s.p99_ns / 1e3, s.p999_ns / 1e3, s.max_ns / 1e3);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  enable_flush_denormals();
+  std::string path = bench::arg(argc, argv, "--recording", "");
+  if (path.empty()) {
+    path = write_synthetic(bench::arg_double(argc, argv, "--minutes", 10.0));
+  }
+  const double live_seconds = bench::arg_double(argc, argv, "--live-seconds", 2.0);
+
+  const uint64_t load_start = now_ns();
+  auto recording = std::make_shared<const PedalRecording>(PedalRecording::load(path));
+  const double load_ms = static_cast<double>(now_ns() - load_start) / 1e6;
+  std::FILE* f = std::fopen(path.c_str(), "rb");
+  std::fseek(f, 0, SEEK_END);
+  const long bytes = std::ftell(f);
+  std::fclose(f);
+  std::printf("recording %s: %zu reports, %.1f s, %ld bytes (%.2f bytes/report), loaded in %.1f ms\n",
+              path.c_str(), recording->samples().size(), recording->duration_seconds(), bytes,
+              static_cast<double>(bytes) / static_cast<double>(recording->samples().size()), load_ms);
+
+  PedalReplayDriver driver(recording, bench_config());
+  PipelineStats stats;
+  const ReplayResult first = driver.run(nullptr, &stats);
+  const ReplayResult second = driver.run();
+  std::printf("unpaced replay: %.2f M reports/s, %.0fx real time\n", first.samples_per_second() / 1e6,
+              first.speedup());
+  std::printf("determinism: checksum %016llx vs %016llx -> %s\n",
+              static_cast<unsigned long long>(first.checksum),
+              static_cast<unsigned long long>(second.checksum),
+              first.checksum == second.checksum ? "identical" : "MISMATCH");
+  print_stats(stats);
+
+  if (live_seconds > 0.0) {
+    PipelineStats live;
+    VJoyOutputOptions stage_options;
+    stage_options.stats = &live;
+    VJoyOutputStage stage(std::make_unique<MemoryVJoyBackend>(), stage_options);
+    PedalEngineOptions engine_options;
+    engine_options.stats = &live;
+    PedalEngine engine(std::make_unique<ReplayPedalSource>(recording, true), stage, bench_config(),
+                       engine_options);
+    stage.start();
+    engine.start();
+    std::this_thread::sleep_for(std::chrono::duration<double>(live_seconds));
+    engine.stop();
+    stage.stop();
+    std::printf("live engine replay at 1x for %.1f s:\n", live_seconds);
+    print_stats(live);
+  }
+  const bool recovered = crash_recovery_check();
+  return first.checksum == second.checksum && recovered ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+// Runs the instrumented pedal path (synthetic source -> engine -> vJoy stage
+// -> memory backend), prints the per-stage summary, the stats endpoint JSON,
+// and optionally appends a CSV row set for regression tracking.
+//
+//   bench_pipeline_stats [--seconds 3] [--csv pedal_stats.csv]
+
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+#include "bench_util.h"
+#include "trackpro/common/clock.h"
+#include "trackpro/pedals/pedal_engine.h"
+#include "trackpro/pedals/pipeline_stats.h"
+#include "trackpro/pedals/synthetic_pedal_source.h"
+#include "trackpro/pedals/vjoy_output_stage.h"
+
+using namespace trackpro;
+using namespace trackpro::pedals;
+
+int main(int argc, char** argv) {
+  const double seconds = bench::arg_double(argc, argv, "--seconds", 3.0);
+  const std::string csv = bench::arg(argc, argv, "--csv", "");
+
+  // Cost of the instrumentation itself.
+  {
+    LatencyHistogram h;
+    constexpr uint64_t kRecords = 10'000'000;
+    const uint64_t t0 = now_ns();
+    for (uint64_t i = 0; i < kRecords; ++i) {
+      h.record((i * 2654435761u) & 0xFFFFF);
+    }
+    std::printf("histogram record(): %.2f ns/op\n",
+                static_cast<double>(now_ns() - t0) / static_cast<double>(kRecords));
+  }
+
+  PipelineStats stats;
+  VJoyOutputOptions stage_options;
+  stage_options.stats = &stats;
+  VJoyOutputStage stage(std::make_unique<MemoryVJoyBackend>(), stage_options);
+
+  PedalEngineOptions engine_options;
+  engine_options.stats = &stats;
+  PedalEngine engine(std::make_unique<SyntheticPedalSource>(), stage, PedalConfig{}, engine_options);
+
+  stage.start();
+  engine.start();
+  std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+  engine.stop();
+  stage.stop();
+
+  const PipelineStatsSnapshot snap = stats.snapshot();
+  std::printf("%-14s %9s %9s %9s %9s %9s %9s\n", "stage", "count", "p50(us)", "p99(us)",
+              "p99.9(us)", "max(us)", "jitter");
+  for (size_t i = 0; i < kPedalStageCount; ++i) {
+    const auto stage_id = static_cast<PedalStage>(i);
+    const StageSummary s = snap.summary(stage_id);
+    std::printf("%-14s %9llu %9.2f %9.2f %9.2f %9.2f %9.2f\n", stage_name(stage_id),
+                static_cast<unsigned long long>(s.count), s.p50_ns / 1e3, s.p99_ns / 1e3,
+                s.p999_ns / 1e3, s.max_ns / 1e3, s.jitter_ns / 1e3);
+  }
+  std::printf("\nendpoint: %s\n", snap.to_json().c_str());
+  if (!csv.empty()) {
+    std::printf("csv %s: %s\n", csv.c_str(), snap.append_csv(csv) ? "appended" : "FAILED");
+  }
+  return 0;
+}
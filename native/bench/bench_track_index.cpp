@@ -0,0 +1,172 @@
+// Track map queries: builds a TrackIndex for a synthetic circuit with 100
+// overlaid laps (each driven on a slightly different line), then times
+// nearest-point-on-reference, corner lookup and hover hit-testing across all
+// laps for random positions near the track. A sample of queries is checked
+// against brute-force scans of every segment.
+//
+//   bench_track_index [--laps 100] [--queries 100000] [--radius 2] [--check 2000]
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "bench_util.h"
+#include "trackpro/common/clock.h"
+#include "trackpro/telemetry/synthetic_session.h"
+#include "trackpro/telemetry/track_index.h"
+
+using namespace trackpro;
+using namespace trackpro::telemetry;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+float segment_distance(Point2 p, Point2 a, Point2 b) {
+  const float dx = b.x - a.x;
+  const float dy = b.y - a.y;
+  const float len2 = dx * dx + dy * dy;
+  const float t = len2 > 0.0f ? std::fmin(1.0f, std::fmax(0.0f, ((p.x - a.x) * dx + (p.y - a.y) * dy) / len2)) : 0.0f;
+  return std::hypot(p.x - (a.x + t * dx), p.y - (a.y + t * dy));
+}
+
+float brute_nearest(const std::vector<Point2>& line, bool closed, Point2 p) {
+  float best = INFINITY;
+  const size_t n = closed ? line.size() : line.size() - 1;
+  for (size_t i = 0; i < n; ++i) {
+    best = std::fmin(best, segment_distance(p, line[i], line[(i + 1) % line.size()]));
+  }
+  return best;
+}
+
+// Corners: stretches where |curvature| exceeds 1/250 m, apex at the peak.
+std::vector<TrackCorner> find_corners(const SyntheticTrack& track) {
+  std::vector<TrackCorner> corners;
+  const size_t n = track.curvature.size();
+  size_t i = 0;
+  while (i < n && std::fabs(track.curvature[i]) > 1.0 / 250.0) ++i;  // start on a straight
+  for (size_t k = 0; k < n; ++k) {
+    const size_t j = (i + k) % n;
+    const bool in = std::fabs(track.curvature[j]) > 1.0 / 250.0;
+    if (in && (corners.empty() || corners.back().end_m >= 0.0f)) {
+      corners.push_back({static_cast<int>(corners.size()) + 1, static_cast<float>(j * track.step_m), 0.0f, -1.0f});
+    }
+    if (!corners.empty() && corners.back().end_m < 0.0f) {
+      TrackCorner& c = corners.back();
+      const double apex_k = std::fabs(track.at(track.curvature, c.apex_m));
+      if (in && (c.apex_m == 0.0f || std::fabs(track.curvature[j]) > apex_k)) c.apex_m = static_cast<float>(j * track.step_m);
+      if (!in) c.end_m = static_cast<float>(j * track.step_m);
+    }
+  }
+  if (!corners.empty() && corners.back().end_m < 0.0f) corners.back().end_m = corners.back().start_m;
+  return corners;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int lap_count = static_cast<int>(bench::arg_int(argc, argv, "--laps", 100));
+  const int queries = static_cast<int>(bench::arg_int(argc, argv, "--queries", 100000));
+  const auto radius = static_cast<float>(bench::arg_double(argc, argv, "--radius", 2.0));
+  const int check = static_cast<int>(bench::arg_int(argc, argv, "--check", 2000));
+
+  SyntheticSessionOptions options;
+  SyntheticSession session(options);
+  const SyntheticTrack& track = session.track();
+  std::vector<Point2> reference;
+  for (size_t i = 0; i < track.x.size(); ++i) {
+    reference.push_back({static_cast<float>(track.x[i]), static_cast<float>(track.y[i])});
+  }
+  const std::vector<TrackCorner> corners = find_corners(track);
+
+  // Laps from the session's Lat/Lon, each pushed onto its own line by up to
+  // +-3 m so overlaid laps are distinct.
+  const LocalProjection projection(options.origin_lat, options.origin_lon);
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  std::vector<std::vector<Point2>> laps(static_cast<size_t>(lap_count));
+  TelemetrySample s;
+  session.next(s);
+  for (auto& lap : laps) {
+    const int32_t number = s.lap;
+    const double amplitude = 3.0 * unit(rng);
+    const double phase = 2.0 * kPi * unit(rng);
+    while (s.lap == number) {
+      const Point2 p = projection.to_local(s.lat, s.lon);
+      const double off = amplitude * std::sin(2.0 * kPi * 7.0 * s.lap_dist / track.length_m + phase);
+      const double heading = track.at(track.heading, s.lap_dist);
+      lap.push_back({static_cast<float>(p.x - off * std::sin(heading)), static_cast<float>(p.y + off * std::cos(heading))});
+      session.next(s);
+    }
+  }
+
+  const uint64_t b0 = now_ns();
+  TrackIndex index(reference, corners);
+  const double ref_build_ms = static_cast<double>(now_ns() - b0) / 1e6;
+  std::vector<PolylineView> views;
+  size_t points = 0;
+  for (const auto& lap : laps) {
+    views.push_back({lap.data(), lap.size()});
+    points += lap.size();
+  }
+  const uint64_t b1 = now_ns();
+  index.set_laps(views);
+  const double lap_build_ms = static_cast<double>(now_ns() - b1) / 1e6;
+  std::printf("reference %zu points, %zu corners, built in %.2f ms\n", reference.size(), corners.size(), ref_build_ms);
+  std::printf("%d laps, %zu segments, built in %.1f ms, %.1f MB\n", lap_count, index.lap_grid().segment_count(),
+              lap_build_ms, static_cast<double>(index.lap_grid().memory_bytes()) / 1e6);
+
+  // Query points: anywhere along the track, up to 15 m either side.
+  std::vector<Point2> probes(static_cast<size_t>(queries));
+  for (Point2& p : probes) {
+    const double d = unit(rng) * track.length_m;
+    const double off = (unit(rng) * 2.0 - 1.0) * 15.0;
+    const double h = track.at(track.heading, d);
+    p = {static_cast<float>(track.at(track.x, d) - off * std::sin(h)), static_cast<float>(track.at(track.y, d) + off * std::cos(h))};
+  }
+
+  std::vector<uint64_t> nearest_ns, corner_ns, hover_ns;
+  std::vector<SegmentHit> per_lap;
+  double sink = 0.0;
+  size_t hover_hits = 0;
+  for (const Point2& p : probes) {
+    uint64_t t0 = now_ns();
+    const ReferenceHit hit = index.nearest_on_reference(p);
+    nearest_ns.push_back(now_ns() - t0);
+    t0 = now_ns();
+    const TrackCorner* corner = index.corner_at(p);
+    corner_ns.push_back(now_ns() - t0);
+    t0 = now_ns();
+    hover_hits += index.hit_test(p, radius, per_lap);
+    hover_ns.push_back(now_ns() - t0);
+    sink += hit.distance_m + (corner != nullptr ? corner->number : 0);
+  }
+  bench::print_latency_row("nearest on reference", nearest_ns);
+  bench::print_latency_row("corner at", corner_ns);
+  bench::print_latency_row("hover hit-test", hover_ns);
+  std::printf("hover: %.1f laps within %.1f m per query\n", static_cast<double>(hover_hits) / queries, radius);
+
+  // Brute force on a sample.
+  size_t reference_errors = 0;
+  size_t hover_errors = 0;
+  std::vector<uint64_t> brute_ns;
+  for (int q = 0; q < std::min(check, queries); ++q) {
+    const Point2 p = probes[static_cast<size_t>(q)];
+    const uint64_t t0 = now_ns();
+    const float want = brute_nearest(reference, true, p);
+    brute_ns.push_back(now_ns() - t0);
+    if (std::fabs(std::fabs(index.nearest_on_reference(p).offset_m) - want) > 1e-3f) ++reference_errors;
+    index.hit_test(p, radius, per_lap);
+    for (size_t l = 0; l < laps.size(); ++l) {
+      const float d = brute_nearest(laps[l], false, p);
+      const bool want_hit = d <= radius;
+      if (want_hit != per_lap[l].found || (want_hit && std::fabs(per_lap[l].distance - d) > 1e-3f)) ++hover_errors;
+    }
+  }
+  bench::print_latency_row("brute-force reference", brute_ns);
+  std::printf("mismatches vs brute force: reference %zu, hover %zu (of %d queries)\n", reference_errors, hover_errors,
+              std::min(check, queries));
+  std::printf("(checksum %.1f)\n", sink);
+  return reference_errors == 0 && hover_errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,225 @@
+// Track-model builder: stores 60 synthetic laps (each on its own line, with
+// GPS noise, two of them with a 25 m excursion) in a lap store, fuses them
+// into a centreline and corner list, and compares the result with the
+// synthetic track's true geometry. Then times adding one more lap
+// incrementally against rebuilding from the whole history, runs a
+// velocity-integrated model without GPS, and round-trips TrackModelCache
+// while a second thread reads its model.
+//
+//   bench_track_model [--laps 60] [--threads 0]
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "trackpro/common/clock.h"
+#include "trackpro/common/thread_pool.h"
+#include "trackpro/telemetry/lap_store.h"
+#include "trackpro/telemetry/synthetic_session.h"
+#include "trackpro/telemetry/track_model.h"
+
+using namespace trackpro;
+using namespace trackpro::telemetry;
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+struct Lap {
+  std::vector<float> distance, speed, vx, vy, yaw;
+  std::vector<double> lat, lon;
+  std::vector<Point2> truth;  // noise-free position, for the error checks
+};
+
+double centerline_rms(const TrackModel& m, const SyntheticTrack& track, Point2 offset) {
+  double sq = 0.0;
+  for (size_t i = 0; i < m.centerline.size(); ++i) {
+    const double d = static_cast<double>(i) * m.step_m;
+    const double dx = m.centerline[i].x + offset.x - track.at(track.x, d);
+    const double dy = m.centerline[i].y + offset.y - track.at(track.y, d);
+    sq += dx * dx + dy * dy;
+  }
+  return std::sqrt(sq / static_cast<double>(m.centerline.size()));
+}
+
+// Corners whose apex lies within 25 m of a reference corner's apex.
+int matched_corners(const std::vector<TrackCorner>& got, const std::vector<TrackCorner>& want, double length) {
+  int matched = 0;
+  for (const TrackCorner& w : want) {
+    for (const TrackCorner& g : got) {
+      const double d = std::fabs(g.apex_m - w.apex_m);
+      if (std::fmin(d, length - d) < 25.0) {
+        ++matched;
+        break;
+      }
+    }
+  }
+  return matched;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int lap_count = static_cast<int>(bench::arg_int(argc, argv, "--laps", 60));
+  const auto threads = static_cast<unsigned>(bench::arg_int(argc, argv, "--threads", 0));
+
+  SyntheticSessionOptions options;
+  SyntheticSession session(options);
+  const SyntheticTrack& track = session.track();
+  const LocalProjection truth_projection(options.origin_lat, options.origin_lon);
+  std::mt19937 rng(11);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  std::normal_distribution<double> gps(0.0, 0.5);
+
+  std::vector<Lap> laps(static_cast<size_t>(lap_count) + 1);
+  TelemetrySample s;
+  session.next(s);
+  while (s.lap_dist > 1.0f) session.next(s);  // start at the line
+  for (size_t l = 0; l < laps.size(); ++l) {
+    Lap& lap = laps[l];
+    const int32_t number = s.lap;
+    const double amplitude = 3.0 * unit(rng);
+    const double phase = 2.0 * kPi * unit(rng);
+    const bool excursion = l == 10 || l == 30;
+    while (s.lap == number) {
+      const double heading = track.at(track.heading, s.lap_dist);
+      double off = amplitude * std::sin(2.0 * kPi * 5.0 * s.lap_dist / track.length_m + phase);
+      if (excursion && s.lap_dist > 1000.0f && s.lap_dist < 1600.0f) off += 25.0;
+      const Point2 p = truth_projection.to_local(s.lat, s.lon);
+      const Point2 q{static_cast<float>(p.x - off * std::sin(heading) + gps(rng)),
+                     static_cast<float>(p.y + off * std::cos(heading) + gps(rng))};
+      double lat, lon;
+      truth_projection.to_geo(q, lat, lon);
+      lap.distance.push_back(s.lap_dist);
+      lap.speed.push_back(s.speed);
+      lap.vx.push_back(s.velocity_x);
+      lap.vy.push_back(s.velocity_y);
+      lap.yaw.push_back(s.yaw);
+      lap.lat.push_back(lat);
+      lap.lon.push_back(lon);
+      lap.truth.push_back(p);
+      session.next(s);
+    }
+  }
+
+  const std::string store_path = "/tmp/trackpro_bench_track_model.tpl";
+  {
+    LapStoreWriter writer(store_path,
+                          {{"LapDist", ChannelType::Float32, "m"},
+                           {"Speed", ChannelType::Float32, "m/s"},
+                           {"Lat", ChannelType::Float64, "deg"},
+                           {"Lon", ChannelType::Float64, "deg"}},
+                          {"synthetic", "", "", 0});
+    for (int l = 0; l < lap_count; ++l) {
+      const Lap& lap = laps[static_cast<size_t>(l)];
+      LapInfo info;
+      info.lap_number = l + 1;
+      info.sample_count = static_cast<uint32_t>(lap.distance.size());
+      info.flags = kLapValid;
+      writer.add_lap(info, {lap.distance.data(), lap.speed.data(), lap.lat.data(), lap.lon.data()});
+    }
+  }
+  const LapStore store = LapStore::open(store_path);
+  ThreadPool pool(threads);
+
+  // Reference corners from the noise-free centreline.
+  std::vector<Point2> exact(track.x.size());
+  std::vector<float> exact_distance(track.x.size()), exact_speed(track.x.size());
+  for (size_t i = 0; i < exact.size(); ++i) {
+    exact[i] = {static_cast<float>(track.x[i]), static_cast<float>(track.y[i])};
+    exact_distance[i] = static_cast<float>(static_cast<double>(i) * track.step_m);
+    exact_speed[i] = static_cast<float>(track.speed[i]);
+  }
+  exact.push_back(exact[0]);
+  exact_distance.push_back(static_cast<float>(track.length_m));
+  exact_speed.push_back(exact_speed[0]);
+  TrackModelBuilder reference("exact", track.length_m);
+  reference.add_lap({exact_distance.data(), exact.data(), exact_speed.data(), exact.size()});
+  const TrackModel truth = reference.build();
+
+  TrackModelBuilder builder("synthetic", track.length_m);
+  const uint64_t t0 = now_ns();
+  const size_t accepted = builder.add_store_laps(store, 0, &pool);
+  const double fuse_ms = static_cast<double>(now_ns() - t0) / 1e6;
+  const uint64_t t1 = now_ns();
+  const TrackModel model = builder.build();
+  const double build_ms = static_cast<double>(now_ns() - t1) / 1e6;
+  std::printf("fused %zu of %d stored laps (%u rejected) on %zu threads in %.1f ms, build %.2f ms\n", accepted,
+              lap_count, builder.rejected(), pool.size(), fuse_ms, build_ms);
+  std::printf("centreline: %zu points at %.2f m, RMS error %.2f m; corners %zu (exact line %zu, %d matched)\n",
+              model.centerline.size(), model.step_m,
+              centerline_rms(model, track,
+                             truth_projection.to_local(model.projection.origin_lat(), model.projection.origin_lon())),
+              model.corners.size(), truth.corners.size(),
+              matched_corners(model.corners, truth.corners, track.length_m));
+
+  // One new lap: incremental fold + build vs re-fusing the whole history.
+  const Lap& extra = laps.back();
+  std::vector<Point2> extra_pos(extra.lat.size());
+  for (size_t i = 0; i < extra_pos.size(); ++i) extra_pos[i] = model.projection.to_local(extra.lat[i], extra.lon[i]);
+  const uint64_t i0 = now_ns();
+  builder.add_lap({extra.distance.data(), extra_pos.data(), extra.speed.data(), extra.distance.size()});
+  const TrackModel refined = builder.build();
+  const double incremental_ms = static_cast<double>(now_ns() - i0) / 1e6;
+  const uint64_t r0 = now_ns();
+  TrackModelBuilder again("synthetic", track.length_m);
+  again.add_store_laps(store, 0, &pool);
+  again.add_lap({extra.distance.data(), extra_pos.data(), extra.speed.data(), extra.distance.size()});
+  const TrackModel rebuilt = again.build();
+  const double rebuild_ms = static_cast<double>(now_ns() - r0) / 1e6;
+  std::printf("add one lap: incremental %.2f ms vs full rebuild %.1f ms (%u laps, models %s)\n", incremental_ms,
+              rebuild_ms, refined.laps, refined.centerline[100].x == rebuilt.centerline[100].x ? "identical" : "DIFFER");
+
+  // No GPS: integrate velocity instead.
+  TrackModelBuilder integrated("synthetic-imu", track.length_m);
+  std::vector<std::vector<Point2>> paths(laps.size());
+  std::vector<LapTrace> traces;
+  for (size_t l = 0; l < laps.size(); ++l) {
+    integrate_velocity(laps[l].vx.data(), laps[l].vy.data(), laps[l].yaw.data(), laps[l].vx.size(),
+                       1.0 / options.tick_rate, paths[l]);
+    traces.push_back({laps[l].distance.data(), paths[l].data(), laps[l].speed.data(), paths[l].size()});
+  }
+  integrated.add_laps(traces, &pool);
+  const TrackModel imu = integrated.build();
+  const Point2 start = laps[0].truth[0];
+  std::printf("velocity-integrated: %u laps, RMS error %.2f m, corners %zu (%d matched)\n", imu.laps,
+              centerline_rms(imu, track, start), imu.corners.size(),
+              matched_corners(imu.corners, truth.corners, track.length_m));
+
+  // Cache round trip.
+  const std::string dir = "/tmp";
+  bool cache_ok = false;
+  {
+    TrackModelCache cache(dir);
+    // A UI thread keeps asking for the model while laps are folded in.
+    std::atomic<bool> folding{true};
+    uint64_t ui_models = 0;
+    std::thread ui([&] {
+      while (folding.load()) {
+        ui_models += cache.model("bench/synthetic") ? 1 : 0;
+      }
+    });
+    cache.add_store_laps("bench/synthetic", track.length_m, store, 0, &pool);
+    folding.store(false);
+    ui.join();
+    const auto first = cache.model("bench/synthetic");
+    cache.save("bench/synthetic");
+    TrackModelCache reopened(dir);
+    // Folding in nothing still loads the saved state.
+    reopened.add_store_laps("bench/synthetic", track.length_m, store, store.lap_count(), &pool);
+    const auto loaded = reopened.model("bench/synthetic");
+    const uint32_t saved_laps = loaded ? loaded->laps : 0;
+    cache_ok = loaded && saved_laps == first->laps && loaded->corners.size() == first->corners.size() &&
+               loaded->centerline[500].x == first->centerline[500].x;
+    std::printf("cache: saved %u laps, reloaded %u, model %s (%llu models read while folding)\n", first->laps,
+                saved_laps, cache_ok ? "identical" : "DIFFERS", static_cast<unsigned long long>(ui_models));
+  }
+  std::remove("/tmp/bench_synthetic.tpm");
+  std::remove(store_path.c_str());
+  return cache_ok ? 0 : 1;
+}
@@ -0,0 +1,211 @@
+// UdpEventLoop throughput on loopback. Generator threads offer voice-sized
+// (504-byte) datagrams from many source sockets at --rate packets per
+// second; the loop's workers echo every packet back, as a relay sends as
+// much as it receives. Runs once per --batch value so per-packet
+// recvfrom/sendto (batch 1) can be compared with recvmmsg/sendmmsg.
+// Reports delivered rates, loss, echo round trip, and worker CPU per
+// packet, from which packets per second per core follows. Workers run at
+// normal priority unless --realtime gives a SCHED_FIFO priority; a real-time
+// worker sharing a core with the generators wakes for every packet, which
+// minimises latency but defeats batching.
+//
+//   bench_udp_event_loop [--rate 40000] [--seconds 5] [--workers 0] [--senders 2] [--flows 64]
+//                        [--batches 1,64] [--realtime 0]
+
+#include <cstdio>
+
+#if defined(__linux__)
+
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cstring>
+#include <netinet/in.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "trackpro/common/byte_io.h"
+#include "trackpro/common/clock.h"
+#include "trackpro/voice/udp_event_loop.h"
+#include "trackpro/voice/voice_codec.h"
+
+using namespace trackpro;
+using namespace trackpro::voice;
+
+namespace {
+
+constexpr size_t kPacketBytes = kVoiceHeaderSize + kAdpcmFrameBytes;
+constexpr size_t kSendBatch = 16;
+
+class Echo : public UdpPacketHandler {
+ public:
+  void on_packet(UdpWorker& worker, const Packet& packet, uint64_t) override {
+    worker.send(packet.peer, packet.data, packet.size);
+  }
+};
+
+struct SenderResult {
+  uint64_t offered = 0;
+  uint64_t echoed = 0;
+  std::vector<uint64_t> round_trip_ns;
+};
+
+// Drains echoes from every flow socket.
+void drain(std::vector<UdpSocket>& flows, SenderResult& r) {
+  mmsghdr msgs[kSendBatch];
+  iovec iov[kSendBatch];
+  static thread_local uint8_t buffers[kSendBatch][kPacketBytes];
+  for (size_t i = 0; i < kSendBatch; ++i) {
+    iov[i] = {buffers[i], kPacketBytes};
+    msgs[i] = {};
+    msgs[i].msg_hdr.msg_iov = &iov[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+  for (UdpSocket& s : flows) {
+    int n;
+    while ((n = ::recvmmsg(s.fd(), msgs, kSendBatch, MSG_DONTWAIT, nullptr)) > 0) {
+      const uint64_t now = now_ns();
+      for (int i = 0; i < n; ++i) {
+        r.round_trip_ns.push_back(now - get_le(buffers[i] + 8, 8));
+      }
+      r.echoed += static_cast<uint64_t>(n);
+    }
+  }
+}
+
+void generate(UdpAddress to, size_t flow_count, double rate, double seconds, std::atomic<bool>& go,
+              SenderResult& r) {
+  std::vector<UdpSocket> flows;
+  for (size_t i = 0; i < flow_count; ++i) {
+    flows.emplace_back();
+    flows.back().set_buffer_sizes(1 << 20);
+  }
+  r.round_trip_ns.reserve(static_cast<size_t>(rate * seconds));
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(to.ip);
+  addr.sin_port = htons(to.port);
+  uint8_t packets[kSendBatch][kPacketBytes] = {};
+  mmsghdr msgs[kSendBatch];
+  iovec iov[kSendBatch];
+  for (size_t i = 0; i < kSendBatch; ++i) {
+    iov[i] = {packets[i], kPacketBytes};
+    msgs[i] = {};
+    msgs[i].msg_hdr.msg_iov = &iov[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+    msgs[i].msg_hdr.msg_name = &addr;
+    msgs[i].msg_hdr.msg_namelen = sizeof(addr);
+  }
+  while (!go.load(std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
+
+  // 1 ms slots; each slot's packets go out in batches, rotating over flows.
+  const uint64_t start = now_ns();
+  const auto slots = static_cast<uint64_t>(seconds * 1000.0);
+  double owed = 0.0;
+  size_t flow = 0;
+  for (uint64_t slot = 0; slot < slots; ++slot) {
+    sleep_until_ns(start + slot * kNanosPerMilli, 20'000);
+    owed += rate / 1000.0;
+    while (owed >= 1.0) {
+      const auto count = static_cast<size_t>(std::min<double>(owed, kSendBatch));
+      const uint64_t now = now_ns();
+      for (size_t i = 0; i < count; ++i) {
+        put_u64(packets[i] + 8, now);
+      }
+      const int sent = ::sendmmsg(flows[flow].fd(), msgs, static_cast<unsigned>(count), 0);
+      r.offered += count;  // a refused send counts as offered and lost
+      owed -= static_cast<double>(count);
+      (void)sent;
+      flow = (flow + 1) % flows.size();
+    }
+    drain(flows, r);
+  }
+  const uint64_t linger = now_ns() + 200 * kNanosPerMilli;
+  while (now_ns() < linger) {
+    drain(flows, r);
+    sleep_until_ns(now_ns() + kNanosPerMilli);
+  }
+}
+
+void run(size_t batch, int realtime, size_t workers, size_t senders, size_t flows, double rate, double seconds) {
+  Echo echo;
+  UdpEventLoopOptions options;
+  options.workers = workers;
+  options.batch = batch;
+  options.realtime_priority = realtime;
+  UdpEventLoop loop(echo, options);
+  loop.start();
+
+  std::atomic<bool> go{false};
+  std::vector<SenderResult> results(senders);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < senders; ++i) {
+    threads.emplace_back(generate, loop.address(), flows, rate / static_cast<double>(senders), seconds,
+                         std::ref(go), std::ref(results[i]));
+  }
+  go = true;
+  for (std::thread& t : threads) {
+    t.join();
+  }
+  loop.stop();
+
+  SenderResult total;
+  for (SenderResult& r : results) {
+    total.offered += r.offered;
+    total.echoed += r.echoed;
+    total.round_trip_ns.insert(total.round_trip_ns.end(), r.round_trip_ns.begin(), r.round_trip_ns.end());
+  }
+  const UdpEventLoopCounters c = loop.counters();
+  const double packets = static_cast<double>(c.received + c.sent);
+  const double cpu_per_packet = packets > 0.0 ? static_cast<double>(c.cpu_ns) / packets : 0.0;
+  std::printf("batch %-3zu workers %zu: offered %.0f/s, received %.0f/s, echoed %.0f/s, lost %.2f%%\n", batch,
+              loop.workers(), static_cast<double>(total.offered) / seconds,
+              static_cast<double>(c.received) / seconds, static_cast<double>(total.echoed) / seconds,
+              100.0 * (1.0 - static_cast<double>(total.echoed) / static_cast<double>(std::max<uint64_t>(1, total.offered))));
+  std::printf("  worker CPU %.1f%% of a core, %.0f ns per packet in or out -> %.0f packets/s per core (%.0f relayed/s)\n",
+              100.0 * static_cast<double>(c.cpu_ns) / (seconds * 1e9),
+              cpu_per_packet, cpu_per_packet > 0.0 ? 1e9 / cpu_per_packet : 0.0,
+              cpu_per_packet > 0.0 ? 1e9 / (2.0 * cpu_per_packet) : 0.0);
+  std::printf("  %.1f packets per receive call, %.1f per send call, %.1f per wakeup\n",
+              static_cast<double>(c.received) / static_cast<double>(std::max<uint64_t>(1, c.receive_calls)),
+              static_cast<double>(c.sent) / static_cast<double>(std::max<uint64_t>(1, c.send_calls)),
+              static_cast<double>(c.received) / static_cast<double>(std::max<uint64_t>(1, c.wakeups)));
+  bench::print_latency_row("  echo round trip", total.round_trip_ns);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const double rate = bench::arg_double(argc, argv, "--rate", 40000.0);
+  const double seconds = bench::arg_double(argc, argv, "--seconds", 5.0);
+  const auto workers = static_cast<size_t>(bench::arg_int(argc, argv, "--workers", 0));
+  const auto senders = std::max<size_t>(1, static_cast<size_t>(bench::arg_int(argc, argv, "--senders", 2)));
+  const auto flows = std::max<size_t>(1, static_cast<size_t>(bench::arg_int(argc, argv, "--flows", 64)));
+  const auto realtime = static_cast<int>(bench::arg_int(argc, argv, "--realtime", 0));
+  std::stringstream batches(bench::arg(argc, argv, "--batches", "1,64"));
+
+  std::printf("%zu-byte datagrams, %zu senders x %zu flows, %.0f s per run\n\n", kPacketBytes, senders, flows,
+              seconds);
+  std::string item;
+  while (std::getline(batches, item, ',')) {
+    const auto batch = static_cast<size_t>(std::max(1, std::atoi(item.c_str())));
+    run(batch, realtime, workers, senders, flows, rate, seconds);
+  }
+  return 0;
+}
+
+#else
+
+int main() {
+  std::printf("bench_udp_event_loop needs Linux (epoll, recvmmsg)\n");
+  return 0;
+}
+
+#endif
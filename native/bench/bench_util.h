@@ -0,0 +1,60 @@
+#pragma once
+
+// Small helpers shared by the benchmark programs. Not part of the library.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+// Looks up "--name value" on the command line; returns `fallback` if absent.
+inline std::string arg(int argc, char** argv, const char* name, const std::string& fallback) {
+  for (int i = 1; i + 1 < argc; ++i) {
+    if (std::strcmp(argv[i], name) == 0) {
+      return argv[i + 1];
+    }
+  }
+  return fallback;
+}
+
+inline double arg_double(int argc, char** argv, const char* name, double fallback) {
+  const std::string v = arg(argc, argv, name, "");
+  return v.empty() ? fallback : std::atof(v.c_str());
+}
+
+inline long long arg_int(int argc, char** argv, const char* name, long long fallback) {
+  const std::string v = arg(argc, argv, name, "");
+  return v.empty() ? fallback : std::atoll(v.c_str());
+}
+
+// Nearest-rank percentile of `values` (sorted in place). q in [0, 1].
+template <typename T>
+T percentile(std::vector<T>& values, double q) {
+  if (values.empty()) {
+    return T{};
+  }
+  std::sort(values.begin(), values.end());
+  const size_t rank = std::min(values.size() - 1, static_cast<size_t>(q * (values.size() - 1) + 0.5));
+  return values[rank];
+}
+
+template <typename T>
+void print_latency_row(const char* label, std::vector<T> values_ns) {
+  if (values_ns.empty()) {
+    std::printf("%-24s (no samples)\n", label);
+    return;
+  }
+  const double p50 = static_cast<double>(percentile(values_ns, 0.50)) / 1e3;
+  const double p99 = static_cast<double>(percentile(values_ns, 0.99)) / 1e3;
+  const double p999 = static_cast<double>(percentile(values_ns, 0.999)) / 1e3;
+  const double max = static_cast<double>(values_ns.back()) / 1e3;
+  std::printf("%-24s n=%-9zu p50=%8.2fus p99=%8.2fus p99.9=%8.2fus max=%8.2fus\n", label,
+              values_ns.size(), p50, p99, p999, max);
+}
+
+}  // namespace bench
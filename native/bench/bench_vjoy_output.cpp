@@ -0,0 +1,162 @@
+// Measures the pedal -> vJoy hand-off: raw SPSC ring throughput, then the
+// full engine driving the output stage while a backend stalls periodically
+// and a "dashboard" thread burns CPU.
+//
+//   bench_vjoy_output [--seconds 3] [--backend memory|uinput] [--stall-every 100]
+//                     [--stall-us 2000]
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "trackpro/common/clock.h"
+#include "trackpro/common/spsc_ring.h"
+#include "trackpro/pedals/pedal_engine.h"
+#include "trackpro/pedals/synthetic_pedal_source.h"
+#include "trackpro/pedals/vjoy_output_stage.h"
+
+using namespace trackpro;
+using namespace trackpro::pedals;
+
+namespace {
+
+void bench_ring_throughput() {
+  constexpr uint64_t kItems = 5'000'000;
+  SpscRing<VJoyReport, 1024> ring;
+  const uint64_t start = now_ns();
+  std::thread consumer([&] {
+    VJoyReport r;
+    uint64_t expected = 0;
+    while (expected < kItems) {
+      if (ring.try_pop(r)) {
+        if (r.sequence != expected) {
+          std::printf("ORDER VIOLATION at %llu\n", static_cast<unsigned long long>(expected));
+          std::abort();
+        }
+        ++expected;
+      } else {
+        std::this_thread::yield();  // matters on single-core machines
+      }
+    }
+  });
+  VJoyReport r;
+  for (uint64_t i = 0; i < kItems;) {
+    r.sequence = i;
+    if (ring.try_push(r)) {
+      ++i;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  consumer.join();
+  const double secs = static_cast<double>(now_ns() - start) / 1e9;
+  std::printf("spsc ring: %llu reports (%zu bytes) in %.2f s = %.1f M reports/s\n",
+              static_cast<unsigned long long>(kItems), sizeof(VJoyReport), secs, kItems / secs / 1e6);
+}
+
+// Memory backend that stalls like a driver call occasionally does, and
+// records input -> write latency.
+class StallingBackend final : public VJoyBackend {
+ public:
+  StallingBackend(uint64_t stall_every, uint64_t stall_ns) : every_(stall_every), stall_ns_(stall_ns) {
+    latencies_.reserve(1 << 22);
+  }
+  bool write(const VJoyReport& report) override {
+    if (latencies_.size() < latencies_.capacity()) {
+      latencies_.push_back(now_ns() - report.input_timestamp_ns);
+    }
+    if (every_ != 0 && ++count_ % every_ == 0) {
+      sleep_until_ns(now_ns() + stall_ns_);
+    }
+    return true;
+  }
+  const char* name() const override { return "stalling-memory"; }
+  const std::vector<uint64_t>& latencies() const { return latencies_; }
+
+ private:
+  uint64_t every_;
+  uint64_t stall_ns_;
+  uint64_t count_ = 0;
+  std::vector<uint64_t> latencies_;
+};
+
+// Wraps the stage so the pedal-thread cost of emit() is measured directly.
+class TimedSink final : public PedalOutputSink {
+ public:
+  explicit TimedSink(PedalOutputSink& inner) : inner_(inner) { costs_.reserve(1 << 22); }
+  void emit(const PedalOutput& out) override {
+    const uint64_t t0 = now_ns();
+    inner_.emit(out);
+    if (costs_.size() < costs_.capacity()) {
+      costs_.push_back(now_ns() - t0);
+    }
+  }
+  const std::vector<uint64_t>& costs() const { return costs_; }
+
+ private:
+  PedalOutputSink& inner_;
+  std::vector<uint64_t> costs_;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const double seconds = bench::arg_double(argc, argv, "--seconds", 3.0);
+  const std::string backend_name = bench::arg(argc, argv, "--backend", "memory");
+  const auto stall_every = static_cast<uint64_t>(bench::arg_int(argc, argv, "--stall-every", 100));
+  const auto stall_ns = static_cast<uint64_t>(bench::arg_int(argc, argv, "--stall-us", 2000)) * kNanosPerMicro;
+
+  bench_ring_throughput();
+
+  std::unique_ptr<VJoyBackend> backend;
+  StallingBackend* stalling = nullptr;
+#if defined(__linux__)
+  if (backend_name == "uinput") {
+    backend = std::make_unique<UinputVJoyBackend>();
+  }
+#endif
+  if (!backend) {
+    auto b = std::make_unique<StallingBackend>(stall_every, stall_ns);
+    stalling = b.get();
+    backend = std::move(b);
+  }
+
+  VJoyOutputStage stage(std::move(backend));
+  TimedSink sink(stage);
+  PedalEngine engine(std::make_unique<SyntheticPedalSource>(), sink, PedalConfig{});
+
+  std::atomic<bool> dashboard_running{true};
+  std::thread dashboard([&] {
+    volatile double x = 0.0;
+    while (dashboard_running.load(std::memory_order_relaxed)) {
+      for (int i = 0; i < 100000; ++i) {
+        x = x + i * 0.5;
+      }
+    }
+  });
+
+  stage.start();
+  engine.start();
+  std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+  engine.stop();
+  stage.stop();
+  dashboard_running.store(false);
+  dashboard.join();
+
+  const VJoyOutputCounters c = stage.counters();
+  std::printf("backend=%s stall=%lluus every %llu writes\n", stage.backend().name(),
+              static_cast<unsigned long long>(stall_ns / kNanosPerMicro),
+              static_cast<unsigned long long>(stall_every));
+  std::printf("pushed=%llu overruns=%llu drops=%llu written=%llu backend_errors=%llu\n",
+              static_cast<unsigned long long>(c.pushed), static_cast<unsigned long long>(c.overruns),
+              static_cast<unsigned long long>(c.drops), static_cast<unsigned long long>(c.written),
+              static_cast<unsigned long long>(c.backend_errors));
+  bench::print_latency_row("emit() on pedal thread", sink.costs());
+  if (stalling != nullptr) {
+    bench::print_latency_row("input->vjoy write", stalling->latencies());
+  }
+  return 0;
+}
@@ -0,0 +1,158 @@
+// Voice activity detection and discontinuous transmission on cockpit audio.
+// By default the input is synthetic: a driver who talks in spurts (mean
+// --talk-s, pauses of mean --pause-s) over engine, rumble and tyre noise at
+// each --engine level. --pcm plays a recording instead (raw 48 kHz mono
+// signed 16-bit little-endian), without a ground truth. Every frame goes
+// through an always-on encoder and through a VoiceSender in open-mic mode;
+// the report compares sender CPU per frame and bandwidth (with 28 bytes of
+// IPv4/UDP overhead per datagram) and, for synthetic input, how much speech
+// the detector clipped and how much noise it let through.
+//
+//   bench_voice_dtx [--seconds 300] [--talk-s 2.5] [--pause-s 6] [--engine 0,0.01,0.02,0.04] [--pcm file.s16]
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "trackpro/common/clock.h"
+#include "trackpro/voice/synthetic_voice.h"
+#include "trackpro/voice/voice_codec.h"
+#include "trackpro/voice/voice_sender.h"
+
+using namespace trackpro;
+using namespace trackpro::voice;
+
+namespace {
+
+constexpr double kOverheadBytes = 28.0;  // IPv4 + UDP headers
+
+struct Input {
+  std::vector<float> pcm;     // whole frames
+  std::vector<bool> talking;  // per frame; empty for recordings
+};
+
+Input synthesize(double seconds, double talk_s, double pause_s, float engine_level) {
+  SyntheticVoiceOptions voice_options;
+  voice_options.mean_talk_s = talk_s;
+  voice_options.mean_pause_s = pause_s;
+  SyntheticVoice voice(voice_options);
+  SyntheticEngineOptions engine_options;
+  engine_options.level = engine_level;
+  SyntheticEngineNoise engine(engine_options);
+  Input in;
+  const auto frames = static_cast<size_t>(seconds * 1e9 / static_cast<double>(kVoiceFrameNs));
+  in.pcm.resize(frames * kVoiceFrameSamples);
+  for (size_t f = 0; f < frames; ++f) {
+    float* frame = in.pcm.data() + f * kVoiceFrameSamples;
+    voice.next(frame);
+    in.talking.push_back(voice.talking());
+    engine.add(frame);
+  }
+  return in;
+}
+
+bool load_pcm(const std::string& path, Input& in) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  const size_t samples = bytes.size() / 2 / kVoiceFrameSamples * kVoiceFrameSamples;
+  in.pcm.resize(samples);
+  for (size_t i = 0; i < samples; ++i) {
+    const auto lo = static_cast<uint8_t>(bytes[2 * i]);
+    const auto hi = static_cast<uint8_t>(bytes[2 * i + 1]);
+    in.pcm[i] = static_cast<float>(static_cast<int16_t>(lo | hi << 8)) / 32768.0f;
+  }
+  return true;
+}
+
+void run(const char* label, const Input& in) {
+  const size_t frames = in.pcm.size() / kVoiceFrameSamples;
+  const double seconds = static_cast<double>(frames) * static_cast<double>(kVoiceFrameNs) / 1e9;
+  uint8_t packet[kVoiceHeaderSize + kAdpcmFrameBytes];
+
+  // Always on: every frame encoded and sent.
+  AdpcmEncoder encoder;
+  double always_bytes = 0.0;
+  uint64_t t0 = now_ns();
+  for (size_t f = 0; f < frames; ++f) {
+    always_bytes += static_cast<double>(kVoiceHeaderSize + encoder.encode(in.pcm.data() + f * kVoiceFrameSamples,
+                                                                          packet + kVoiceHeaderSize)) +
+                    kOverheadBytes;
+  }
+  const double always_ns = static_cast<double>(now_ns() - t0) / static_cast<double>(frames);
+
+  // Detector alone, for its share of the cost.
+  VoiceActivityDetector vad;
+  t0 = now_ns();
+  size_t active = 0;
+  for (size_t f = 0; f < frames; ++f) {
+    active += vad.process(in.pcm.data() + f * kVoiceFrameSamples) ? 1 : 0;
+  }
+  const double vad_ns = static_cast<double>(now_ns() - t0) / static_cast<double>(frames);
+
+  VoiceSender sender;
+  double dtx_bytes = 0.0;
+  uint64_t speech = 0;
+  uint64_t speech_sent = 0;
+  uint64_t noise = 0;
+  uint64_t noise_sent = 0;
+  t0 = now_ns();
+  for (size_t f = 0; f < frames; ++f) {
+    const size_t size = sender.process(in.pcm.data() + f * kVoiceFrameSamples, f * kVoiceFrameNs, packet);
+    dtx_bytes += size > 0 ? static_cast<double>(size) + kOverheadBytes : 0.0;
+    if (!in.talking.empty()) {
+      const bool sent = sender.transmitting();
+      (in.talking[f] ? speech : noise) += 1;
+      (in.talking[f] ? speech_sent : noise_sent) += sent ? 1 : 0;
+    }
+  }
+  const double dtx_ns = static_cast<double>(now_ns() - t0) / static_cast<double>(frames);
+  const VoiceSenderCounters& c = sender.counters();
+
+  std::printf("%s: %.0f s, %.1f%% of frames sent by DTX\n", label, seconds,
+              100.0 * static_cast<double>(c.encoded) / static_cast<double>(frames));
+  std::printf("  always on: %6.0f ns/frame, %6.1f kbit/s\n", always_ns, always_bytes * 8.0 / seconds / 1e3);
+  std::printf("  VAD + DTX: %6.0f ns/frame (VAD %.0f ns), %6.1f kbit/s -> %.1f%% less CPU, %.1f%% less bandwidth\n",
+              dtx_ns, vad_ns, dtx_bytes * 8.0 / seconds / 1e3, 100.0 * (1.0 - dtx_ns / always_ns),
+              100.0 * (1.0 - dtx_bytes / always_bytes));
+  if (!in.talking.empty()) {
+    std::printf("  speech frames sent %.1f%% (clipped %.1f%%), noise frames sent %.1f%% (hangover included)\n",
+                100.0 * static_cast<double>(speech_sent) / static_cast<double>(std::max<uint64_t>(speech, 1)),
+                100.0 * (1.0 - static_cast<double>(speech_sent) / static_cast<double>(std::max<uint64_t>(speech, 1))),
+                100.0 * static_cast<double>(noise_sent) / static_cast<double>(std::max<uint64_t>(noise, 1)));
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const double seconds = bench::arg_double(argc, argv, "--seconds", 300.0);
+  const double talk_s = bench::arg_double(argc, argv, "--talk-s", 2.5);
+  const double pause_s = bench::arg_double(argc, argv, "--pause-s", 6.0);
+  const std::string pcm = bench::arg(argc, argv, "--pcm", "");
+
+  if (!pcm.empty()) {
+    Input in;
+    if (!load_pcm(pcm, in) || in.pcm.empty()) {
+      std::fprintf(stderr, "cannot read %s\n", pcm.c_str());
+      return 1;
+    }
+    run(pcm.c_str(), in);
+    return 0;
+  }
+  std::stringstream levels(bench::arg(argc, argv, "--engine", "0,0.01,0.02,0.04"));
+  std::string item;
+  while (std::getline(levels, item, ',')) {
+    const float level = std::stof(item);
+    char label[64];
+    std::snprintf(label, sizeof(label), "engine level %.2f", static_cast<double>(level));
+    run(label, synthesize(seconds, talk_s, pause_s, level));
+  }
+  return 0;
+}
@@ -0,0 +1,271 @@
+// Voice server load test on localhost. Simulated clients (one UDP socket
+// each) join groups of --group-size; --talkers per group stream 20 ms ADPCM
+// frames continuously, the rest send keepalives. Each mode runs for
+// --seconds against a VoiceServerLoop with --workers event-loop threads
+// (0: one per core): forward relays frames as they
+// arrive, mix runs talkers through jitter buffers and sends one mixed stream
+// per listener every 20 ms. Reports server CPU per stream and the
+// capture-to-delivery latency tail seen by the clients (for mixes, from the
+// oldest voice in the frame, so it includes the server's jitter buffer).
+// The server requires join tokens. Before the clients start, a squatter
+// claims a client's stream without a token, with a wrong token, and claims
+// the server's own stream; all three must be counted as spoofed and the
+// clients must still get through.
+//
+//   bench_voice_server [--clients 240] [--group-size 8] [--talkers 2] [--seconds 10] [--mode both|forward|mix]
+//                      [--workers 0]
+
+#include <cstdio>
+#include <string>
+
+#if defined(__linux__)
+
+#include <poll.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "trackpro/common/byte_io.h"
+#include "trackpro/common/clock.h"
+#include "trackpro/common/realtime.h"
+#include "trackpro/voice/synthetic_voice.h"
+#include "trackpro/voice/voice_codec.h"
+#include "trackpro/voice/voice_server_loop.h"
+
+using namespace trackpro;
+using namespace trackpro::voice;
+
+namespace {
+
+constexpr size_t kBankFrames = 250;  // 5 s of pre-encoded speech per voice
+constexpr size_t kVoices = 4;
+constexpr VoiceSessionKey kSessionKey{0x5452414b50524f31ULL, 0x766f6963652d6b65ULL};
+constexpr uint64_t kSquatterPackets = 3;
+
+struct Client {
+  UdpSocket socket;
+  uint32_t stream;
+  uint8_t group;
+  bool talker;
+  uint64_t token;
+  uint32_t sequence = 0;
+};
+
+// Three claims the server must refuse: client 1's stream with no token, then
+// with a wrong one, and the server's own stream.
+void squat(const UdpAddress& to) {
+  UdpSocket squatter;
+  uint8_t packet[kVoiceHeaderSize + kVoiceJoinTokenSize];
+  VoicePacketHeader header;
+  header.stream = 1;
+  write_voice_header(header, packet);
+  squatter.send_to(to, packet, kVoiceHeaderSize);
+  header.flags = kVoiceFlagJoin;
+  write_voice_header(header, packet);
+  put_u64(packet + kVoiceHeaderSize, voice_join_token(kSessionKey, 1) ^ 1);
+  squatter.send_to(to, packet, sizeof(packet));
+  header.stream = kVoiceServerStream;
+  header.flags = kVoiceFlagNone;
+  write_voice_header(header, packet);
+  squatter.send_to(to, packet, kVoiceHeaderSize);
+}
+
+struct Result {
+  VoiceServerCounters server;
+  std::vector<uint64_t> latency_ns;
+  uint64_t delivered = 0;
+  uint64_t sent = 0;
+  size_t workers = 0;
+};
+
+Result run(VoiceServerMode mode, size_t workers, size_t clients, size_t group_size, size_t talkers, double seconds,
+           const std::vector<std::vector<uint8_t>>& bank) {
+  VoiceServerOptions server_options;
+  server_options.mode = mode;
+  server_options.require_join = true;
+  server_options.session_key = kSessionKey;
+  UdpEventLoopOptions loop_options;
+  loop_options.workers = workers;
+  loop_options.realtime_priority = 50;
+  VoiceServerLoop server(server_options, loop_options);
+  server.start();
+  const UdpAddress to = server.address();
+
+  std::vector<Client> fleet;
+  fleet.reserve(clients);
+  for (size_t i = 0; i < clients; ++i) {
+    const size_t seat = i % group_size;
+    const auto stream = static_cast<uint32_t>(i + 1);
+    fleet.push_back({UdpSocket(), stream, static_cast<uint8_t>(i / group_size), seat < talkers,
+                     voice_join_token(kSessionKey, stream)});
+    fleet.back().socket.set_buffer_sizes(256 << 10);
+  }
+
+  Result result;
+  result.workers = server.workers();
+  std::atomic<bool> done{false};
+  std::thread receiver([&] {
+    std::vector<pollfd> fds;
+    for (Client& c : fleet) {
+      fds.push_back({c.socket.fd(), POLLIN, 0});
+    }
+    result.latency_ns.reserve(static_cast<size_t>(seconds * 50.0) * clients * 2);
+    uint8_t buffer[2048];
+    while (!done.load(std::memory_order_relaxed)) {
+      if (::poll(fds.data(), fds.size(), 50) <= 0) {
+        continue;
+      }
+      for (size_t i = 0; i < fds.size(); ++i) {
+        if ((fds[i].revents & POLLIN) == 0) {
+          continue;
+        }
+        long n;
+        while ((n = fleet[i].socket.receive(buffer, sizeof(buffer), nullptr)) > 0) {
+          VoicePacketHeader header;
+          const uint8_t* payload;
+          size_t size;
+          if (parse_voice_packet(buffer, static_cast<size_t>(n), header, payload, size)) {
+            result.latency_ns.push_back(now_ns() - header.capture_ns);
+            ++result.delivered;
+          }
+        }
+      }
+    }
+  });
+
+  squat(to);
+
+  // All clients share one sending thread; talkers are spread over the
+  // 20 ms period in 1 ms slots instead of all firing at once.
+  {
+    promote_current_thread_realtime(40);
+    constexpr uint64_t kSlots = 20;
+    uint8_t packet[kVoiceHeaderSize + kAdpcmFrameBytes];
+    const uint64_t start = now_ns() + 20 * kNanosPerMilli;
+    const auto ticks = static_cast<uint64_t>(seconds * 1e9) / kVoiceFrameNs;
+    for (uint64_t tick = 0; tick < ticks; ++tick) {
+      for (uint64_t slot = 0; slot < kSlots; ++slot) {
+        sleep_until_ns(start + tick * kVoiceFrameNs + slot * kVoiceFrameNs / kSlots, 20'000);
+        for (size_t i = slot; i < fleet.size(); i += kSlots) {
+          Client& c = fleet[i];
+          // Listeners keep their seat with a keepalive every second.
+          if (!c.talker && tick % 50 != 0) {
+            continue;
+          }
+          VoicePacketHeader header;
+          header.stream = c.stream;
+          header.group = c.group;
+          header.sequence = c.sequence++;
+          header.capture_ns = now_ns();
+          size_t size = kVoiceHeaderSize;
+          // Everyone joins on the first tick; listeners' keepalives are joins.
+          if (!c.talker || tick == 0) {
+            header.flags = kVoiceFlagJoin;
+            put_u64(packet + kVoiceHeaderSize, c.token);
+            size += kVoiceJoinTokenSize;
+          } else {
+            const std::vector<uint8_t>& frame = bank[(i % kVoices) * kBankFrames + (tick + i) % kBankFrames];
+            std::copy(frame.begin(), frame.end(), packet + kVoiceHeaderSize);
+            size += frame.size();
+          }
+          write_voice_header(header, packet);
+          result.sent += c.socket.send_to(to, packet, size) ? 1 : 0;
+        }
+      }
+    }
+  }
+  sleep_until_ns(now_ns() + 300 * kNanosPerMilli);
+  result.server = server.counters();
+  server.stop();
+  done = true;
+  receiver.join();
+  return result;
+}
+
+void report(const char* name, Result& r, size_t workers, size_t clients, size_t talkers_total, double seconds) {
+  const double cpu = static_cast<double>(r.server.cpu_ns) / (seconds * 1e9);
+  const uint64_t outgoing = r.server.sent;
+  std::printf("%s: %zu clients, %zu talking, %zu workers; server CPU %.1f%% of a core\n", name, clients,
+              talkers_total, workers, 100.0 * cpu);
+  std::printf("  per talker stream: %.1f us CPU per second (%.3f%% of a core); per client: %.1f us/s\n",
+              cpu * 1e6 / static_cast<double>(talkers_total), 100.0 * cpu / static_cast<double>(talkers_total),
+              cpu * 1e6 / static_cast<double>(clients));
+  std::printf("  server received %llu, sent %llu (%.0f/s), encodes %llu, send failures %llu, spoofed %llu, "
+              "clients %llu\n",
+              static_cast<unsigned long long>(r.server.received), static_cast<unsigned long long>(outgoing),
+              static_cast<double>(outgoing) / seconds, static_cast<unsigned long long>(r.server.encodes),
+              static_cast<unsigned long long>(r.server.send_failures),
+              static_cast<unsigned long long>(r.server.spoofed), static_cast<unsigned long long>(r.server.clients));
+  std::printf("  clients sent %llu, received %llu\n", static_cast<unsigned long long>(r.sent),
+              static_cast<unsigned long long>(r.delivered));
+  bench::print_latency_row("  capture -> client", r.latency_ns);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const auto clients = static_cast<size_t>(bench::arg_int(argc, argv, "--clients", 240));
+  const auto group_size = std::max<size_t>(2, static_cast<size_t>(bench::arg_int(argc, argv, "--group-size", 8)));
+  const auto talkers = std::min(group_size, static_cast<size_t>(bench::arg_int(argc, argv, "--talkers", 2)));
+  const double seconds = bench::arg_double(argc, argv, "--seconds", 10.0);
+  const std::string mode = bench::arg(argc, argv, "--mode", "both");
+  const auto workers = static_cast<size_t>(bench::arg_int(argc, argv, "--workers", 0));
+
+  // A small bank of encoded speech; talkers cycle through it at different
+  // offsets so the server mixes different material.
+  std::vector<std::vector<uint8_t>> bank;
+  for (size_t v = 0; v < kVoices; ++v) {
+    SyntheticVoiceOptions options;
+    options.seed = static_cast<uint32_t>(v + 1);
+    SyntheticVoice voice(options);
+    AdpcmEncoder encoder;
+    float pcm[kVoiceFrameSamples];
+    for (size_t f = 0; f < kBankFrames; ++f) {
+      voice.next(pcm);
+      std::vector<uint8_t> frame(kAdpcmFrameBytes);
+      frame.resize(encoder.encode(pcm, frame.data()));
+      bank.push_back(std::move(frame));
+    }
+  }
+
+  size_t talkers_total = 0;
+  for (size_t i = 0; i < clients; ++i) {
+    talkers_total += i % group_size < talkers ? 1 : 0;
+  }
+  std::printf("%zu groups of up to %zu, %.0f s per mode\n\n", (clients + group_size - 1) / group_size, group_size,
+              seconds);
+  int status = 0;
+  // Every client joined and only the squatter was refused.
+  const auto check = [&](const Result& r) {
+    if (r.server.spoofed != kSquatterPackets || r.server.joined != clients) {
+      std::printf("FAIL: %llu of %zu clients joined, %llu spoofed (expected %llu)\n",
+                  static_cast<unsigned long long>(r.server.joined), clients,
+                  static_cast<unsigned long long>(r.server.spoofed),
+                  static_cast<unsigned long long>(kSquatterPackets));
+      status = 1;
+    }
+  };
+  if (mode == "both" || mode == "forward") {
+    Result r = run(VoiceServerMode::Forward, workers, clients, group_size, talkers, seconds, bank);
+    report("forward", r, r.workers, clients, talkers_total, seconds);
+    check(r);
+  }
+  if (mode == "both" || mode == "mix") {
+    Result r = run(VoiceServerMode::Mix, workers, clients, group_size, talkers, seconds, bank);
+    report("mix", r, r.workers, clients, talkers_total, seconds);
+    check(r);
+  }
+  return status;
+}
+
+#else
+
+int main() {
+  std::printf("bench_voice_server needs Linux (UDP sockets)\n");
+  return 0;
+}
+
+#endif
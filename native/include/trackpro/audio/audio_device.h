@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace trackpro::audio {
+
+struct AudioFormat {
+  uint32_t sample_rate = 48'000;
+  uint32_t channels = 2;
+  uint32_t frames_per_callback = 256;  // 5.3 ms at 48 kHz
+};
+
+// Produces the device's output. Called on the device's audio thread, which
+// must never wait: implementations may not lock, allocate or make blocking
+// system calls.
+class AudioRenderCallback {
+ public:
+  virtual ~AudioRenderCallback() = default;
+  // Fills `frames` interleaved frames of the device format into `out`.
+  virtual void render(float* out, size_t frames) = 0;
+  // Called by the device when it starts, before any render(). Throws
+  // std::invalid_argument if the callback cannot fill `format`, and the
+  // device then does not start.
+  virtual void check_format(const AudioFormat& format) const { (void)format; }
+};
+
+struct AudioDeviceCounters {
+  uint64_t callbacks = 0;
+  // Periods whose callback finished after the next period was due; a real
+  // device would have played a glitch.
+  uint64_t late = 0;
+};
+
+// Output backend for the audio mixer. Implementations: null (headless
+// pacing for tests and benchmarks). Platform backends pull from the same
+// callback.
+class AudioOutputDevice {
+ public:
+  virtual ~AudioOutputDevice() = default;
+
+  virtual AudioFormat format() const = 0;
+  // Starts calling `callback` once per period on the audio thread. The
+  // callback must outlive stop(). Throws std::invalid_argument, without
+  // starting, if callback.check_format() refuses format().
+  virtual void start(AudioRenderCallback& callback) = 0;
+  virtual void stop() = 0;
+  virtual AudioDeviceCounters counters() const = 0;
+  virtual const char* name() const = 0;
+};
+
+}  // namespace trackpro::audio
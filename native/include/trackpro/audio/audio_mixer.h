@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "trackpro/audio/audio_device.h"
+#include "trackpro/common/latency_histogram.h"
+#include "trackpro/common/seqlock.h"
+#include "trackpro/common/spsc_ring.h"
+
+namespace trackpro::audio {
+
+// Mixer inputs in priority order: a lane is ducked while any lane above it
+// is playing.
+enum class AudioLane : uint8_t {
+  TeamRadio,  // team voice chat
+  Spotter,    // car left/right, flags
+  Coach,      // coaching TTS
+};
+
+constexpr size_t kAudioLaneCount = 3;
+constexpr size_t kAudioBlockFrames = 256;  // lane queue granularity and render chunk
+
+const char* lane_name(AudioLane lane);
+
+struct AudioMixerOptions {
+  uint32_t sample_rate = 48'000;  // lanes are mono at the device rate
+  uint32_t channels = 2;          // output channels; every channel gets the mix
+  // Gain applied to each lane while a higher-priority lane plays. The first
+  // entry is unused: nothing outranks team radio.
+  std::array<float, kAudioLaneCount> duck_db = {0.0f, -12.0f, -20.0f};
+  float attack_ms = 10.0f;    // time constant of ducking down
+  float release_ms = 250.0f;  // time constant of coming back up
+  // A lane still counts as playing this long after its last sample, so the
+  // gaps between words do not pump the lanes below it.
+  float hold_ms = 300.0f;
+  // render() stops mixing lower-priority lanes once this much time has gone
+  // by in the callback, so an overloaded machine drops coaching before it
+  // glitches team radio.
+  uint64_t budget_ns = 1'000'000;
+  // Render time of every callback. Owned by the caller; null disables it.
+  LatencyHistogram* callback_ns = nullptr;
+};
+
+struct AudioMixerCounters {
+  uint64_t callbacks = 0;
+  uint64_t frames = 0;
+  uint64_t over_budget = 0;  // callbacks that ran past budget_ns
+  uint64_t shed = 0;         // lane chunks skipped to stay within budget
+  uint64_t limited = 0;      // chunks the output limiter turned down
+  uint64_t max_callback_ns = 0;
+  std::array<uint64_t, kAudioLaneCount> played{};   // samples mixed per lane
+  std::array<uint64_t, kAudioLaneCount> dropped{};  // samples rejected by write()
+  std::array<float, kAudioLaneCount> gain{};        // current ducking gain per lane
+};
+
+// Real-time mixer for everything the driver hears. Each lane is fed by one
+// producer thread through a wait-free queue; render() runs on the audio
+// device thread, pulls from every lane, ducks lower lanes under higher ones
+// with smoothed gains, limits the sum and writes the device format. The
+// callback never locks, allocates or waits, and its work per frame is fixed.
+// The lane queues make this a large object (about 1.6 MB); keep it on the
+// heap.
+class AudioMixer final : public AudioRenderCallback {
+ public:
+  // Throws std::invalid_argument on a zero rate or channel count.
+  explicit AudioMixer(AudioMixerOptions options = {});
+
+  AudioMixer(const AudioMixer&) = delete;
+  AudioMixer& operator=(const AudioMixer&) = delete;
+
+  // Queues mono samples on `lane`. One producer thread per lane. Returns how
+  // many were accepted; a lane holds about 2.7 s, and samples that did not
+  // fit are counted as dropped.
+  size_t write(AudioLane lane, const float* pcm, size_t samples);
+
+  // Samples waiting on `lane`, approximately.
+  size_t queued(AudioLane lane) const;
+
+  // Listener volume per lane, linear. Any thread.
+  void set_volume(AudioLane lane, float gain);
+
+  // Audio thread only.
+  void render(float* out, size_t frames) override;
+  // The device must run at the mixer's sample rate and channel count:
+  // render() writes frames * channels samples and times ducking in samples.
+  void check_format(const AudioFormat& format) const override;
+
+  AudioMixerCounters counters() const;
+
+ private:
+  struct Block {
+    uint32_t size = 0;
+    float samples[kAudioBlockFrames];
+  };
+
+  struct Lane {
+    SpscRing<Block, 512> queue;
+    std::atomic<float> volume{1.0f};
+    std::atomic<uint64_t> dropped{0};
+    // Audio thread state.
+    Block current;
+    uint32_t offset = 0;
+    float gain = 1.0f;
+    uint64_t hold_left = 0;  // samples
+    std::array<float, kAudioBlockFrames> pcm{};
+
+    size_t pull(size_t frames);
+  };
+
+  void render_chunk(float* out, size_t frames, uint64_t start_ns);
+
+  AudioMixerOptions options_;
+  std::array<float, kAudioLaneCount> duck_gain_{};
+  float attack_samples_;
+  float release_samples_;
+  uint64_t hold_samples_;
+  std::array<Lane, kAudioLaneCount> lanes_;
+
+  // Audio thread state.
+  std::array<float, kAudioBlockFrames> mix_{};
+  float limiter_gain_ = 1.0f;
+  AudioMixerCounters counters_;
+  SeqLock<AudioMixerCounters> published_;
+};
+
+}  // namespace trackpro::audio
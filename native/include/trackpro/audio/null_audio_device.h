@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "trackpro/audio/audio_device.h"
+
+namespace trackpro::audio {
+
+struct NullAudioDeviceOptions {
+  AudioFormat format;
+  int realtime_priority = 70;  // SCHED_FIFO priority; ignored if unprivileged
+  int cpu = -1;                // pin the audio thread; -1 leaves it floating
+  uint64_t spin_ns = 50'000;   // busy-wait tail of each sleep
+};
+
+// Audio device without hardware: a real-time thread calls the render
+// callback at the format's period, as a sound card would, and discards the
+// output. Lets the mixer run headless in benchmarks and on CI machines, and
+// pump() renders synchronously for deterministic checks.
+class NullAudioDevice final : public AudioOutputDevice {
+ public:
+  // Throws std::invalid_argument on a zero rate, channel count or period.
+  explicit NullAudioDevice(NullAudioDeviceOptions options = {});
+  ~NullAudioDevice() override;
+
+  NullAudioDevice(const NullAudioDevice&) = delete;
+  NullAudioDevice& operator=(const NullAudioDevice&) = delete;
+
+  AudioFormat format() const override { return options_.format; }
+  void start(AudioRenderCallback& callback) override;
+  void stop() override;
+  AudioDeviceCounters counters() const override;
+  const char* name() const override { return "null"; }
+
+  bool running() const { return running_.load(std::memory_order_acquire); }
+
+  // Renders `periods` periods back to back on the calling thread. Only while
+  // stopped. Checks the callback's format as start() does.
+  void pump(AudioRenderCallback& callback, size_t periods);
+
+  // The last rendered period, interleaved. Only while stopped.
+  const std::vector<float>& output() const { return buffer_; }
+
+  // True once the audio thread obtained real-time scheduling.
+  bool realtime() const { return realtime_.load(std::memory_order_acquire); }
+
+ private:
+  void run(AudioRenderCallback& callback);
+
+  NullAudioDeviceOptions options_;
+  std::vector<float> buffer_;
+  std::thread thread_;
+  std::atomic<bool> running_{false};
+  std::atomic<bool> realtime_{false};
+  std::atomic<uint64_t> callbacks_{0};
+  std::atomic<uint64_t> late_{0};
+};
+
+}  // namespace trackpro::audio
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+namespace trackpro {
+
+// Monotonic timestamp in nanoseconds. All native timestamps (pedal reports,
+// telemetry ticks, voice packets) share this clock so they can be subtracted.
+uint64_t now_ns();
+
+// Sleeps until `deadline_ns` on the now_ns() clock. The OS sleep is used for
+// everything except the last `spin_ns`, which is busy-waited to hide timer
+// slack. Returns immediately if the deadline has already passed.
+void sleep_until_ns(uint64_t deadline_ns, uint64_t spin_ns = 50'000);
+
+// CPU time consumed by the calling thread, in nanoseconds. 0 where the
+// platform has no per-thread CPU clock.
+uint64_t thread_cpu_ns();
+
+constexpr uint64_t kNanosPerMicro = 1'000;
+constexpr uint64_t kNanosPerMilli = 1'000'000;
+constexpr uint64_t kNanosPerSecond = 1'000'000'000;
+
+}  // namespace trackpro
@@ -0,0 +1,17 @@
+#pragma once
+
+// 64-bit stdio positioning. Plain fseek/ftell take a long, which is 32 bits
+// on Windows, so files past 2 GiB (long .ibt sessions, lap stores) need these.
+
+#include <cstdint>
+#include <cstdio>
+
+namespace trackpro {
+
+// Seeks to `offset` from the start of the file. False on failure.
+bool seek_file(std::FILE* f, uint64_t offset);
+
+// Size of the file, leaving the position at its end. False on failure.
+bool file_size(std::FILE* f, uint64_t& size);
+
+}  // namespace trackpro
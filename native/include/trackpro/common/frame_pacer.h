@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+namespace trackpro {
+
+// Paces a UI loop at a capped frame rate. wait() sleeps until the next frame
+// boundary; a loop that overran skips the frames it missed instead of
+// rendering them back to back, so a slow frame never turns into a burst.
+class FramePacer {
+ public:
+  // Throws std::invalid_argument unless fps > 0.
+  explicit FramePacer(double fps, uint64_t spin_ns = 0);
+
+  // Returns the start time of the frame about to be drawn.
+  uint64_t wait();
+
+  uint64_t period_ns() const { return period_ns_; }
+  uint64_t frames() const { return frames_; }
+  uint64_t dropped_frames() const { return dropped_; }
+
+ private:
+  uint64_t period_ns_;
+  uint64_t spin_ns_;
+  uint64_t next_ = 0;
+  uint64_t frames_ = 0;
+  uint64_t dropped_ = 0;
+};
+
+}  // namespace trackpro
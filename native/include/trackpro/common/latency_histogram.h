@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace trackpro {
+
+// Log-linear histogram bucket layout shared by LatencyHistogram and its
+// snapshots: values below 16 get exact buckets, above that each power of two
+// is split into 16 sub-buckets (~6% relative resolution). Values are clamped
+// to 2^41 ns (~36 minutes).
+struct HistogramLayout {
+  static constexpr size_t kSubBuckets = 16;
+  static constexpr unsigned kMaxMagnitude = 41;
+  static constexpr size_t kBucketCount = kSubBuckets + (kMaxMagnitude - 4) * kSubBuckets;
+
+  static size_t bucket_for(uint64_t value);
+  static uint64_t bucket_lower(size_t bucket);
+  static uint64_t bucket_upper(size_t bucket);  // exclusive
+};
+
+// Point-in-time copy of a histogram; plain data, safe to pass around.
+struct HistogramSnapshot {
+  std::array<uint64_t, HistogramLayout::kBucketCount> buckets{};
+  uint64_t count = 0;
+  uint64_t min = 0;
+  uint64_t max = 0;
+  uint64_t sum = 0;
+
+  // Bucket midpoint at quantile q in [0, 1]; 0 when empty.
+  uint64_t percentile(double q) const;
+  double mean() const;
+  // Standard deviation estimated from bucket midpoints.
+  double stddev() const;
+};
+
+// Fixed-size, allocation-free histogram of nanosecond latencies. record() is
+// lock-free and safe from any number of threads; snapshot() may run
+// concurrently and sees each counter atomically (the copy as a whole is not
+// a single atomic cut, which is fine for monitoring).
+class LatencyHistogram {
+ public:
+  void record(uint64_t value_ns);
+  HistogramSnapshot snapshot() const;
+  void reset();
+
+ private:
+  std::array<std::atomic<uint64_t>, HistogramLayout::kBucketCount> buckets_{};
+  std::atomic<uint64_t> min_{UINT64_MAX};
+  std::atomic<uint64_t> max_{0};
+  std::atomic<uint64_t> sum_{0};
+};
+
+}  // namespace trackpro
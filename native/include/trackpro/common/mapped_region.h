@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace trackpro {
+
+// Owning memory mapping of a file or named shared-memory object. Move-only;
+// unmapped on destruction. Factory functions throw std::system_error.
+class MappedRegion {
+ public:
+  MappedRegion() = default;
+  ~MappedRegion();
+  MappedRegion(MappedRegion&& other) noexcept;
+  MappedRegion& operator=(MappedRegion&& other) noexcept;
+  MappedRegion(const MappedRegion&) = delete;
+  MappedRegion& operator=(const MappedRegion&) = delete;
+
+  // Maps an existing file read-only. On Linux, /dev/shm paths give the same
+  // behaviour as Windows named shared memory.
+  static MappedRegion open_read(const std::string& path);
+
+  // Creates (or truncates) a file of `size` bytes and maps it read-write.
+  static MappedRegion create(const std::string& path, size_t size);
+
+#if defined(_WIN32)
+  // Opens a named file mapping such as iRacing's "Local\\IRSDKMemMapFileName".
+  static MappedRegion open_named(const std::string& name);
+  static MappedRegion create_named(const std::string& name, size_t size);
+#endif
+
+  const uint8_t* data() const { return data_; }
+  uint8_t* mutable_data() { return writable_ ? data_ : nullptr; }
+  size_t size() const { return size_; }
+  bool valid() const { return data_ != nullptr; }
+
+  // Hints that access will be random (lap store) or sequential (importers).
+  void advise_random() const;
+  void advise_sequential() const;
+
+ private:
+  void reset();
+
+  uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  bool writable_ = false;
+#if defined(_WIN32)
+  void* mapping_ = nullptr;
+#endif
+};
+
+}  // namespace trackpro
@@ -0,0 +1,27 @@
+#pragma once
+
+namespace trackpro {
+
+// Raises the calling thread to a real-time scheduling class (SCHED_FIFO on
+// Linux, TIME_CRITICAL on Windows). `priority` is in the platform's native
+// range. Returns false when the process lacks the privilege; callers treat
+// that as "run best effort", never as an error.
+bool promote_current_thread_realtime(int priority);
+
+// Lowers the calling thread below normal threads without starving it (nice
+// +10 on Linux, THREAD_PRIORITY_BELOW_NORMAL on Windows): it yields to the
+// sim when they contend but still gets a share of a busy core. Returns false
+// if the platform refused; the thread then keeps its normal priority.
+bool demote_current_thread_background();
+
+// Pins the calling thread to one CPU. A negative cpu is a no-op.
+bool pin_current_thread(int cpu);
+
+// Sets flush-to-zero/denormals-are-zero for the calling thread so decaying
+// filter states never fall onto the slow denormal path.
+void enable_flush_denormals();
+
+// Names the calling thread for debuggers and `top -H`.
+void set_current_thread_name(const char* name);
+
+}  // namespace trackpro
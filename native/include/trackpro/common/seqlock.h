@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace trackpro {
+
+// Single-writer, multi-reader publication of a small value. The writer never
+// waits; readers retry while a store is in progress, so they never see a torn
+// value. For values read by several consumers at different rates (UI,
+// voice coach) where a TripleBuffer's single reader is not enough.
+template <typename T>
+class SeqLock {
+  static_assert(std::is_trivially_copyable_v<T>, "SeqLock copies values with memcpy");
+
+ public:
+  void store(const T& value) {
+    const uint64_t v = version_.load(std::memory_order_relaxed);
+    version_.store(v + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&value_, &value, sizeof(T));
+    version_.store(v + 2, std::memory_order_release);
+  }
+
+  // Returns false before the first store.
+  bool load(T& out) const {
+    for (;;) {
+      const uint64_t before = version_.load(std::memory_order_acquire);
+      if (before == 0) {
+        return false;
+      }
+      if ((before & 1) != 0) {
+        std::this_thread::yield();  // writer preempted mid-store
+        continue;
+      }
+      std::memcpy(&out, &value_, sizeof(T));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (version_.load(std::memory_order_relaxed) == before) {
+        return true;
+      }
+    }
+  }
+
+  // Number of completed stores.
+  uint64_t stores() const { return version_.load(std::memory_order_acquire) / 2; }
+
+ private:
+  std::atomic<uint64_t> version_{0};
+  T value_{};
+};
+
+}  // namespace trackpro
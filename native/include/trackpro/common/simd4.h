@@ -0,0 +1,102 @@
+#pragma once
+
+// Minimal 4-lane float vector used by the per-axis pedal kernels (one lane
+// per pedal) and the telemetry resampling kernels. Maps onto SSE2 on x86 and
+// onto plain arrays elsewhere, so the kernels are written once.
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define TRACKPRO_SIMD4_SSE2 1
+#endif
+
+namespace trackpro::simd {
+
+#if defined(TRACKPRO_SIMD4_SSE2)
+
+struct Vec4 {
+  __m128 v;
+};
+struct Mask4 {
+  __m128 m;
+};
+
+inline Vec4 load(const float* p) { return {_mm_loadu_ps(p)}; }
+inline void store(float* p, Vec4 a) { _mm_storeu_ps(p, a.v); }
+inline Vec4 splat(float x) { return {_mm_set1_ps(x)}; }
+inline Vec4 operator+(Vec4 a, Vec4 b) { return {_mm_add_ps(a.v, b.v)}; }
+inline Vec4 operator-(Vec4 a, Vec4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline Vec4 operator*(Vec4 a, Vec4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+inline Vec4 operator/(Vec4 a, Vec4 b) { return {_mm_div_ps(a.v, b.v)}; }
+inline Vec4 min(Vec4 a, Vec4 b) { return {_mm_min_ps(a.v, b.v)}; }
+inline Vec4 max(Vec4 a, Vec4 b) { return {_mm_max_ps(a.v, b.v)}; }
+inline Vec4 abs(Vec4 a) { return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)}; }
+inline Mask4 lanes(bool l0, bool l1, bool l2, bool l3) {
+  return {_mm_castsi128_ps(_mm_setr_epi32(-static_cast<int>(l0), -static_cast<int>(l1),
+                                          -static_cast<int>(l2), -static_cast<int>(l3)))};
+}
+inline Vec4 select(Mask4 mask, Vec4 a, Vec4 b) {
+  return {_mm_or_ps(_mm_and_ps(mask.m, a.v), _mm_andnot_ps(mask.m, b.v))};
+}
+
+// lo = base[idx[k]], hi = base[idx[k] + 1] for k = 0..3: the two ends of four
+// interpolation segments.
+inline void gather_pairs(const float* base, const int32_t* idx, Vec4& lo, Vec4& hi) {
+#if defined(__AVX2__)
+  const __m128i offset = _mm_loadu_si128(reinterpret_cast<const __m128i*>(idx));
+  lo.v = _mm_i32gather_ps(base, offset, 4);
+  hi.v = _mm_i32gather_ps(base + 1, offset, 4);
+#else
+  // One 8-byte load per pair, then deinterleave. The pairs are only 4-byte
+  // aligned; movq has no alignment requirement, unlike a double load.
+  const auto pair = [base](int32_t i) { return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(base + i)); };
+  const __m128 p01 = _mm_castsi128_ps(_mm_unpacklo_epi64(pair(idx[0]), pair(idx[1])));
+  const __m128 p23 = _mm_castsi128_ps(_mm_unpacklo_epi64(pair(idx[2]), pair(idx[3])));
+  lo.v = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(2, 0, 2, 0));
+  hi.v = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(3, 1, 3, 1));
+#endif
+}
+
+#else
+
+struct Vec4 {
+  float v[4];
+};
+struct Mask4 {
+  bool m[4];
+};
+
+#define TRACKPRO_SIMD4_LANES(expr) \
+  Vec4 r;                          \
+  for (int i = 0; i < 4; ++i) {    \
+    r.v[i] = (expr);               \
+  }                                \
+  return r
+
+inline Vec4 load(const float* p) { Vec4 r; std::memcpy(r.v, p, sizeof(r.v)); return r; }
+inline void store(float* p, Vec4 a) { std::memcpy(p, a.v, sizeof(a.v)); }
+inline Vec4 splat(float x) { TRACKPRO_SIMD4_LANES(x); }
+inline Vec4 operator+(Vec4 a, Vec4 b) { TRACKPRO_SIMD4_LANES(a.v[i] + b.v[i]); }
+inline Vec4 operator-(Vec4 a, Vec4 b) { TRACKPRO_SIMD4_LANES(a.v[i] - b.v[i]); }
+inline Vec4 operator*(Vec4 a, Vec4 b) { TRACKPRO_SIMD4_LANES(a.v[i] * b.v[i]); }
+inline Vec4 operator/(Vec4 a, Vec4 b) { TRACKPRO_SIMD4_LANES(a.v[i] / b.v[i]); }
+inline Vec4 min(Vec4 a, Vec4 b) { TRACKPRO_SIMD4_LANES(b.v[i] < a.v[i] ? b.v[i] : a.v[i]); }
+inline Vec4 max(Vec4 a, Vec4 b) { TRACKPRO_SIMD4_LANES(b.v[i] > a.v[i] ? b.v[i] : a.v[i]); }
+inline Vec4 abs(Vec4 a) { TRACKPRO_SIMD4_LANES(a.v[i] < 0.0f ? -a.v[i] : a.v[i]); }
+inline Mask4 lanes(bool l0, bool l1, bool l2, bool l3) { return {{l0, l1, l2, l3}}; }
+inline Vec4 select(Mask4 mask, Vec4 a, Vec4 b) { TRACKPRO_SIMD4_LANES(mask.m[i] ? a.v[i] : b.v[i]); }
+
+inline void gather_pairs(const float* base, const int32_t* idx, Vec4& lo, Vec4& hi) {
+  for (int i = 0; i < 4; ++i) {
+    lo.v[i] = base[idx[i]];
+    hi.v[i] = base[idx[i] + 1];
+  }
+}
+
+#undef TRACKPRO_SIMD4_LANES
+
+#endif
+
+}  // namespace trackpro::simd
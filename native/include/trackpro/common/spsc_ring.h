@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace trackpro {
+
+constexpr size_t kCacheLineSize = 64;
+
+// Wait-free single-producer/single-consumer ring buffer. try_push() may only
+// be called from one thread and try_pop() from one (other) thread; both
+// complete in a bounded number of steps and never block or allocate.
+//
+// Capacity must be a power of two. Indices run freely and are masked on
+// access, so all `Capacity` slots are usable.
+template <typename T, size_t Capacity>
+class SpscRing {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "SpscRing capacity must be a power of two");
+  static_assert(std::is_trivially_copyable_v<T>, "SpscRing holds trivially copyable values");
+
+ public:
+  bool try_push(const T& value) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head - cached_tail_ >= Capacity) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (head - cached_tail_ >= Capacity) {
+        return false;
+      }
+    }
+    slots_[head & kMask] = value;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool try_pop(T& out) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == cached_head_) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (tail == cached_head_) {
+        return false;
+      }
+    }
+    out = slots_[tail & kMask];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Approximate when called concurrently with push/pop; exact otherwise.
+  size_t size() const {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+  }
+  bool empty() const { return size() == 0; }
+  static constexpr size_t capacity() { return Capacity; }
+
+ private:
+  static constexpr size_t kMask = Capacity - 1;
+
+  // Producer-owned line: head plus its cached view of the consumer.
+  alignas(kCacheLineSize) std::atomic<size_t> head_{0};
+  size_t cached_tail_ = 0;
+  // Consumer-owned line.
+  alignas(kCacheLineSize) std::atomic<size_t> tail_{0};
+  size_t cached_head_ = 0;
+
+  alignas(kCacheLineSize) T slots_[Capacity];
+};
+
+}  // namespace trackpro
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace trackpro {
+
+// Fixed-size pool for batch work (imports, analysis). Not for real-time
+// threads: submit() takes a mutex and may allocate.
+class ThreadPool {
+ public:
+  // 0 threads means one per hardware thread.
+  explicit ThreadPool(unsigned threads = 0);
+  // Runs every queued task, then joins.
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  template <typename F>
+  auto submit(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+    using Result = std::invoke_result_t<std::decay_t<F>>;
+    auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+    std::future<Result> future = packaged->get_future();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queue_.emplace_back([packaged] { (*packaged)(); });
+    }
+    ready_.notify_one();
+    return future;
+  }
+
+  size_t size() const { return workers_.size(); }
+
+ private:
+  void worker_loop();
+
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::deque<std::function<void()>> queue_;
+  bool stopping_ = false;
+  std::vector<std::thread> workers_;
+};
+
+// Runs fn(i) for every i in [0, count) on the pool's workers and the calling
+// thread. Work is claimed `grain` indices at a time from a shared cursor, so
+// threads that finish early keep taking work from the rest instead of idling
+// behind a fixed split. Blocks until every index is done and rethrows the
+// first exception. Must not be called from inside a pool task.
+template <typename F>
+void parallel_for(ThreadPool& pool, size_t count, size_t grain, F&& fn) {
+  grain = std::max<size_t>(1, grain);
+  std::atomic<size_t> cursor{0};
+  auto drain = [&] {
+    for (;;) {
+      const size_t begin = cursor.fetch_add(grain, std::memory_order_relaxed);
+      if (begin >= count) {
+        return;
+      }
+      const size_t end = std::min(count, begin + grain);
+      for (size_t i = begin; i < end; ++i) {
+        fn(i);
+      }
+    }
+  };
+  const size_t helpers = std::min(pool.size(), (count + grain - 1) / grain);
+  std::vector<std::future<void>> pending;
+  pending.reserve(helpers);
+  for (size_t t = 0; t < helpers; ++t) {
+    pending.push_back(pool.submit(drain));
+  }
+  std::exception_ptr error;
+  try {
+    drain();
+  } catch (...) {
+    error = std::current_exception();
+    cursor.store(count, std::memory_order_relaxed);
+  }
+  for (auto& f : pending) {
+    try {
+      f.get();
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+      cursor.store(count, std::memory_order_relaxed);
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+}  // namespace trackpro
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace trackpro {
+
+// Latest-value channel between one writer and one reader. The writer fills
+// write_buffer() and publish()es it; the reader calls update() and then uses
+// read_buffer(). Neither side ever blocks or waits for the other, and the
+// reader always sees a complete value: the slot it holds is never touched by
+// the writer.
+//
+// The writer's slot holds stale contents after publish(), so each write must
+// overwrite the whole value. Multiple writers must serialise among
+// themselves; the reader side must stay single-threaded.
+template <typename T>
+class TripleBuffer {
+ public:
+  TripleBuffer() = default;
+  explicit TripleBuffer(const T& initial) : slots_{initial, initial, initial} {}
+
+  // Writer side.
+  T& write_buffer() { return slots_[back_]; }
+  void publish() {
+    const uint8_t previous = middle_.exchange(static_cast<uint8_t>(back_ | kFresh),
+                                              std::memory_order_acq_rel);
+    back_ = previous & kIndexMask;
+  }
+
+  // Reader side. Returns true if a newer value was picked up.
+  bool update() {
+    if ((middle_.load(std::memory_order_relaxed) & kFresh) == 0) {
+      return false;
+    }
+    const uint8_t previous = middle_.exchange(front_, std::memory_order_acq_rel);
+    front_ = previous & kIndexMask;
+    return true;
+  }
+  const T& read_buffer() const { return slots_[front_]; }
+  T& read_buffer() { return slots_[front_]; }
+
+ private:
+  static constexpr uint8_t kIndexMask = 0x3;
+  static constexpr uint8_t kFresh = 0x4;
+
+  T slots_[3] = {T(), T(), T()};
+  uint8_t back_ = 0;   // writer-owned
+  uint8_t front_ = 1;  // reader-owned
+  std::atomic<uint8_t> middle_{2};
+};
+
+}  // namespace trackpro
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "trackpro/pedals/pedal_types.h"
+
+namespace trackpro::pedals {
+
+// Maps raw device counts onto [0, 1]. Deadzones are expressed as fractions of
+// the calibrated travel and are removed from both ends before rescaling.
+struct AxisCalibration {
+  uint16_t min = 0;
+  uint16_t max = 65535;
+  float deadzone_low = 0.0f;
+  float deadzone_high = 0.0f;
+  bool inverted = false;
+
+  float apply(uint16_t raw) const;
+};
+
+using Calibration = std::array<AxisCalibration, kPedalAxisCount>;
+
+}  // namespace trackpro::pedals
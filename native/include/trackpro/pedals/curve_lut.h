@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "trackpro/pedals/pedal_types.h"
+#include "trackpro/pedals/response_curve.h"
+
+namespace trackpro::pedals {
+
+// A ResponseCurve compiled into a fixed-size table sampled on a uniform grid
+// over [0, 1]. Each entry stores the value and the slope to the next entry,
+// so evaluating is one load plus one multiply-add.
+//
+// All four pedal axes live in one CurveBank (4 x 512 x 8 bytes = 16 KiB),
+// which stays resident in L1 for the lifetime of the pedal thread.
+class CurveBank {
+ public:
+  static constexpr size_t kSegments = 512;
+
+  CurveBank();  // all axes identity
+
+  // Recompiles one axis. Runs on the UI thread when a curve is edited, never
+  // on the pedal thread.
+  void compile(PedalAxis axis, const ResponseCurve& curve);
+  void compile(const std::array<ResponseCurve, kPedalAxisCount>& curves);
+
+  // One axis, scalar.
+  float evaluate(PedalAxis axis, float x) const;
+
+  // All four axes at once, vectorised where the target supports it (AVX2
+  // gather, else SSE2 with scalar loads, else plain scalar). `in` values are
+  // clamped to [0, 1].
+  void evaluate4(const float in[kPedalAxisCount], float out[kPedalAxisCount]) const;
+
+ private:
+  struct Entry {
+    float y;
+    float dy;
+  };
+
+  // [axis][segment]; the trailing entry duplicates the end point so x == 1
+  // needs no special case.
+  alignas(64) Entry table_[kPedalAxisCount][kSegments + 1];
+};
+
+}  // namespace trackpro::pedals
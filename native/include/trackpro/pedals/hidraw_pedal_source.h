@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "trackpro/pedals/pedal_source.h"
+
+namespace trackpro::pedals {
+
+// Where each axis lives inside the device's input report. Offsets are in
+// bytes after the report ID (if any); values are little-endian.
+struct HidAxisField {
+  int byte_offset = -1;  // -1: axis not present on this device
+  uint8_t bits = 16;     // 8 or 16
+};
+
+struct HidReportLayout {
+  int report_id = -1;  // -1: device does not use numbered reports
+  std::array<HidAxisField, kPedalAxisCount> axes{};
+};
+
+// Linux hardware backend reading /dev/hidrawN directly. Opened non-blocking;
+// wait() sleeps in ppoll() so the engine wakes the instant a report lands.
+// Unplugging the device (POLLHUP/POLLERR, or ENODEV from read) marks the
+// source disconnected; it then only sleeps to each deadline.
+class HidrawPedalSource final : public PedalSource {
+ public:
+  // Throws std::system_error if the device cannot be opened.
+  HidrawPedalSource(const std::string& device_path, HidReportLayout layout);
+  ~HidrawPedalSource() override;
+
+  HidrawPedalSource(const HidrawPedalSource&) = delete;
+  HidrawPedalSource& operator=(const HidrawPedalSource&) = delete;
+
+  bool wait(uint64_t deadline_ns, uint64_t spin_ns) override;
+  bool read(RawPedalSample& out) override;
+  const char* name() const override { return "hidraw"; }
+  bool disconnected() const override { return disconnected_; }
+
+  // Decodes one report using `layout`; exposed for replaying captured bytes.
+  static bool decode(const HidReportLayout& layout, const uint8_t* report, size_t size,
+                     RawPedalSample& out);
+
+ private:
+  int fd_ = -1;
+  HidReportLayout layout_;
+  RawPedalSample last_{};
+  bool disconnected_ = false;
+};
+
+}  // namespace trackpro::pedals
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "trackpro/common/triple_buffer.h"
+#include "trackpro/pedals/pedal_pipeline.h"
+#include "trackpro/pedals/pedal_source.h"
+
+namespace trackpro::pedals {
+
+// Receives every processed sample on the engine thread. Implementations must
+// not block: anything slow belongs behind a queue.
+class PedalOutputSink {
+ public:
+  virtual ~PedalOutputSink() = default;
+  virtual void emit(const PedalOutput& output) = 0;
+};
+
+struct PedalEngineOptions {
+  uint32_t rate_hz = 1000;
+  int realtime_priority = 80;  // SCHED_FIFO priority; ignored if unprivileged
+  int cpu = -1;                // pin the engine thread; -1 leaves it floating
+  uint64_t spin_ns = 50'000;   // busy-wait tail of each PedalSource::wait()
+  // Per-stage latency histograms; owned by the caller and shared with the
+  // vJoy output stage. Null disables instrumentation.
+  PipelineStats* stats = nullptr;
+};
+
+struct PedalEngineCounters {
+  uint64_t reports = 0;     // samples processed and emitted
+  uint64_t ticks = 0;       // scheduler periods elapsed
+  uint64_t idle_ticks = 0;  // periods in which the source produced nothing
+  uint64_t late_ticks = 0;  // periods skipped because the thread overslept
+  // Periods after the source's device went away (see source_disconnected()).
+  uint64_t disconnected_ticks = 0;
+};
+
+// Dedicated real-time pedal thread. Reports are processed the moment the
+// source delivers them; the fixed-rate tick guarantees the source is polled at
+// least `rate_hz` times a second even if it cannot signal readiness.
+class PedalEngine {
+ public:
+  PedalEngine(std::unique_ptr<PedalSource> source, PedalOutputSink& sink, PedalConfig config,
+              PedalEngineOptions options = {});
+  ~PedalEngine();
+
+  PedalEngine(const PedalEngine&) = delete;
+  PedalEngine& operator=(const PedalEngine&) = delete;
+
+  void start();
+  void stop();
+  bool running() const { return running_.load(std::memory_order_acquire); }
+
+  // Safe to call from any thread while the engine runs. The new pipeline
+  // (including compiled curves) is built on the calling thread and published
+  // as one snapshot; the engine thread picks it up on its next sample without
+  // locking and never observes a partially applied config.
+  void update_config(PedalConfig config);
+
+  // The most recently submitted config.
+  PedalConfig config() const;
+
+  PedalEngineCounters counters() const;
+
+  // True once the engine thread obtained real-time scheduling.
+  bool realtime() const { return realtime_.load(std::memory_order_acquire); }
+
+  // True once the source reported its device gone (e.g. pedals unplugged).
+  // The engine keeps ticking without output; the owner decides whether to
+  // reopen the device and start a new engine.
+  bool source_disconnected() const { return disconnected_.load(std::memory_order_acquire); }
+
+ private:
+  void run();
+  bool read_source(RawPedalSample& sample);
+  void process_and_emit(const RawPedalSample& sample);
+
+  std::unique_ptr<PedalSource> source_;
+  PedalOutputSink& sink_;
+  PedalEngineOptions options_;
+
+  // Serialises writers only; the engine thread never touches it.
+  mutable std::mutex update_mutex_;
+  PedalConfig submitted_;
+  TripleBuffer<PedalPipeline> pipelines_;
+  FilterState filter_state_;  // engine thread only
+
+  std::thread thread_;
+  std::atomic<bool> running_{false};
+  std::atomic<bool> realtime_{false};
+  std::atomic<bool> disconnected_{false};
+
+  std::atomic<uint64_t> reports_{0};
+  std::atomic<uint64_t> ticks_{0};
+  std::atomic<uint64_t> idle_ticks_{0};
+  std::atomic<uint64_t> late_ticks_{0};
+  std::atomic<uint64_t> disconnected_ticks_{0};
+  uint64_t sequence_ = 0;
+};
+
+}  // namespace trackpro::pedals
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "trackpro/pedals/pedal_types.h"
+
+namespace trackpro::pedals {
+
+enum class FilterKind : uint8_t {
+  None = 0,
+  OneEuro,  // adaptive low-pass: heavy smoothing at rest, little lag when moving
+  Biquad,   // 2nd-order Butterworth-style low-pass (RBJ cookbook)
+  Median3,  // median of the last three samples; kills single-sample spikes
+};
+
+const char* filter_name(FilterKind kind);
+
+struct FilterSettings {
+  FilterKind kind = FilterKind::None;
+  // One-euro: cutoff = min_cutoff_hz + beta * |pedal speed in units/s|.
+  float min_cutoff_hz = 5.0f;
+  float beta = 2.0f;
+  float derivative_cutoff_hz = 20.0f;
+  // Biquad low-pass.
+  float cutoff_hz = 60.0f;
+  float q = 0.7071f;
+};
+
+// Per-lane history for every filter kind. Owned by whoever drives the
+// pipeline (the engine thread, a replay run) and kept across config changes
+// so retuning a filter mid-session does not restart it from zero.
+struct FilterState {
+  bool primed = false;
+  uint64_t last_timestamp_ns = 0;
+  alignas(16) float median_x1[kPedalAxisCount]{};
+  alignas(16) float median_x2[kPedalAxisCount]{};
+  alignas(16) float biquad_z1[kPedalAxisCount]{};
+  alignas(16) float biquad_z2[kPedalAxisCount]{};
+  alignas(16) float euro_x[kPedalAxisCount]{};
+  alignas(16) float euro_dx[kPedalAxisCount]{};
+};
+
+// Immutable, precomputed filter coefficients for the four pedal axes. Each
+// kind runs as one 4-lane SIMD kernel and lanes pick their kind's result, so
+// per-axis filter choices cost the same as a single shared one.
+class FilterBank {
+ public:
+  FilterBank();  // all axes unfiltered
+
+  void configure(const std::array<FilterSettings, kPedalAxisCount>& settings, float sample_rate_hz);
+
+  bool active() const { return active_; }
+  const FilterSettings& settings(PedalAxis axis) const { return settings_[axis_index(axis)]; }
+
+  // Filters `values` in place. `timestamp_ns` drives the one-euro filter's
+  // time step so irregular report intervals are handled correctly.
+  void apply(uint64_t timestamp_ns, float values[kPedalAxisCount], FilterState& state) const;
+
+  // Steady-state group delay added by the axis's filter, in milliseconds,
+  // with the pedal moving at `speed_per_s` (full travel = 1.0). Only one-euro
+  // depends on speed: at rest (the default) it reports its worst case, which
+  // is several times what it adds during a real stroke.
+  float group_delay_ms(PedalAxis axis, float speed_per_s = 0.0f) const;
+
+ private:
+  std::array<FilterSettings, kPedalAxisCount> settings_{};
+  float sample_rate_hz_ = 1000.0f;
+  bool active_ = false;
+  bool lane_[4][kPedalAxisCount]{};  // [kind][axis]
+
+  alignas(16) float b0_[kPedalAxisCount]{};
+  alignas(16) float b1_[kPedalAxisCount]{};
+  alignas(16) float b2_[kPedalAxisCount]{};
+  alignas(16) float a1_[kPedalAxisCount]{};
+  alignas(16) float a2_[kPedalAxisCount]{};
+  alignas(16) float min_cutoff_[kPedalAxisCount]{};
+  alignas(16) float beta_[kPedalAxisCount]{};
+  alignas(16) float derivative_cutoff_[kPedalAxisCount]{};
+};
+
+}  // namespace trackpro::pedals
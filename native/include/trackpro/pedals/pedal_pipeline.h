@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+
+#include "trackpro/pedals/calibration.h"
+#include "trackpro/pedals/curve_lut.h"
+#include "trackpro/pedals/pedal_filter.h"
+#include "trackpro/pedals/pedal_types.h"
+#include "trackpro/pedals/pipeline_stats.h"
+#include "trackpro/pedals/response_curve.h"
+
+namespace trackpro::pedals {
+
+// Everything the calibration UI can change about pedal processing.
+struct PedalConfig {
+  Calibration calibration{};
+  std::array<ResponseCurve, kPedalAxisCount> curves{};
+  std::array<FilterSettings, kPedalAxisCount> filters{};
+  float sample_rate_hz = 1000.0f;  // nominal report rate, for filter design
+};
+
+// The per-sample processing chain: calibrate, apply the response curve, then
+// filter. The pipeline itself is immutable between set_config() calls - all
+// history lives in the caller's FilterState - so it can be driven by the
+// real-time engine or by offline replay at whatever rate the caller likes.
+// Curves and filter coefficients are compiled when the config is set, so
+// process() never walks control points or evaluates trig.
+class PedalPipeline {
+ public:
+  explicit PedalPipeline(PedalConfig config = {});
+
+  void set_config(PedalConfig config);
+  const PedalConfig& config() const { return config_; }
+
+  // Fills `out.value` and `out.input_timestamp_ns`; output timestamp and
+  // sequence belong to whoever emits the result. Stage timings are recorded
+  // into `stats` when given.
+  void process(const RawPedalSample& in, PedalOutput& out, FilterState& filter_state,
+               PipelineStats* stats = nullptr) const;
+
+  const FilterBank& filters() const { return filters_; }
+
+ private:
+  PedalConfig config_;
+  CurveBank curves_;
+  FilterBank filters_;
+};
+
+}  // namespace trackpro::pedals
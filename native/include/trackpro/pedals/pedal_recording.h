@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "trackpro/pedals/pedal_types.h"
+
+namespace trackpro::pedals {
+
+// On-disk format for raw pedal captures (.tpr), little-endian:
+//
+//   header (32 bytes)
+//     char[4]  magic "TPPR"
+//     u16      version (1)
+//     u16      axis count (4)
+//     u32      nominal report rate, Hz
+//     u32      reserved
+//     u64      timestamp of the first report, ns (recorder's clock; 0 if none)
+//     u64      report count (0 if the recorder did not close cleanly)
+//   records, one per HID report
+//     varint   ns since the previous report (first: since header timestamp)
+//     varint   zigzag(raw - previous raw), per axis
+//
+// Pedals mostly sit still or move smoothly, so a 1 kHz capture costs about
+// 6-8 bytes per report instead of the 16 of a fixed layout.
+struct PedalRecordingHeader {
+  uint32_t rate_hz = 1000;
+  uint64_t start_timestamp_ns = 0;
+  uint64_t report_count = 0;
+};
+
+class PedalRecorder {
+ public:
+  // Throws std::system_error if the file cannot be created.
+  PedalRecorder(const std::string& path, uint32_t rate_hz);
+  ~PedalRecorder();
+
+  PedalRecorder(const PedalRecorder&) = delete;
+  PedalRecorder& operator=(const PedalRecorder&) = delete;
+
+  // Reports must arrive in timestamp order. Returns false on I/O error.
+  bool append(const RawPedalSample& sample);
+
+  // Flushes and writes the final report count. Idempotent. Everything else
+  // in the header is on disk from the first append(), so a recorder that is
+  // killed before close() leaves a file load() reads up to the last record
+  // that reached the disk.
+  bool close();
+
+  uint64_t count() const { return count_; }
+
+ private:
+  std::FILE* file_ = nullptr;
+  std::string path_;
+  PedalRecordingHeader header_;
+  RawPedalSample previous_{};
+  uint64_t count_ = 0;
+  bool ok_ = true;
+};
+
+// A whole recording decoded into memory - a one-hour 1 kHz session is about
+// 58 MB decoded - ready for replay at any speed.
+class PedalRecording {
+ public:
+  // Throws std::runtime_error on a missing, foreign or corrupt file. A
+  // recording whose writer crashed is read up to its last complete record.
+  static PedalRecording load(const std::string& path);
+
+  const PedalRecordingHeader& header() const { return header_; }
+  const std::vector<RawPedalSample>& samples() const { return samples_; }
+  double duration_seconds() const;
+
+ private:
+  PedalRecordingHeader header_;
+  std::vector<RawPedalSample> samples_;
+};
+
+}  // namespace trackpro::pedals
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "trackpro/common/spsc_ring.h"
+#include "trackpro/pedals/pedal_engine.h"
+#include "trackpro/pedals/pedal_pipeline.h"
+#include "trackpro/pedals/pedal_recording.h"
+#include "trackpro/pedals/pedal_source.h"
+#include "trackpro/pedals/pipeline_stats.h"
+
+namespace trackpro::pedals {
+
+// Wraps a live source and records every report it yields. File I/O happens on
+// a background thread fed through an SPSC ring, so recording adds one ring
+// push to the engine thread. Reports are dropped (and counted) rather than
+// blocking if the disk falls behind.
+class RecordingPedalSource final : public PedalSource {
+ public:
+  // Throws std::system_error if the recording cannot be created.
+  RecordingPedalSource(std::unique_ptr<PedalSource> inner, const std::string& path,
+                       uint32_t rate_hz = 1000);
+  ~RecordingPedalSource() override;
+
+  bool wait(uint64_t deadline_ns, uint64_t spin_ns) override { return inner_->wait(deadline_ns, spin_ns); }
+  bool read(RawPedalSample& out) override;
+  const char* name() const override { return "recording"; }
+  bool disconnected() const override { return inner_->disconnected(); }
+
+  uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+ private:
+  void run();
+
+  std::unique_ptr<PedalSource> inner_;
+  PedalRecorder recorder_;
+  SpscRing<RawPedalSample, 4096> ring_;
+  std::atomic<bool> running_{true};
+  std::atomic<uint64_t> dropped_{0};
+  std::thread writer_;
+};
+
+// Plays a recording into the real-time engine at its original pace, with
+// timestamps rebased onto now_ns() so latency figures stay meaningful.
+class ReplayPedalSource final : public PedalSource {
+ public:
+  explicit ReplayPedalSource(std::shared_ptr<const PedalRecording> recording, bool loop = false);
+
+  bool wait(uint64_t deadline_ns, uint64_t spin_ns) override;
+  bool read(RawPedalSample& out) override;
+  const char* name() const override { return "replay"; }
+
+  bool finished() const { return !loop_ && next_ >= recording_->samples().size(); }
+
+ private:
+  uint64_t due_ns(size_t index) const;
+
+  std::shared_ptr<const PedalRecording> recording_;
+  bool loop_;
+  size_t next_ = 0;
+  uint64_t base_ns_ = 0;  // now_ns() corresponding to the recording's first report
+  uint64_t loop_offset_ns_ = 0;
+};
+
+struct ReplayResult {
+  uint64_t samples = 0;
+  double wall_seconds = 0.0;
+  double recorded_seconds = 0.0;
+  // FNV-1a over every output value; identical inputs and config must give
+  // identical checksums on every run and machine with the same float model.
+  uint64_t checksum = 0;
+
+  double samples_per_second() const { return wall_seconds > 0 ? samples / wall_seconds : 0.0; }
+  double speedup() const { return wall_seconds > 0 ? recorded_seconds / wall_seconds : 0.0; }
+};
+
+// Drives the full processing pipeline from a recording on the calling thread,
+// as fast as possible (speed = 0) or paced at `speed` x real time. Samples
+// keep their recorded timestamps, so time-dependent filters behave exactly as
+// they did live. Per-stage costs go into `stats` when given; InputToEmit is
+// measured from the moment each report is picked up.
+class PedalReplayDriver {
+ public:
+  PedalReplayDriver(std::shared_ptr<const PedalRecording> recording, PedalConfig config);
+
+  ReplayResult run(PedalOutputSink* sink = nullptr, PipelineStats* stats = nullptr,
+                   double speed = 0.0);
+
+ private:
+  std::shared_ptr<const PedalRecording> recording_;
+  PedalPipeline pipeline_;
+};
+
+}  // namespace trackpro::pedals
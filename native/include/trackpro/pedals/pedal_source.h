@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+#include "trackpro/pedals/pedal_types.h"
+
+namespace trackpro::pedals {
+
+// Input backend for the pedal engine. Implementations: hidraw (Linux
+// hardware), synthetic (generated motion) and replay (recorded sessions).
+//
+// Sources are driven from the engine thread only and need not be thread-safe.
+class PedalSource {
+ public:
+  virtual ~PedalSource() = default;
+
+  // Blocks until a report is ready or `deadline_ns` passes. Returns true if a
+  // subsequent read() will produce a sample. The last `spin_ns` before the
+  // deadline is busy-waited, as in sleep_until_ns(). The default
+  // implementation just sleeps to the deadline, which degrades to plain
+  // polling.
+  virtual bool wait(uint64_t deadline_ns, uint64_t spin_ns);
+
+  // Non-blocking. Drains every pending report and stores the newest in `out`.
+  // Returns false if nothing new arrived since the previous call.
+  virtual bool read(RawPedalSample& out) = 0;
+
+  virtual const char* name() const = 0;
+
+  // True once the device has gone away (unplugged). A disconnected source
+  // still sleeps to the deadline in wait() and never produces samples.
+  virtual bool disconnected() const { return false; }
+};
+
+}  // namespace trackpro::pedals
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace trackpro::pedals {
+
+enum class PedalAxis : uint8_t { Throttle = 0, Brake = 1, Clutch = 2, Handbrake = 3 };
+
+constexpr size_t kPedalAxisCount = 4;
+
+constexpr size_t axis_index(PedalAxis axis) { return static_cast<size_t>(axis); }
+
+const char* axis_name(PedalAxis axis);
+
+// One HID report as read from the device, before any processing. Raw values
+// are the device's native counts; 16 bits covers every load cell we ship.
+struct RawPedalSample {
+  uint64_t timestamp_ns = 0;  // now_ns() when the report was read
+  std::array<uint16_t, kPedalAxisCount> raw{};
+};
+
+// Calibrated, curved pedal positions in [0, 1].
+struct PedalOutput {
+  uint64_t input_timestamp_ns = 0;   // copied from the RawPedalSample
+  uint64_t output_timestamp_ns = 0;  // now_ns() when handed to the sink
+  uint64_t sequence = 0;
+  std::array<float, kPedalAxisCount> value{};
+};
+
+}  // namespace trackpro::pedals
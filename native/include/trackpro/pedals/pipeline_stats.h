@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "trackpro/common/latency_histogram.h"
+
+namespace trackpro::pedals {
+
+// Instrumented points of the pedal path. Per-stage entries are the time spent
+// inside that stage; the last three are end-to-end and scheduling measures.
+enum class PedalStage : uint8_t {
+  HidRead = 0,   // source read(): draining and decoding the HID report
+  Calibrate,     // raw counts -> [0, 1]
+  Curve,         // response-curve lookup
+  Filter,        // noise filter stage
+  VJoyWrite,     // backend write() on the vJoy writer thread
+  InputToEmit,   // report timestamp -> handed to the output sink
+  InputToVJoy,   // report timestamp -> vJoy write completed
+  TickJitter,    // tick deadline -> engine loop reaching it (wake-up lateness, >= 0)
+};
+
+constexpr size_t kPedalStageCount = 8;
+
+const char* stage_name(PedalStage stage);
+
+struct StageSummary {
+  uint64_t count = 0;
+  uint64_t min_ns = 0;
+  uint64_t p50_ns = 0;
+  uint64_t p99_ns = 0;
+  uint64_t p999_ns = 0;
+  uint64_t max_ns = 0;
+  double mean_ns = 0.0;
+  double jitter_ns = 0.0;  // standard deviation
+};
+
+struct PipelineStatsSnapshot {
+  uint64_t taken_at_ns = 0;
+  std::array<HistogramSnapshot, kPedalStageCount> stages{};
+
+  StageSummary summary(PedalStage stage) const;
+
+  // Stats endpoint payload: {"taken_at_ns":..,"stages":{"hid_read":{...},..}}
+  std::string to_json() const;
+
+  // Appends one row per stage to `path`, writing the header first if the file
+  // is new, so periodic dumps build a time series that can be diffed across
+  // driver or OS updates. Returns false on I/O error.
+  bool append_csv(const std::string& path) const;
+};
+
+// Shared by the engine thread (read/calibrate/curve/filter/emit/jitter) and
+// the vJoy writer thread (write, input-to-vJoy). Recording is lock-free and
+// allocation-free; snapshot() and reset() may be called from any thread.
+class PipelineStats {
+ public:
+  void record(PedalStage stage, uint64_t ns) {
+    histograms_[static_cast<size_t>(stage)].record(ns);
+  }
+
+  PipelineStatsSnapshot snapshot() const;
+  void reset();
+
+ private:
+  std::array<LatencyHistogram, kPedalStageCount> histograms_;
+};
+
+}  // namespace trackpro::pedals
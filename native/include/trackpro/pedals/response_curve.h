@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace trackpro::pedals {
+
+struct CurvePoint {
+  float x = 0.0f;
+  float y = 0.0f;
+};
+
+// Piecewise-linear pedal response curve over [0, 1] -> [0, 1], as edited in
+// the calibration UI. Points are kept sorted by x; the ends are implicitly
+// clamped to the first and last point.
+class ResponseCurve {
+ public:
+  ResponseCurve();  // identity
+  explicit ResponseCurve(std::vector<CurvePoint> points);
+
+  // Named presets used by the calibration UI: "linear", "progressive",
+  // "aggressive", "s-curve".
+  static ResponseCurve preset(const std::string& name);
+
+  float evaluate(float x) const;
+
+  const std::vector<CurvePoint>& points() const { return points_; }
+
+ private:
+  std::vector<CurvePoint> points_;
+};
+
+}  // namespace trackpro::pedals
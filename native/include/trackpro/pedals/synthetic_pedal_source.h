@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+
+#include "trackpro/pedals/pedal_source.h"
+
+namespace trackpro::pedals {
+
+struct SyntheticPedalOptions {
+  uint32_t report_rate_hz = 1000;  // how often the fake device "sends"
+  float noise_counts = 0.0f;       // gaussian sensor noise, in raw counts
+  uint32_t seed = 1;
+};
+
+// Generates plausible pedal motion (throttle sweeps, brake stabs with a
+// load-cell style plateau, occasional clutch and handbrake) on a fixed report
+// clock, as if a USB device were pushing reports. Used for latency benchmarks
+// and for running the engine on machines without pedals.
+class SyntheticPedalSource final : public PedalSource {
+ public:
+  explicit SyntheticPedalSource(SyntheticPedalOptions options = {});
+
+  bool wait(uint64_t deadline_ns, uint64_t spin_ns) override;
+  bool read(RawPedalSample& out) override;
+  const char* name() const override { return "synthetic"; }
+
+  // The clean signal at `t_seconds`, without noise; useful as ground truth.
+  static RawPedalSample generate(double t_seconds);
+
+  uint64_t missed_reports() const { return missed_reports_; }
+
+ private:
+  SyntheticPedalOptions options_;
+  uint64_t period_ns_;
+  uint64_t start_ns_;
+  uint64_t next_report_ns_;
+  uint64_t missed_reports_ = 0;
+  std::mt19937 rng_;
+  std::normal_distribution<float> noise_;
+};
+
+}  // namespace trackpro::pedals
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "trackpro/common/seqlock.h"
+#include "trackpro/pedals/vjoy_report.h"
+
+namespace trackpro::pedals {
+
+// Destination for vJoy reports. Called only from the output stage's writer
+// thread, so implementations may block (driver calls) without stalling the
+// pedal thread.
+class VJoyBackend {
+ public:
+  virtual ~VJoyBackend() = default;
+  // False if the report did not reach the device; the output stage retries
+  // it until it does or a newer report replaces it.
+  virtual bool write(const VJoyReport& report) = 0;
+  virtual const char* name() const = 0;
+};
+
+// Keeps the most recent report in memory. Used by benchmarks and by the UI
+// preview when no driver is installed.
+class MemoryVJoyBackend final : public VJoyBackend {
+ public:
+  bool write(const VJoyReport& report) override;
+  const char* name() const override { return "memory"; }
+
+  // Reader side; safe from any thread. Returns false before the first write.
+  bool last(VJoyReport& out) const;
+  uint64_t writes() const { return writes_.load(std::memory_order_acquire); }
+
+ private:
+  SeqLock<VJoyReport> last_;
+  std::atomic<uint64_t> writes_{0};
+};
+
+#if defined(__linux__)
+// Creates a virtual joystick through /dev/uinput with the same 8-axis,
+// 32-button shape as the vJoy device, so games and `evtest` on Linux see the
+// output exactly as Windows titles see vJoy.
+class UinputVJoyBackend final : public VJoyBackend {
+ public:
+  // Throws std::system_error if uinput is unavailable.
+  explicit UinputVJoyBackend(const std::string& device_name = "TrackPro Virtual Pedals");
+  ~UinputVJoyBackend() override;
+
+  UinputVJoyBackend(const UinputVJoyBackend&) = delete;
+  UinputVJoyBackend& operator=(const UinputVJoyBackend&) = delete;
+
+  bool write(const VJoyReport& report) override;
+  const char* name() const override { return "uinput"; }
+
+ private:
+  int fd_ = -1;
+  VJoyReport previous_{};
+};
+#endif
+
+}  // namespace trackpro::pedals
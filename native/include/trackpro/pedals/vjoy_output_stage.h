@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include "trackpro/common/spsc_ring.h"
+#include "trackpro/pedals/pedal_engine.h"
+#include "trackpro/pedals/pipeline_stats.h"
+#include "trackpro/pedals/vjoy_backend.h"
+#include "trackpro/pedals/vjoy_report.h"
+
+namespace trackpro::pedals {
+
+struct VJoyOutputCounters {
+  uint64_t pushed = 0;          // reports accepted into the ring
+  uint64_t overruns = 0;        // reports rejected because the ring was full
+  uint64_t drops = 0;           // queued reports superseded before being written
+  uint64_t written = 0;         // reports handed to the backend successfully
+  uint64_t backend_errors = 0;  // backend write() returned false (each retry counts)
+};
+
+struct VJoyOutputOptions {
+  VJoyAxisMap axis_map{};
+  int cpu = -1;
+  // Writer-thread idle strategy: spin this many polls, then sleep this long.
+  uint32_t idle_spins = 256;
+  uint64_t idle_sleep_ns = 20'000;
+  // Receives VJoyWrite and InputToVJoy timings; usually the same object the
+  // engine records into.
+  PipelineStats* stats = nullptr;
+};
+
+// Decouples the pedal thread from the vJoy driver. The engine calls emit() on
+// its own thread; the report is pushed into a wait-free SPSC ring and a
+// separate writer thread hands it to the backend. Only the newest queued
+// report is ever written - a joystick only cares about current state - so a
+// slow backend costs dropped intermediates, never a stalled pedal loop. A
+// report the backend failed to write is retried while the writer is idle,
+// so the device never stays behind pedals that have stopped moving.
+class VJoyOutputStage final : public PedalOutputSink {
+ public:
+  static constexpr size_t kRingCapacity = 256;
+
+  explicit VJoyOutputStage(std::unique_ptr<VJoyBackend> backend, VJoyOutputOptions options = {});
+  ~VJoyOutputStage() override;
+
+  VJoyOutputStage(const VJoyOutputStage&) = delete;
+  VJoyOutputStage& operator=(const VJoyOutputStage&) = delete;
+
+  void start();
+  void stop();  // drains anything still queued before returning
+
+  // Producer side: pedal engine thread only.
+  void emit(const PedalOutput& output) override;
+
+  // Button state merged into every subsequent report; any thread.
+  void set_buttons(uint32_t buttons) { buttons_.store(buttons, std::memory_order_relaxed); }
+
+  VJoyOutputCounters counters() const;
+  VJoyBackend& backend() { return *backend_; }
+
+ private:
+  void run();
+  bool drain();
+
+  std::unique_ptr<VJoyBackend> backend_;
+  VJoyOutputOptions options_;
+  SpscRing<VJoyReport, kRingCapacity> ring_;
+  std::atomic<uint32_t> buttons_{0};
+  VJoyReport retry_{};  // writer thread only
+  bool retry_pending_ = false;
+
+  std::thread thread_;
+  std::atomic<bool> running_{false};
+
+  std::atomic<uint64_t> pushed_{0};
+  std::atomic<uint64_t> overruns_{0};
+  std::atomic<uint64_t> drops_{0};
+  std::atomic<uint64_t> written_{0};
+  std::atomic<uint64_t> backend_errors_{0};
+};
+
+}  // namespace trackpro::pedals
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "trackpro/pedals/pedal_types.h"
+
+namespace trackpro::pedals {
+
+// vJoy devices are configured by the installer with 8 axes and 32 buttons.
+constexpr size_t kVJoyAxisCount = 8;
+constexpr size_t kVJoyButtonCount = 32;
+
+// vJoy axis range: 0x1..0x8000.
+constexpr int32_t kVJoyAxisMin = 0x1;
+constexpr int32_t kVJoyAxisMax = 0x8000;
+
+// Names follow vJoy's HID usages in order.
+enum class VJoyAxis : uint8_t { X = 0, Y, Z, RX, RY, RZ, Slider0, Slider1 };
+
+struct VJoyReport {
+  uint64_t sequence = 0;
+  uint64_t input_timestamp_ns = 0;  // carried through for latency accounting
+  std::array<int32_t, kVJoyAxisCount> axes{};
+  uint32_t buttons = 0;  // bit n = button n+1
+};
+
+// Which vJoy axis each pedal drives.
+struct VJoyAxisMap {
+  std::array<VJoyAxis, kPedalAxisCount> target{VJoyAxis::X, VJoyAxis::Y, VJoyAxis::Z,
+                                               VJoyAxis::RX};
+};
+
+inline int32_t to_vjoy_axis(float value) {
+  const float v = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+  return kVJoyAxisMin + static_cast<int32_t>(v * static_cast<float>(kVJoyAxisMax - kVJoyAxisMin) + 0.5f);
+}
+
+}  // namespace trackpro::pedals
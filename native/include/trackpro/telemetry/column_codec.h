@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace trackpro::telemetry {
+
+enum class ChannelType : uint8_t {
+  Float32 = 0,
+  Float64 = 1,
+  Int32 = 2,
+};
+
+constexpr size_t channel_type_size(ChannelType type) { return type == ChannelType::Float64 ? 8 : 4; }
+const char* channel_type_name(ChannelType type);
+
+// Encodings for one column chunk (one channel of one lap). Stored in the
+// chunk directory, so new codecs can be added without a format bump.
+enum class ColumnCodec : uint8_t {
+  Raw = 0,
+  // Floats are mapped to order-preserving integers (so nearby values have
+  // nearby bit patterns, across zero too); consecutive differences are
+  // zigzag-varint coded. Lossless. Smooth telemetry needs 1-3 bytes/value.
+  DeltaVarint = 1,
+  // Same integer mapping; differences (PackedDelta) or differences of
+  // differences (PackedDeltaDelta) are zigzagged and bit-packed in blocks of
+  // 128 at the block's widest width, four interleaved lanes so SSE2 unpacks
+  // and prefix-sums four values at a time. Delta-of-delta suits channels
+  // with a steady slope (SessionTime, LapDist, lap timers), where residuals
+  // are a few bits.
+  PackedDelta = 2,
+  PackedDeltaDelta = 3,
+  // Gorilla-style XOR of each float's bits with the previous one, storing
+  // only the meaningful bits. Wins on channels that repeat or change in the
+  // low mantissa only. Floats only.
+  Xor = 4,
+  // (value, run length) pairs. Booleans, gear, flags and stale channels.
+  RunLength = 5,
+};
+
+const char* codec_name(ColumnCodec codec);
+
+// Appends `count` values of `type` to `out` with whichever codec gives the
+// smallest chunk (raw if none is smaller). Returns the codec used.
+ColumnCodec encode_column(ChannelType type, const void* values, size_t count, std::vector<uint8_t>& out);
+
+// Decodes exactly `count` values into `out`. Returns false if the chunk is
+// truncated or has trailing bytes.
+bool decode_column(ColumnCodec codec, ChannelType type, const uint8_t* data, size_t size, size_t count,
+                   void* out);
+
+// Encodes with one specific codec (Raw included); for benchmarks and tests
+// of individual codecs. Returns false if the codec does not apply to `type`.
+bool encode_column_as(ColumnCodec codec, ChannelType type, const void* values, size_t count,
+                      std::vector<uint8_t>& out);
+
+}  // namespace trackpro::telemetry
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "trackpro/common/thread_pool.h"
+#include "trackpro/telemetry/lap_store.h"
+#include "trackpro/telemetry/track_index.h"
+#include "trackpro/telemetry/track_model.h"
+
+namespace trackpro::telemetry {
+
+// One lap through one corner. Distances are LapDist in metres; a metric
+// that did not occur (no braking, no throttle pickup) is NaN.
+struct CornerMetrics {
+  uint32_t source = 0;  // index into CornerMetricsTable::sources()
+  uint32_t lap = 0;     // lap index within that source
+  uint16_t corner = 0;  // index into the table's corners
+  bool valid = false;   // lap flagged valid and the corner was measurable
+  float brake_point_m = 0.0f;     // first brake application in the approach
+  float entry_speed = 0.0f;       // m/s at the brake point (or corner start)
+  float min_speed = 0.0f;         // m/s
+  float min_speed_m = 0.0f;
+  float throttle_point_m = 0.0f;  // first throttle application after the minimum
+  float trail_brake_s = 0.0f;     // braking past the corner start (turn-in)
+  float coasting_s = 0.0f;        // neither pedal applied, approach to exit
+  float corner_time_s = 0.0f;     // corner start to end
+};
+
+// Running aggregate over the valid rows of one corner. Brake and throttle
+// points average only the laps where they occurred, and stay NaN if none did.
+struct CornerSummary {
+  uint32_t laps = 0;
+  float best_min_speed = 0.0f;
+  float mean_min_speed = 0.0f;
+  float mean_brake_point_m = std::numeric_limits<float>::quiet_NaN();
+  float latest_brake_point_m = std::numeric_limits<float>::quiet_NaN();
+  float mean_throttle_point_m = std::numeric_limits<float>::quiet_NaN();
+  float mean_trail_brake_s = 0.0f;
+  float mean_coasting_s = 0.0f;
+  float best_corner_time_s = 0.0f;
+  float mean_corner_time_s = 0.0f;
+};
+
+struct CornerMetricsOptions {
+  float brake_on = 0.05f;         // pedal fraction that counts as applied
+  float throttle_on = 0.2f;
+  float approach_m = 250.0f;      // how far before the corner to look for braking (not past the previous corner's exit)
+  size_t laps_per_claim = 4;      // parallel_for grain
+};
+
+// Per-corner metrics for every stored lap of one track/car combination.
+// update() computes rows only for laps it has not seen, in parallel, and
+// folds them into per-corner summaries, so refreshing a view after a
+// session costs the new laps only.
+//
+// Not thread-safe: owned by one analysis thread; the work inside update()
+// runs on the pool.
+class CornerMetricsTable {
+ public:
+  explicit CornerMetricsTable(std::vector<TrackCorner> corners, CornerMetricsOptions options = {});
+
+  // Adds laps [already seen, lap_count) of the store named `source` (its
+  // path). Stores need LapDist, Speed, Throttle and Brake. Returns the
+  // number of laps added.
+  size_t update(const std::string& source, const LapStore& store, ThreadPool& pool);
+
+  const std::vector<TrackCorner>& corners() const { return corners_; }
+  const std::vector<std::string>& sources() const { return sources_; }
+  // Lap-major: every corner of a lap is contiguous.
+  const std::vector<CornerMetrics>& rows() const { return rows_; }
+  const CornerSummary& summary(size_t corner) const { return summaries_[corner]; }
+  size_t lap_count() const { return corners_.empty() ? 0 : rows_.size() / corners_.size(); }
+
+ private:
+  struct Totals {
+    uint32_t braked = 0;
+    uint32_t throttled = 0;
+    double min_speed = 0.0;
+    double brake_point = 0.0;
+    double throttle_point = 0.0;
+    double trail_brake = 0.0;
+    double coasting = 0.0;
+    double corner_time = 0.0;
+  };
+
+  struct Channels {
+    size_t distance;
+    size_t speed;
+    size_t throttle;
+    size_t brake;
+  };
+
+  void measure_lap(const LapStore& store, const Channels& channels, size_t lap, CornerMetrics* out) const;
+  void fold(const CornerMetrics& row);
+
+  std::vector<TrackCorner> corners_;
+  CornerMetricsOptions options_;
+  std::vector<std::string> sources_;
+  std::vector<size_t> seen_;  // laps consumed per source
+  std::vector<CornerMetrics> rows_;
+  std::vector<CornerSummary> summaries_;
+  std::vector<Totals> totals_;
+};
+
+// Tables per track/car, rebuilt from scratch when the track model's corners
+// change and otherwise updated incrementally. Same threading rules as the
+// table.
+class CornerMetricsCache {
+ public:
+  explicit CornerMetricsCache(ThreadPool& pool, CornerMetricsOptions options = {});
+
+  // `stores` are (path, store) pairs for every session of the combination.
+  const CornerMetricsTable& update(const std::string& track_id, const std::string& car, const TrackModel& model,
+                                   const std::vector<std::pair<std::string, const LapStore*>>& stores);
+
+ private:
+  ThreadPool& pool_;
+  CornerMetricsOptions options_;
+  std::map<std::string, std::unique_ptr<CornerMetricsTable>> tables_;
+};
+
+}  // namespace trackpro::telemetry
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "trackpro/common/mapped_region.h"
+#include "trackpro/telemetry/irsdk_layout.h"
+
+namespace trackpro::telemetry {
+
+// Everything in an .ibt file except the sample records: headers, variable
+// table and session YAML. Small (tens of KB) and parsed once per file.
+class IbtLayout {
+ public:
+  // Parses from the start of a file image; `size` must cover at least the
+  // header, variable table and session info. Throws std::runtime_error.
+  static IbtLayout parse(const uint8_t* data, size_t size);
+
+  // Reads just the non-record prefix of `path` (no mapping, no record I/O).
+  static IbtLayout read(const std::string& path);
+
+  const IrsdkHeader& header() const { return header_; }
+  const IrsdkDiskSubHeader& disk_header() const { return disk_; }
+  const std::vector<IrsdkVarHeader>& vars() const { return vars_; }
+  const std::string& session_info() const { return session_info_; }
+
+  // Index into vars(), or -1.
+  int find_var(std::string_view name) const;
+
+  uint64_t records_offset() const { return static_cast<uint64_t>(header_.varBuf[0].bufOffset); }
+  size_t record_size() const { return static_cast<size_t>(header_.bufLen); }
+  // Record count from the disk header, clamped to what the file holds.
+  size_t record_count() const { return record_count_; }
+
+ private:
+  friend class IbtFile;
+
+  // Falls back to counting whole records when the writer never patched the
+  // disk header (sim crashed mid-session) or claims more than exists.
+  void clamp_record_count(uint64_t file_size);
+
+  IrsdkHeader header_{};
+  IrsdkDiskSubHeader disk_{};
+  std::vector<IrsdkVarHeader> vars_;
+  std::string session_info_;
+  size_t record_count_ = 0;
+};
+
+// Memory-mapped .ibt file for random access to records.
+class IbtFile {
+ public:
+  static IbtFile open(const std::string& path);
+
+  const IbtLayout& layout() const { return layout_; }
+  const uint8_t* record(size_t index) const {
+    return region_.data() + layout_.records_offset() + index * layout_.record_size();
+  }
+
+ private:
+  MappedRegion region_;
+  IbtLayout layout_;
+};
+
+struct IbtVarSpec {
+  std::string name;
+  IrsdkVarType type = IrsdkVarType::Float;
+  int count = 1;
+  std::string unit;
+  std::string desc;
+};
+
+// Writes .ibt files in iRacing's layout. Used to synthesise sessions for
+// Linux testing and benchmarks; real files come from the sim.
+class IbtWriter {
+ public:
+  // Throws std::system_error if the file cannot be created.
+  IbtWriter(const std::string& path, const std::vector<IbtVarSpec>& vars, int tick_rate,
+            const std::string& session_info);
+  ~IbtWriter();
+
+  IbtWriter(const IbtWriter&) = delete;
+  IbtWriter& operator=(const IbtWriter&) = delete;
+
+  size_t record_size() const { return static_cast<size_t>(header_.bufLen); }
+  // Row offset of a variable by spec index, in the same order as `vars`.
+  int32_t offset(size_t var_index) const { return vars_[var_index].offset; }
+
+  bool append(const uint8_t* record);
+  // Writes the final record and lap counts. Idempotent.
+  bool close(int32_t lap_count = 0);
+
+  size_t records() const { return records_; }
+
+ private:
+  std::FILE* file_ = nullptr;
+  IrsdkHeader header_{};
+  IrsdkDiskSubHeader disk_{};
+  std::vector<IrsdkVarHeader> vars_;
+  size_t records_ = 0;
+  bool ok_ = true;
+};
+
+}  // namespace trackpro::telemetry
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "trackpro/common/thread_pool.h"
+#include "trackpro/telemetry/lap_store.h"
+
+namespace trackpro::telemetry {
+
+struct IbtImportOptions {
+  // irsdk variable names to import; empty imports every scalar variable.
+  // Array variables (CarIdx*) are skipped.
+  std::vector<std::string> channels;
+  size_t chunk_records = 4096;
+  unsigned threads = 0;            // 0 = one per core
+  size_t max_chunks_in_flight = 0; // read-ahead bound; 0 = 2 per thread
+};
+
+struct IbtImportStats {
+  uint64_t records = 0;
+  uint64_t laps = 0;
+  uint64_t bytes_read = 0;
+  uint64_t bytes_written = 0;
+  double seconds = 0.0;
+
+  double mb_per_second() const { return seconds > 0.0 ? static_cast<double>(bytes_read) / 1e6 / seconds : 0.0; }
+};
+
+// Streams an .ibt file into a lap store. The header and variable table are
+// parsed once; records are read sequentially in fixed-size chunks, and a
+// thread pool transposes each chunk into columns and encodes finished laps
+// while the calling thread reads ahead and writes laps in order. Memory is
+// bounded by the read-ahead window plus the laps being assembled, not by the
+// file size.
+class IbtImporter {
+ public:
+  explicit IbtImporter(IbtImportOptions options = {});
+
+  // Creates `store_path`. Throws std::runtime_error / std::system_error.
+  IbtImportStats import(const std::string& ibt_path, const std::string& store_path);
+
+ private:
+  IbtImportOptions options_;
+  ThreadPool pool_;
+};
+
+}  // namespace trackpro::telemetry
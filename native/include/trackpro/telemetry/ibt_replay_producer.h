@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "trackpro/common/mapped_region.h"
+#include "trackpro/telemetry/ibt_file.h"
+
+namespace trackpro::telemetry {
+
+// Plays an .ibt file into a memory region laid out exactly like iRacing's
+// live IRSDKMemMapFileName: header, variable table, session YAML, then
+// `num_buffers` rotating rows. Lets IrsdkReader run on Linux against
+// /dev/shm, and gives benchmarks a deterministic sim.
+class IbtReplayProducer {
+ public:
+  // Creates the region at `region_path` (a /dev/shm path on Linux, a mapping
+  // name on Windows). Throws std::system_error / std::invalid_argument.
+  IbtReplayProducer(std::shared_ptr<const IbtFile> file, const std::string& region_path,
+                    int num_buffers = 3);
+  ~IbtReplayProducer();
+
+  IbtReplayProducer(const IbtReplayProducer&) = delete;
+  IbtReplayProducer& operator=(const IbtReplayProducer&) = delete;
+
+  // Publishes the next record and returns false at end of file (unless
+  // looping). Single writer: call from one thread, or use start().
+  bool step(bool loop = false);
+
+  // Publishes on a thread at `speed` times the file's tick rate; speed <= 0
+  // publishes as fast as possible. A paced thread that falls behind resumes
+  // the cadence rather than catching up in a burst.
+  void start(double speed = 1.0, bool loop = true);
+  void stop();
+
+  // Clears the connected bit, as the sim does on exit.
+  void disconnect();
+
+  uint64_t published() const { return published_.load(std::memory_order_relaxed); }
+  size_t region_size() const { return region_.size(); }
+
+ private:
+  void run(double speed, bool loop);
+
+  std::shared_ptr<const IbtFile> file_;
+  MappedRegion region_;
+  IrsdkHeader* header_ = nullptr;
+  int num_buffers_ = 3;
+  size_t next_record_ = 0;
+  int32_t tick_ = 0;
+  std::atomic<uint64_t> published_{0};
+  std::atomic<bool> running_{false};
+  std::thread thread_;
+};
+
+}  // namespace trackpro::telemetry
@@ -0,0 +1,95 @@
+#pragma once
+
+// Binary layout of iRacing's telemetry interface (irsdk_defines.h), shared by
+// the live memory-mapped file and .ibt disk files. Field names follow the SDK
+// so they can be cross-checked against it.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace trackpro::telemetry {
+
+constexpr const char* kIrsdkMemMapName = "Local\\IRSDKMemMapFileName";
+constexpr const char* kIrsdkDataValidEventName = "Local\\IRSDKDataValidEvent";
+
+constexpr int kIrsdkMaxBufs = 4;
+constexpr int kIrsdkMaxString = 32;
+constexpr int kIrsdkMaxDesc = 64;
+constexpr int kIrsdkVersion = 2;
+
+enum IrsdkStatus : int32_t { kIrsdkStatusConnected = 1 };
+
+enum class IrsdkVarType : int32_t {
+  Char = 0,
+  Bool = 1,
+  Int = 2,
+  BitField = 3,
+  Float = 4,
+  Double = 5,
+};
+
+constexpr size_t irsdk_type_size(IrsdkVarType type) {
+  switch (type) {
+    case IrsdkVarType::Char:
+    case IrsdkVarType::Bool:
+      return 1;
+    case IrsdkVarType::Int:
+    case IrsdkVarType::BitField:
+    case IrsdkVarType::Float:
+      return 4;
+    case IrsdkVarType::Double:
+      return 8;
+  }
+  return 0;
+}
+
+#pragma pack(push, 4)
+
+struct IrsdkVarBuf {
+  int32_t tickCount;  // used to detect changes in data
+  int32_t bufOffset;  // offset from header
+  int32_t pad[2];
+};
+
+struct IrsdkHeader {
+  int32_t ver;
+  int32_t status;  // bitfield of IrsdkStatus
+  int32_t tickRate;
+  int32_t sessionInfoUpdate;  // incremented when the session YAML changes
+  int32_t sessionInfoLen;
+  int32_t sessionInfoOffset;
+  int32_t numVars;
+  int32_t varHeaderOffset;
+  int32_t numBuf;
+  int32_t bufLen;
+  int32_t pad1[2];
+  IrsdkVarBuf varBuf[kIrsdkMaxBufs];
+};
+
+// Follows IrsdkHeader in .ibt files only.
+struct IrsdkDiskSubHeader {
+  int64_t sessionStartDate;  // time_t
+  double sessionStartTime;
+  double sessionEndTime;
+  int32_t sessionLapCount;
+  int32_t sessionRecordCount;
+};
+
+struct IrsdkVarHeader {
+  IrsdkVarType type;
+  int32_t offset;  // offset from the start of a telemetry row
+  int32_t count;   // > 1 for arrays
+  bool countAsTime;
+  char pad[3];
+  char name[kIrsdkMaxString];
+  char desc[kIrsdkMaxDesc];
+  char unit[kIrsdkMaxString];
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(IrsdkHeader) == 112, "irsdk_header layout");
+static_assert(sizeof(IrsdkDiskSubHeader) == 32, "irsdk_diskSubHeader layout");
+static_assert(sizeof(IrsdkVarHeader) == 144, "irsdk_varHeader layout");
+
+}  // namespace trackpro::telemetry
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "trackpro/common/mapped_region.h"
+#include "trackpro/telemetry/irsdk_layout.h"
+
+namespace trackpro::telemetry {
+
+// One telemetry row inside the shared-memory ring. The row is read in place:
+// nothing is copied. The sim rotates through numBuf (3) buffers, so a row
+// stays intact for roughly numBuf-1 ticks; check still_valid() after reading
+// to detect the rare case where the reader fell that far behind.
+struct IrsdkFrame {
+  const uint8_t* row = nullptr;
+  int32_t tick = -1;
+  const volatile int32_t* tick_slot = nullptr;
+
+  bool still_valid() const;
+};
+
+// Typed, pre-resolved accessor for one variable. Holds only an offset, so
+// reading is a single unaligned load from the frame; no lookup, no copy of
+// the row, no allocation.
+template <typename T>
+class IrsdkVar {
+ public:
+  IrsdkVar() = default;
+
+  bool bound() const { return offset_ >= 0; }
+  int count() const { return count_; }
+
+  T get(const IrsdkFrame& frame, int index = 0) const {
+    T value;
+    std::memcpy(&value, frame.row + offset_ + static_cast<int32_t>(sizeof(T)) * index, sizeof(T));
+    return value;
+  }
+
+  // For array variables (e.g. CarIdxLapDistPct[64]): the raw elements in
+  // shared memory. irsdk rows are naturally aligned, so this is safe to
+  // dereference on x86 and ARM alike.
+  const T* data(const IrsdkFrame& frame) const {
+    return reinterpret_cast<const T*>(frame.row + offset_);
+  }
+
+ private:
+  friend class IrsdkReader;
+  IrsdkVar(int32_t offset, int32_t count) : offset_(offset), count_(count) {}
+
+  int32_t offset_ = -1;
+  int32_t count_ = 0;
+};
+
+enum class IrsdkPoll {
+  Disconnected,  // no sim, or the header is not valid yet
+  NoNewData,     // same tick as last poll
+  NewFrame,
+};
+
+struct IrsdkReaderCounters {
+  uint64_t frames = 0;         // NewFrame polls
+  uint64_t skipped_ticks = 0;  // ticks published but never observed
+  uint64_t layout_changes = 0;
+  uint64_t rejected_vars = 0;  // table entries dropped for lying outside the row
+};
+
+// Reads iRacing's live telemetry (or IbtReplayProducer's stand-in) straight
+// from the memory-mapped region. The variable table is indexed once per
+// session layout; after that poll() is a few loads of the buffer headers.
+//
+// Single-threaded: one reader per capture thread.
+class IrsdkReader {
+ public:
+  explicit IrsdkReader(MappedRegion region);
+
+  IrsdkPoll poll(IrsdkFrame& frame);
+
+  // Polls until a new frame arrives or `timeout_ns` elapses. On Windows this
+  // waits on the sim's data-valid event; elsewhere it sleeps in short steps.
+  IrsdkPoll wait_for_frame(IrsdkFrame& frame, uint64_t timeout_ns);
+
+  // Resolves a variable; unbound if absent, if T does not match its type
+  // (float/double/int32_t/bool/char; bitfields read as int32_t or uint32_t),
+  // or if the table placed it outside the bufLen-byte row.
+  template <typename T>
+  IrsdkVar<T> var(std::string_view name) const {
+    const IrsdkVarHeader* h = find(name);
+    if (h == nullptr || !type_matches<T>(h->type)) {
+      return {};
+    }
+    return IrsdkVar<T>(h->offset, h->count);
+  }
+
+  const IrsdkVarHeader* find(std::string_view name) const;
+
+  // Bumped whenever the variable table is re-indexed; bound IrsdkVars from an
+  // older revision must be re-resolved.
+  uint32_t layout_revision() const { return layout_revision_; }
+  // Bumped whenever the sim rewrites the session YAML.
+  int32_t session_info_update() const { return session_info_update_; }
+  // Zero-copy view of the session YAML.
+  std::string_view session_info() const;
+
+  int tick_rate() const { return header()->tickRate; }
+  const IrsdkReaderCounters& counters() const { return counters_; }
+
+ private:
+  template <typename T>
+  static bool type_matches(IrsdkVarType type) {
+    switch (type) {
+      case IrsdkVarType::Char:
+        return std::is_same_v<T, char>;
+      case IrsdkVarType::Bool:
+        return std::is_same_v<T, bool>;
+      case IrsdkVarType::Int:
+        return std::is_same_v<T, int32_t>;
+      case IrsdkVarType::BitField:
+        return std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t>;
+      case IrsdkVarType::Float:
+        return std::is_same_v<T, float>;
+      case IrsdkVarType::Double:
+        return std::is_same_v<T, double>;
+    }
+    return false;
+  }
+
+  const IrsdkHeader* header() const { return reinterpret_cast<const IrsdkHeader*>(region_.data()); }
+  bool layout_is_current() const;
+  bool reindex();
+
+  MappedRegion region_;
+  // (name, var header) sorted by name; names point into shared memory.
+  std::vector<std::pair<std::string_view, const IrsdkVarHeader*>> index_;
+  int32_t indexed_num_vars_ = -1;
+  int32_t indexed_var_offset_ = -1;
+  int32_t indexed_buf_len_ = -1;
+  uint32_t layout_revision_ = 0;
+  int32_t session_info_update_ = -1;
+  int32_t last_tick_ = -1;
+  IrsdkReaderCounters counters_;
+};
+
+}  // namespace trackpro::telemetry
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "trackpro/common/thread_pool.h"
+#include "trackpro/telemetry/lap_store.h"
+
+namespace trackpro::telemetry {
+
+// Zone maps for one lap store: min/max of selected channels over fixed
+// stretches of lap distance (100 m by default) for every lap. Lets queries
+// about part of a lap ("minimum speed through Eau Rouge") decide most laps
+// without decoding them. Built incrementally and saved beside the store.
+class LapZoneIndex {
+ public:
+  // Throws std::invalid_argument for a non-positive length or zone size.
+  LapZoneIndex(double track_length_m, std::vector<std::string> channels, float zone_m = 100.0f);
+
+  // Indexes laps [lap_count(), store.lap_count()), decoding LapDist and the
+  // indexed channels, in parallel when a pool is given. Returns laps added.
+  size_t update(const LapStore& store, ThreadPool* pool = nullptr);
+
+  size_t lap_count() const { return laps_; }
+  size_t zone_count() const { return zones_; }
+  float zone_m() const { return zone_m_; }
+  const std::vector<std::string>& channels() const { return channels_; }
+  int find_channel(const std::string& name) const;  // -1 if not indexed
+
+  // Zone z of an indexed channel; {+inf, -inf} if no sample fell in it.
+  float zone_min(size_t lap, size_t channel, size_t zone) const { return cells_[cell(lap, channel, zone)].min; }
+  float zone_max(size_t lap, size_t channel, size_t zone) const { return cells_[cell(lap, channel, zone)].max; }
+
+  // .tpz sidecar. save() returns false on I/O failure; load() throws
+  // std::runtime_error.
+  bool save(const std::string& path) const;
+  static LapZoneIndex load(const std::string& path);
+
+  size_t memory_bytes() const { return cells_.capacity() * sizeof(Cell); }
+
+ private:
+  struct Cell {
+    float min;
+    float max;
+  };
+
+  size_t cell(size_t lap, size_t channel, size_t zone) const {
+    return (lap * channels_.size() + channel) * zones_ + zone;
+  }
+  void index_lap(const LapStore& store, const std::vector<int>& columns, int distance, size_t lap);
+
+  double length_;
+  std::vector<std::string> channels_;
+  float zone_m_;
+  size_t zones_;
+  size_t laps_ = 0;
+  std::vector<Cell> cells_;  // [lap][channel][zone]
+};
+
+enum class Aggregate { Min, Max };
+enum class Compare { Less, Greater };
+
+// "<aggregate> of <channel> between from_m and to_m <compare> value". A
+// range with to_m <= from_m means the whole lap.
+struct ChannelPredicate {
+  std::string channel;
+  Aggregate aggregate = Aggregate::Min;
+  float from_m = 0.0f;
+  float to_m = 0.0f;
+  Compare compare = Compare::Greater;
+  double value = 0.0;
+};
+
+struct LapQuery {
+  std::string track;  // store metadata; empty matches any
+  std::string car;
+  uint32_t require_flags = kLapValid;
+  uint32_t exclude_flags = 0;
+  double min_lap_time_s = 0.0;
+  double max_lap_time_s = std::numeric_limits<double>::infinity();
+  std::vector<ChannelPredicate> where;  // all must hold
+};
+
+// One store to search, with its zone maps if it has them.
+struct QuerySource {
+  const LapStore* store = nullptr;
+  const LapZoneIndex* index = nullptr;
+};
+
+struct QueryHit {
+  uint32_t source;
+  uint32_t lap;
+};
+
+struct QueryStats {
+  uint64_t laps = 0;              // laps in the sources searched
+  uint64_t pruned_metadata = 0;   // wrong track/car, flags or lap time
+  uint64_t decided_by_stats = 0;  // settled by chunk min/max or zone maps
+  uint64_t decoded_laps = 0;      // needed decoding to decide
+  uint64_t decoded_chunks = 0;
+};
+
+struct QueryResult {
+  std::vector<QueryHit> hits;  // in source, then lap order
+  QueryStats stats;
+};
+
+// Evaluates cheapest first: store metadata, lap flags and time, whole-lap
+// predicates against the store's exact per-chunk min/max, ranged predicates
+// against zone maps. Only laps the statistics cannot decide are decoded, and
+// then only LapDist and the channels their predicates name.
+QueryResult run_query(const std::vector<QuerySource>& sources, const LapQuery& query, ThreadPool* pool = nullptr);
+
+}  // namespace trackpro::telemetry
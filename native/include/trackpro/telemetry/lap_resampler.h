@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace trackpro::telemetry {
+
+// Maps laps from time samples onto a fixed track-distance grid (0, step,
+// 2*step, ... track length), so any two laps of a track line up point for
+// point and comparing them is a plain array operation.
+//
+// plan() walks the lap's distance channel once and records, for every grid
+// point, the sample segment it falls in and the interpolation weight.
+// apply() then resamples any number of channels with that plan: a gather of
+// the segment ends and one multiply-add per point, four points per SIMD op.
+class DistanceResampler {
+ public:
+  // Throws std::invalid_argument for a non-positive length or step.
+  explicit DistanceResampler(double track_length_m, double step_m = 0.5);
+
+  size_t points() const { return points_; }
+  double step() const { return step_; }
+  double track_length() const { return length_; }
+
+  // `distance_m` is LapDist for each sample. Leading ticks that still carry
+  // the previous lap's LapDist (see lagging_lap_start()) are unwrapped to
+  // just before the line; later glitches where it steps backwards (spins) are
+  // held at the running maximum. Grid points outside the lap's range clamp
+  // to its ends. Returns false if there are fewer than two samples.
+  bool plan(const float* distance_m, size_t count);
+
+  // `out` holds points() values. Uses the most recent plan().
+  void apply(const float* channel, float* out) const;
+  void apply(const double* channel, double* out) const;
+
+  // Several channels in one pass over the plan; out[c] holds points() values.
+  void apply(const std::vector<const float*>& channels, const std::vector<float*>& out) const;
+
+  // The plan, for callers that cache or inspect it.
+  const std::vector<int32_t>& segment_index() const { return index_; }
+  const std::vector<float>& segment_weight() const { return weight_; }
+
+ private:
+  double length_;
+  double step_;
+  size_t points_;
+  std::vector<int32_t> index_;  // padded to a multiple of 4
+  std::vector<float> weight_;
+  std::vector<float> monotonic_;
+};
+
+// Number of leading samples that still carry the previous lap's LapDist:
+// the first ticks after the line can report a distance near the track
+// length before it wraps to zero. These are the samples before the first
+// drop of more than half a lap, provided they all sit in the second half of
+// `track_length_m`. Zero for a lap that starts cleanly.
+size_t lagging_lap_start(const float* distance_m, size_t count, double track_length_m);
+
+// out[i] = a[i] - b[i]; the lap-vs-lap comparison once both are resampled.
+void subtract(const float* a, const float* b, float* out, size_t count);
+
+}  // namespace trackpro::telemetry
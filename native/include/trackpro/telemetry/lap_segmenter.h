@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "trackpro/telemetry/lap_store.h"
+#include "trackpro/telemetry/telemetry_sample.h"
+
+namespace trackpro::telemetry {
+
+constexpr int kMaxSectors = 16;
+
+enum class LapEnd : uint8_t {
+  Completed,   // crossed start/finish
+  Reset,       // car reset, tow, or LapDistPct jump
+  SessionEnd,  // finish() with a lap in progress
+};
+
+const char* lap_end_name(LapEnd end);
+
+// A closed lap. Samples [first_sample, first_sample + info.sample_count)
+// belong to it; the sample that closed it is the first of the next lap.
+struct SegmentedLap {
+  LapInfo info;
+  LapEnd end = LapEnd::Completed;
+  uint64_t first_sample = 0;
+  double end_session_time = 0.0;
+  int sector_count = 0;
+  std::array<double, kMaxSectors> sector_times{};  // s; only whole sectors
+};
+
+struct SectorTime {
+  int32_t lap_number = 0;
+  int sector = 0;
+  double time_s = 0.0;
+  double end_session_time = 0.0;
+};
+
+class LapListener {
+ public:
+  virtual ~LapListener() = default;
+  virtual void on_lap(const SegmentedLap& lap) = 0;
+  virtual void on_sector(const SectorTime&) {}
+  // Timing began; `lap` has the number, start time and initial flags.
+  virtual void on_lap_start(const LapInfo&) {}
+};
+
+struct LapSegmenterOptions {
+  // LapDistPct at which sectors 2..n start; empty means one sector per lap.
+  // See parse_sector_splits() for reading iRacing's SplitTimeInfo.
+  std::vector<float> sector_splits;
+  // A tick-to-tick LapDistPct change larger than this (and not a wrap at
+  // start/finish) is a reset or tow.
+  float reset_jump_pct = 0.05f;
+  // Start/finish is crossed when LapDistPct goes from above 1-window to
+  // below window.
+  float wrap_window = 0.2f;
+  float sample_rate_hz = 60.0f;
+};
+
+// Incremental lap and sector splitter driven by the live LapDistPct stream.
+// Constant work per sample: one comparison against the next sector split
+// and the start/finish line, with boundary times interpolated between
+// ticks. Laps are delivered to the listener from inside push() the moment
+// they close.
+//
+//  - Timing starts at a start/finish crossing or at pit exit (out lap). A
+//    stream that begins on track opens an incomplete lap at once.
+//  - Touching pit road marks the lap as an in lap; it still closes at the
+//    line.
+//  - Leaving the track (tow, IsOnTrack false), a LapDistPct jump (reset) or
+//    rolling backwards over the line aborts the lap as incomplete; timing
+//    resumes at the next crossing or pit exit.
+//
+// Only laps with none of those flags are marked kLapValid.
+class LapSegmenter {
+ public:
+  explicit LapSegmenter(LapListener& listener, LapSegmenterOptions options = {});
+
+  void push(const TelemetrySample& sample);
+  // Emits the lap in progress, if any, as incomplete.
+  void finish();
+
+  bool lap_in_progress() const { return timing_; }
+  uint64_t samples() const { return index_; }
+  const LapSegmenterOptions& options() const { return options_; }
+
+ private:
+  void start_lap(const TelemetrySample& sample, double start_time, uint32_t flags);
+  void close_lap(double end_time, LapEnd end);
+
+  LapListener& listener_;
+  LapSegmenterOptions options_;
+  TelemetrySample previous_{};
+  bool have_previous_ = false;
+  bool timing_ = false;
+  uint64_t index_ = 0;
+
+  SegmentedLap lap_;
+  int next_sector_ = 0;
+  double sector_start_ = 0.0;
+};
+
+// SectorStartPct values after 0 from the session YAML's SplitTimeInfo.
+std::vector<float> parse_sector_splits(std::string_view session_yaml);
+
+}  // namespace trackpro::telemetry
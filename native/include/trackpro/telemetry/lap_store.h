@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "trackpro/common/mapped_region.h"
+#include "trackpro/telemetry/column_codec.h"
+
+namespace trackpro::telemetry {
+
+// Columnar lap history (.tpl). Every channel of every lap is its own
+// compressed chunk; a fixed-size directory after the chunks locates them and
+// carries per-lap metadata and per-chunk min/max. Readers map the file and
+// use the directory in place, so plotting one channel of one lap faults in
+// the directory entry and that chunk's pages, nothing else.
+//
+//   [header 64][chunk][chunk]...[channel table][lap table][chunk table][metadata][trailer 32]
+//
+// The file is append-only: each commit writes a new directory after the new
+// chunks and then moves the header's committed-end pointer (u64 at offset 8)
+// to its trailer. Bytes past that point are ignored.
+
+struct ChannelInfo {
+  std::string name;  // irsdk variable name, e.g. "Speed"
+  ChannelType type = ChannelType::Float32;
+  std::string unit;
+};
+
+enum LapFlags : uint32_t {
+  kLapValid = 1u << 0,       // complete, no off-tracks/resets
+  kLapOutLap = 1u << 1,      // started from the pits
+  kLapInLap = 1u << 2,       // ended in the pits
+  kLapIncomplete = 1u << 3,  // session ended or car reset mid-lap
+};
+
+struct LapInfo {
+  int32_t lap_number = 0;
+  uint32_t sample_count = 0;
+  uint32_t flags = 0;  // LapFlags
+  float sample_rate_hz = 60.0f;
+  double lap_time_s = 0.0;
+  double start_session_time = 0.0;
+};
+
+struct ChunkStats {
+  ColumnCodec codec = ColumnCodec::Raw;
+  uint32_t encoded_bytes = 0;
+  double min = 0.0;
+  double max = 0.0;
+};
+
+// Free-form session description, stored as "key=value" lines.
+struct LapStoreMetadata {
+  std::string track;
+  std::string car;
+  std::string driver;
+  int64_t session_start_unix = 0;
+};
+
+// One lap with every column already encoded. Produced by encode_lap(), which
+// is thread-safe, so importers can encode on many threads and write on one.
+struct EncodedLap {
+  LapInfo info;
+  std::vector<uint8_t> bytes;         // all chunks, back to back
+  std::vector<ChunkStats> chunks;     // per channel
+  std::vector<uint32_t> chunk_starts; // offset of each chunk within `bytes`
+};
+
+// `columns[c]` points at info.sample_count values of channels[c].type.
+EncodedLap encode_lap(const std::vector<ChannelInfo>& channels, const LapInfo& info,
+                      const std::vector<const void*>& columns);
+
+class LapStoreWriter {
+ public:
+  // Creates a new store; throws std::system_error / std::invalid_argument.
+  LapStoreWriter(const std::string& path, std::vector<ChannelInfo> channels, LapStoreMetadata metadata = {});
+  // Reopens an existing store to add laps (e.g. automatic lap saving across
+  // app restarts). Throws std::runtime_error on a damaged file.
+  static LapStoreWriter append_to(const std::string& path);
+  ~LapStoreWriter();
+
+  LapStoreWriter(LapStoreWriter&& other) noexcept;
+  LapStoreWriter& operator=(LapStoreWriter&&) = delete;
+  LapStoreWriter(const LapStoreWriter&) = delete;
+  LapStoreWriter& operator=(const LapStoreWriter&) = delete;
+
+  bool add_lap(const LapInfo& info, const std::vector<const void*>& columns);
+  bool write_lap(const EncodedLap& lap);
+
+  // Writes the directory and trailer after the last chunk, syncs, then
+  // publishes them in the header. Nothing committed is ever overwritten, so
+  // calling this after every saved lap keeps the file valid at all times: a
+  // crash loses at most the laps since the last commit, and readers that
+  // have the file mapped keep a consistent view. Each commit leaves the
+  // previous directory behind as dead space. No-op if nothing changed.
+  bool commit();
+  // Commits and closes. Idempotent; called by the destructor.
+  bool close();
+
+  const std::vector<ChannelInfo>& channels() const { return channels_; }
+  size_t lap_count() const { return laps_.size(); }
+
+ private:
+  struct ChunkRef {
+    uint64_t offset;
+    ChunkStats stats;
+  };
+
+  LapStoreWriter() = default;
+
+  std::string path_;
+  std::FILE* file_ = nullptr;
+  uint64_t end_ = 0;
+  std::vector<ChannelInfo> channels_;
+  LapStoreMetadata metadata_;
+  std::vector<LapInfo> laps_;
+  std::vector<ChunkRef> chunks_;  // lap-major
+  bool ok_ = true;
+  bool dirty_ = false;  // laps written since the last commit
+};
+
+class LapStore {
+ public:
+  // Maps `path` read-only; throws std::system_error / std::runtime_error.
+  static LapStore open(const std::string& path);
+
+  size_t lap_count() const { return lap_count_; }
+  size_t channel_count() const { return channels_.size(); }
+  const std::vector<ChannelInfo>& channels() const { return channels_; }
+  int find_channel(std::string_view name) const;  // -1 if absent
+  const LapStoreMetadata& metadata() const { return metadata_; }
+
+  LapInfo lap(size_t index) const;
+  ChunkStats chunk(size_t lap, size_t channel) const;
+
+  // Decodes one channel of one lap into `out`, which must hold
+  // lap(lap).sample_count values of the channel's type.
+  bool decode(size_t lap, size_t channel, void* out) const;
+  // Decodes and converts to float (any channel type), resizing `out`.
+  bool read(size_t lap, size_t channel, std::vector<float>& out) const;
+  bool read(size_t lap, size_t channel, std::vector<double>& out) const;
+
+  size_t file_size() const { return region_.size(); }
+
+ private:
+  template <typename T>
+  bool read_converted(size_t lap, size_t channel, std::vector<T>& out) const;
+
+  MappedRegion region_;
+  std::vector<ChannelInfo> channels_;
+  LapStoreMetadata metadata_;
+  size_t lap_count_ = 0;
+  const uint8_t* lap_table_ = nullptr;
+  const uint8_t* chunk_table_ = nullptr;
+};
+
+}  // namespace trackpro::telemetry
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "trackpro/telemetry/minmax_pyramid.h"
+#include "trackpro/telemetry/telemetry_capture.h"
+
+namespace trackpro::telemetry {
+
+// A plotted channel: one float field of TelemetrySample.
+struct DashboardChannel {
+  const char* name;
+  float TelemetrySample::*field;
+};
+
+// Speed, RPM, throttle, brake and steering.
+std::vector<DashboardChannel> default_dashboard_channels();
+
+// What the renderer gets each frame. Valid only during render().
+struct DashboardView {
+  const CaptureSnapshot& snapshot;
+  const std::vector<DashboardChannel>& channels;
+  const std::vector<MinMaxPyramid>& history;  // one per channel, whole session
+  uint64_t frame = 0;
+  uint64_t frame_start_ns = 0;
+};
+
+// Draws the dashboard. Runs on the dashboard thread and may take as long as
+// it likes: capture never waits for it.
+class DashboardRenderer {
+ public:
+  virtual ~DashboardRenderer() = default;
+  virtual void render(const DashboardView& view) = 0;
+};
+
+struct LiveDashboardOptions {
+  double max_fps = 60.0;
+  // Opt in to run start()'s thread below normal priority (see
+  // demote_current_thread_background()), so a renderer that overruns its
+  // frame yields to the sim. It then gets only a small share of a core the
+  // sim or another busy process saturates, and its frame rate drops.
+  bool background = false;
+  std::vector<DashboardChannel> channels = default_dashboard_channels();
+};
+
+struct LiveDashboardCounters {
+  uint64_t frames = 0;          // render() calls
+  uint64_t idle_frames = 0;     // frame slots with no new capture data
+  uint64_t dropped_frames = 0;  // frame slots lost to slow renders
+  uint64_t samples = 0;         // log samples folded into the history pyramids
+};
+
+// The UI side of live telemetry. Each frame it takes the newest
+// CaptureSnapshot, appends the log samples it has not seen to per-channel
+// MinMaxPyramids, and calls the renderer at most once per frame slot.
+//
+// Drive it either from the host's UI thread with frame(), or let start()
+// run it on its own thread paced at max_fps; not both.
+class LiveDashboard {
+ public:
+  LiveDashboard(TelemetryCapture& capture, DashboardRenderer& renderer, LiveDashboardOptions options = {});
+  ~LiveDashboard();
+
+  LiveDashboard(const LiveDashboard&) = delete;
+  LiveDashboard& operator=(const LiveDashboard&) = delete;
+
+  // One frame: returns true if anything new was rendered.
+  bool frame(uint64_t frame_start_ns);
+
+  void start();
+  void stop();
+
+  LiveDashboardCounters counters() const;
+
+  // True once start()'s thread lowered its priority (options.background).
+  bool background() const { return background_.load(std::memory_order_acquire); }
+
+ private:
+  void run();
+
+  TelemetryCapture& capture_;
+  DashboardRenderer& renderer_;
+  LiveDashboardOptions options_;
+  std::vector<MinMaxPyramid> history_;
+  size_t ingested_ = 0;
+
+  std::thread thread_;
+  std::atomic<bool> running_{false};
+  std::atomic<bool> background_{false};
+
+  std::atomic<uint64_t> frames_{0};
+  std::atomic<uint64_t> idle_frames_{0};
+  std::atomic<uint64_t> dropped_frames_{0};
+  std::atomic<uint64_t> samples_{0};
+};
+
+}  // namespace trackpro::telemetry
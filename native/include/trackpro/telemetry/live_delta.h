@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "trackpro/common/seqlock.h"
+#include "trackpro/common/triple_buffer.h"
+#include "trackpro/telemetry/lap_segmenter.h"
+#include "trackpro/telemetry/reference_lap.h"
+#include "trackpro/telemetry/telemetry_sample.h"
+
+namespace trackpro::telemetry {
+
+// What the dashboard and voice coach read. Published once per tick.
+struct DeltaSnapshot {
+  uint64_t sequence = 0;
+  int32_t lap = 0;
+  float lap_dist_m = 0.0f;
+  float elapsed_s = 0.0f;          // current lap
+  float delta_best_s = 0.0f;       // + is slower than the best lap
+  float delta_reference_s = 0.0f;  // against the chosen reference
+  float predicted_lap_s = 0.0f;    // best lap time + delta_best
+  float best_lap_s = 0.0f;
+  bool timing = false;
+  bool has_best = false;
+  bool has_reference = false;
+  uint64_t truncated_laps = 0;  // laps longer than the trace holds, never made best
+};
+
+// Live delta-to-best and delta-to-reference at the full telemetry rate.
+//
+// The capture thread feeds it LapSegmenter events (it is a LapListener) and
+// calls update() once per sample; each update is two ReferenceLap lookups.
+// The current lap is recorded as it is driven, and becomes the new best
+// reference the moment a faster valid lap closes. A lap that outlasts the
+// preallocated trace (ten minutes at 360 Hz) stops recording there and is
+// never promoted, since its reference would end mid-lap. Any number of readers call
+// snapshot() from other threads; they never block the capture thread.
+class LiveDelta final : public LapListener {
+ public:
+  LiveDelta();
+
+  // Capture thread.
+  void update(const TelemetrySample& sample);
+  void on_lap_start(const LapInfo& lap) override;
+  void on_lap(const SegmentedLap& lap) override;
+
+  // Any thread: picks the reference for delta_reference_s (nullptr clears).
+  // Takes effect on the next update(). Single caller at a time (UI thread).
+  void set_reference(std::shared_ptr<const ReferenceLap> reference);
+  // Seeds the best lap (e.g. loaded from history). Same threading as above.
+  void set_best(std::shared_ptr<const ReferenceLap> best);
+
+  // Any thread.
+  DeltaSnapshot snapshot() const;
+  // Capture thread only (the pointer is swapped there).
+  std::shared_ptr<const ReferenceLap> best() const { return best_; }
+
+ private:
+  // Cumulative UI-side state; generations tell the capture thread which
+  // fields changed since it last looked.
+  struct References {
+    std::shared_ptr<const ReferenceLap> reference;
+    std::shared_ptr<const ReferenceLap> best;
+    uint64_t reference_generation = 0;
+    uint64_t best_generation = 0;
+  };
+
+  void take_pending();
+
+  std::shared_ptr<const ReferenceLap> best_;
+  std::shared_ptr<const ReferenceLap> reference_;
+  size_t best_hint_ = 0;
+  size_t reference_hint_ = 0;
+
+  bool timing_ = false;
+  int32_t lap_ = 0;
+  double lap_start_ = 0.0;
+  std::vector<float> trace_distance_;
+  std::vector<float> trace_elapsed_;
+  bool trace_truncated_ = false;
+  uint64_t truncated_laps_ = 0;
+  uint64_t sequence_ = 0;
+  uint64_t reference_generation_ = 0;
+  uint64_t best_generation_ = 0;
+
+  // UI -> capture thread handoff of reference changes.
+  TripleBuffer<References> pending_;
+  std::mutex pending_writer_;
+  References pending_state_;
+
+  SeqLock<DeltaSnapshot> published_;
+};
+
+}  // namespace trackpro::telemetry
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace trackpro::telemetry {
+
+struct MinMax {
+  float min;
+  float max;
+};
+
+// One channel's samples plus a min/max pyramid over them, for plotting at
+// any zoom. Level k summarises kFanout^k samples per entry, so the pyramid
+// adds about 1/7 of a min/max pair per sample.
+//
+// columns() returns exactly one (min, max) pair per pixel column; each
+// column is answered exactly (spikes never disappear) from at most
+// 2*(kFanout-1) entries per level, so the cost depends on the pixel count,
+// not on how many samples are visible.
+//
+// Not thread-safe: owned by whichever thread records or draws.
+class MinMaxPyramid {
+ public:
+  static constexpr size_t kFanout = 8;
+
+  MinMaxPyramid() = default;
+
+  // Bulk build over a finished lap (SIMD reduction per level).
+  static MinMaxPyramid build(const float* values, size_t count);
+
+  // Appends one sample, updating the last entry of every level. O(levels).
+  void append(float value);
+  // Reserves every level for `samples`, so append() never reallocates
+  // mid-session.
+  void reserve(size_t samples);
+  void clear();
+
+  size_t size() const { return samples_.size(); }
+  size_t levels() const { return levels_.size(); }
+  const std::vector<float>& samples() const { return samples_; }
+
+  // Exact min/max over samples [begin, end). Requires begin < end <= size().
+  MinMax range(size_t begin, size_t end) const;
+
+  // Splits samples [begin, end) into `pixels` equal columns and writes one
+  // pair per column to out[0..pixels). Columns narrower than a sample repeat
+  // the sample they fall on.
+  void columns(size_t begin, size_t end, size_t pixels, MinMax* out) const;
+
+  size_t memory_bytes() const;
+
+ private:
+  std::vector<float> samples_;
+  std::vector<std::vector<MinMax>> levels_;  // levels_[k] summarises kFanout^(k+1) samples
+  size_t reserved_ = 0;
+};
+
+}  // namespace trackpro::telemetry
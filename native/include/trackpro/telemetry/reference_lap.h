@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace trackpro::telemetry {
+
+class LapStore;
+
+// Elapsed time as a function of lap distance for one lap, kept as the lap's
+// own samples (no resampling error). Immutable once built, so one instance
+// can be shared between the capture thread and the UI.
+class ReferenceLap {
+ public:
+  // `distance_m` and `elapsed_s` are per sample from the lap start. Leading
+  // samples that still carry the previous lap's distance (lagging_lap_start(),
+  // taking the furthest sample as the track length) are moved before the
+  // line, then distance is held at its running maximum so the table is
+  // sorted. Throws std::invalid_argument with fewer than two samples.
+  ReferenceLap(std::vector<float> distance_m, std::vector<float> elapsed_s, double lap_time_s);
+
+  // Builds from a stored lap's LapDist and SessionTime (or LapCurrentLapTime)
+  // channels. Throws std::runtime_error if they are missing.
+  static ReferenceLap from_store(const LapStore& store, size_t lap);
+
+  // Elapsed time at `distance_m`: binary search plus linear interpolation.
+  // `hint` is the segment found last time; live distance advances a little
+  // per tick, so checking it and its successor first makes the usual
+  // lookup O(1). Beyond the last sample, extrapolates to the lap time.
+  double time_at(double distance_m, size_t& hint) const;
+  double time_at(double distance_m) const {
+    size_t hint = 0;
+    return time_at(distance_m, hint);
+  }
+
+  double lap_time() const { return lap_time_; }
+  double length() const { return distance_.back(); }
+  size_t size() const { return distance_.size(); }
+
+ private:
+  std::vector<float> distance_;
+  std::vector<float> elapsed_;
+  double lap_time_;
+};
+
+}  // namespace trackpro::telemetry
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "trackpro/telemetry/telemetry_sample.h"
+
+namespace trackpro::telemetry {
+
+// Append-only session history shared by one writer (the capture thread) and
+// any number of readers. Samples live in fixed blocks that never move, and
+// nothing below size() is modified again, so readers use [0, size()) while
+// the writer keeps appending, without locks or copies.
+class SampleLog {
+ public:
+  static constexpr size_t kBlockSamples = 4096;
+
+  // Fixes the capacity up front; blocks are allocated as they fill.
+  explicit SampleLog(size_t max_samples);
+
+  SampleLog(const SampleLog&) = delete;
+  SampleLog& operator=(const SampleLog&) = delete;
+
+  // Writer side. Returns false once the log is full.
+  bool append(const TelemetrySample& sample);
+
+  // Reader side.
+  size_t size() const { return size_.load(std::memory_order_acquire); }
+  const TelemetrySample& operator[](size_t i) const { return blocks_[i / kBlockSamples][i % kBlockSamples]; }
+  size_t capacity() const { return blocks_.size() * kBlockSamples; }
+
+ private:
+  std::vector<std::unique_ptr<TelemetrySample[]>> blocks_;
+  std::atomic<size_t> size_{0};
+};
+
+}  // namespace trackpro::telemetry
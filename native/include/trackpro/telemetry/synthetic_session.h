@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "trackpro/telemetry/telemetry_sample.h"
+
+namespace trackpro::telemetry {
+
+// A closed synthetic circuit sampled on a uniform distance grid: centreline,
+// curvature and the grip-limited speed profile a driver would follow. Stands
+// in for a real track when benchmarking on Linux without iRacing.
+struct SyntheticTrack {
+  double length_m = 0.0;
+  double step_m = 0.0;
+  std::vector<double> x;          // metres, local east
+  std::vector<double> y;          // metres, local north
+  std::vector<double> heading;    // radians
+  std::vector<double> curvature;  // 1/m, signed
+  std::vector<double> speed;      // target speed, m/s
+
+  static SyntheticTrack build(double length_m, uint32_t seed = 1);
+
+  // Linear interpolation of a grid channel at distance `d` (wrapped).
+  double at(const std::vector<double>& channel, double d) const;
+};
+
+struct SyntheticSessionOptions {
+  double track_length_m = 4000.0;
+  int tick_rate = 60;
+  uint32_t seed = 1;
+  double lap_time_spread = 0.01;  // per-lap pace variation, fraction
+  double origin_lat = 50.4372;    // Spa-Francorchamps
+  double origin_lon = 5.9714;
+};
+
+// Drives the synthetic track lap after lap at the configured tick rate.
+class SyntheticSession {
+ public:
+  explicit SyntheticSession(SyntheticSessionOptions options = {});
+
+  void next(TelemetrySample& out);
+
+  const SyntheticTrack& track() const { return track_; }
+  const SyntheticSessionOptions& options() const { return options_; }
+
+ private:
+  SyntheticSessionOptions options_;
+  SyntheticTrack track_;
+  std::mt19937 rng_;
+  std::normal_distribution<double> pace_;
+  TelemetrySample state_;
+  double distance_ = 0.0;  // along the current lap, m
+  double lap_start_time_ = 0.0;
+  double pace_factor_ = 1.0;
+  float previous_speed_ = 0.0f;
+};
+
+// Writes an .ibt file with `seconds` of synthetic driving. Besides the named
+// channels above, `filler_vars` extra float channels pad each record to the
+// width of a real iRacing row (~250 variables). Returns the record count.
+size_t write_synthetic_ibt(const std::string& path, double seconds,
+                           const SyntheticSessionOptions& options = {}, int filler_vars = 220);
+
+}  // namespace trackpro::telemetry
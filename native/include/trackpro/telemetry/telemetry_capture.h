@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "trackpro/common/triple_buffer.h"
+#include "trackpro/telemetry/sample_log.h"
+#include "trackpro/telemetry/telemetry_sample.h"
+#include "trackpro/telemetry/telemetry_source.h"
+
+namespace trackpro::telemetry {
+
+// Published after every captured tick. Immutable once the reader holds it:
+// the log entries it covers are final.
+struct CaptureSnapshot {
+  uint64_t sequence = 0;  // ticks captured so far
+  size_t samples = 0;     // SampleLog entries [0, samples) are complete
+  TelemetrySample latest;
+  uint64_t capture_ns = 0;  // now_ns() when `latest` was read from the source
+};
+
+// Runs on the capture thread for every tick (lap segmenter, live delta, ...).
+// Implementations must not block.
+class CaptureListener {
+ public:
+  virtual ~CaptureListener() = default;
+  virtual void on_sample(const TelemetrySample& sample) = 0;
+};
+
+struct TelemetryCaptureOptions {
+  size_t max_samples = 360 * 3600 * 4;  // four hours at 360 Hz
+  int realtime_priority = 60;           // below the pedal engine's 80
+  int cpu = -1;
+  uint64_t idle_timeout_ns = 100'000'000;  // how often stop() is noticed with no sim
+};
+
+struct TelemetryCaptureCounters {
+  uint64_t samples = 0;         // ticks captured
+  uint64_t source_dropped = 0;  // ticks the source published but capture missed
+  uint64_t log_full = 0;        // ticks captured after the log filled up
+};
+
+// Dedicated telemetry capture thread. Reads the source as fast as it
+// produces, appends every tick to the SampleLog, runs listeners, and
+// publishes a CaptureSnapshot through a TripleBuffer. Nothing the UI does can
+// block it: the UI only ever reads the snapshot and the append-only log.
+class TelemetryCapture {
+ public:
+  explicit TelemetryCapture(std::unique_ptr<TelemetrySource> source, TelemetryCaptureOptions options = {});
+  ~TelemetryCapture();
+
+  TelemetryCapture(const TelemetryCapture&) = delete;
+  TelemetryCapture& operator=(const TelemetryCapture&) = delete;
+
+  // Listeners must be added before start().
+  void add_listener(CaptureListener& listener);
+
+  void start();
+  void stop();
+  bool running() const { return running_.load(std::memory_order_acquire); }
+  bool realtime() const { return realtime_.load(std::memory_order_acquire); }
+
+  // Snapshot reader side; one reader thread (the dashboard). Returns true if
+  // a newer snapshot was picked up.
+  bool update() { return snapshots_.update(); }
+  const CaptureSnapshot& snapshot() const { return snapshots_.read_buffer(); }
+
+  // Safe from any thread.
+  const SampleLog& log() const { return log_; }
+  TelemetryCaptureCounters counters() const;
+
+ private:
+  void run();
+
+  std::unique_ptr<TelemetrySource> source_;
+  TelemetryCaptureOptions options_;
+  std::vector<CaptureListener*> listeners_;
+  SampleLog log_;
+  TripleBuffer<CaptureSnapshot> snapshots_;
+
+  std::thread thread_;
+  std::atomic<bool> running_{false};
+  std::atomic<bool> realtime_{false};
+
+  std::atomic<uint64_t> samples_{0};
+  std::atomic<uint64_t> source_dropped_{0};
+  std::atomic<uint64_t> log_full_{0};
+};
+
+}  // namespace trackpro::telemetry
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+namespace trackpro::telemetry {
+
+// One telemetry tick with the channels TrackPro consumes, named after the
+// irsdk variables they map to.
+struct TelemetrySample {
+  double session_time = 0.0;  // SessionTime, s
+  int32_t session_tick = 0;   // SessionTick
+  int32_t lap = 0;            // Lap
+  float lap_dist_pct = 0.0f;  // LapDistPct
+  float lap_dist = 0.0f;      // LapDist, m
+  float lap_current_lap_time = 0.0f;
+  float speed = 0.0f;  // m/s
+  float rpm = 0.0f;
+  int32_t gear = 0;
+  float throttle = 0.0f;
+  float brake = 0.0f;
+  float clutch = 0.0f;
+  float steering = 0.0f;  // SteeringWheelAngle, rad
+  double lat = 0.0;
+  double lon = 0.0;
+  float velocity_x = 0.0f;  // car frame, forward, m/s
+  float velocity_y = 0.0f;  // car frame, left, m/s
+  float yaw = 0.0f;         // heading, rad
+  bool on_pit_road = false;
+  bool is_on_track = true;
+};
+
+}  // namespace trackpro::telemetry
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+
+#include "trackpro/common/mapped_region.h"
+#include "trackpro/telemetry/irsdk_reader.h"
+#include "trackpro/telemetry/telemetry_sample.h"
+
+namespace trackpro::telemetry {
+
+// Where the capture thread gets ticks from. Called from one thread only.
+class TelemetrySource {
+ public:
+  virtual ~TelemetrySource() = default;
+
+  // Waits until the next tick or `deadline_ns` (now_ns() clock). Returns
+  // false on timeout or while the sim is disconnected.
+  virtual bool next(TelemetrySample& sample, uint64_t deadline_ns) = 0;
+
+  // Ticks the sim published that never reached next(): the capture thread
+  // was too slow to see them, or a row was overwritten while being read.
+  virtual uint64_t dropped() const { return 0; }
+};
+
+// Live iRacing (or IbtReplayProducer) telemetry through IrsdkReader. The
+// TelemetrySample variables are re-bound whenever the layout changes;
+// missing variables read as the sample's defaults.
+class IrsdkTelemetrySource final : public TelemetrySource {
+ public:
+  explicit IrsdkTelemetrySource(MappedRegion region);
+
+  bool next(TelemetrySample& sample, uint64_t deadline_ns) override;
+  uint64_t dropped() const override { return reader_.counters().skipped_ticks + torn_; }
+
+  const IrsdkReader& reader() const { return reader_; }
+
+ private:
+  struct Vars {
+    IrsdkVar<double> session_time;
+    IrsdkVar<int32_t> session_tick;
+    IrsdkVar<int32_t> lap;
+    IrsdkVar<float> lap_dist_pct;
+    IrsdkVar<float> lap_dist;
+    IrsdkVar<float> lap_current_lap_time;
+    IrsdkVar<float> speed;
+    IrsdkVar<float> rpm;
+    IrsdkVar<int32_t> gear;
+    IrsdkVar<float> throttle;
+    IrsdkVar<float> brake;
+    IrsdkVar<float> clutch;
+    IrsdkVar<float> steering;
+    IrsdkVar<double> lat;
+    IrsdkVar<double> lon;
+    IrsdkVar<float> velocity_x;
+    IrsdkVar<float> velocity_y;
+    IrsdkVar<float> yaw;
+    IrsdkVar<bool> on_pit_road;
+    IrsdkVar<bool> is_on_track;
+  };
+
+  void bind();
+
+  IrsdkReader reader_;
+  Vars vars_;
+  uint32_t bound_revision_ = 0;
+  bool bound_ = false;
+  uint64_t torn_ = 0;
+};
+
+}  // namespace trackpro::telemetry
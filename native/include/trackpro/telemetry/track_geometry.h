@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace trackpro::telemetry {
+
+// Track-local planar coordinates: metres east (x) and north (y) of an
+// origin near the circuit.
+struct Point2 {
+  float x = 0.0f;
+  float y = 0.0f;
+};
+
+// A polyline stored elsewhere (a lap's positions, a reference line).
+struct PolylineView {
+  const Point2* points = nullptr;
+  size_t count = 0;
+};
+
+// Equirectangular projection about an origin. Over a circuit-sized area
+// (a few km) the error is millimetres, and it matches how the synthetic
+// session derives Lat/Lon.
+class LocalProjection {
+ public:
+  LocalProjection() = default;
+  LocalProjection(double origin_lat, double origin_lon);
+
+  Point2 to_local(double lat, double lon) const;
+  void to_geo(Point2 p, double& lat, double& lon) const;
+
+  double origin_lat() const { return origin_lat_; }
+  double origin_lon() const { return origin_lon_; }
+
+ private:
+  double origin_lat_ = 0.0;
+  double origin_lon_ = 0.0;
+  double metres_per_deg_lat_ = 0.0;
+  double metres_per_deg_lon_ = 0.0;
+};
+
+// Cumulative distance along `line` (out[0] = 0), optionally including the
+// closing segment as out[count]. Returns the total length.
+double cumulative_distance(PolylineView line, bool closed, std::vector<float>& out);
+
+}  // namespace trackpro::telemetry
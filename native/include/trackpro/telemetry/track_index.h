@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "trackpro/telemetry/track_geometry.h"
+
+namespace trackpro::telemetry {
+
+struct SegmentHit {
+  bool found = false;
+  uint32_t line = 0;   // which polyline
+  uint32_t index = 0;  // the segment runs from point `index` to the next
+  float t = 0.0f;      // position along the segment, 0..1
+  float distance = 0.0f;
+  Point2 point;  // closest point on the segment
+};
+
+// Uniform grid over the segments of one or more polylines. Each cell lists
+// the segments whose bounding box overlaps it (CSR layout, endpoints stored
+// inline so a cell is one contiguous read), so a query only measures the few
+// segments near the query point. Immutable after
+// construction and safe to query from any number of threads.
+class SegmentGrid {
+ public:
+  SegmentGrid() = default;
+  // Copies the points. `closed` joins each line's last point to its first.
+  SegmentGrid(const std::vector<PolylineView>& lines, float cell_m, bool closed = false);
+
+  // Closest segment to `p` within `max_distance`, searching outward ring by
+  // ring until no closer cell remains.
+  SegmentHit nearest(Point2 p, float max_distance = std::numeric_limits<float>::infinity()) const;
+
+  // Closest point of every line within `radius` of `p`. per_line is resized
+  // to line_count(); returns how many lines were hit.
+  size_t nearest_per_line(Point2 p, float radius, std::vector<SegmentHit>& per_line) const;
+
+  size_t line_count() const { return line_start_.empty() ? 0 : line_start_.size() - 1; }
+  size_t segment_count() const { return segments_.size(); }
+  size_t memory_bytes() const;
+
+ private:
+  struct Segment {
+    uint32_t a;  // index into points_
+    uint32_t b;
+    uint32_t line;
+  };
+  struct CellEntry {
+    Point2 a;
+    Point2 b;
+    uint32_t segment;
+    uint32_t line;
+  };
+
+  void measure(const CellEntry& e, Point2 p, SegmentHit& hit) const;
+  int cell_x(float x) const;
+  int cell_y(float y) const;
+
+  std::vector<Point2> points_;
+  std::vector<uint32_t> line_start_;
+  std::vector<Segment> segments_;
+  std::vector<uint32_t> cell_start_;  // cols_ * rows_ + 1
+  std::vector<CellEntry> cells_;
+  float min_x_ = 0.0f;
+  float min_y_ = 0.0f;
+  float cell_ = 1.0f;
+  int cols_ = 0;
+  int rows_ = 0;
+};
+
+// A corner as a stretch of the reference line. A corner spanning the
+// start/finish line has end_m < start_m.
+struct TrackCorner {
+  int number = 0;
+  float start_m = 0.0f;
+  float apex_m = 0.0f;
+  float end_m = 0.0f;
+};
+
+struct ReferenceHit {
+  bool found = false;
+  float distance_m = 0.0f;  // along the reference line from its first point
+  float offset_m = 0.0f;    // signed: positive left of the direction of travel
+  Point2 point;
+};
+
+// Per-track spatial index for the track map: the reference line with its
+// corners, plus whichever laps are overlaid. The reference grid is built
+// once per track; set_laps() rebuilds only the overlay.
+class TrackIndex {
+ public:
+  // `reference` is a closed line in driving order. Throws
+  // std::invalid_argument if it has fewer than three points.
+  TrackIndex(std::vector<Point2> reference, std::vector<TrackCorner> corners, float cell_m = 10.0f);
+
+  void set_laps(const std::vector<PolylineView>& laps, float cell_m = 4.0f);
+
+  ReferenceHit nearest_on_reference(Point2 p) const;
+  const TrackCorner* corner_at(Point2 p) const;
+  const TrackCorner* corner_at_distance(float distance_m) const;
+
+  // Hover: the closest point of each overlaid lap within `radius_m`.
+  size_t hit_test(Point2 p, float radius_m, std::vector<SegmentHit>& per_lap) const {
+    return laps_.nearest_per_line(p, radius_m, per_lap);
+  }
+
+  float length() const { return length_; }
+  const std::vector<Point2>& reference() const { return reference_; }
+  const std::vector<TrackCorner>& corners() const { return corners_; }
+  const SegmentGrid& lap_grid() const { return laps_; }
+
+ private:
+  std::vector<Point2> reference_;
+  std::vector<float> reference_distance_;
+  float length_ = 0.0f;
+  std::vector<TrackCorner> corners_;  // sorted by start_m
+  SegmentGrid reference_grid_;
+  SegmentGrid laps_;
+};
+
+}  // namespace trackpro::telemetry
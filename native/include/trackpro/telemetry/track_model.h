@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "trackpro/common/thread_pool.h"
+#include "trackpro/telemetry/lap_store.h"
+#include "trackpro/telemetry/track_geometry.h"
+#include "trackpro/telemetry/track_index.h"
+
+namespace trackpro::telemetry {
+
+// One lap's path: positions in track-local metres against LapDist. `speed`
+// may be null.
+struct LapTrace {
+  const float* distance = nullptr;
+  const Point2* position = nullptr;
+  const float* speed = nullptr;
+  size_t count = 0;
+};
+
+// Integrates velocity into positions relative to the first sample, for
+// tracks without GPS channels. `velocity_x`/`velocity_y` are iRacing's
+// VelocityX/VelocityY, in the car's frame (forward, left); each sample is
+// rotated by `yaw` (rad, counter-clockwise) into the track frame first. The
+// closing error of the lap is spread linearly along it, so the path ends
+// where it started.
+void integrate_velocity(const float* velocity_x, const float* velocity_y, const float* yaw, size_t count,
+                        double dt_s, std::vector<Point2>& out);
+
+// The fused centreline and corner list of one track, on a uniform distance
+// grid starting at the start/finish line.
+struct TrackModel {
+  std::string track_id;
+  double length_m = 0.0;
+  double step_m = 0.0;
+  uint32_t laps = 0;
+  LocalProjection projection;  // maps live Lat/Lon onto `centerline`
+  std::vector<Point2> centerline;
+  std::vector<float> curvature;  // 1/m, signed, positive turning left
+  std::vector<float> speed;      // mean speed, m/s; empty without speed data
+  std::vector<TrackCorner> corners;
+
+  TrackIndex index() const { return TrackIndex(centerline, corners); }
+};
+
+struct TrackModelOptions {
+  double step_m = 2.0;
+  double smoothing_m = 12.0;  // moving-average window for the centreline and curvature
+  double corner_enter_curvature = 1.0 / 200.0;
+  double corner_exit_curvature = 1.0 / 400.0;
+  double min_corner_m = 15.0;
+  // Fast kinks: below this curvature peak a corner must also cost this
+  // fraction of entry speed to count.
+  double kink_curvature = 1.0 / 100.0;
+  double kink_speed_drop = 0.03;
+  // After three laps, laps whose RMS distance from the current centreline
+  // exceeds this are rejected (off-tracks, bad GPS, wrong layout).
+  double outlier_rms_m = 8.0;
+};
+
+// Incremental track-model builder. Each lap is resampled onto the distance
+// grid and added to per-point running sums, so adding a lap costs one pass
+// over that lap and the history never needs to be reprocessed. build()
+// derives the centreline, curvature and corners from the sums.
+//
+// Not thread-safe; add_laps() parallelises internally.
+class TrackModelBuilder {
+ public:
+  TrackModelBuilder(std::string track_id, double track_length_m, TrackModelOptions options = {});
+
+  // Folds one lap in. Returns false if it is too short or rejected as an
+  // outlier.
+  bool add_lap(const LapTrace& lap);
+
+  // Resamples laps on `pool` (or the calling thread) and folds them in
+  // order. Returns how many were accepted.
+  size_t add_laps(const std::vector<LapTrace>& laps, ThreadPool* pool = nullptr);
+
+  // Valid laps [first_lap, lap_count) of a lap store. Positions come from
+  // Lat/Lon when present (the projection origin is fixed by the first lap
+  // ever added), otherwise from VelocityX/VelocityY rotated by Yaw and
+  // integrated.
+  size_t add_store_laps(const LapStore& store, size_t first_lap = 0, ThreadPool* pool = nullptr);
+
+  // For add_lap() callers that project Lat/Lon themselves, so the model
+  // carries the same projection. Ignored once an origin is fixed.
+  void set_projection(const LocalProjection& projection);
+
+  TrackModel build() const;
+
+  const std::string& track_id() const { return track_id_; }
+  double length() const { return length_; }
+  uint32_t laps() const { return laps_; }
+  uint32_t rejected() const { return rejected_; }
+  // Bumped by every accepted lap.
+  uint64_t revision() const { return revision_; }
+
+  // .tpm file with the running sums. save() returns false on I/O failure;
+  // load() throws std::runtime_error.
+  bool save(const std::string& path) const;
+  static TrackModelBuilder load(const std::string& path, TrackModelOptions options = {});
+
+ private:
+  struct Resampled {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> speed;  // empty without speed
+  };
+
+  bool resample(const LapTrace& lap, Resampled& out) const;
+  bool fold(const Resampled& lap);
+
+  std::string track_id_;
+  double length_;
+  double step_;
+  size_t bins_;
+  TrackModelOptions options_;
+  bool has_origin_ = false;
+  LocalProjection projection_;
+  std::vector<double> sum_x_;
+  std::vector<double> sum_y_;
+  std::vector<double> sum_speed_;
+  uint32_t laps_ = 0;
+  uint32_t speed_laps_ = 0;
+  uint32_t rejected_ = 0;
+  uint64_t revision_ = 0;
+};
+
+// Per-track builders and their latest models, persisted as
+// <directory>/<track id>.tpm. Thread-safe: every use of a track's builder
+// goes through the cache under that track's lock, so a UI thread asking
+// for model() never races a lap being folded in, and work on one track
+// does not wait for another.
+class TrackModelCache {
+ public:
+  explicit TrackModelCache(std::string directory, TrackModelOptions options = {});
+
+  // Fold laps into the track's builder (see TrackModelBuilder). The first
+  // use of a track loads its saved state, or starts empty; a saved model
+  // whose length differs by more than 1% (a different layout) is discarded.
+  bool add_lap(const std::string& track_id, double track_length_m, const LapTrace& lap);
+  size_t add_store_laps(const std::string& track_id, double track_length_m, const LapStore& store,
+                        size_t first_lap = 0, ThreadPool* pool = nullptr);
+
+  // The track's model, rebuilt only if laps were added since the last call.
+  // Null for an unknown track or one without laps.
+  std::shared_ptr<const TrackModel> model(const std::string& track_id);
+
+  bool save(const std::string& track_id);
+
+ private:
+  struct Entry {
+    std::mutex mutex;  // guards everything below
+    std::unique_ptr<TrackModelBuilder> builder;
+    std::shared_ptr<const TrackModel> model;
+    uint64_t model_revision = 0;
+  };
+
+  // The track's entry, created on first use. Entries are never removed, so
+  // the reference stays valid.
+  Entry& entry(const std::string& track_id);
+  Entry* find(const std::string& track_id);
+  // Loads or creates the entry's builder. Caller holds e.mutex.
+  TrackModelBuilder& builder(Entry& e, const std::string& track_id, double track_length_m) const;
+  std::string path_for(const std::string& track_id) const;
+
+  std::string directory_;
+  TrackModelOptions options_;
+  std::mutex mutex_;  // guards entries_ (the map, not the entries)
+  std::map<std::string, Entry> entries_;
+};
+
+}  // namespace trackpro::telemetry
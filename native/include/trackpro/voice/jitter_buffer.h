@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "trackpro/voice/voice_codec.h"
+#include "trackpro/voice/voice_frame.h"
+
+namespace trackpro::voice {
+
+struct JitterBufferOptions {
+  uint64_t min_delay_ns = kVoiceFrameNs;
+  uint64_t max_delay_ns = 400 * kNanosPerMilli;
+  // The target delay covers this fraction of recent arrival delays...
+  double quantile = 0.98;
+  // ...where "recent" is an exponential window of about 1 / (1 - forget)
+  // packets.
+  double forget = 0.995;
+  // Missing frames in a row that are concealed before the stream is treated
+  // as stopped (talk spurt over); playback then re-buffers.
+  int max_conceal_frames = 5;
+  bool (*decode)(const uint8_t* data, size_t size, float* pcm) = adpcm_decode;
+};
+
+struct JitterBufferCounters {
+  uint64_t frames = 0;       // frames pulled
+  uint64_t concealed = 0;    // synthesised for a missing packet (underruns)
+  uint64_t silent = 0;       // silence while buffering or stopped
+  uint64_t late = 0;         // arrived after their slot was played
+  uint64_t duplicates = 0;
+  uint64_t accelerated = 0;  // frames shortened by time-stretching
+  uint64_t expanded = 0;     // frames lengthened
+  uint64_t resyncs = 0;      // jumps over a gap wider than the buffer
+};
+
+// Where the first sample of a pulled frame came from, for latency accounting.
+struct PlayoutInfo {
+  bool voiced = false;     // false: silence
+  bool concealed = false;  // synthesised rather than decoded
+  uint32_t sequence = 0;   // source frame
+  uint32_t offset = 0;     // sample position within it
+};
+
+// Adaptive jitter buffer for one incoming voice stream. Tracks the arrival
+// delay distribution and plays out at its `quantile`, moving towards a new
+// target by time-stretching whole pitch periods (shorten when above target,
+// lengthen when below) rather than by skipping or inserting frames. Missing
+// frames are concealed by repeating the last pitch period with a fading
+// gain, and cross-faded into the next real frame.
+//
+// Not thread-safe: push() and pull() are meant for the playout thread, with
+// the network thread handing packets over through a SpscRing. pull() does
+// not allocate.
+class JitterBuffer {
+ public:
+  explicit JitterBuffer(JitterBufferOptions options = {});
+
+  // Queues one received frame. `arrival_ns` is when it came off the network.
+  void push(uint32_t sequence, const uint8_t* payload, size_t size, uint64_t arrival_ns);
+
+  // Produces the next kVoiceFrameSamples samples of playout.
+  PlayoutInfo pull(float* out);
+
+  uint64_t target_delay_ns() const { return target_ns_; }
+  // Audio queued for playout: decoded samples plus frames up to the newest
+  // received, counting gaps that will be concealed.
+  uint64_t buffered_ns() const;
+  const JitterBufferCounters& counters() const { return counters_; }
+
+  static constexpr size_t kSlots = 64;  // 1.28 s of frames
+  static constexpr size_t kMaxPayload = 512;
+
+ private:
+  struct Slot {
+    uint32_t sequence = 0;
+    bool full = false;
+    uint16_t size = 0;
+    uint64_t jitter_ns = 0;  // arrival delay above the base
+    uint8_t data[kMaxPayload];
+  };
+  struct Chunk {
+    PlayoutInfo info;
+    uint32_t length = 0;  // output samples (after stretching)
+  };
+
+  static constexpr size_t kBins = 256;
+  static constexpr size_t kMaxChunk = kVoiceFrameSamples * 3 / 2;
+  static constexpr size_t kHistory = kVoiceFrameSamples;
+
+  uint64_t record_delay(uint32_t sequence, uint64_t arrival_ns);  // returns jitter
+  size_t queued_frames(uint32_t from) const;
+  void produce();
+  void append(const float* samples, size_t length, const PlayoutInfo& info);
+  void conceal(float* out, size_t length, bool advance);
+
+  JitterBufferOptions options_;
+  JitterBufferCounters counters_;
+
+  std::array<Slot, kSlots> slots_{};
+  uint32_t next_ = 0;       // next sequence to play
+  bool playing_ = false;    // false: buffering up to the target
+  bool rebase_ = true;      // next push sets next_
+  int concealing_ = 0;      // consecutive concealed frames
+  double level_ns_ = -1.0;  // smoothed buffer level; < 0 until playing
+
+  // Delay statistics. Relative delay is arrival time minus the frame's
+  // nominal send time; the base is its minimum over the last two windows.
+  bool have_origin_ = false;
+  uint64_t origin_ns_ = 0;
+  uint32_t origin_sequence_ = 0;
+  int64_t window_min_ = 0;
+  int64_t previous_min_ = 0;
+  uint32_t window_packets_ = 0;
+  std::array<double, kBins> histogram_{};
+  double weight_ = 1.0;
+  double total_ = 0.0;
+  uint64_t bin_ns_;
+  uint64_t target_ns_;
+
+  // Decoded output waiting to be pulled, in chunks of one source frame.
+  std::array<float, kMaxChunk * 3> pending_{};
+  size_t pending_size_ = 0;
+  std::array<Chunk, 4> chunks_{};
+  size_t chunk_count_ = 0;
+  size_t chunk_consumed_ = 0;  // samples of chunks_[0] already pulled
+
+  std::array<float, kHistory> history_{};  // last real output, for concealment
+  uint32_t conceal_lag_ = 0;
+  uint32_t conceal_phase_ = 0;
+  float conceal_gain_ = 1.0f;
+  std::array<float, kMaxChunk> frame_{};
+};
+
+}  // namespace trackpro::voice
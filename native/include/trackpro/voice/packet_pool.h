@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "trackpro/voice/udp_socket.h"
+
+namespace trackpro::voice {
+
+// Largest UDP payload that fits a 1500-byte IPv4 MTU.
+constexpr size_t kMaxDatagram = 1472;
+
+struct Packet {
+  UdpAddress peer;  // source when received, destination when sent
+  uint16_t size = 0;
+  uint8_t data[kMaxDatagram];
+};
+
+// Fixed set of packet buffers allocated up front, so the packet path never
+// touches the heap. acquire() and release() are O(1). Not thread-safe: each
+// event-loop worker owns one.
+class PacketPool {
+ public:
+  explicit PacketPool(size_t capacity);
+
+  PacketPool(const PacketPool&) = delete;
+  PacketPool& operator=(const PacketPool&) = delete;
+
+  // Null when every packet is in use.
+  Packet* acquire();
+  void release(Packet* packet);
+
+  size_t capacity() const { return packets_.size(); }
+  size_t available() const { return free_.size(); }
+
+ private:
+  std::vector<Packet> packets_;
+  std::vector<Packet*> free_;
+};
+
+}  // namespace trackpro::voice
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+
+#include "trackpro/voice/voice_frame.h"
+
+namespace trackpro::voice {
+
+struct SyntheticVoiceOptions {
+  uint32_t seed = 1;
+  // Mean talk spurt and pause lengths. A zero pause talks continuously.
+  double mean_talk_s = 3.0;
+  double mean_pause_s = 0.0;
+  float level = 0.2f;  // peak amplitude of a syllable
+};
+
+// Speech-like test signal for the voice benchmarks: a glottal pulse train
+// with drifting pitch (90-220 Hz) through three vowel formant resonators,
+// shaped into syllables and grouped into talk spurts.
+class SyntheticVoice {
+ public:
+  explicit SyntheticVoice(SyntheticVoiceOptions options = {});
+
+  // Next kVoiceFrameSamples samples.
+  void next(float* out);
+  // Whether the last frame was inside a talk spurt.
+  bool talking() const { return talking_; }
+
+ private:
+  struct Resonator {
+    float a1 = 0.0f;
+    float a2 = 0.0f;
+    float gain = 0.0f;
+    float y1 = 0.0f;
+    float y2 = 0.0f;
+    float run(float x) {
+      const float y = gain * x + a1 * y1 - a2 * y2;
+      y2 = y1;
+      y1 = y;
+      return y;
+    }
+  };
+
+  void start_syllable();
+
+  SyntheticVoiceOptions options_;
+  std::mt19937 rng_;
+  Resonator formants_[3];
+  bool talking_ = true;
+  uint64_t spurt_left_ = 0;     // samples until the spurt or pause ends
+  uint32_t syllable_left_ = 0;  // samples left in the syllable (incl. gap)
+  uint32_t syllable_length_ = 1;
+  uint32_t voiced_length_ = 1;
+  float pitch_ = 120.0f;
+  float pitch_glide_ = 0.0f;  // Hz per sample
+  float phase_ = 0.0f;
+};
+
+struct SyntheticEngineOptions {
+  uint32_t seed = 1;
+  float level = 0.02f;  // scale; 0.02 is about -44 dBFS RMS
+  int cylinders = 6;
+  double gear_s = 3.5;  // time to climb from shift-down to shift-up revs
+};
+
+// Cockpit background for the voice benchmarks: engine orders at the firing
+// frequency of a revving engine (climbing through each gear, dropping at
+// every upshift, lifting for corners), plus road rumble and broadband wind
+// and tyre noise.
+class SyntheticEngineNoise {
+ public:
+  explicit SyntheticEngineNoise(SyntheticEngineOptions options = {});
+
+  // Adds the next kVoiceFrameSamples samples of noise to `out`.
+  void add(float* out);
+
+ private:
+  SyntheticEngineOptions options_;
+  std::mt19937 rng_;
+  double t_ = 0.0;  // seconds
+  float phase_ = 0.0f;
+  float rumble_ = 0.0f;
+  float hiss_ = 0.0f;
+};
+
+}  // namespace trackpro::voice
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "trackpro/common/seqlock.h"
+#include "trackpro/voice/packet_pool.h"
+#include "trackpro/voice/udp_socket.h"
+
+namespace trackpro::voice {
+
+struct UdpEventLoopOptions {
+  UdpAddress address;  // port 0 picks a free one
+  // Worker threads, each with its own SO_REUSEPORT socket on the shared
+  // port. 0 means one per hardware thread.
+  size_t workers = 0;
+  size_t batch = 64;          // datagrams per recvmmsg/sendmmsg call
+  size_t pool_packets = 1024;  // send buffers per worker
+  int socket_buffer_bytes = 4 << 20;
+  // Payload byte that picks the worker (value modulo workers), checked in
+  // the kernel by a reuseport BPF program so related traffic always meets
+  // on one worker. -1 leaves the kernel's address hash.
+  int steer_offset = -1;
+  uint64_t tick_ns = 0;        // period of on_tick(); 0 disables it
+  int realtime_priority = 0;   // SCHED_FIFO priority; 0 or unprivileged stays best effort
+  bool pin_workers = true;     // worker i on CPU i
+};
+
+struct UdpEventLoopCounters {
+  uint64_t received = 0;
+  uint64_t sent = 0;
+  uint64_t send_failures = 0;  // dropped: socket buffer full or pool empty
+  uint64_t receive_calls = 0;  // recvmmsg calls that returned data
+  uint64_t send_calls = 0;     // sendmmsg calls
+  uint64_t wakeups = 0;        // epoll_wait returns
+  uint64_t ticks = 0;
+  uint64_t cpu_ns = 0;         // worker thread CPU time
+};
+
+class UdpWorker;
+
+// Called on the worker threads. A worker only ever calls its own handler
+// methods, one at a time; different workers call concurrently.
+class UdpPacketHandler {
+ public:
+  virtual ~UdpPacketHandler() = default;
+  // `packet` is only valid during the call. Replies sent through
+  // `worker` are batched and flushed when the receive batch is done.
+  virtual void on_packet(UdpWorker& worker, const Packet& packet, uint64_t now_ns) = 0;
+  virtual void on_tick(UdpWorker&, uint64_t) {}
+};
+
+// One worker's socket, buffers and send queue.
+class UdpWorker {
+ public:
+  ~UdpWorker();
+
+  size_t index() const { return index_; }
+
+  // Copies the datagram into a pooled buffer and queues it for the next
+  // sendmmsg. False if it is oversized or no buffer is free.
+  bool send(const UdpAddress& to, const uint8_t* data, size_t size);
+
+  // Sends everything queued.
+  void flush();
+
+ private:
+  friend class UdpEventLoop;
+  struct Batch;
+
+  UdpWorker(size_t index, UdpSocket socket, const UdpEventLoopOptions& options);
+  void run(UdpPacketHandler& handler, const std::atomic<bool>& running);
+  void receive_all(UdpPacketHandler& handler);
+  void publish();
+
+  size_t index_;
+  UdpSocket socket_;
+  const UdpEventLoopOptions& options_;
+  PacketPool pool_;
+  std::unique_ptr<Batch> batch_;
+  int epoll_fd_ = -1;
+  int timer_fd_ = -1;
+  int wake_fd_ = -1;
+  uint64_t cpu_start_ns_ = 0;
+  UdpEventLoopCounters counters_;
+  SeqLock<UdpEventLoopCounters> published_;
+  std::thread thread_;
+};
+
+// Multi-threaded UDP server loop (Linux): each worker waits on epoll for its
+// socket, its tick timer and a stop event, receives with recvmmsg into
+// preallocated buffers, and sends with sendmmsg from a preallocated pool.
+class UdpEventLoop {
+ public:
+  // Binds all sockets immediately, so address() is valid before start().
+  // Throws std::system_error.
+  UdpEventLoop(UdpPacketHandler& handler, UdpEventLoopOptions options = {});
+  ~UdpEventLoop();
+
+  UdpEventLoop(const UdpEventLoop&) = delete;
+  UdpEventLoop& operator=(const UdpEventLoop&) = delete;
+
+  void start();
+  void stop();
+  bool running() const { return running_.load(std::memory_order_acquire); }
+
+  UdpAddress address() const { return address_; }
+  size_t workers() const { return workers_.size(); }
+
+  // Per-worker snapshots, updated by each worker after every wakeup.
+  UdpEventLoopCounters counters(size_t worker) const;
+  UdpEventLoopCounters counters() const;  // summed over workers
+
+ private:
+  UdpPacketHandler& handler_;
+  UdpEventLoopOptions options_;
+  UdpAddress address_;
+  std::vector<std::unique_ptr<UdpWorker>> workers_;
+  std::atomic<bool> running_{false};
+};
+
+}  // namespace trackpro::voice
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace trackpro::voice {
+
+// IPv4 address and port, both in host byte order.
+struct UdpAddress {
+  uint32_t ip = 0x7F000001;  // 127.0.0.1
+  uint16_t port = 0;
+
+  bool operator==(const UdpAddress& o) const { return ip == o.ip && port == o.port; }
+  bool operator!=(const UdpAddress& o) const { return !(*this == o); }
+};
+
+// Non-blocking IPv4 UDP socket (Linux). Used by the voice server and the
+// voice benchmarks.
+class UdpSocket {
+ public:
+  // Binds to `address` (port 0 picks a free one). `reuse_port` sets
+  // SO_REUSEPORT so several sockets can share a port and the kernel spreads
+  // flows across them. Throws std::system_error.
+  explicit UdpSocket(UdpAddress address = {}, bool reuse_port = false);
+  ~UdpSocket();
+
+  UdpSocket(UdpSocket&& other) noexcept;
+  UdpSocket& operator=(UdpSocket&& other) noexcept;
+  UdpSocket(const UdpSocket&) = delete;
+  UdpSocket& operator=(const UdpSocket&) = delete;
+
+  int fd() const { return fd_; }
+  UdpAddress local_address() const;
+
+  // Kernel send/receive buffer sizes, in bytes.
+  void set_buffer_sizes(int bytes);
+
+  // False if the datagram was not queued (send buffer full or unreachable).
+  bool send_to(const UdpAddress& to, const uint8_t* data, size_t size);
+
+  // Receives one datagram, waiting until `deadline_ns` (now_ns() clock; a
+  // past deadline does not wait). Returns its size, or -1 if none arrived.
+  long receive(uint8_t* data, size_t capacity, UdpAddress* from, uint64_t deadline_ns = 0);
+
+ private:
+  int fd_ = -1;
+};
+
+}  // namespace trackpro::voice
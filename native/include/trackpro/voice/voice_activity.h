@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+
+#include "trackpro/voice/voice_frame.h"
+
+namespace trackpro::voice {
+
+struct VoiceActivityOptions {
+  float threshold_db = 5.0f;      // band energy above the noise floor that counts as voice
+  uint32_t hangover_frames = 15;  // stay active this long after the last voiced frame (300 ms)
+  // The noise floor drops at once to any quieter frame and rises towards
+  // louder ones by at most this much per frame: quickly through frames that
+  // are not voice, so it follows the engine back up after a lift, and only
+  // slowly through voiced ones, so sustained speech does not lift the floor
+  // into the speech itself.
+  float floor_rise_db = 0.5f;
+  float floor_rise_voiced_db = 0.05f;
+  float silence_db = -60.0f;      // below this a frame is silent whatever the floor (muted mic)
+  // A loud cockpit: once the talker's running speech level stands less than
+  // noisy_margin_db above the floor, voice is tested against
+  // noisy_threshold_db and held for noisy_hangover_frames, so the quieter
+  // syllables under the engine go out with the talk spurt around them.
+  float noisy_margin_db = 20.0f;
+  float noisy_threshold_db = 3.0f;
+  uint32_t noisy_hangover_frames = 50;  // 1 s
+};
+
+// Cheap energy-based voice activity detector for one 48 kHz stream. Each
+// frame's energy in the speech band (500 Hz - 4 kHz, two one-pole filters)
+// is compared with a noise floor that tracks the quietest recent frames:
+// engine noise is steady and sets the floor, while speech comes and goes at
+// syllable rate and stands above it. A hangover keeps word endings and the
+// gaps between syllables. The detector also follows the talker's level; when
+// the engine comes within noisy_margin_db of it, energy alone cannot follow
+// single syllables, so a talk spurt is held through to its end instead. A
+// few multiply-adds per sample.
+class VoiceActivityDetector {
+ public:
+  // Throws std::invalid_argument if a floor rise rate is negative.
+  explicit VoiceActivityDetector(VoiceActivityOptions options = {});
+
+  // Classifies one kVoiceFrameSamples frame. True while voice is present or
+  // within the hangover.
+  bool process(const float* pcm);
+
+  bool active() const { return active_; }
+  float energy_db() const { return energy_db_; }
+  float noise_floor_db() const { return floor_db_; }
+  float speech_level_db() const { return speech_db_; }
+  // Whether the last frame was classified with the loud-cockpit settings.
+  bool noisy() const { return noisy_; }
+
+ private:
+  VoiceActivityOptions options_;
+  float low_pass_;   // filter coefficients
+  float high_pass_;
+  float lp_state_ = 0.0f;
+  float hp_state_ = 0.0f;
+  float hp_input_ = 0.0f;
+  float energy_db_ = -100.0f;
+  float floor_db_ = 0.0f;
+  float speech_db_ = 0.0f;  // running level of voiced frames
+  bool primed_ = false;     // floor set by a first frame
+  bool noisy_ = false;
+  uint32_t hangover_ = 0;
+  bool active_ = false;
+};
+
+}  // namespace trackpro::voice
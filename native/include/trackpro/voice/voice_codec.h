@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "trackpro/voice/voice_frame.h"
+
+namespace trackpro::voice {
+
+// Built-in voice codec: IMA ADPCM, 4 bits per sample (192 kbit/s at 48 kHz).
+// Keeps the native tree free of codec dependencies; the app can put Opus
+// behind the same encode/decode calls. Each frame starts with the encoder's
+// predictor state, so frames decode independently and a lost packet never
+// corrupts the next one.
+constexpr size_t kAdpcmFrameBytes = 4 + kVoiceFrameSamples / 2;
+
+class AdpcmEncoder {
+ public:
+  // Encodes one frame into `out` (kAdpcmFrameBytes). Returns the size.
+  size_t encode(const float* pcm, uint8_t* out);
+
+ private:
+  int predictor_ = 0;
+  int index_ = 0;
+};
+
+// Decodes one frame into kVoiceFrameSamples samples. False if the payload is
+// not an ADPCM frame.
+bool adpcm_decode(const uint8_t* data, size_t size, float* pcm);
+
+}  // namespace trackpro::voice
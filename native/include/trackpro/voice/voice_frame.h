@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "trackpro/common/clock.h"
+
+namespace trackpro::voice {
+
+// Voice is 48 kHz mono in 20 ms frames end to end (capture, codec, network,
+// jitter buffer, mixer). Samples are floats in [-1, 1].
+constexpr int kVoiceSampleRate = 48000;
+constexpr size_t kVoiceFrameSamples = 960;
+constexpr uint64_t kVoiceFrameNs = 20 * kNanosPerMilli;
+
+// Packet flags.
+enum : uint8_t {
+  kVoiceFlagNone = 0,
+  kVoiceFlagMixed = 1 << 0,  // server mix; capture_ns is the oldest voice's, in its clock
+  kVoiceFlagJoin = 1 << 1,   // payload is the stream's join token, not audio
+};
+
+// Stream id the voice server uses for the mixes it sends. No client may
+// join with it.
+constexpr uint32_t kVoiceServerStream = 0;
+
+// Secret the session host shares with the voice server. The host hands each
+// driver a stream id and that stream's join token out of band.
+struct VoiceSessionKey {
+  uint64_t k0 = 0;
+  uint64_t k1 = 0;
+};
+
+constexpr size_t kVoiceJoinTokenSize = 8;
+
+// SipHash-2-4 of the stream id under the session key. The server checks a
+// join without a table of issued tokens, and one stream's token says
+// nothing about another's.
+uint64_t voice_join_token(const VoiceSessionKey& key, uint32_t stream);
+
+// Fixed 20-byte little-endian header in front of every voice datagram,
+// followed by one encoded frame.
+struct VoicePacketHeader {
+  uint32_t stream = 0;      // sender id, unique per session
+  uint32_t sequence = 0;    // frame number within the stream
+  uint64_t capture_ns = 0;  // sender's now_ns() at the frame's first sample
+  uint8_t flags = kVoiceFlagNone;
+  uint8_t group = 0;  // voice channel (team radio, spotter, ...)
+};
+
+constexpr size_t kVoiceHeaderSize = 20;
+// Byte offset of `group`, for steering a group's packets to one server
+// worker in the kernel.
+constexpr size_t kVoiceGroupOffset = 17;
+
+void write_voice_header(const VoicePacketHeader& header, uint8_t* out);
+
+// Splits a datagram into header and payload. False if it is too short.
+bool parse_voice_packet(const uint8_t* data, size_t size, VoicePacketHeader& header, const uint8_t*& payload,
+                        size_t& payload_size);
+
+}  // namespace trackpro::voice
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "trackpro/voice/voice_activity.h"
+#include "trackpro/voice/voice_codec.h"
+#include "trackpro/voice/voice_frame.h"
+
+namespace trackpro::voice {
+
+enum class TransmitMode : uint8_t {
+  OpenMic,     // send while the voice activity detector hears speech
+  PushToTalk,  // send while the talk key is held
+};
+
+struct VoiceSenderOptions {
+  uint32_t stream = 1;
+  uint8_t group = 0;
+  TransmitMode mode = TransmitMode::OpenMic;
+  VoiceActivityOptions vad;
+  // While not transmitting, a keepalive (header only) goes out this often so
+  // the server keeps the seat; 0 sends none.
+  uint32_t keepalive_frames = 50;
+  // voice_join_token() for `stream`, from the session host; 0 for a server
+  // without VoiceServerOptions::require_join. With a token the first frame
+  // goes out as a join instead of audio, and every keepalive is a join, so
+  // a lost join is repeated within keepalive_frames of silence.
+  uint64_t join_token = 0;
+};
+
+struct VoiceSenderCounters {
+  uint64_t frames = 0;      // captured frames processed
+  uint64_t encoded = 0;     // encoded and sent
+  uint64_t suppressed = 0;  // neither encoded nor sent (silence or key up)
+  uint64_t keepalives = 0;
+  uint64_t bytes = 0;       // datagram bytes produced
+};
+
+// Capture side of a voice stream with discontinuous transmission: frames
+// are only encoded and sent while transmitting. Sequence numbers keep
+// counting through the gaps, so the receiver's jitter buffer sees a gap
+// (and re-buffers at the next talk spurt) rather than a clock jump.
+class VoiceSender {
+ public:
+  explicit VoiceSender(VoiceSenderOptions options = {});
+
+  // One captured frame. Writes the datagram to send into `out` (at least
+  // kVoiceHeaderSize + kAdpcmFrameBytes) and returns its size, or 0 if
+  // nothing goes out for this frame.
+  size_t process(const float* pcm, uint64_t capture_ns, uint8_t* out);
+
+  // Push-to-talk key state; ignored in open-mic mode.
+  void set_talk_key(bool down) { talk_key_ = down; }
+
+  bool transmitting() const { return transmitting_; }
+  const VoiceActivityDetector& vad() const { return vad_; }
+  const VoiceSenderCounters& counters() const { return counters_; }
+
+ private:
+  VoiceSenderOptions options_;
+  VoiceActivityDetector vad_;
+  AdpcmEncoder encoder_;
+  VoiceSenderCounters counters_;
+  uint32_t sequence_ = 0;
+  uint32_t since_sent_ = 0;  // frames since the last datagram
+  bool joined_ = false;      // first join sent
+  bool talk_key_ = false;
+  bool transmitting_ = false;
+};
+
+}  // namespace trackpro::voice
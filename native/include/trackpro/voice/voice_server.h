@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "trackpro/voice/jitter_buffer.h"
+#include "trackpro/voice/udp_socket.h"
+#include "trackpro/voice/voice_codec.h"
+#include "trackpro/voice/voice_frame.h"
+
+namespace trackpro::voice {
+
+enum class VoiceServerMode : uint8_t {
+  // Selective forwarding: each frame is relayed, still encoded, to the other
+  // members of the sender's group. Cheapest for the server, but every client
+  // decodes one stream per talker.
+  Forward,
+  // Mixing: each talker runs through a jitter buffer and is decoded; every
+  // 20 ms the server mixes each group and sends one encoded stream per
+  // listener. Talkers get a mix without their own voice.
+  Mix,
+};
+
+struct VoiceServerOptions {
+  VoiceServerMode mode = VoiceServerMode::Forward;
+  size_t max_clients = 1024;
+  // Clients that send nothing (not even keepalives) for this long are
+  // dropped.
+  uint64_t client_timeout_ns = 10 * kNanosPerSecond;
+  JitterBufferOptions jitter;  // per talker, mix mode
+  // Streams then join only through a join packet carrying
+  // voice_join_token(session_key, stream), and a valid join moves a stream
+  // to its new address. Without it the first address to use a stream id
+  // keeps it until it expires.
+  bool require_join = false;
+  VoiceSessionKey session_key;
+};
+
+struct VoiceServerCounters {
+  uint64_t received = 0;   // datagrams accepted (audio and keepalives)
+  uint64_t malformed = 0;  // too short to carry a header
+  uint64_t rejected = 0;   // new clients beyond max_clients
+  uint64_t spoofed = 0;    // packets claiming the server's stream, a stream bound elsewhere, or a bad join
+  uint64_t forwarded = 0;  // relayed frames (forward mode)
+  uint64_t mixes = 0;      // group mixes with at least one voice (mix mode)
+  uint64_t encodes = 0;    // frames encoded (mix mode)
+  uint64_t sent = 0;       // datagrams handed to the sink
+  uint64_t send_failures = 0;
+  uint64_t joined = 0;
+  uint64_t expired = 0;
+  uint64_t clients = 0;  // connected now
+  uint64_t cpu_ns = 0;   // worker thread CPU time (VoiceServerLoop only)
+};
+
+// Where the server's outgoing datagrams go. The data is only valid for the
+// duration of the call.
+class VoicePacketSink {
+ public:
+  virtual ~VoicePacketSink() = default;
+  virtual bool send(const UdpAddress& to, const uint8_t* data, size_t size) = 0;
+};
+
+// Voice relay for one session, independent of the transport: the owner
+// feeds it datagrams and calls tick() every kVoiceFrameNs. Clients are
+// identified by their stream id and join the group named in their packets;
+// a packet with an empty payload is a keepalive, which is how listen-only
+// clients stay connected. A stream stays bound to the address it joined
+// from until it expires; packets claiming it from elsewhere, or claiming
+// kVoiceServerStream, are dropped and counted. With
+// VoiceServerOptions::require_join only the holder of a stream's join token
+// can bind it, so a peer cannot squat another driver's id before they
+// connect. Not thread-safe.
+class VoiceServer {
+ public:
+  explicit VoiceServer(VoiceServerOptions options = {});
+  ~VoiceServer();
+
+  VoiceServer(const VoiceServer&) = delete;
+  VoiceServer& operator=(const VoiceServer&) = delete;
+
+  void receive(const UdpAddress& from, const uint8_t* data, size_t size, uint64_t now_ns, VoicePacketSink& out);
+
+  // Drops idle clients and, in mix mode, produces and sends one frame per
+  // group.
+  void tick(uint64_t now_ns, VoicePacketSink& out);
+
+  VoiceServerMode mode() const { return options_.mode; }
+  size_t clients() const { return clients_.size(); }
+  const VoiceServerCounters& counters() const { return counters_; }
+
+ private:
+  struct Client;
+
+  Client* find_or_join(const VoicePacketHeader& header, const uint8_t* payload, size_t payload_size,
+                       const UdpAddress& from, uint64_t now_ns);
+  void leave_group(Client& client);
+  void expire(uint64_t now_ns);
+  void mix_group(uint8_t group, VoicePacketSink& out);
+  void send(const UdpAddress& to, const uint8_t* data, size_t size, VoicePacketSink& out);
+
+  VoiceServerOptions options_;
+  VoiceServerCounters counters_;
+  std::vector<std::unique_ptr<Client>> clients_;
+  std::unordered_map<uint32_t, size_t> index_;  // stream -> clients_ slot
+  std::array<std::vector<Client*>, 256> groups_;
+
+  // Mix mode: one encoder and sequence per group for listeners that hear
+  // the full mix.
+  std::array<AdpcmEncoder, 256> group_encoders_{};
+  std::array<uint32_t, 256> group_sequences_{};
+  std::array<float, kVoiceFrameSamples> sum_{};
+  std::array<float, kVoiceFrameSamples> scratch_{};
+  uint64_t last_expiry_ns_ = 0;
+};
+
+}  // namespace trackpro::voice
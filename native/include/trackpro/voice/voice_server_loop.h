@@ -0,0 +1,45 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "trackpro/common/seqlock.h"
+#include "trackpro/voice/udp_event_loop.h"
+#include "trackpro/voice/voice_server.h"
+
+namespace trackpro::voice {
+
+// Runs the voice server on a UdpEventLoop (Linux). Each worker owns an
+// independent VoiceServer, and the loop steers packets to workers by voice
+// group in the kernel, so a group's talkers and listeners always meet on
+// one worker and workers share nothing. A client that switches group moves
+// to the new group's worker; the old one forgets it after the client
+// timeout.
+class VoiceServerLoop : private UdpPacketHandler {
+ public:
+  // `loop.tick_ns` and `loop.steer_offset` are set by the server. Throws
+  // std::system_error.
+  explicit VoiceServerLoop(VoiceServerOptions server = {}, UdpEventLoopOptions loop = {});
+  ~VoiceServerLoop() override;
+
+  void start() { loop_.start(); }
+  void stop() { loop_.stop(); }
+  bool running() const { return loop_.running(); }
+
+  UdpAddress address() const { return loop_.address(); }
+  size_t workers() const { return loop_.workers(); }
+
+  // Summed over workers; each worker publishes once per tick.
+  VoiceServerCounters counters() const;
+  UdpEventLoopCounters loop_counters() const { return loop_.counters(); }
+
+ private:
+  void on_packet(UdpWorker& worker, const Packet& packet, uint64_t now_ns) override;
+  void on_tick(UdpWorker& worker, uint64_t now_ns) override;
+
+  struct Shard;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  UdpEventLoop loop_;
+};
+
+}  // namespace trackpro::voice
@@ -0,0 +1,193 @@
+#include "trackpro/audio/audio_mixer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "trackpro/common/clock.h"
+
+namespace trackpro::audio {
+namespace {
+
+constexpr float kCeiling = 0.98f;           // limiter output peak
+constexpr float kLimiterReleaseMs = 100.0f;
+
+float db_to_gain(float db) { return std::pow(10.0f, db / 20.0f); }
+
+}  // namespace
+
+const char* lane_name(AudioLane lane) {
+  switch (lane) {
+    case AudioLane::TeamRadio:
+      return "team_radio";
+    case AudioLane::Spotter:
+      return "spotter";
+    case AudioLane::Coach:
+      return "coach";
+  }
+  return "unknown";
+}
+
+AudioMixer::AudioMixer(AudioMixerOptions options)
+    : options_(options),
+      attack_samples_(options.attack_ms * 1e-3f * static_cast<float>(options.sample_rate)),
+      release_samples_(options.release_ms * 1e-3f * static_cast<float>(options.sample_rate)),
+      hold_samples_(static_cast<uint64_t>(options.hold_ms * 1e-3f * static_cast<float>(options.sample_rate))) {
+  if (options_.sample_rate == 0 || options_.channels == 0) {
+    throw std::invalid_argument("AudioMixer needs a non-zero sample rate and channel count");
+  }
+  for (size_t i = 0; i < kAudioLaneCount; ++i) {
+    duck_gain_[i] = i == 0 ? 1.0f : db_to_gain(options_.duck_db[i]);
+    counters_.gain[i] = 1.0f;
+  }
+}
+
+void AudioMixer::check_format(const AudioFormat& format) const {
+  if (format.sample_rate != options_.sample_rate || format.channels != options_.channels) {
+    throw std::invalid_argument("AudioMixer is set up for " + std::to_string(options_.sample_rate) + " Hz x " +
+                                std::to_string(options_.channels) + " channels, the device runs " +
+                                std::to_string(format.sample_rate) + " Hz x " + std::to_string(format.channels));
+  }
+}
+
+size_t AudioMixer::write(AudioLane lane, const float* pcm, size_t samples) {
+  Lane& l = lanes_[static_cast<size_t>(lane)];
+  Block block;
+  size_t done = 0;
+  while (done < samples) {
+    block.size = static_cast<uint32_t>(std::min(samples - done, kAudioBlockFrames));
+    std::copy_n(pcm + done, block.size, block.samples);
+    if (!l.queue.try_push(block)) {
+      break;
+    }
+    done += block.size;
+  }
+  if (done < samples) {
+    l.dropped.fetch_add(samples - done, std::memory_order_relaxed);
+  }
+  return done;
+}
+
+size_t AudioMixer::queued(AudioLane lane) const {
+  return lanes_[static_cast<size_t>(lane)].queue.size() * kAudioBlockFrames;
+}
+
+void AudioMixer::set_volume(AudioLane lane, float gain) {
+  lanes_[static_cast<size_t>(lane)].volume.store(gain, std::memory_order_relaxed);
+}
+
+AudioMixerCounters AudioMixer::counters() const {
+  AudioMixerCounters c;
+  if (!published_.load(c)) {
+    c.gain.fill(1.0f);
+  }
+  for (size_t i = 0; i < kAudioLaneCount; ++i) {
+    c.dropped[i] = lanes_[i].dropped.load(std::memory_order_relaxed);
+  }
+  return c;
+}
+
+size_t AudioMixer::Lane::pull(size_t frames) {
+  size_t n = 0;
+  while (n < frames) {
+    if (offset == current.size) {
+      if (!queue.try_pop(current)) {
+        break;
+      }
+      offset = 0;
+    }
+    const size_t take = std::min<size_t>(frames - n, current.size - offset);
+    std::copy_n(current.samples + offset, take, pcm.data() + n);
+    offset += static_cast<uint32_t>(take);
+    n += take;
+  }
+  return n;
+}
+
+void AudioMixer::render_chunk(float* out, size_t frames, uint64_t start_ns) {
+  std::fill_n(mix_.begin(), frames, 0.0f);
+  const float n = static_cast<float>(frames);
+
+  bool above_playing = false;
+  for (size_t i = 0; i < kAudioLaneCount; ++i) {
+    // Team radio is always mixed. Below it, a callback that has already used
+    // its budget leaves the audio queued for the next one.
+    if (i > 0 && now_ns() - start_ns > options_.budget_ns) {
+      ++counters_.shed;
+      continue;
+    }
+    Lane& lane = lanes_[i];
+    const size_t got = lane.pull(frames);
+    if (got > 0) {
+      lane.hold_left = hold_samples_;
+    } else {
+      lane.hold_left -= std::min<uint64_t>(lane.hold_left, frames);
+    }
+
+    float target = lane.volume.load(std::memory_order_relaxed);
+    if (above_playing) {
+      target *= duck_gain_[i];
+    }
+    const float tau = target < lane.gain ? attack_samples_ : release_samples_;
+    const float next = target + (lane.gain - target) * std::exp(-n / tau);
+    if (got > 0) {
+      // Ramp across the chunk so gain changes never step.
+      const float step = (next - lane.gain) / n;
+      float g = lane.gain;
+      for (size_t s = 0; s < got; ++s) {
+        g += step;
+        mix_[s] += lane.pcm[s] * g;
+      }
+      counters_.played[i] += got;
+    }
+    lane.gain = next;
+    counters_.gain[i] = next;
+    above_playing = above_playing || lane.hold_left > 0;
+  }
+
+  // Peak limiter: turns down at once when the sum would clip and recovers
+  // over ~100 ms.
+  float peak = 0.0f;
+  for (size_t s = 0; s < frames; ++s) {
+    peak = std::max(peak, std::fabs(mix_[s]));
+  }
+  const float release = 1.0f - std::exp(-n / (kLimiterReleaseMs * 1e-3f * static_cast<float>(options_.sample_rate)));
+  float gain = limiter_gain_ + (1.0f - limiter_gain_) * release;
+  if (peak * gain > kCeiling) {
+    gain = kCeiling / peak;
+    ++counters_.limited;
+  }
+  limiter_gain_ = gain;
+
+  const size_t channels = options_.channels;
+  for (size_t s = 0; s < frames; ++s) {
+    const float v = mix_[s] * gain;
+    for (size_t c = 0; c < channels; ++c) {
+      out[s * channels + c] = v;
+    }
+  }
+}
+
+void AudioMixer::render(float* out, size_t frames) {
+  const uint64_t start = now_ns();
+  for (size_t done = 0; done < frames;) {
+    const size_t n = std::min(frames - done, kAudioBlockFrames);
+    render_chunk(out + done * options_.channels, n, start);
+    done += n;
+  }
+  const uint64_t elapsed = now_ns() - start;
+
+  ++counters_.callbacks;
+  counters_.frames += frames;
+  if (elapsed > options_.budget_ns) {
+    ++counters_.over_budget;
+  }
+  counters_.max_callback_ns = std::max(counters_.max_callback_ns, elapsed);
+  if (options_.callback_ns != nullptr) {
+    options_.callback_ns->record(elapsed);
+  }
+  published_.store(counters_);
+}
+
+}  // namespace trackpro::audio
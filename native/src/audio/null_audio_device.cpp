@@ -0,0 +1,80 @@
+#include "trackpro/audio/null_audio_device.h"
+
+#include <stdexcept>
+
+#include "trackpro/common/clock.h"
+#include "trackpro/common/realtime.h"
+
+namespace trackpro::audio {
+
+NullAudioDevice::NullAudioDevice(NullAudioDeviceOptions options) : options_(options) {
+  const AudioFormat& f = options_.format;
+  if (f.sample_rate == 0 || f.channels == 0 || f.frames_per_callback == 0) {
+    throw std::invalid_argument("NullAudioDevice needs a non-zero rate, channel count and period");
+  }
+  buffer_.assign(static_cast<size_t>(f.frames_per_callback) * f.channels, 0.0f);
+}
+
+NullAudioDevice::~NullAudioDevice() { stop(); }
+
+void NullAudioDevice::start(AudioRenderCallback& callback) {
+  if (running()) {
+    return;
+  }
+  callback.check_format(options_.format);
+  if (running_.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  thread_ = std::thread([this, &callback] { run(callback); });
+}
+
+void NullAudioDevice::stop() {
+  running_.store(false, std::memory_order_release);
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+AudioDeviceCounters NullAudioDevice::counters() const {
+  AudioDeviceCounters c;
+  c.callbacks = callbacks_.load(std::memory_order_relaxed);
+  c.late = late_.load(std::memory_order_relaxed);
+  return c;
+}
+
+void NullAudioDevice::pump(AudioRenderCallback& callback, size_t periods) {
+  callback.check_format(options_.format);
+  for (size_t i = 0; i < periods; ++i) {
+    callback.render(buffer_.data(), options_.format.frames_per_callback);
+    callbacks_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void NullAudioDevice::run(AudioRenderCallback& callback) {
+  set_current_thread_name("tp-audio");
+  pin_current_thread(options_.cpu);
+  enable_flush_denormals();
+  realtime_.store(promote_current_thread_realtime(options_.realtime_priority),
+                  std::memory_order_release);
+
+  const AudioFormat& f = options_.format;
+  const uint64_t period = static_cast<uint64_t>(f.frames_per_callback) * kNanosPerSecond / f.sample_rate;
+  uint64_t next = now_ns();
+  while (running_.load(std::memory_order_acquire)) {
+    callback.render(buffer_.data(), f.frames_per_callback);
+    callbacks_.fetch_add(1, std::memory_order_relaxed);
+
+    next += period;
+    const uint64_t now = now_ns();
+    if (now >= next) {
+      // The hardware buffer would have run dry: count the glitch and
+      // resynchronise instead of rendering the missed periods back to back.
+      late_.fetch_add(1, std::memory_order_relaxed);
+      next = now;
+      continue;
+    }
+    sleep_until_ns(next, options_.spin_ns);
+  }
+}
+
+}  // namespace trackpro::audio
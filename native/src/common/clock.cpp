@@ -0,0 +1,63 @@
+#include "trackpro/common/clock.h"
+
+#include <chrono>
+#include <thread>
+
+#if defined(__linux__)
+#include <time.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#define TRACKPRO_CPU_RELAX() _mm_pause()
+#else
+#define TRACKPRO_CPU_RELAX() ((void)0)
+#endif
+
+namespace trackpro {
+
+uint64_t now_ns() {
+#if defined(__linux__)
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * kNanosPerSecond + static_cast<uint64_t>(ts.tv_nsec);
+#else
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now().time_since_epoch())
+                                   .count());
+#endif
+}
+
+uint64_t thread_cpu_ns() {
+#if defined(__linux__)
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * kNanosPerSecond + static_cast<uint64_t>(ts.tv_nsec);
+#else
+  return 0;
+#endif
+}
+
+void sleep_until_ns(uint64_t deadline_ns, uint64_t spin_ns) {
+  uint64_t now = now_ns();
+  if (now >= deadline_ns) {
+    return;
+  }
+  if (deadline_ns - now > spin_ns) {
+    const uint64_t wake = deadline_ns - spin_ns;
+#if defined(__linux__)
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(wake / kNanosPerSecond);
+    ts.tv_nsec = static_cast<long>(wake % kNanosPerSecond);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) != 0) {
+    }
+#else
+    std::this_thread::sleep_for(std::chrono::nanoseconds(wake - now));
+#endif
+  }
+  while (now_ns() < deadline_ns) {
+    TRACKPRO_CPU_RELAX();
+  }
+}
+
+}  // namespace trackpro
@@ -0,0 +1,34 @@
+#include "trackpro/common/file_io.h"
+
+#include <sys/types.h>
+
+namespace trackpro {
+
+bool seek_file(std::FILE* f, uint64_t offset) {
+#if defined(_WIN32)
+  return _fseeki64(f, static_cast<int64_t>(offset), SEEK_SET) == 0;
+#else
+  return fseeko(f, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+bool file_size(std::FILE* f, uint64_t& size) {
+#if defined(_WIN32)
+  if (_fseeki64(f, 0, SEEK_END) != 0) {
+    return false;
+  }
+  const int64_t end = _ftelli64(f);
+#else
+  if (fseeko(f, 0, SEEK_END) != 0) {
+    return false;
+  }
+  const off_t end = ftello(f);
+#endif
+  if (end < 0) {
+    return false;
+  }
+  size = static_cast<uint64_t>(end);
+  return true;
+}
+
+}  // namespace trackpro
@@ -0,0 +1,35 @@
+#include "trackpro/common/frame_pacer.h"
+
+#include <stdexcept>
+
+#include "trackpro/common/clock.h"
+
+namespace trackpro {
+
+FramePacer::FramePacer(double fps, uint64_t spin_ns) : spin_ns_(spin_ns) {
+  if (!(fps > 0.0)) {
+    throw std::invalid_argument("FramePacer fps must be positive");
+  }
+  period_ns_ = static_cast<uint64_t>(static_cast<double>(kNanosPerSecond) / fps);
+}
+
+uint64_t FramePacer::wait() {
+  uint64_t now = now_ns();
+  if (next_ == 0) {
+    next_ = now;
+  } else if (now < next_) {
+    sleep_until_ns(next_, spin_ns_);
+    now = now_ns();
+  } else if (now - next_ >= period_ns_) {
+    // Overran by whole frames: drop them and realign to the current one.
+    const uint64_t missed = (now - next_) / period_ns_;
+    dropped_ += missed;
+    next_ += missed * period_ns_;
+  }
+  ++frames_;
+  const uint64_t start = next_;
+  next_ += period_ns_;
+  return start;
+}
+
+}  // namespace trackpro
@@ -0,0 +1,125 @@
+#include "trackpro/common/latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace trackpro {
+namespace {
+
+unsigned log2_floor(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+  return 63u - static_cast<unsigned>(__builtin_clzll(v));
+#else
+  unsigned m = 0;
+  while (v >>= 1) {
+    ++m;
+  }
+  return m;
+#endif
+}
+
+}  // namespace
+
+size_t HistogramLayout::bucket_for(uint64_t value) {
+  if (value < kSubBuckets) {
+    return static_cast<size_t>(value);
+  }
+  const unsigned magnitude = std::min(log2_floor(value), kMaxMagnitude - 1);
+  const uint64_t clamped = std::min<uint64_t>(value, (uint64_t{1} << kMaxMagnitude) - 1);
+  const size_t sub = static_cast<size_t>((clamped >> (magnitude - 4)) & (kSubBuckets - 1));
+  return kSubBuckets + (magnitude - 4) * kSubBuckets + sub;
+}
+
+uint64_t HistogramLayout::bucket_lower(size_t bucket) {
+  if (bucket < kSubBuckets) {
+    return bucket;
+  }
+  const size_t magnitude = (bucket - kSubBuckets) / kSubBuckets + 4;
+  const size_t sub = (bucket - kSubBuckets) % kSubBuckets;
+  return static_cast<uint64_t>(kSubBuckets + sub) << (magnitude - 4);
+}
+
+uint64_t HistogramLayout::bucket_upper(size_t bucket) {
+  if (bucket < kSubBuckets) {
+    return bucket + 1;
+  }
+  const size_t magnitude = (bucket - kSubBuckets) / kSubBuckets + 4;
+  const size_t sub = (bucket - kSubBuckets) % kSubBuckets;
+  return static_cast<uint64_t>(kSubBuckets + sub + 1) << (magnitude - 4);
+}
+
+uint64_t HistogramSnapshot::percentile(double q) const {
+  if (count == 0) {
+    return 0;
+  }
+  const uint64_t rank = static_cast<uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * count));
+  uint64_t seen = 0;
+  for (size_t b = 0; b < buckets.size(); ++b) {
+    seen += buckets[b];
+    if (seen >= std::max<uint64_t>(rank, 1)) {
+      const uint64_t lo = HistogramLayout::bucket_lower(b);
+      const uint64_t hi = HistogramLayout::bucket_upper(b);
+      return std::clamp<uint64_t>(lo + (hi - lo) / 2, min, max);
+    }
+  }
+  return max;
+}
+
+double HistogramSnapshot::mean() const {
+  return count == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(count);
+}
+
+double HistogramSnapshot::stddev() const {
+  if (count < 2) {
+    return 0.0;
+  }
+  const double mu = mean();
+  double acc = 0.0;
+  for (size_t b = 0; b < buckets.size(); ++b) {
+    if (buckets[b] == 0) {
+      continue;
+    }
+    const double mid = 0.5 * static_cast<double>(HistogramLayout::bucket_lower(b) +
+                                                 HistogramLayout::bucket_upper(b));
+    acc += static_cast<double>(buckets[b]) * (mid - mu) * (mid - mu);
+  }
+  return std::sqrt(acc / static_cast<double>(count));
+}
+
+void LatencyHistogram::record(uint64_t value_ns) {
+  buckets_[HistogramLayout::bucket_for(value_ns)].fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(value_ns, std::memory_order_relaxed);
+  uint64_t seen = min_.load(std::memory_order_relaxed);
+  while (value_ns < seen && !min_.compare_exchange_weak(seen, value_ns, std::memory_order_relaxed)) {
+  }
+  seen = max_.load(std::memory_order_relaxed);
+  while (value_ns > seen && !max_.compare_exchange_weak(seen, value_ns, std::memory_order_relaxed)) {
+  }
+}
+
+HistogramSnapshot LatencyHistogram::snapshot() const {
+  HistogramSnapshot s;
+  uint64_t total = 0;
+  for (size_t b = 0; b < buckets_.size(); ++b) {
+    s.buckets[b] = buckets_[b].load(std::memory_order_relaxed);
+    total += s.buckets[b];
+  }
+  // Derive count from the copied buckets so percentiles stay self-consistent.
+  s.count = total;
+  s.sum = sum_.load(std::memory_order_relaxed);
+  s.max = max_.load(std::memory_order_relaxed);
+  const uint64_t min = min_.load(std::memory_order_relaxed);
+  s.min = min == UINT64_MAX ? 0 : min;
+  return s;
+}
+
+void LatencyHistogram::reset() {
+  for (auto& b : buckets_) {
+    b.store(0, std::memory_order_relaxed);
+  }
+  sum_.store(0, std::memory_order_relaxed);
+  min_.store(UINT64_MAX, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace trackpro
@@ -0,0 +1,216 @@
+#include "trackpro/common/mapped_region.h"
+
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace trackpro {
+
+MappedRegion::~MappedRegion() { reset(); }
+
+MappedRegion::MappedRegion(MappedRegion&& other) noexcept { *this = std::move(other); }
+
+MappedRegion& MappedRegion::operator=(MappedRegion&& other) noexcept {
+  if (this != &other) {
+    reset();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    writable_ = std::exchange(other.writable_, false);
+#if defined(_WIN32)
+    mapping_ = std::exchange(other.mapping_, nullptr);
+#endif
+  }
+  return *this;
+}
+
+#if defined(_WIN32)
+
+namespace {
+
+[[noreturn]] void throw_last_error(const std::string& what) {
+  throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), what);
+}
+
+}  // namespace
+
+void MappedRegion::reset() {
+  if (data_ != nullptr) {
+    UnmapViewOfFile(data_);
+  }
+  if (mapping_ != nullptr) {
+    CloseHandle(mapping_);
+  }
+  data_ = nullptr;
+  mapping_ = nullptr;
+  size_ = 0;
+}
+
+MappedRegion MappedRegion::open_read(const std::string& path) {
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw_last_error("open " + path);
+  }
+  LARGE_INTEGER size;
+  GetFileSizeEx(file, &size);
+  MappedRegion region;
+  region.size_ = static_cast<size_t>(size.QuadPart);
+  if (region.size_ != 0) {
+    region.mapping_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (region.mapping_ == nullptr) {
+      throw_last_error("map " + path);
+    }
+    region.data_ = static_cast<uint8_t*>(MapViewOfFile(region.mapping_, FILE_MAP_READ, 0, 0, 0));
+    if (region.data_ == nullptr) {
+      throw_last_error("map " + path);
+    }
+  } else {
+    CloseHandle(file);
+  }
+  return region;
+}
+
+MappedRegion MappedRegion::create(const std::string& path, size_t size) {
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                            CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw_last_error("create " + path);
+  }
+  MappedRegion region;
+  region.mapping_ = CreateFileMappingA(file, nullptr, PAGE_READWRITE,
+                                       static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+                                       static_cast<DWORD>(size), nullptr);
+  CloseHandle(file);
+  if (region.mapping_ == nullptr) {
+    throw_last_error("map " + path);
+  }
+  region.data_ = static_cast<uint8_t*>(MapViewOfFile(region.mapping_, FILE_MAP_WRITE, 0, 0, size));
+  if (region.data_ == nullptr) {
+    throw_last_error("map " + path);
+  }
+  region.size_ = size;
+  region.writable_ = true;
+  return region;
+}
+
+MappedRegion MappedRegion::open_named(const std::string& name) {
+  MappedRegion region;
+  region.mapping_ = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+  if (region.mapping_ == nullptr) {
+    throw_last_error("open mapping " + name);
+  }
+  region.data_ = static_cast<uint8_t*>(MapViewOfFile(region.mapping_, FILE_MAP_READ, 0, 0, 0));
+  if (region.data_ == nullptr) {
+    throw_last_error("map " + name);
+  }
+  MEMORY_BASIC_INFORMATION info;
+  VirtualQuery(region.data_, &info, sizeof(info));
+  region.size_ = info.RegionSize;
+  return region;
+}
+
+MappedRegion MappedRegion::create_named(const std::string& name, size_t size) {
+  MappedRegion region;
+  region.mapping_ = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                       static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+                                       static_cast<DWORD>(size), name.c_str());
+  if (region.mapping_ == nullptr) {
+    throw_last_error("create mapping " + name);
+  }
+  region.data_ = static_cast<uint8_t*>(MapViewOfFile(region.mapping_, FILE_MAP_WRITE, 0, 0, size));
+  if (region.data_ == nullptr) {
+    throw_last_error("map " + name);
+  }
+  region.size_ = size;
+  region.writable_ = true;
+  return region;
+}
+
+void MappedRegion::advise_random() const {}
+void MappedRegion::advise_sequential() const {}
+
+#else
+
+void MappedRegion::reset() {
+  if (data_ != nullptr) {
+    ::munmap(data_, size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+  writable_ = false;
+}
+
+MappedRegion MappedRegion::open_read(const std::string& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::system_error(errno, std::generic_category(), "open " + path);
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    const int err = errno;
+    ::close(fd);
+    throw std::system_error(err, std::generic_category(), "stat " + path);
+  }
+  MappedRegion region;
+  region.size_ = static_cast<size_t>(st.st_size);
+  if (region.size_ != 0) {
+    void* p = ::mmap(nullptr, region.size_, PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+      const int err = errno;
+      ::close(fd);
+      throw std::system_error(err, std::generic_category(), "mmap " + path);
+    }
+    region.data_ = static_cast<uint8_t*>(p);
+  }
+  ::close(fd);
+  return region;
+}
+
+MappedRegion MappedRegion::create(const std::string& path, size_t size) {
+  const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    throw std::system_error(errno, std::generic_category(), "create " + path);
+  }
+  if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    const int err = errno;
+    ::close(fd);
+    throw std::system_error(err, std::generic_category(), "truncate " + path);
+  }
+  void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  const int err = errno;
+  ::close(fd);
+  if (p == MAP_FAILED) {
+    throw std::system_error(err, std::generic_category(), "mmap " + path);
+  }
+  MappedRegion region;
+  region.data_ = static_cast<uint8_t*>(p);
+  region.size_ = size;
+  region.writable_ = true;
+  return region;
+}
+
+void MappedRegion::advise_random() const {
+  if (data_ != nullptr) {
+    ::madvise(data_, size_, MADV_RANDOM);
+  }
+}
+
+void MappedRegion::advise_sequential() const {
+  if (data_ != nullptr) {
+    ::madvise(data_, size_, MADV_SEQUENTIAL);
+  }
+}
+
+#endif
+
+}  // namespace trackpro
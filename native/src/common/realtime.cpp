@@ -0,0 +1,74 @@
+#include "trackpro/common/realtime.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace trackpro {
+
+bool promote_current_thread_realtime(int priority) {
+#if defined(__linux__)
+  sched_param param{};
+  param.sched_priority = priority;
+  return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+#elif defined(_WIN32)
+  (void)priority;
+  return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL) != 0;
+#else
+  (void)priority;
+  return false;
+#endif
+}
+
+bool demote_current_thread_background() {
+#if defined(__linux__)
+  // Linux applies nice per thread when given a thread id.
+  return setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10) == 0;
+#elif defined(_WIN32)
+  return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL) != 0;
+#else
+  return false;
+#endif
+}
+
+bool pin_current_thread(int cpu) {
+  if (cpu < 0) {
+    return true;
+  }
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+  return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << cpu) != 0;
+#else
+  return false;
+#endif
+}
+
+void enable_flush_denormals() {
+#if defined(__SSE2__) || defined(_M_X64)
+  _mm_setcsr(_mm_getcsr() | 0x8040);  // FTZ | DAZ
+#endif
+}
+
+void set_current_thread_name(const char* name) {
+#if defined(__linux__)
+  pthread_setname_np(pthread_self(), name);
+#else
+  (void)name;
+#endif
+}
+
+}  // namespace trackpro
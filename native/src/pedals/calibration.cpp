@@ -0,0 +1,23 @@
+#include "trackpro/pedals/calibration.h"
+
+#include <algorithm>
+
+namespace trackpro::pedals {
+
+float AxisCalibration::apply(uint16_t raw) const {
+  if (max <= min) {
+    return 0.0f;
+  }
+  float x = (static_cast<float>(raw) - static_cast<float>(min)) / static_cast<float>(max - min);
+  x = std::clamp(x, 0.0f, 1.0f);
+  if (inverted) {
+    x = 1.0f - x;
+  }
+  const float span = 1.0f - deadzone_low - deadzone_high;
+  if (span <= 0.0f) {
+    return 0.0f;
+  }
+  return std::clamp((x - deadzone_low) / span, 0.0f, 1.0f);
+}
+
+}  // namespace trackpro::pedals
@@ -0,0 +1,80 @@
+#include "trackpro/pedals/curve_lut.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define TRACKPRO_CURVE_SSE2 1
+#endif
+
+namespace trackpro::pedals {
+
+CurveBank::CurveBank() {
+  const ResponseCurve identity;
+  for (size_t axis = 0; axis < kPedalAxisCount; ++axis) {
+    compile(static_cast<PedalAxis>(axis), identity);
+  }
+}
+
+void CurveBank::compile(PedalAxis axis, const ResponseCurve& curve) {
+  Entry* row = table_[axis_index(axis)];
+  float previous = curve.evaluate(0.0f);
+  for (size_t i = 0; i <= kSegments; ++i) {
+    const float next = curve.evaluate(static_cast<float>(i + 1) / static_cast<float>(kSegments));
+    row[i].y = previous;
+    row[i].dy = i == kSegments ? 0.0f : next - previous;
+    previous = next;
+  }
+}
+
+void CurveBank::compile(const std::array<ResponseCurve, kPedalAxisCount>& curves) {
+  for (size_t axis = 0; axis < kPedalAxisCount; ++axis) {
+    compile(static_cast<PedalAxis>(axis), curves[axis]);
+  }
+}
+
+float CurveBank::evaluate(PedalAxis axis, float x) const {
+  const float scaled = std::clamp(x, 0.0f, 1.0f) * static_cast<float>(kSegments);
+  const size_t i = std::min(static_cast<size_t>(scaled), kSegments);
+  const Entry& e = table_[axis_index(axis)][i];
+  return e.y + (scaled - static_cast<float>(i)) * e.dy;
+}
+
+void CurveBank::evaluate4(const float in[kPedalAxisCount], float out[kPedalAxisCount]) const {
+  static_assert(kPedalAxisCount == 4, "evaluate4 is written for four pedal axes");
+#if defined(TRACKPRO_CURVE_SSE2)
+  __m128 x = _mm_loadu_ps(in);
+  x = _mm_min_ps(_mm_max_ps(x, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+  const __m128 scaled = _mm_mul_ps(x, _mm_set1_ps(static_cast<float>(kSegments)));
+  const __m128i index = _mm_cvttps_epi32(scaled);
+  const __m128 frac = _mm_sub_ps(scaled, _mm_cvtepi32_ps(index));
+#if defined(__AVX2__)
+  // Element offsets of (axis, index).y; .dy is one float further on.
+  const __m128i row = _mm_setr_epi32(0, 1 * (kSegments + 1) * 2, 2 * (kSegments + 1) * 2,
+                                     3 * (kSegments + 1) * 2);
+  const __m128i offset = _mm_add_epi32(row, _mm_slli_epi32(index, 1));
+  const float* base = &table_[0][0].y;
+  const __m128 y = _mm_i32gather_ps(base, offset, 4);
+  const __m128 dy = _mm_i32gather_ps(base + 1, offset, 4);
+#else
+  alignas(16) int32_t idx[4];
+  _mm_store_si128(reinterpret_cast<__m128i*>(idx), index);
+  // Each Entry is 8 bytes: load (y, dy) pairs and deinterleave.
+  const __m128 e01 = _mm_castpd_ps(_mm_loadh_pd(
+      _mm_load_sd(reinterpret_cast<const double*>(&table_[0][idx[0]])),
+      reinterpret_cast<const double*>(&table_[1][idx[1]])));
+  const __m128 e23 = _mm_castpd_ps(_mm_loadh_pd(
+      _mm_load_sd(reinterpret_cast<const double*>(&table_[2][idx[2]])),
+      reinterpret_cast<const double*>(&table_[3][idx[3]])));
+  const __m128 y = _mm_shuffle_ps(e01, e23, _MM_SHUFFLE(2, 0, 2, 0));
+  const __m128 dy = _mm_shuffle_ps(e01, e23, _MM_SHUFFLE(3, 1, 3, 1));
+#endif
+  _mm_storeu_ps(out, _mm_add_ps(y, _mm_mul_ps(frac, dy)));
+#else
+  for (size_t axis = 0; axis < kPedalAxisCount; ++axis) {
+    out[axis] = evaluate(static_cast<PedalAxis>(axis), in[axis]);
+  }
+#endif
+}
+
+}  // namespace trackpro::pedals
@@ -0,0 +1,112 @@
+#include "trackpro/pedals/hidraw_pedal_source.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <ctime>
+#include <system_error>
+
+#include "trackpro/common/clock.h"
+
+namespace trackpro::pedals {
+
+HidrawPedalSource::HidrawPedalSource(const std::string& device_path, HidReportLayout layout)
+    : layout_(layout) {
+  fd_ = ::open(device_path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+  if (fd_ < 0) {
+    throw std::system_error(errno, std::generic_category(), "open " + device_path);
+  }
+}
+
+HidrawPedalSource::~HidrawPedalSource() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+}
+
+bool HidrawPedalSource::wait(uint64_t deadline_ns, uint64_t spin_ns) {
+  // Sleep in ppoll until `spin_ns` before the deadline, then poll without
+  // blocking to hide timer slack, as sleep_until_ns does.
+  for (;;) {
+    if (disconnected_) {
+      sleep_until_ns(deadline_ns, spin_ns);
+      return false;
+    }
+    const uint64_t now = now_ns();
+    const uint64_t remaining = deadline_ns > now ? deadline_ns - now : 0;
+    const uint64_t sleep = remaining > spin_ns ? remaining - spin_ns : 0;
+    timespec timeout;
+    timeout.tv_sec = static_cast<time_t>(sleep / kNanosPerSecond);
+    timeout.tv_nsec = static_cast<long>(sleep % kNanosPerSecond);
+    pollfd pfd{fd_, POLLIN, 0};
+    const int rc = ::ppoll(&pfd, 1, &timeout, nullptr);
+    if (rc > 0 && (pfd.revents & (POLLHUP | POLLERR | POLLNVAL)) != 0) {
+      disconnected_ = true;
+      continue;
+    }
+    if (rc > 0 && (pfd.revents & POLLIN) != 0) {
+      return true;
+    }
+    if (now_ns() >= deadline_ns) {
+      return false;
+    }
+  }
+}
+
+bool HidrawPedalSource::read(RawPedalSample& out) {
+  uint8_t buffer[64];
+  bool got = false;
+  for (;;) {
+    const ssize_t n = ::read(fd_, buffer, sizeof(buffer));
+    if (n < 0 && errno != EAGAIN && errno != EINTR) {
+      disconnected_ = true;  // ENODEV once the device is unplugged
+    }
+    if (n <= 0) {
+      break;
+    }
+    RawPedalSample decoded = last_;
+    if (decode(layout_, buffer, static_cast<size_t>(n), decoded)) {
+      decoded.timestamp_ns = now_ns();
+      last_ = decoded;
+      got = true;
+    }
+  }
+  if (got) {
+    out = last_;
+  }
+  return got;
+}
+
+bool HidrawPedalSource::decode(const HidReportLayout& layout, const uint8_t* report, size_t size,
+                               RawPedalSample& out) {
+  size_t base = 0;
+  if (layout.report_id >= 0) {
+    if (size == 0 || report[0] != static_cast<uint8_t>(layout.report_id)) {
+      return false;
+    }
+    base = 1;
+  }
+  for (size_t axis = 0; axis < kPedalAxisCount; ++axis) {
+    const HidAxisField& field = layout.axes[axis];
+    if (field.byte_offset < 0) {
+      continue;
+    }
+    const size_t at = base + static_cast<size_t>(field.byte_offset);
+    if (field.bits == 8) {
+      if (at >= size) {
+        return false;
+      }
+      out.raw[axis] = static_cast<uint16_t>(report[at] * 257);  // stretch to 16 bits
+    } else {
+      if (at + 1 >= size) {
+        return false;
+      }
+      out.raw[axis] = static_cast<uint16_t>(report[at] | (report[at + 1] << 8));
+    }
+  }
+  return true;
+}
+
+}  // namespace trackpro::pedals
@@ -0,0 +1,137 @@
+#include "trackpro/pedals/pedal_engine.h"
+
+#include <stdexcept>
+#include <utility>
+
+#include "trackpro/common/clock.h"
+#include "trackpro/common/realtime.h"
+
+namespace trackpro::pedals {
+
+PedalEngine::PedalEngine(std::unique_ptr<PedalSource> source, PedalOutputSink& sink,
+                         PedalConfig config, PedalEngineOptions options)
+    : source_(std::move(source)),
+      sink_(sink),
+      options_(options),
+      submitted_(std::move(config)),
+      pipelines_(PedalPipeline(submitted_)) {
+  if (!source_) {
+    throw std::invalid_argument("PedalEngine requires a source");
+  }
+  if (options_.rate_hz == 0) {
+    throw std::invalid_argument("PedalEngine rate must be non-zero");
+  }
+}
+
+PedalEngine::~PedalEngine() { stop(); }
+
+void PedalEngine::start() {
+  if (running_.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  thread_ = std::thread([this] { run(); });
+}
+
+void PedalEngine::stop() {
+  running_.store(false, std::memory_order_release);
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void PedalEngine::update_config(PedalConfig config) {
+  std::lock_guard<std::mutex> lock(update_mutex_);
+  submitted_ = config;
+  pipelines_.write_buffer().set_config(std::move(config));
+  pipelines_.publish();
+}
+
+PedalConfig PedalEngine::config() const {
+  std::lock_guard<std::mutex> lock(update_mutex_);
+  return submitted_;
+}
+
+PedalEngineCounters PedalEngine::counters() const {
+  PedalEngineCounters c;
+  c.reports = reports_.load(std::memory_order_relaxed);
+  c.ticks = ticks_.load(std::memory_order_relaxed);
+  c.idle_ticks = idle_ticks_.load(std::memory_order_relaxed);
+  c.late_ticks = late_ticks_.load(std::memory_order_relaxed);
+  c.disconnected_ticks = disconnected_ticks_.load(std::memory_order_relaxed);
+  return c;
+}
+
+bool PedalEngine::read_source(RawPedalSample& sample) {
+  if (options_.stats == nullptr) {
+    return source_->read(sample);
+  }
+  const uint64_t t0 = now_ns();
+  const bool got = source_->read(sample);
+  if (got) {
+    options_.stats->record(PedalStage::HidRead, now_ns() - t0);
+  }
+  return got;
+}
+
+void PedalEngine::process_and_emit(const RawPedalSample& sample) {
+  pipelines_.update();
+  PedalOutput out;
+  pipelines_.read_buffer().process(sample, out, filter_state_, options_.stats);
+  out.sequence = sequence_++;
+  out.output_timestamp_ns = now_ns();
+  if (options_.stats != nullptr) {
+    options_.stats->record(PedalStage::InputToEmit, out.output_timestamp_ns - sample.timestamp_ns);
+  }
+  sink_.emit(out);
+  reports_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PedalEngine::run() {
+  set_current_thread_name("tp-pedals");
+  pin_current_thread(options_.cpu);
+  enable_flush_denormals();
+  realtime_.store(promote_current_thread_realtime(options_.realtime_priority),
+                  std::memory_order_release);
+
+  const uint64_t period = kNanosPerSecond / options_.rate_hz;
+  uint64_t next_tick = now_ns() + period;
+  bool produced_this_period = false;
+  RawPedalSample sample;
+
+  while (running_.load(std::memory_order_acquire)) {
+    if (source_->wait(next_tick, options_.spin_ns) && read_source(sample)) {
+      process_and_emit(sample);
+      produced_this_period = true;
+    }
+
+    const uint64_t now = now_ns();
+    if (now < next_tick) {
+      continue;
+    }
+    if (options_.stats != nullptr) {
+      options_.stats->record(PedalStage::TickJitter, now - next_tick);
+    }
+    if (source_->disconnected()) {
+      disconnected_.store(true, std::memory_order_release);
+      disconnected_ticks_.fetch_add(1, std::memory_order_relaxed);
+    } else if (!produced_this_period) {
+      if (read_source(sample)) {
+        process_and_emit(sample);
+      } else {
+        idle_ticks_.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    produced_this_period = false;
+    ticks_.fetch_add(1, std::memory_order_relaxed);
+
+    next_tick += period;
+    if (now >= next_tick) {
+      // Overslept by at least a whole period: resynchronise rather than
+      // bursting through the backlog of missed ticks.
+      late_ticks_.fetch_add((now - next_tick) / period + 1, std::memory_order_relaxed);
+      next_tick = now + period;
+    }
+  }
+}
+
+}  // namespace trackpro::pedals
@@ -0,0 +1,166 @@
+#include "trackpro/pedals/pedal_filter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "trackpro/common/clock.h"
+#include "trackpro/common/simd4.h"
+
+namespace trackpro::pedals {
+namespace {
+
+constexpr float kTwoPi = 6.28318530717958647692f;
+
+using simd::Vec4;
+
+// Smoothing factor of a first-order low-pass with cutoff `fc` at step `dt`.
+Vec4 euro_alpha(Vec4 fc, Vec4 dt) {
+  const Vec4 r = simd::splat(kTwoPi) * fc * dt;
+  return r / (r + simd::splat(1.0f));
+}
+
+}  // namespace
+
+const char* filter_name(FilterKind kind) {
+  switch (kind) {
+    case FilterKind::None:
+      return "none";
+    case FilterKind::OneEuro:
+      return "one-euro";
+    case FilterKind::Biquad:
+      return "biquad";
+    case FilterKind::Median3:
+      return "median3";
+  }
+  return "unknown";
+}
+
+FilterBank::FilterBank() { configure({}, 1000.0f); }
+
+void FilterBank::configure(const std::array<FilterSettings, kPedalAxisCount>& settings,
+                           float sample_rate_hz) {
+  settings_ = settings;
+  sample_rate_hz_ = sample_rate_hz > 0.0f ? sample_rate_hz : 1000.0f;
+  active_ = false;
+  for (auto& kind : lane_) {
+    std::fill(std::begin(kind), std::end(kind), false);
+  }
+
+  for (size_t axis = 0; axis < kPedalAxisCount; ++axis) {
+    const FilterSettings& s = settings_[axis];
+    lane_[static_cast<size_t>(s.kind)][axis] = true;
+    active_ = active_ || s.kind != FilterKind::None;
+
+    // RBJ low-pass, normalised by a0. Cutoff is kept below Nyquist.
+    const float fc = std::clamp(s.cutoff_hz, 0.1f, 0.45f * sample_rate_hz_);
+    const float w0 = kTwoPi * fc / sample_rate_hz_;
+    const float alpha = std::sin(w0) / (2.0f * std::max(s.q, 0.1f));
+    const float cosw = std::cos(w0);
+    const float a0 = 1.0f + alpha;
+    b0_[axis] = (1.0f - cosw) * 0.5f / a0;
+    b1_[axis] = (1.0f - cosw) / a0;
+    b2_[axis] = b0_[axis];
+    a1_[axis] = -2.0f * cosw / a0;
+    a2_[axis] = (1.0f - alpha) / a0;
+
+    min_cutoff_[axis] = std::max(s.min_cutoff_hz, 0.01f);
+    beta_[axis] = std::max(s.beta, 0.0f);
+    derivative_cutoff_[axis] = std::max(s.derivative_cutoff_hz, 0.01f);
+  }
+}
+
+void FilterBank::apply(uint64_t timestamp_ns, float values[kPedalAxisCount], FilterState& s) const {
+  if (!active_) {
+    s.primed = false;
+    return;
+  }
+  const Vec4 x = simd::load(values);
+
+  if (!s.primed) {
+    // Start every kernel in steady state at the current input so enabling a
+    // filter never produces a transient.
+    simd::store(s.median_x1, x);
+    simd::store(s.median_x2, x);
+    const Vec4 z2 = (simd::load(b2_) - simd::load(a2_)) * x;
+    simd::store(s.biquad_z2, z2);
+    simd::store(s.biquad_z1, (simd::load(b1_) - simd::load(a1_)) * x + z2);
+    simd::store(s.euro_x, x);
+    simd::store(s.euro_dx, simd::splat(0.0f));
+    s.last_timestamp_ns = timestamp_ns;
+    s.primed = true;
+    return;
+  }
+
+  // All kernels run every sample, keeping each lane's history warm so an
+  // axis can switch kind without a restart.
+
+  // Median of three: max(min(a, b), min(max(a, b), c)).
+  const Vec4 x1 = simd::load(s.median_x1);
+  const Vec4 x2 = simd::load(s.median_x2);
+  const Vec4 median = simd::max(simd::min(x, x1), simd::min(simd::max(x, x1), x2));
+  simd::store(s.median_x2, x1);
+  simd::store(s.median_x1, x);
+
+  // Biquad, transposed direct form II.
+  const Vec4 z1 = simd::load(s.biquad_z1);
+  const Vec4 z2 = simd::load(s.biquad_z2);
+  const Vec4 biquad = simd::load(b0_) * x + z1;
+  simd::store(s.biquad_z1, simd::load(b1_) * x - simd::load(a1_) * biquad + z2);
+  simd::store(s.biquad_z2, simd::load(b2_) * x - simd::load(a2_) * biquad);
+
+  // One-euro.
+  float dt_s = static_cast<float>(timestamp_ns - s.last_timestamp_ns) / static_cast<float>(kNanosPerSecond);
+  if (!(dt_s > 0.0f)) {
+    dt_s = 1.0f / sample_rate_hz_;
+  }
+  s.last_timestamp_ns = timestamp_ns;
+  const Vec4 dt = simd::splat(dt_s);
+  const Vec4 prev_x = simd::load(s.euro_x);
+  const Vec4 prev_dx = simd::load(s.euro_dx);
+  const Vec4 dx = (x - prev_x) / dt;
+  const Vec4 edx = prev_dx + euro_alpha(simd::load(derivative_cutoff_), dt) * (dx - prev_dx);
+  const Vec4 cutoff = simd::load(min_cutoff_) + simd::load(beta_) * simd::abs(edx);
+  const Vec4 euro = prev_x + euro_alpha(cutoff, dt) * (x - prev_x);
+  simd::store(s.euro_x, euro);
+  simd::store(s.euro_dx, edx);
+
+  auto mask = [this](FilterKind kind) {
+    const bool* l = lane_[static_cast<size_t>(kind)];
+    return simd::lanes(l[0], l[1], l[2], l[3]);
+  };
+  Vec4 out = simd::select(mask(FilterKind::Median3), median, x);
+  out = simd::select(mask(FilterKind::Biquad), biquad, out);
+  out = simd::select(mask(FilterKind::OneEuro), euro, out);
+  simd::store(values, out);
+}
+
+float FilterBank::group_delay_ms(PedalAxis axis, float speed_per_s) const {
+  const size_t a = axis_index(axis);
+  float samples = 0.0f;
+  switch (settings_[a].kind) {
+    case FilterKind::None:
+      break;
+    case FilterKind::Median3:
+      samples = 1.0f;
+      break;
+    case FilterKind::Biquad: {
+      // Group delay at DC of B(z)/A(z): sum(k*b_k)/sum(b_k) - sum(k*a_k)/sum(a_k).
+      const float b_sum = b0_[a] + b1_[a] + b2_[a];
+      const float a_sum = 1.0f + a1_[a] + a2_[a];
+      samples = (b1_[a] + 2.0f * b2_[a]) / b_sum - (a1_[a] + 2.0f * a2_[a]) / a_sum;
+      break;
+    }
+    case FilterKind::OneEuro: {
+      // First-order EMA at the cutoff for this speed: (1 - alpha) / alpha
+      // samples.
+      const float cutoff = min_cutoff_[a] + beta_[a] * std::fabs(speed_per_s);
+      const float r = kTwoPi * cutoff / sample_rate_hz_;
+      const float alpha = r / (r + 1.0f);
+      samples = (1.0f - alpha) / alpha;
+      break;
+    }
+  }
+  return samples * 1000.0f / sample_rate_hz_;
+}
+
+}  // namespace trackpro::pedals
@@ -0,0 +1,41 @@
+#include "trackpro/pedals/pedal_pipeline.h"
+
+#include <utility>
+
+#include "trackpro/common/clock.h"
+
+namespace trackpro::pedals {
+
+PedalPipeline::PedalPipeline(PedalConfig config) : config_(std::move(config)) {
+  curves_.compile(config_.curves);
+  filters_.configure(config_.filters, config_.sample_rate_hz);
+}
+
+void PedalPipeline::set_config(PedalConfig config) {
+  config_ = std::move(config);
+  curves_.compile(config_.curves);
+  filters_.configure(config_.filters, config_.sample_rate_hz);
+}
+
+void PedalPipeline::process(const RawPedalSample& in, PedalOutput& out, FilterState& filter_state,
+                            PipelineStats* stats) const {
+  out.input_timestamp_ns = in.timestamp_ns;
+  const uint64_t t0 = stats ? now_ns() : 0;
+  float calibrated[kPedalAxisCount];
+  for (size_t axis = 0; axis < kPedalAxisCount; ++axis) {
+    calibrated[axis] = config_.calibration[axis].apply(in.raw[axis]);
+  }
+  const uint64_t t1 = stats ? now_ns() : 0;
+  curves_.evaluate4(calibrated, out.value.data());
+  const uint64_t t2 = stats ? now_ns() : 0;
+  filters_.apply(in.timestamp_ns, out.value.data(), filter_state);
+  if (stats) {
+    stats->record(PedalStage::Calibrate, t1 - t0);
+    stats->record(PedalStage::Curve, t2 - t1);
+    if (filters_.active()) {
+      stats->record(PedalStage::Filter, now_ns() - t2);
+    }
+  }
+}
+
+}  // namespace trackpro::pedals
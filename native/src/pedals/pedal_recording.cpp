@@ -0,0 +1,147 @@
+#include "trackpro/pedals/pedal_recording.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include "trackpro/common/byte_io.h"
+
+namespace trackpro::pedals {
+namespace {
+
+constexpr char kMagic[4] = {'T', 'P', 'P', 'R'};
+constexpr uint16_t kVersion = 1;
+constexpr size_t kHeaderSize = 32;
+constexpr long kStartTimestampOffset = 16;
+constexpr long kReportCountOffset = 24;
+// A record is a timestamp delta and one delta per axis, each a varint of at
+// least one byte.
+constexpr size_t kMinRecordBytes = 1 + kPedalAxisCount;
+
+}  // namespace
+
+PedalRecorder::PedalRecorder(const std::string& path, uint32_t rate_hz) : path_(path) {
+  file_ = std::fopen(path.c_str(), "wb");
+  if (file_ == nullptr) {
+    throw std::system_error(errno, std::generic_category(), "create " + path);
+  }
+  std::setvbuf(file_, nullptr, _IOFBF, 1 << 16);
+  header_.rate_hz = rate_hz;
+  // Everything but the start time and the report count is known now, so a
+  // recorder that never reaches close() still leaves a loadable file. The
+  // start time is patched in by the first append().
+  uint8_t header[kHeaderSize] = {};
+  std::memcpy(header, kMagic, sizeof(kMagic));
+  put_u16(header + 4, kVersion);
+  put_u16(header + 6, static_cast<uint16_t>(kPedalAxisCount));
+  put_u32(header + 8, header_.rate_hz);
+  ok_ = std::fwrite(header, 1, sizeof(header), file_) == sizeof(header) && std::fflush(file_) == 0;
+}
+
+PedalRecorder::~PedalRecorder() { close(); }
+
+bool PedalRecorder::append(const RawPedalSample& sample) {
+  if (file_ == nullptr) {
+    return false;
+  }
+  if (count_ == 0) {
+    header_.start_timestamp_ns = sample.timestamp_ns;
+    previous_ = sample;
+    previous_.raw = {};
+    uint8_t start[8];
+    put_u64(start, header_.start_timestamp_ns);
+    ok_ = ok_ && std::fseek(file_, kStartTimestampOffset, SEEK_SET) == 0 &&
+          std::fwrite(start, 1, sizeof(start), file_) == sizeof(start) && std::fseek(file_, 0, SEEK_END) == 0;
+  }
+  uint8_t record[10 + kPedalAxisCount * 3];
+  const uint64_t delta = sample.timestamp_ns >= previous_.timestamp_ns
+                             ? sample.timestamp_ns - previous_.timestamp_ns
+                             : 0;
+  size_t n = put_varint(record, delta);
+  for (size_t axis = 0; axis < kPedalAxisCount; ++axis) {
+    n += put_varint(record + n, zigzag(static_cast<int64_t>(sample.raw[axis]) - previous_.raw[axis]));
+  }
+  ok_ = ok_ && std::fwrite(record, 1, n, file_) == n;
+  previous_ = sample;
+  ++count_;
+  return ok_;
+}
+
+bool PedalRecorder::close() {
+  if (file_ == nullptr) {
+    return ok_;
+  }
+  header_.report_count = count_;
+  uint8_t report_count[8];
+  put_u64(report_count, header_.report_count);
+  ok_ = ok_ && std::fseek(file_, kReportCountOffset, SEEK_SET) == 0 &&
+        std::fwrite(report_count, 1, sizeof(report_count), file_) == sizeof(report_count);
+  ok_ = std::fclose(file_) == 0 && ok_;
+  file_ = nullptr;
+  return ok_;
+}
+
+PedalRecording PedalRecording::load(const std::string& path) {
+  std::FILE* f = std::fopen(path.c_str(), "rb");
+  if (f == nullptr) {
+    throw std::runtime_error("cannot open pedal recording " + path + ": " + std::strerror(errno));
+  }
+  std::vector<uint8_t> bytes;
+  uint8_t chunk[1 << 16];
+  for (size_t n; (n = std::fread(chunk, 1, sizeof(chunk), f)) > 0;) {
+    bytes.insert(bytes.end(), chunk, chunk + n);
+  }
+  std::fclose(f);
+
+  if (bytes.size() < kHeaderSize || std::memcmp(bytes.data(), kMagic, sizeof(kMagic)) != 0) {
+    throw std::runtime_error(path + " is not a TrackPro pedal recording");
+  }
+  if (get_le(bytes.data() + 4, 2) != kVersion || get_le(bytes.data() + 6, 2) != kPedalAxisCount) {
+    throw std::runtime_error(path + ": unsupported pedal recording version");
+  }
+
+  PedalRecording rec;
+  rec.header_.rate_hz = static_cast<uint32_t>(get_le(bytes.data() + 8, 4));
+  rec.header_.start_timestamp_ns = get_le(bytes.data() + kStartTimestampOffset, 8);
+  rec.header_.report_count = get_le(bytes.data() + kReportCountOffset, 8);
+  // The stored count is only a hint: a corrupt one must not size the
+  // allocation past what the payload can hold.
+  const uint64_t max_reports = (bytes.size() - kHeaderSize) / kMinRecordBytes;
+  rec.samples_.reserve(static_cast<size_t>(std::min(rec.header_.report_count, max_reports)));
+
+  const uint8_t* p = bytes.data() + kHeaderSize;
+  const uint8_t* end = bytes.data() + bytes.size();
+  RawPedalSample current;
+  current.timestamp_ns = rec.header_.start_timestamp_ns;
+  while (p < end) {
+    RawPedalSample next = current;
+    uint64_t v;
+    if (!get_varint(p, end, v)) {
+      break;
+    }
+    next.timestamp_ns += v;
+    bool complete = true;
+    for (size_t axis = 0; axis < kPedalAxisCount && complete; ++axis) {
+      complete = get_varint(p, end, v);
+      next.raw[axis] = static_cast<uint16_t>(next.raw[axis] + unzigzag(v));
+    }
+    if (!complete) {
+      break;  // torn final record from an unclean shutdown
+    }
+    rec.samples_.push_back(next);
+    current = next;
+  }
+  rec.header_.report_count = rec.samples_.size();
+  return rec;
+}
+
+double PedalRecording::duration_seconds() const {
+  if (samples_.size() < 2) {
+    return 0.0;
+  }
+  return static_cast<double>(samples_.back().timestamp_ns - samples_.front().timestamp_ns) / 1e9;
+}
+
+}  // namespace trackpro::pedals
@@ -0,0 +1,140 @@
+#include "trackpro/pedals/pedal_replay.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include "trackpro/common/clock.h"
+#include "trackpro/common/realtime.h"
+
+namespace trackpro::pedals {
+
+RecordingPedalSource::RecordingPedalSource(std::unique_ptr<PedalSource> inner,
+                                           const std::string& path, uint32_t rate_hz)
+    : inner_(std::move(inner)), recorder_(path, rate_hz) {
+  if (!inner_) {
+    throw std::invalid_argument("RecordingPedalSource requires a source");
+  }
+  writer_ = std::thread([this] { run(); });
+}
+
+RecordingPedalSource::~RecordingPedalSource() {
+  running_.store(false, std::memory_order_release);
+  writer_.join();
+  recorder_.close();
+}
+
+bool RecordingPedalSource::read(RawPedalSample& out) {
+  if (!inner_->read(out)) {
+    return false;
+  }
+  if (!ring_.try_push(out)) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+  }
+  return true;
+}
+
+void RecordingPedalSource::run() {
+  set_current_thread_name("tp-pedal-rec");
+  RawPedalSample sample;
+  for (;;) {
+    const bool stopping = !running_.load(std::memory_order_acquire);
+    bool any = false;
+    while (ring_.try_pop(sample)) {
+      recorder_.append(sample);
+      any = true;
+    }
+    if (stopping) {
+      return;
+    }
+    if (!any) {
+      sleep_until_ns(now_ns() + 5 * kNanosPerMilli, 0);
+    }
+  }
+}
+
+ReplayPedalSource::ReplayPedalSource(std::shared_ptr<const PedalRecording> recording, bool loop)
+    : recording_(std::move(recording)), loop_(loop) {
+  if (!recording_ || recording_->samples().empty()) {
+    throw std::invalid_argument("ReplayPedalSource requires a non-empty recording");
+  }
+  base_ns_ = now_ns();
+}
+
+uint64_t ReplayPedalSource::due_ns(size_t index) const {
+  const auto& samples = recording_->samples();
+  return base_ns_ + loop_offset_ns_ + (samples[index].timestamp_ns - samples.front().timestamp_ns);
+}
+
+bool ReplayPedalSource::wait(uint64_t deadline_ns, uint64_t spin_ns) {
+  if (finished()) {
+    sleep_until_ns(deadline_ns, spin_ns);
+    return false;
+  }
+  const uint64_t due = due_ns(next_);
+  sleep_until_ns(due < deadline_ns ? due : deadline_ns, spin_ns);
+  return now_ns() >= due;
+}
+
+bool ReplayPedalSource::read(RawPedalSample& out) {
+  const auto& samples = recording_->samples();
+  const uint64_t now = now_ns();
+  bool got = false;
+  while (!finished() && due_ns(next_) <= now) {
+    out = samples[next_];
+    out.timestamp_ns = due_ns(next_);
+    got = true;
+    if (++next_ == samples.size() && loop_) {
+      const uint64_t period = samples.size() > 1 ? samples[1].timestamp_ns - samples[0].timestamp_ns : 0;
+      loop_offset_ns_ += samples.back().timestamp_ns - samples.front().timestamp_ns + period;
+      next_ = 0;
+    }
+  }
+  return got;
+}
+
+PedalReplayDriver::PedalReplayDriver(std::shared_ptr<const PedalRecording> recording, PedalConfig config)
+    : recording_(std::move(recording)), pipeline_(std::move(config)) {
+  if (!recording_) {
+    throw std::invalid_argument("PedalReplayDriver requires a recording");
+  }
+}
+
+ReplayResult PedalReplayDriver::run(PedalOutputSink* sink, PipelineStats* stats, double speed) {
+  const auto& samples = recording_->samples();
+  ReplayResult result;
+  result.recorded_seconds = recording_->duration_seconds();
+  result.checksum = 1469598103934665603ull;
+
+  FilterState filter_state;
+  PedalOutput out;
+  const uint64_t start = now_ns();
+  const uint64_t first_ts = samples.empty() ? 0 : samples.front().timestamp_ns;
+
+  for (size_t i = 0; i < samples.size(); ++i) {
+    const RawPedalSample& sample = samples[i];
+    if (speed > 0.0) {
+      sleep_until_ns(start + static_cast<uint64_t>(static_cast<double>(sample.timestamp_ns - first_ts) / speed));
+    }
+    const uint64_t picked_up = stats ? now_ns() : 0;
+    pipeline_.process(sample, out, filter_state, stats);
+    out.sequence = i;
+    out.output_timestamp_ns = now_ns();
+    if (stats) {
+      stats->record(PedalStage::InputToEmit, out.output_timestamp_ns - picked_up);
+    }
+    if (sink) {
+      sink->emit(out);
+    }
+    for (float v : out.value) {
+      uint32_t bits;
+      std::memcpy(&bits, &v, sizeof(bits));
+      result.checksum = (result.checksum ^ bits) * 1099511628211ull;
+    }
+  }
+  result.samples = samples.size();
+  result.wall_seconds = static_cast<double>(now_ns() - start) / 1e9;
+  return result;
+}
+
+}  // namespace trackpro::pedals
@@ -0,0 +1,12 @@
+#include "trackpro/pedals/pedal_source.h"
+
+#include "trackpro/common/clock.h"
+
+namespace trackpro::pedals {
+
+bool PedalSource::wait(uint64_t deadline_ns, uint64_t spin_ns) {
+  sleep_until_ns(deadline_ns, spin_ns);
+  return true;
+}
+
+}  // namespace trackpro::pedals
@@ -0,0 +1,19 @@
+#include "trackpro/pedals/pedal_types.h"
+
+namespace trackpro::pedals {
+
+const char* axis_name(PedalAxis axis) {
+  switch (axis) {
+    case PedalAxis::Throttle:
+      return "throttle";
+    case PedalAxis::Brake:
+      return "brake";
+    case PedalAxis::Clutch:
+      return "clutch";
+    case PedalAxis::Handbrake:
+      return "handbrake";
+  }
+  return "unknown";
+}
+
+}  // namespace trackpro::pedals
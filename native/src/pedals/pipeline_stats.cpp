@@ -0,0 +1,102 @@
+#include "trackpro/pedals/pipeline_stats.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "trackpro/common/clock.h"
+
+namespace trackpro::pedals {
+
+const char* stage_name(PedalStage stage) {
+  switch (stage) {
+    case PedalStage::HidRead:
+      return "hid_read";
+    case PedalStage::Calibrate:
+      return "calibrate";
+    case PedalStage::Curve:
+      return "curve";
+    case PedalStage::Filter:
+      return "filter";
+    case PedalStage::VJoyWrite:
+      return "vjoy_write";
+    case PedalStage::InputToEmit:
+      return "input_to_emit";
+    case PedalStage::InputToVJoy:
+      return "input_to_vjoy";
+    case PedalStage::TickJitter:
+      return "tick_jitter";
+  }
+  return "unknown";
+}
+
+StageSummary PipelineStatsSnapshot::summary(PedalStage stage) const {
+  const HistogramSnapshot& h = stages[static_cast<size_t>(stage)];
+  StageSummary s;
+  s.count = h.count;
+  s.min_ns = h.min;
+  s.p50_ns = h.percentile(0.50);
+  s.p99_ns = h.percentile(0.99);
+  s.p999_ns = h.percentile(0.999);
+  s.max_ns = h.max;
+  s.mean_ns = h.mean();
+  s.jitter_ns = h.stddev();
+  return s;
+}
+
+std::string PipelineStatsSnapshot::to_json() const {
+  std::ostringstream out;
+  out << "{\"taken_at_ns\":" << taken_at_ns << ",\"stages\":{";
+  for (size_t i = 0; i < kPedalStageCount; ++i) {
+    const auto stage = static_cast<PedalStage>(i);
+    const StageSummary s = summary(stage);
+    out << (i ? "," : "") << '"' << stage_name(stage) << "\":{\"count\":" << s.count
+        << ",\"min_ns\":" << s.min_ns << ",\"p50_ns\":" << s.p50_ns << ",\"p99_ns\":" << s.p99_ns
+        << ",\"p999_ns\":" << s.p999_ns << ",\"max_ns\":" << s.max_ns
+        << ",\"mean_ns\":" << static_cast<uint64_t>(s.mean_ns)
+        << ",\"jitter_ns\":" << static_cast<uint64_t>(s.jitter_ns) << '}';
+  }
+  out << "}}";
+  return out.str();
+}
+
+bool PipelineStatsSnapshot::append_csv(const std::string& path) const {
+  bool is_new = true;
+  if (std::FILE* f = std::fopen(path.c_str(), "rb")) {
+    std::fseek(f, 0, SEEK_END);
+    is_new = std::ftell(f) == 0;
+    std::fclose(f);
+  }
+  std::ofstream out(path, std::ios::app);
+  if (!out) {
+    return false;
+  }
+  if (is_new) {
+    out << "taken_at_ns,stage,count,min_ns,p50_ns,p99_ns,p999_ns,max_ns,mean_ns,jitter_ns\n";
+  }
+  for (size_t i = 0; i < kPedalStageCount; ++i) {
+    const auto stage = static_cast<PedalStage>(i);
+    const StageSummary s = summary(stage);
+    out << taken_at_ns << ',' << stage_name(stage) << ',' << s.count << ',' << s.min_ns << ','
+        << s.p50_ns << ',' << s.p99_ns << ',' << s.p999_ns << ',' << s.max_ns << ','
+        << static_cast<uint64_t>(s.mean_ns) << ',' << static_cast<uint64_t>(s.jitter_ns) << '\n';
+  }
+  return static_cast<bool>(out);
+}
+
+PipelineStatsSnapshot PipelineStats::snapshot() const {
+  PipelineStatsSnapshot s;
+  s.taken_at_ns = now_ns();
+  for (size_t i = 0; i < kPedalStageCount; ++i) {
+    s.stages[i] = histograms_[i].snapshot();
+  }
+  return s;
+}
+
+void PipelineStats::reset() {
+  for (auto& h : histograms_) {
+    h.reset();
+  }
+}
+
+}  // namespace trackpro::pedals
@@ -0,0 +1,52 @@
+#include "trackpro/pedals/response_curve.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace trackpro::pedals {
+
+ResponseCurve::ResponseCurve() : points_{{0.0f, 0.0f}, {1.0f, 1.0f}} {}
+
+ResponseCurve::ResponseCurve(std::vector<CurvePoint> points) : points_(std::move(points)) {
+  if (points_.size() < 2) {
+    throw std::invalid_argument("ResponseCurve needs at least two points");
+  }
+  std::sort(points_.begin(), points_.end(),
+            [](const CurvePoint& a, const CurvePoint& b) { return a.x < b.x; });
+}
+
+ResponseCurve ResponseCurve::preset(const std::string& name) {
+  if (name == "linear") {
+    return ResponseCurve();
+  }
+  if (name == "progressive") {
+    return ResponseCurve({{0.0f, 0.0f}, {0.25f, 0.08f}, {0.5f, 0.25f}, {0.75f, 0.55f}, {1.0f, 1.0f}});
+  }
+  if (name == "aggressive") {
+    return ResponseCurve({{0.0f, 0.0f}, {0.25f, 0.45f}, {0.5f, 0.75f}, {0.75f, 0.92f}, {1.0f, 1.0f}});
+  }
+  if (name == "s-curve") {
+    return ResponseCurve({{0.0f, 0.0f}, {0.25f, 0.1f}, {0.5f, 0.5f}, {0.75f, 0.9f}, {1.0f, 1.0f}});
+  }
+  throw std::invalid_argument("unknown curve preset: " + name);
+}
+
+float ResponseCurve::evaluate(float x) const {
+  if (x <= points_.front().x) {
+    return points_.front().y;
+  }
+  if (x >= points_.back().x) {
+    return points_.back().y;
+  }
+  auto hi = std::upper_bound(points_.begin(), points_.end(), x,
+                             [](float v, const CurvePoint& p) { return v < p.x; });
+  auto lo = hi - 1;
+  const float dx = hi->x - lo->x;
+  if (dx <= 0.0f) {
+    return hi->y;
+  }
+  const float t = (x - lo->x) / dx;
+  return lo->y + t * (hi->y - lo->y);
+}
+
+}  // namespace trackpro::pedals
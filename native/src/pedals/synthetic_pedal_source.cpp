@@ -0,0 +1,80 @@
+#include "trackpro/pedals/synthetic_pedal_source.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "trackpro/common/clock.h"
+
+namespace trackpro::pedals {
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+uint16_t to_counts(double x) {
+  return static_cast<uint16_t>(std::clamp(x, 0.0, 1.0) * 65535.0 + 0.5);
+}
+
+// Brake application shaped like a real stab: fast rise, plateau with trail
+// off, released before the next corner.
+double brake_profile(double t) {
+  const double phase = std::fmod(t, 4.0);
+  if (phase < 0.08) {
+    return phase / 0.08 * 0.9;
+  }
+  if (phase < 0.6) {
+    return 0.9 - (phase - 0.08) * 0.4;
+  }
+  if (phase < 1.2) {
+    return std::max(0.0, 0.69 * (1.2 - phase) / 0.6);
+  }
+  return 0.0;
+}
+
+}  // namespace
+
+SyntheticPedalSource::SyntheticPedalSource(SyntheticPedalOptions options)
+    : options_(options),
+      period_ns_(kNanosPerSecond / std::max<uint32_t>(1, options.report_rate_hz)),
+      start_ns_(now_ns()),
+      next_report_ns_(start_ns_ + period_ns_),
+      rng_(options.seed),
+      noise_(0.0f, std::max(options.noise_counts, 1e-6f)) {}
+
+RawPedalSample SyntheticPedalSource::generate(double t) {
+  RawPedalSample s;
+  const double brake = brake_profile(t);
+  const double throttle = brake > 0.0 ? 0.0 : 0.5 + 0.5 * std::sin(2.0 * kPi * 0.35 * t);
+  const double clutch = std::fmod(t, 9.0) < 0.4 ? 1.0 : 0.0;
+  const double handbrake = std::fmod(t, 15.0) < 0.25 ? 0.8 : 0.0;
+  s.raw = {to_counts(throttle), to_counts(brake), to_counts(clutch), to_counts(handbrake)};
+  return s;
+}
+
+bool SyntheticPedalSource::wait(uint64_t deadline_ns, uint64_t spin_ns) {
+  sleep_until_ns(std::min(deadline_ns, next_report_ns_), spin_ns);
+  return now_ns() >= next_report_ns_;
+}
+
+bool SyntheticPedalSource::read(RawPedalSample& out) {
+  const uint64_t now = now_ns();
+  if (now < next_report_ns_) {
+    return false;
+  }
+  // Reports that piled up while we were not reading are superseded by the
+  // newest one, exactly like a HID device queue drained in one go.
+  const uint64_t pending = (now - next_report_ns_) / period_ns_;
+  missed_reports_ += pending;
+  const uint64_t report_ns = next_report_ns_ + pending * period_ns_;
+  next_report_ns_ = report_ns + period_ns_;
+
+  out = generate(static_cast<double>(report_ns - start_ns_) / 1e9);
+  out.timestamp_ns = report_ns;
+  if (options_.noise_counts > 0.0f) {
+    for (auto& v : out.raw) {
+      v = static_cast<uint16_t>(std::clamp(static_cast<float>(v) + noise_(rng_), 0.0f, 65535.0f));
+    }
+  }
+  return true;
+}
+
+}  // namespace trackpro::pedals
@@ -0,0 +1,121 @@
+#include "trackpro/pedals/vjoy_backend.h"
+
+#include <cstring>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/uinput.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <system_error>
+#endif
+
+namespace trackpro::pedals {
+
+bool MemoryVJoyBackend::write(const VJoyReport& report) {
+  last_.store(report);
+  writes_.fetch_add(1, std::memory_order_release);
+  return true;
+}
+
+bool MemoryVJoyBackend::last(VJoyReport& out) const { return last_.load(out); }
+
+#if defined(__linux__)
+namespace {
+
+constexpr int kAbsCodes[kVJoyAxisCount] = {ABS_X,  ABS_Y,  ABS_Z,        ABS_RX,
+                                           ABS_RY, ABS_RZ, ABS_THROTTLE, ABS_RUDDER};
+
+void ioctl_or_throw(int fd, unsigned long request, int value, const char* what) {
+  if (::ioctl(fd, request, value) < 0) {
+    throw std::system_error(errno, std::generic_category(), what);
+  }
+}
+
+}  // namespace
+
+UinputVJoyBackend::UinputVJoyBackend(const std::string& device_name) {
+  fd_ = ::open("/dev/uinput", O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+  if (fd_ < 0) {
+    throw std::system_error(errno, std::generic_category(), "open /dev/uinput");
+  }
+  try {
+    ioctl_or_throw(fd_, UI_SET_EVBIT, EV_ABS, "UI_SET_EVBIT EV_ABS");
+    ioctl_or_throw(fd_, UI_SET_EVBIT, EV_KEY, "UI_SET_EVBIT EV_KEY");
+    for (size_t b = 0; b < kVJoyButtonCount; ++b) {
+      ioctl_or_throw(fd_, UI_SET_KEYBIT, BTN_TRIGGER_HAPPY1 + static_cast<int>(b), "UI_SET_KEYBIT");
+    }
+    for (int code : kAbsCodes) {
+      ioctl_or_throw(fd_, UI_SET_ABSBIT, code, "UI_SET_ABSBIT");
+      uinput_abs_setup abs{};
+      abs.code = static_cast<uint16_t>(code);
+      abs.absinfo.minimum = kVJoyAxisMin;
+      abs.absinfo.maximum = kVJoyAxisMax;
+      if (::ioctl(fd_, UI_ABS_SETUP, &abs) < 0) {
+        throw std::system_error(errno, std::generic_category(), "UI_ABS_SETUP");
+      }
+    }
+    uinput_setup setup{};
+    setup.id.bustype = BUS_VIRTUAL;
+    setup.id.vendor = 0x1234;   // matches the vJoy driver's vendor id
+    setup.id.product = 0xBEAD;  // and product id
+    std::strncpy(setup.name, device_name.c_str(), UINPUT_MAX_NAME_SIZE - 1);
+    if (::ioctl(fd_, UI_DEV_SETUP, &setup) < 0) {
+      throw std::system_error(errno, std::generic_category(), "UI_DEV_SETUP");
+    }
+    if (::ioctl(fd_, UI_DEV_CREATE) < 0) {
+      throw std::system_error(errno, std::generic_category(), "UI_DEV_CREATE");
+    }
+  } catch (...) {
+    ::close(fd_);
+    throw;
+  }
+}
+
+UinputVJoyBackend::~UinputVJoyBackend() {
+  if (fd_ >= 0) {
+    ::ioctl(fd_, UI_DEV_DESTROY);
+    ::close(fd_);
+  }
+}
+
+bool UinputVJoyBackend::write(const VJoyReport& report) {
+  input_event events[kVJoyAxisCount + kVJoyButtonCount + 1];
+  size_t count = 0;
+  auto push = [&](uint16_t type, uint16_t code, int32_t value) {
+    input_event& ev = events[count++];
+    std::memset(&ev, 0, sizeof(ev));
+    ev.type = type;
+    ev.code = code;
+    ev.value = value;
+  };
+  for (size_t a = 0; a < kVJoyAxisCount; ++a) {
+    if (report.axes[a] != previous_.axes[a]) {
+      push(EV_ABS, static_cast<uint16_t>(kAbsCodes[a]), report.axes[a]);
+    }
+  }
+  const uint32_t changed = report.buttons ^ previous_.buttons;
+  for (size_t b = 0; b < kVJoyButtonCount; ++b) {
+    if (changed & (1u << b)) {
+      push(EV_KEY, static_cast<uint16_t>(BTN_TRIGGER_HAPPY1 + b), (report.buttons >> b) & 1u);
+    }
+  }
+  if (count == 0) {
+    return true;
+  }
+  push(EV_SYN, SYN_REPORT, 0);
+  const ssize_t bytes = static_cast<ssize_t>(count * sizeof(input_event));
+  // The fd is non-blocking: on EAGAIN or a short write the device has not
+  // seen this state, so the next write diffs against the last one it did
+  // see and re-sends everything that changed since.
+  if (::write(fd_, events, static_cast<size_t>(bytes)) != bytes) {
+    return false;
+  }
+  previous_ = report;
+  return true;
+}
+#endif
+
+}  // namespace trackpro::pedals
@@ -0,0 +1,114 @@
+#include "trackpro/pedals/vjoy_output_stage.h"
+
+#include <stdexcept>
+#include <utility>
+
+#include "trackpro/common/clock.h"
+#include "trackpro/common/realtime.h"
+
+namespace trackpro::pedals {
+
+VJoyOutputStage::VJoyOutputStage(std::unique_ptr<VJoyBackend> backend, VJoyOutputOptions options)
+    : backend_(std::move(backend)), options_(options) {
+  if (!backend_) {
+    throw std::invalid_argument("VJoyOutputStage requires a backend");
+  }
+}
+
+VJoyOutputStage::~VJoyOutputStage() { stop(); }
+
+void VJoyOutputStage::start() {
+  if (running_.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  thread_ = std::thread([this] { run(); });
+}
+
+void VJoyOutputStage::stop() {
+  running_.store(false, std::memory_order_release);
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void VJoyOutputStage::emit(const PedalOutput& output) {
+  VJoyReport report;
+  report.sequence = output.sequence;
+  report.input_timestamp_ns = output.input_timestamp_ns;
+  for (size_t axis = 0; axis < kPedalAxisCount; ++axis) {
+    report.axes[static_cast<size_t>(options_.axis_map.target[axis])] = to_vjoy_axis(output.value[axis]);
+  }
+  report.buttons = buttons_.load(std::memory_order_relaxed);
+
+  if (ring_.try_push(report)) {
+    pushed_.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    overruns_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+VJoyOutputCounters VJoyOutputStage::counters() const {
+  VJoyOutputCounters c;
+  c.pushed = pushed_.load(std::memory_order_relaxed);
+  c.overruns = overruns_.load(std::memory_order_relaxed);
+  c.drops = drops_.load(std::memory_order_relaxed);
+  c.written = written_.load(std::memory_order_relaxed);
+  c.backend_errors = backend_errors_.load(std::memory_order_relaxed);
+  return c;
+}
+
+bool VJoyOutputStage::drain() {
+  VJoyReport report;
+  const bool retry = !ring_.try_pop(report);
+  if (retry) {
+    if (!retry_pending_) {
+      return false;
+    }
+    report = retry_;
+  } else {
+    uint64_t superseded = 0;
+    while (ring_.try_pop(report)) {
+      ++superseded;
+    }
+    if (superseded != 0) {
+      drops_.fetch_add(superseded, std::memory_order_relaxed);
+    }
+  }
+  const uint64_t t0 = options_.stats ? now_ns() : 0;
+  const bool ok = backend_->write(report);
+  if (options_.stats != nullptr) {
+    const uint64_t t1 = now_ns();
+    options_.stats->record(PedalStage::VJoyWrite, t1 - t0);
+    options_.stats->record(PedalStage::InputToVJoy, t1 - report.input_timestamp_ns);
+  }
+  retry_pending_ = !ok;
+  if (ok) {
+    written_.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    retry_ = report;
+    backend_errors_.fetch_add(1, std::memory_order_relaxed);
+  }
+  // A failed retry counts as idle so the writer backs off instead of
+  // spinning on a full device queue.
+  return ok || !retry;
+}
+
+void VJoyOutputStage::run() {
+  set_current_thread_name("tp-vjoy");
+  pin_current_thread(options_.cpu);
+
+  uint32_t idle = 0;
+  while (running_.load(std::memory_order_acquire)) {
+    if (drain()) {
+      idle = 0;
+      continue;
+    }
+    if (++idle < options_.idle_spins) {
+      continue;
+    }
+    sleep_until_ns(now_ns() + options_.idle_sleep_ns, 0);
+  }
+  drain();
+}
+
+}  // namespace trackpro::pedals
@@ -0,0 +1,851 @@
+#include "trackpro/telemetry/column_codec.h"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TRACKPRO_CODEC_SSE2 1
+#endif
+
+#include "trackpro/common/byte_io.h"
+
+namespace trackpro::telemetry {
+namespace {
+
+constexpr size_t kBlock = 128;       // values per packed block
+constexpr size_t kRows = kBlock / 4;  // four interleaved lanes
+
+unsigned bit_width(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+  return v == 0 ? 0u : 64u - static_cast<unsigned>(__builtin_clzll(v));
+#else
+  unsigned n = 0;
+  for (; v != 0; v >>= 1) {
+    ++n;
+  }
+  return n;
+#endif
+}
+
+unsigned trailing_zeros(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_ctzll(v));
+#else
+  unsigned n = 0;
+  for (; (v & 1) == 0; v >>= 1) {
+    ++n;
+  }
+  return n;
+#endif
+}
+
+uint32_t ordered_bits(float v) {
+  uint32_t u;
+  std::memcpy(&u, &v, sizeof(u));
+  return (u & 0x80000000u) != 0 ? ~u : (u | 0x80000000u);
+}
+
+float from_ordered_bits(uint32_t u) {
+  u = (u & 0x80000000u) != 0 ? (u & 0x7FFFFFFFu) : ~u;
+  float v;
+  std::memcpy(&v, &u, sizeof(v));
+  return v;
+}
+
+uint64_t ordered_bits(double v) {
+  uint64_t u;
+  std::memcpy(&u, &v, sizeof(u));
+  constexpr uint64_t kSign = 1ull << 63;
+  return (u & kSign) != 0 ? ~u : (u | kSign);
+}
+
+double from_ordered_bits(uint64_t u) {
+  constexpr uint64_t kSign = 1ull << 63;
+  u = (u & kSign) != 0 ? (u & ~kSign) : ~u;
+  double v;
+  std::memcpy(&v, &u, sizeof(v));
+  return v;
+}
+
+// Calls f(load), where load(i) maps value i into the 64-bit integer domain
+// of the varint codecs.
+template <typename F>
+auto with_loader(ChannelType type, const void* values, F f) {
+  switch (type) {
+    case ChannelType::Float32: {
+      const auto* v = static_cast<const float*>(values);
+      return f([v](size_t i) { return static_cast<uint64_t>(ordered_bits(v[i])); });
+    }
+    case ChannelType::Float64: {
+      const auto* v = static_cast<const double*>(values);
+      return f([v](size_t i) { return ordered_bits(v[i]); });
+    }
+    case ChannelType::Int32:
+      break;
+  }
+  const auto* v = static_cast<const int32_t*>(values);
+  return f([v](size_t i) { return static_cast<uint64_t>(static_cast<int64_t>(v[i])); });
+}
+
+// Calls f(store), the inverse of with_loader.
+template <typename F>
+bool with_storer(ChannelType type, void* out, F f) {
+  switch (type) {
+    case ChannelType::Float32: {
+      auto* v = static_cast<float*>(out);
+      return f([v](size_t i, uint64_t u) { v[i] = from_ordered_bits(static_cast<uint32_t>(u)); });
+    }
+    case ChannelType::Float64: {
+      auto* v = static_cast<double*>(out);
+      return f([v](size_t i, uint64_t u) { v[i] = from_ordered_bits(u); });
+    }
+    case ChannelType::Int32: {
+      auto* v = static_cast<int32_t*>(out);
+      return f([v](size_t i, uint64_t u) { v[i] = static_cast<int32_t>(u); });
+    }
+  }
+  return false;
+}
+
+size_t varint_size(uint64_t v) { return v < 0x80 ? 1 : (bit_width(v) + 6) / 7; }
+
+template <typename Load>
+void encode_deltas(size_t count, std::vector<uint8_t>& out, Load load) {
+  const size_t start = out.size();
+  out.resize(start + count * 10);
+  uint8_t* p = out.data() + start;
+  uint64_t previous = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const uint64_t current = load(i);
+    p += put_varint(p, zigzag(static_cast<int64_t>(current - previous)));
+    previous = current;
+  }
+  out.resize(static_cast<size_t>(p - out.data()));
+}
+
+template <typename Store>
+bool decode_deltas(const uint8_t* data, size_t size, size_t count, Store store) {
+  const uint8_t* p = data;
+  const uint8_t* end = data + size;
+  uint64_t current = 0;
+  for (size_t i = 0; i < count; ++i) {
+    uint64_t v;
+    if (!get_varint(p, end, v)) {
+      return false;
+    }
+    current += static_cast<uint64_t>(unzigzag(v));
+    store(i, current);
+  }
+  return p == end;
+}
+
+// The *_size functions stop counting once they reach `limit`.
+template <typename Load>
+size_t deltas_size(size_t count, size_t limit, Load load) {
+  size_t bytes = 0;
+  uint64_t previous = 0;
+  for (size_t i = 0; i < count && bytes < limit; ++i) {
+    const uint64_t current = load(i);
+    bytes += varint_size(zigzag(static_cast<int64_t>(current - previous)));
+    previous = current;
+  }
+  return bytes;
+}
+
+// Each run is the zigzagged change from the previous run's value, then the
+// run length minus one.
+template <typename Load>
+void encode_runs(size_t count, std::vector<uint8_t>& out, Load load) {
+  std::vector<uint8_t> buf;
+  uint8_t pair[20];
+  uint64_t previous = 0;
+  for (size_t i = 0; i < count;) {
+    const uint64_t value = load(i);
+    size_t j = i + 1;
+    while (j < count && load(j) == value) {
+      ++j;
+    }
+    size_t n = put_varint(pair, zigzag(static_cast<int64_t>(value - previous)));
+    n += put_varint(pair + n, j - i - 1);
+    out.insert(out.end(), pair, pair + n);
+    previous = value;
+    i = j;
+  }
+}
+
+template <typename Load>
+size_t runs_size(size_t count, size_t limit, Load load) {
+  size_t bytes = 0;
+  uint64_t previous = 0;
+  for (size_t i = 0; i < count && bytes < limit;) {
+    const uint64_t value = load(i);
+    size_t j = i + 1;
+    while (j < count && load(j) == value) {
+      ++j;
+    }
+    bytes += varint_size(zigzag(static_cast<int64_t>(value - previous))) + varint_size(j - i - 1);
+    previous = value;
+    i = j;
+  }
+  return bytes;
+}
+
+template <typename Store>
+bool decode_runs(const uint8_t* data, size_t size, size_t count, Store store) {
+  const uint8_t* p = data;
+  const uint8_t* end = data + size;
+  uint64_t current = 0;
+  for (size_t i = 0; i < count;) {
+    uint64_t change;
+    uint64_t run;
+    if (!get_varint(p, end, change) || !get_varint(p, end, run) || run >= count - i) {
+      return false;
+    }
+    current += static_cast<uint64_t>(unzigzag(change));
+    for (const size_t stop = i + run + 1; i < stop; ++i) {
+      store(i, current);
+    }
+  }
+  return p == end;
+}
+
+// 32-bit (Float32, Int32) and 64-bit (Float64) domains of the packed codecs.
+std::vector<uint32_t> narrow_domain(ChannelType type, const void* values, size_t count) {
+  std::vector<uint32_t> v(count);
+  with_loader(type, values, [&](auto load) {
+    for (size_t i = 0; i < count; ++i) {
+      v[i] = static_cast<uint32_t>(load(i));
+    }
+  });
+  return v;
+}
+
+std::vector<uint64_t> wide_domain(const void* values, size_t count) {
+  std::vector<uint64_t> v(count);
+  const auto* d = static_cast<const double*>(values);
+  for (size_t i = 0; i < count; ++i) {
+    v[i] = ordered_bits(d[i]);
+  }
+  return v;
+}
+
+// --- Packed delta / delta-of-delta ------------------------------------------
+//
+// Header: varint first value, then (delta-of-delta only) the zigzagged first
+// difference, which seeds the running slope so the first residuals are zero.
+// Then per block of 128 residuals: one width byte and the zigzagged residuals
+// at that width. Value j of a block is in lane j % 4; lane l's bits run
+// through words l, l + 4, l + 8, ... so one 128-bit load feeds all four lanes.
+// The last block is zero-padded.
+
+template <typename W>
+W zig(W r) {
+  using S = std::make_signed_t<W>;
+  return static_cast<W>(r << 1) ^ static_cast<W>(static_cast<S>(r) >> (sizeof(W) * 8 - 1));
+}
+
+template <typename W>
+W unzig(W z) {
+  return (z >> 1) ^ (W{0} - (z & 1));
+}
+
+template <typename W>
+size_t packed_block_bytes(unsigned width) {
+  constexpr unsigned kBits = sizeof(W) * 8;
+  return 4 * ((kRows * width + kBits - 1) / kBits) * sizeof(W);
+}
+
+template <typename W>
+W get_word(const uint8_t* p) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  W w;
+  std::memcpy(&w, p, sizeof(w));
+  return w;
+#else
+  return static_cast<W>(get_le(p, sizeof(W)));
+#endif
+}
+
+template <typename W>
+void pack_block(const W* r, unsigned width, uint8_t* p) {
+  constexpr unsigned kBits = sizeof(W) * 8;
+  const size_t words = packed_block_bytes<W>(width) / sizeof(W);
+  W buf[kBlock] = {};
+  for (size_t lane = 0; lane < 4; ++lane) {
+    for (size_t row = 0, bit = 0; row < kRows; ++row, bit += width) {
+      const W v = r[row * 4 + lane];
+      const size_t word = bit / kBits;
+      const unsigned off = bit % kBits;
+      buf[word * 4 + lane] |= static_cast<W>(v << off);
+      if (off + width > kBits) {
+        buf[(word + 1) * 4 + lane] |= static_cast<W>(v >> (kBits - off));
+      }
+    }
+  }
+  for (size_t w = 0; w < words; ++w) {
+    if (sizeof(W) == 4) {
+      put_u32(p + w * 4, static_cast<uint32_t>(buf[w]));
+    } else {
+      put_u64(p + w * 8, static_cast<uint64_t>(buf[w]));
+    }
+  }
+}
+
+template <typename W>
+void unpack_block(const uint8_t* p, unsigned width, W* r) {
+  constexpr unsigned kBits = sizeof(W) * 8;
+  if (width == 0) {
+    std::fill(r, r + kBlock, W{0});
+    return;
+  }
+  const W mask = width == kBits ? ~W{0} : static_cast<W>((W{1} << width) - 1);
+  for (size_t lane = 0; lane < 4; ++lane) {
+    for (size_t row = 0, bit = 0; row < kRows; ++row, bit += width) {
+      const size_t word = bit / kBits;
+      const unsigned off = bit % kBits;
+      W v = get_word<W>(p + (word * 4 + lane) * sizeof(W)) >> off;
+      if (off + width > kBits) {
+        v |= static_cast<W>(get_word<W>(p + ((word + 1) * 4 + lane) * sizeof(W)) << (kBits - off));
+      }
+      r[row * 4 + lane] = v & mask;
+    }
+  }
+}
+
+// Residuals back to values: one prefix sum per order.
+template <typename W>
+void integrate_block(W* r, int order, W& previous, W& slope) {
+  for (size_t i = 0; i < kBlock; ++i) {
+    W d = unzig(r[i]);
+    if (order == 2) {
+      slope += d;
+      d = slope;
+    }
+    previous += d;
+    r[i] = previous;
+  }
+}
+
+#if defined(TRACKPRO_CODEC_SSE2)
+
+__m128i prefix_sum(__m128i x) {
+  x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+  return _mm_add_epi32(x, _mm_slli_si128(x, 8));
+}
+
+// unpack_block + integrate_block for 32-bit words, a row of four at a time.
+void decode_block(const uint8_t* p, unsigned width, int order, uint32_t& previous, uint32_t& slope, uint32_t* out) {
+  const auto* in = reinterpret_cast<const __m128i*>(p);
+  const __m128i mask = _mm_set1_epi32(width >= 32 ? -1 : static_cast<int>((1u << width) - 1));
+  const __m128i one = _mm_set1_epi32(1);
+  const __m128i zero = _mm_setzero_si128();
+  __m128i word = width > 0 ? _mm_loadu_si128(in++) : zero;
+  __m128i level = _mm_set1_epi32(static_cast<int>(previous));
+  __m128i step = _mm_set1_epi32(static_cast<int>(slope));
+  unsigned off = 0;
+  for (size_t row = 0; row < kRows; ++row) {
+    __m128i r = zero;
+    if (width > 0) {
+      r = _mm_srl_epi32(word, _mm_cvtsi32_si128(static_cast<int>(off)));
+      off += width;
+      if (off >= 32 && row + 1 < kRows) {
+        off -= 32;
+        word = _mm_loadu_si128(in++);
+        if (off > 0) {
+          r = _mm_or_si128(r, _mm_sll_epi32(word, _mm_cvtsi32_si128(static_cast<int>(width - off))));
+        }
+      }
+      r = _mm_and_si128(r, mask);
+    }
+    r = _mm_xor_si128(_mm_srli_epi32(r, 1), _mm_sub_epi32(zero, _mm_and_si128(r, one)));
+    if (order == 2) {
+      r = _mm_add_epi32(prefix_sum(r), step);
+      step = _mm_shuffle_epi32(r, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    level = _mm_add_epi32(prefix_sum(r), level);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + row * 4), level);
+    level = _mm_shuffle_epi32(level, _MM_SHUFFLE(3, 3, 3, 3));
+  }
+  previous = static_cast<uint32_t>(_mm_cvtsi128_si32(level));
+  slope = static_cast<uint32_t>(_mm_cvtsi128_si32(step));
+}
+
+void store_floats(const uint32_t* u, size_t n, float* out) {
+  const __m128i sign = _mm_set1_epi32(static_cast<int>(0x80000000u));
+  const __m128i ones = _mm_set1_epi32(-1);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(u + i));
+    // Negative-mapped values flip every bit, positive ones only the sign.
+    const __m128i flip = _mm_or_si128(_mm_xor_si128(_mm_srai_epi32(x, 31), ones), sign);
+    _mm_storeu_ps(out + i, _mm_castsi128_ps(_mm_xor_si128(x, flip)));
+  }
+  for (; i < n; ++i) {
+    out[i] = from_ordered_bits(u[i]);
+  }
+}
+
+#else
+
+void decode_block(const uint8_t* p, unsigned width, int order, uint32_t& previous, uint32_t& slope, uint32_t* out) {
+  unpack_block(p, width, out);
+  integrate_block(out, order, previous, slope);
+}
+
+void store_floats(const uint32_t* u, size_t n, float* out) {
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = from_ordered_bits(u[i]);
+  }
+}
+
+#endif
+
+void decode_block(const uint8_t* p, unsigned width, int order, uint64_t& previous, uint64_t& slope, uint64_t* out) {
+  unpack_block(p, width, out);
+  integrate_block(out, order, previous, slope);
+}
+
+// Computes the header and each block's zigzagged residuals and width,
+// handing them to head(base, slope) and block(residuals, width).
+template <typename W, typename Head, typename Block>
+void packed_blocks(const std::vector<W>& v, int order, Head head, Block block) {
+  const W base = v.empty() ? W{0} : v[0];
+  const W slope = order == 2 && v.size() > 1 ? static_cast<W>(v[1] - v[0]) : W{0};
+  head(base, slope);
+  W previous = static_cast<W>(base - slope);
+  W step = slope;
+  W r[kBlock];
+  for (size_t i = 0; i < v.size(); i += kBlock) {
+    W bits = 0;
+    for (size_t j = 0; j < kBlock; ++j) {
+      r[j] = 0;
+      if (i + j < v.size()) {
+        const W d = static_cast<W>(v[i + j] - previous);
+        r[j] = zig<W>(order == 2 ? static_cast<W>(d - step) : d);
+        step = d;
+        previous = v[i + j];
+        bits |= r[j];
+      }
+    }
+    block(r, bit_width(bits));
+  }
+}
+
+template <typename W>
+uint64_t signed_slope(W slope) {
+  return zigzag(static_cast<std::make_signed_t<W>>(slope));
+}
+
+template <typename W>
+size_t packed_size(const std::vector<W>& v, int order) {
+  size_t bytes = 0;
+  packed_blocks(
+      v, order,
+      [&](W base, W slope) { bytes += varint_size(base) + (order == 2 ? varint_size(signed_slope(slope)) : 0); },
+      [&](const W*, unsigned width) { bytes += 1 + packed_block_bytes<W>(width); });
+  return bytes;
+}
+
+template <typename W>
+void encode_packed(const std::vector<W>& v, int order, std::vector<uint8_t>& out) {
+  packed_blocks(
+      v, order,
+      [&](W base, W slope) {
+        uint8_t head[20];
+        size_t n = put_varint(head, base);
+        if (order == 2) {
+          n += put_varint(head + n, signed_slope(slope));
+        }
+        out.insert(out.end(), head, head + n);
+      },
+      [&](const W* r, unsigned width) {
+        out.push_back(static_cast<uint8_t>(width));
+        const size_t start = out.size();
+        out.resize(start + packed_block_bytes<W>(width));
+        pack_block(r, width, out.data() + start);
+      });
+}
+
+// Decodes into `count` domain words, handing each finished block to
+// store(first, words, n).
+template <typename W, typename Store>
+bool decode_packed(const uint8_t* data, size_t size, size_t count, int order, Store store) {
+  const uint8_t* p = data;
+  const uint8_t* end = data + size;
+  uint64_t base;
+  uint64_t first_step = 0;
+  if (!get_varint(p, end, base) || (order == 2 && !get_varint(p, end, first_step))) {
+    return false;
+  }
+  W slope = static_cast<W>(unzigzag(first_step));
+  W previous = static_cast<W>(static_cast<W>(base) - slope);
+  alignas(16) W block[kBlock];
+  for (size_t i = 0; i < count; i += kBlock) {
+    if (p == end || *p > sizeof(W) * 8) {
+      return false;
+    }
+    const unsigned width = *p++;
+    const size_t bytes = packed_block_bytes<W>(width);
+    if (static_cast<size_t>(end - p) < bytes) {
+      return false;
+    }
+    decode_block(p, width, order, previous, slope, block);
+    p += bytes;
+    store(i, block, std::min(kBlock, count - i));
+  }
+  return p == end;
+}
+
+// --- XOR --------------------------------------------------------------------
+//
+// First value verbatim. Then per value, LSB-first bits: 0 = same as previous;
+// 10 = XOR fits the previous leading/trailing-zero window, followed by the
+// bits inside it; 11 = new window (leading zeros, length - 1), then the bits.
+
+class BitWriter {
+ public:
+  explicit BitWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+  void put(uint64_t v, unsigned n) {
+    if (n > 32) {
+      put(v & 0xFFFFFFFFu, 32);
+      put(v >> 32, n - 32);
+      return;
+    }
+    acc_ |= v << bits_;
+    bits_ += n;
+    while (bits_ >= 8) {
+      out_.push_back(static_cast<uint8_t>(acc_));
+      acc_ >>= 8;
+      bits_ -= 8;
+    }
+  }
+
+  void flush() {
+    if (bits_ > 0) {
+      out_.push_back(static_cast<uint8_t>(acc_));
+    }
+    acc_ = 0;
+    bits_ = 0;
+  }
+
+ private:
+  std::vector<uint8_t>& out_;
+  uint64_t acc_ = 0;
+  unsigned bits_ = 0;
+};
+
+class BitReader {
+ public:
+  BitReader(const uint8_t* p, const uint8_t* end) : p_(p), end_(end) {}
+
+  bool get(unsigned n, uint64_t& v) {
+    if (n > 32) {
+      uint64_t hi;
+      if (!get(32, v) || !get(n - 32, hi)) {
+        return false;
+      }
+      v |= hi << 32;
+      return true;
+    }
+    while (bits_ < n) {
+      if (p_ == end_) {
+        return false;
+      }
+      acc_ |= static_cast<uint64_t>(*p_++) << bits_;
+      bits_ += 8;
+    }
+    v = acc_ & ((1ull << n) - 1);
+    acc_ >>= n;
+    bits_ -= n;
+    return true;
+  }
+
+  // Only the final byte's padding is left.
+  bool done() const { return p_ == end_ && bits_ < 8; }
+
+ private:
+  const uint8_t* p_;
+  const uint8_t* end_;
+  uint64_t acc_ = 0;
+  unsigned bits_ = 0;
+};
+
+// Emits the bit fields for v[0, count) through put(bits, n) until put()
+// returns false.
+template <typename W, typename Put>
+void xor_bits(const W* v, size_t count, Put put) {
+  constexpr unsigned kBits = sizeof(W) * 8;
+  constexpr unsigned kField = kBits == 32 ? 5 : 6;
+  if (count == 0) {
+    return;
+  }
+  put(v[0], kBits);
+  unsigned lead = kBits;
+  unsigned trail = 0;
+  bool more = true;
+  for (size_t i = 1; i < count && more; ++i) {
+    const W x = v[i] ^ v[i - 1];
+    if (x == 0) {
+      more = put(0, 1);
+      continue;
+    }
+    const unsigned l = kBits - bit_width(x);
+    const unsigned t = trailing_zeros(x);
+    if (l >= lead && t >= trail) {
+      put(0b01, 2);
+      more = put(x >> trail, kBits - lead - trail);
+    } else {
+      const unsigned len = kBits - l - t;
+      put(0b11, 2);
+      put(l, kField);
+      put(len - 1, kField);
+      more = put(x >> t, len);
+      lead = l;
+      trail = t;
+    }
+  }
+}
+
+template <typename W>
+size_t xor_size(const W* v, size_t count, size_t limit) {
+  uint64_t bits = 0;
+  xor_bits(v, count, [&](uint64_t, unsigned n) {
+    bits += n;
+    return bits < uint64_t{limit} * 8;
+  });
+  return static_cast<size_t>((bits + 7) / 8);
+}
+
+template <typename W>
+void encode_xor(const W* v, size_t count, std::vector<uint8_t>& out) {
+  BitWriter w(out);
+  xor_bits(v, count, [&](uint64_t x, unsigned n) {
+    w.put(x, n);
+    return true;
+  });
+  w.flush();
+}
+
+template <typename W>
+bool decode_xor(const uint8_t* data, size_t size, size_t count, W* out) {
+  constexpr unsigned kBits = sizeof(W) * 8;
+  constexpr unsigned kField = kBits == 32 ? 5 : 6;
+  if (count == 0) {
+    return size == 0;
+  }
+  BitReader r(data, data + size);
+  uint64_t v;
+  if (!r.get(kBits, v)) {
+    return false;
+  }
+  out[0] = static_cast<W>(v);
+  unsigned lead = kBits;
+  unsigned trail = 0;
+  for (size_t i = 1; i < count; ++i) {
+    uint64_t bit;
+    if (!r.get(1, bit)) {
+      return false;
+    }
+    if (bit == 0) {
+      out[i] = out[i - 1];
+      continue;
+    }
+    if (!r.get(1, bit)) {
+      return false;
+    }
+    if (bit == 1) {
+      uint64_t l;
+      uint64_t len;
+      if (!r.get(kField, l) || !r.get(kField, len) || l + len + 1 > kBits) {
+        return false;
+      }
+      lead = static_cast<unsigned>(l);
+      trail = kBits - lead - static_cast<unsigned>(len + 1);
+    } else if (lead == kBits) {
+      return false;  // no window yet
+    }
+    if (!r.get(kBits - lead - trail, v)) {
+      return false;
+    }
+    out[i] = out[i - 1] ^ static_cast<W>(v << trail);
+  }
+  return r.done();
+}
+
+}  // namespace
+
+const char* channel_type_name(ChannelType type) {
+  switch (type) {
+    case ChannelType::Float32:
+      return "f32";
+    case ChannelType::Float64:
+      return "f64";
+    case ChannelType::Int32:
+      return "i32";
+  }
+  return "?";
+}
+
+const char* codec_name(ColumnCodec codec) {
+  switch (codec) {
+    case ColumnCodec::Raw:
+      return "raw";
+    case ColumnCodec::DeltaVarint:
+      return "delta-varint";
+    case ColumnCodec::PackedDelta:
+      return "packed-delta";
+    case ColumnCodec::PackedDeltaDelta:
+      return "packed-dod";
+    case ColumnCodec::Xor:
+      return "xor";
+    case ColumnCodec::RunLength:
+      return "rle";
+  }
+  return "?";
+}
+
+bool encode_column_as(ColumnCodec codec, ChannelType type, const void* values, size_t count,
+                      std::vector<uint8_t>& out) {
+  switch (codec) {
+    case ColumnCodec::Raw: {
+      const auto* p = static_cast<const uint8_t*>(values);
+      out.insert(out.end(), p, p + count * channel_type_size(type));
+      return true;
+    }
+    case ColumnCodec::DeltaVarint:
+      with_loader(type, values, [&](auto load) { encode_deltas(count, out, load); });
+      return true;
+    case ColumnCodec::RunLength:
+      with_loader(type, values, [&](auto load) { encode_runs(count, out, load); });
+      return true;
+    case ColumnCodec::PackedDelta:
+    case ColumnCodec::PackedDeltaDelta: {
+      const int order = codec == ColumnCodec::PackedDelta ? 1 : 2;
+      if (type == ChannelType::Float64) {
+        encode_packed(wide_domain(values, count), order, out);
+      } else {
+        encode_packed(narrow_domain(type, values, count), order, out);
+      }
+      return true;
+    }
+    case ColumnCodec::Xor:
+      if (type == ChannelType::Float32) {
+        std::vector<uint32_t> bits(count);
+        std::memcpy(bits.data(), values, count * 4);
+        encode_xor(bits.data(), count, out);
+        return true;
+      }
+      if (type == ChannelType::Float64) {
+        std::vector<uint64_t> bits(count);
+        std::memcpy(bits.data(), values, count * 8);
+        encode_xor(bits.data(), count, out);
+        return true;
+      }
+      return false;
+  }
+  return false;
+}
+
+ColumnCodec encode_column(ChannelType type, const void* values, size_t count, std::vector<uint8_t>& out) {
+  // Size every candidate without writing it, then encode the smallest.
+  // Candidates go fastest-to-decode first, so ties favour the cheaper one.
+  ColumnCodec best = ColumnCodec::Raw;
+  size_t best_size = count * channel_type_size(type);
+  auto consider = [&](ColumnCodec codec, size_t size) {
+    if (size < best_size) {
+      best = codec;
+      best_size = size;
+    }
+  };
+  if (type == ChannelType::Float64) {
+    const std::vector<uint64_t> v = wide_domain(values, count);
+    consider(ColumnCodec::PackedDelta, packed_size(v, 1));
+    consider(ColumnCodec::PackedDeltaDelta, packed_size(v, 2));
+  } else {
+    const std::vector<uint32_t> v = narrow_domain(type, values, count);
+    consider(ColumnCodec::PackedDelta, packed_size(v, 1));
+    consider(ColumnCodec::PackedDeltaDelta, packed_size(v, 2));
+  }
+  with_loader(type, values, [&](auto load) {
+    consider(ColumnCodec::RunLength, runs_size(count, best_size, load));
+    consider(ColumnCodec::DeltaVarint, deltas_size(count, best_size, load));
+  });
+  if (type == ChannelType::Float32) {
+    std::vector<uint32_t> bits(count);
+    std::memcpy(bits.data(), values, count * 4);
+    consider(ColumnCodec::Xor, xor_size(bits.data(), count, best_size));
+  } else if (type == ChannelType::Float64) {
+    std::vector<uint64_t> bits(count);
+    std::memcpy(bits.data(), values, count * 8);
+    consider(ColumnCodec::Xor, xor_size(bits.data(), count, best_size));
+  }
+  encode_column_as(best, type, values, count, out);
+  return best;
+}
+
+bool decode_column(ColumnCodec codec, ChannelType type, const uint8_t* data, size_t size, size_t count,
+                   void* out) {
+  switch (codec) {
+    case ColumnCodec::Raw:
+      if (size != count * channel_type_size(type)) {
+        return false;
+      }
+      std::memcpy(out, data, size);
+      return true;
+    case ColumnCodec::DeltaVarint:
+      return with_storer(type, out, [&](auto store) { return decode_deltas(data, size, count, store); });
+    case ColumnCodec::RunLength:
+      return with_storer(type, out, [&](auto store) { return decode_runs(data, size, count, store); });
+    case ColumnCodec::PackedDelta:
+    case ColumnCodec::PackedDeltaDelta: {
+      const int order = codec == ColumnCodec::PackedDelta ? 1 : 2;
+      switch (type) {
+        case ChannelType::Float32: {
+          auto* v = static_cast<float*>(out);
+          return decode_packed<uint32_t>(data, size, count, order, [v](size_t first, const uint32_t* u, size_t n) {
+            store_floats(u, n, v + first);
+          });
+        }
+        case ChannelType::Int32: {
+          auto* v = static_cast<int32_t*>(out);
+          return decode_packed<uint32_t>(data, size, count, order, [v](size_t first, const uint32_t* u, size_t n) {
+            std::memcpy(v + first, u, n * 4);
+          });
+        }
+        case ChannelType::Float64: {
+          auto* v = static_cast<double*>(out);
+          return decode_packed<uint64_t>(data, size, count, order, [v](size_t first, const uint64_t* u, size_t n) {
+            for (size_t i = 0; i < n; ++i) {
+              v[first + i] = from_ordered_bits(u[i]);
+            }
+          });
+        }
+      }
+      return false;
+    }
+    case ColumnCodec::Xor:
+      if (type == ChannelType::Float32) {
+        std::vector<uint32_t> bits(count);
+        if (!decode_xor(data, size, count, bits.data())) {
+          return false;
+        }
+        std::memcpy(out, bits.data(), count * 4);
+        return true;
+      }
+      if (type == ChannelType::Float64) {
+        std::vector<uint64_t> bits(count);
+        if (!decode_xor(data, size, count, bits.data())) {
+          return false;
+        }
+        std::memcpy(out, bits.data(), count * 8);
+        return true;
+      }
+      return false;
+  }
+  return false;
+}
+
+}  // namespace trackpro::telemetry
@@ -0,0 +1,197 @@
+#include "trackpro/telemetry/corner_metrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace trackpro::telemetry {
+namespace {
+
+size_t channel(const LapStore& store, const char* name) {
+  const int c = store.find_channel(name);
+  if (c < 0) {
+    throw std::invalid_argument(std::string("lap store has no ") + name + " channel");
+  }
+  return static_cast<size_t>(c);
+}
+
+bool same_corners(const std::vector<TrackCorner>& a, const std::vector<TrackCorner>& b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i].start_m != b[i].start_m || a[i].apex_m != b[i].apex_m || a[i].end_m != b[i].end_m) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+CornerMetricsTable::CornerMetricsTable(std::vector<TrackCorner> corners, CornerMetricsOptions options)
+    : corners_(std::move(corners)), options_(options), summaries_(corners_.size()), totals_(corners_.size()) {}
+
+size_t CornerMetricsTable::update(const std::string& source, const LapStore& store, ThreadPool& pool) {
+  auto it = std::find(sources_.begin(), sources_.end(), source);
+  const auto index = static_cast<size_t>(it - sources_.begin());
+  if (it == sources_.end()) {
+    sources_.push_back(source);
+    seen_.push_back(0);
+  }
+  const size_t first = seen_[index];
+  if (store.lap_count() <= first || corners_.empty()) {
+    return 0;
+  }
+  const Channels channels{channel(store, "LapDist"), channel(store, "Speed"), channel(store, "Throttle"),
+                          channel(store, "Brake")};
+  const size_t added = store.lap_count() - first;
+  const size_t base = rows_.size();
+  rows_.resize(base + added * corners_.size());
+  parallel_for(pool, added, options_.laps_per_claim, [&](size_t i) {
+    CornerMetrics* out = rows_.data() + base + i * corners_.size();
+    measure_lap(store, channels, first + i, out);
+    for (size_t c = 0; c < corners_.size(); ++c) {
+      out[c].source = static_cast<uint32_t>(index);
+    }
+  });
+  for (size_t r = base; r < rows_.size(); ++r) {
+    fold(rows_[r]);
+  }
+  seen_[index] = store.lap_count();
+  return added;
+}
+
+void CornerMetricsTable::measure_lap(const LapStore& store, const Channels& channels, size_t lap,
+                                     CornerMetrics* out) const {
+  const LapInfo info = store.lap(lap);
+  std::vector<float> distance;
+  std::vector<float> speed;
+  std::vector<float> throttle;
+  std::vector<float> brake;
+  const bool read = store.read(lap, channels.distance, distance) && store.read(lap, channels.speed, speed) &&
+                    store.read(lap, channels.throttle, throttle) && store.read(lap, channels.brake, brake);
+  const size_t n = distance.size();
+  // Running maximum so the corner windows can be found by binary search.
+  for (size_t i = 1; i < n; ++i) {
+    distance[i] = std::max(distance[i], distance[i - 1]);
+  }
+  const double dt = info.sample_rate_hz > 0.0f ? 1.0 / info.sample_rate_hz : 1.0 / 60.0;
+  auto at = [&](float d) {
+    return std::min(n - 1, static_cast<size_t>(std::lower_bound(distance.begin(), distance.end(), d) - distance.begin()));
+  };
+
+  for (size_t c = 0; c < corners_.size(); ++c) {
+    const TrackCorner& corner = corners_[c];
+    CornerMetrics& m = out[c];
+    m = CornerMetrics{};
+    m.lap = static_cast<uint32_t>(lap);
+    m.corner = static_cast<uint16_t>(c);
+    // Corners across the start/finish line span two laps; skip them.
+    if (!read || n < 2 || corner.end_m < corner.start_m || speed.size() != n || throttle.size() != n ||
+        brake.size() != n) {
+      continue;
+    }
+    // The approach ends the previous corner's braking: start it no earlier
+    // than that corner's exit.
+    float approach_m = std::max(0.0f, corner.start_m - options_.approach_m);
+    if (c > 0 && corners_[c - 1].end_m <= corner.start_m) {
+      approach_m = std::max(approach_m, corners_[c - 1].end_m);
+    }
+    const size_t approach = at(approach_m);
+    const size_t start = at(corner.start_m);
+    const size_t end = at(corner.end_m);
+    if (end <= start + 1) {
+      continue;
+    }
+
+    size_t brake_at = n;
+    for (size_t i = approach; i < end; ++i) {
+      if (brake[i] >= options_.brake_on) {
+        brake_at = i;
+        break;
+      }
+    }
+    size_t min_at = start;
+    for (size_t i = start; i < end; ++i) {
+      if (speed[i] < speed[min_at]) {
+        min_at = i;
+      }
+    }
+    size_t throttle_at = n;
+    for (size_t i = min_at; i <= end; ++i) {
+      if (throttle[i] >= options_.throttle_on) {
+        throttle_at = i;
+        break;
+      }
+    }
+    uint32_t trail = 0;
+    for (size_t i = start; i < end; ++i) {
+      trail += brake[i] >= options_.brake_on ? 1 : 0;
+    }
+    uint32_t coasting = 0;
+    for (size_t i = approach; i < end; ++i) {
+      coasting += (brake[i] < options_.brake_on && throttle[i] < options_.throttle_on) ? 1 : 0;
+    }
+
+    m.valid = (info.flags & kLapValid) != 0;
+    m.brake_point_m = brake_at < n ? distance[brake_at] : NAN;
+    m.entry_speed = speed[brake_at < n ? brake_at : start];
+    m.min_speed = speed[min_at];
+    m.min_speed_m = distance[min_at];
+    m.throttle_point_m = throttle_at < n ? distance[throttle_at] : NAN;
+    m.trail_brake_s = static_cast<float>(trail * dt);
+    m.coasting_s = static_cast<float>(coasting * dt);
+    m.corner_time_s = static_cast<float>(static_cast<double>(end - start) * dt);
+  }
+}
+
+void CornerMetricsTable::fold(const CornerMetrics& row) {
+  if (!row.valid) {
+    return;
+  }
+  CornerSummary& s = summaries_[row.corner];
+  Totals& t = totals_[row.corner];
+  const bool first = s.laps == 0;
+  ++s.laps;
+  t.min_speed += row.min_speed;
+  t.trail_brake += row.trail_brake_s;
+  t.coasting += row.coasting_s;
+  t.corner_time += row.corner_time_s;
+  s.best_min_speed = first ? row.min_speed : std::max(s.best_min_speed, row.min_speed);
+  s.best_corner_time_s = first ? row.corner_time_s : std::min(s.best_corner_time_s, row.corner_time_s);
+  if (!std::isnan(row.brake_point_m)) {
+    s.latest_brake_point_m = t.braked == 0 ? row.brake_point_m : std::max(s.latest_brake_point_m, row.brake_point_m);
+    ++t.braked;
+    t.brake_point += row.brake_point_m;
+    s.mean_brake_point_m = static_cast<float>(t.brake_point / t.braked);
+  }
+  if (!std::isnan(row.throttle_point_m)) {
+    ++t.throttled;
+    t.throttle_point += row.throttle_point_m;
+    s.mean_throttle_point_m = static_cast<float>(t.throttle_point / t.throttled);
+  }
+  s.mean_min_speed = static_cast<float>(t.min_speed / s.laps);
+  s.mean_trail_brake_s = static_cast<float>(t.trail_brake / s.laps);
+  s.mean_coasting_s = static_cast<float>(t.coasting / s.laps);
+  s.mean_corner_time_s = static_cast<float>(t.corner_time / s.laps);
+}
+
+CornerMetricsCache::CornerMetricsCache(ThreadPool& pool, CornerMetricsOptions options)
+    : pool_(pool), options_(options) {}
+
+const CornerMetricsTable& CornerMetricsCache::update(
+    const std::string& track_id, const std::string& car, const TrackModel& model,
+    const std::vector<std::pair<std::string, const LapStore*>>& stores) {
+  std::unique_ptr<CornerMetricsTable>& table = tables_[track_id + '\n' + car];
+  if (!table || !same_corners(table->corners(), model.corners)) {
+    table = std::make_unique<CornerMetricsTable>(model.corners, options_);
+  }
+  for (const auto& [path, store] : stores) {
+    table->update(path, *store, pool_);
+  }
+  return *table;
+}
+
+}  // namespace trackpro::telemetry
@@ -0,0 +1,178 @@
+#include "trackpro/telemetry/ibt_file.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include "trackpro/common/file_io.h"
+
+namespace trackpro::telemetry {
+namespace {
+
+constexpr size_t kPrefixHeaders = sizeof(IrsdkHeader) + sizeof(IrsdkDiskSubHeader);
+
+std::string_view fixed_string(const char* s, size_t max) {
+  return std::string_view(s, strnlen(s, max));
+}
+
+}  // namespace
+
+IbtLayout IbtLayout::parse(const uint8_t* data, size_t size) {
+  if (size < kPrefixHeaders) {
+    throw std::runtime_error("ibt: file too small for headers");
+  }
+  IbtLayout layout;
+  std::memcpy(&layout.header_, data, sizeof(IrsdkHeader));
+  std::memcpy(&layout.disk_, data + sizeof(IrsdkHeader), sizeof(IrsdkDiskSubHeader));
+  const IrsdkHeader& h = layout.header_;
+  if (h.ver < 1 || h.numVars < 0 || h.numVars > 4096 || h.bufLen <= 0 || h.varHeaderOffset < 0 ||
+      h.sessionInfoOffset < 0 || h.sessionInfoLen < 0) {
+    throw std::runtime_error("ibt: invalid header");
+  }
+  const size_t vars_end = static_cast<size_t>(h.varHeaderOffset) +
+                          static_cast<size_t>(h.numVars) * sizeof(IrsdkVarHeader);
+  const size_t info_end = static_cast<size_t>(h.sessionInfoOffset) + static_cast<size_t>(h.sessionInfoLen);
+  if (vars_end > size || info_end > size) {
+    throw std::runtime_error("ibt: variable table or session info out of range");
+  }
+  layout.vars_.resize(static_cast<size_t>(h.numVars));
+  std::memcpy(layout.vars_.data(), data + h.varHeaderOffset, vars_end - static_cast<size_t>(h.varHeaderOffset));
+  for (const IrsdkVarHeader& v : layout.vars_) {
+    const size_t size = irsdk_type_size(v.type);
+    const size_t end = static_cast<size_t>(v.offset) + size * static_cast<size_t>(v.count);
+    if (size == 0 || v.offset < 0 || v.count < 1 || end > static_cast<size_t>(h.bufLen)) {
+      throw std::runtime_error("ibt: variable outside the record");
+    }
+  }
+  const char* info = reinterpret_cast<const char*>(data + h.sessionInfoOffset);
+  layout.session_info_.assign(info, strnlen(info, static_cast<size_t>(h.sessionInfoLen)));
+  layout.record_count_ = static_cast<size_t>(std::max(layout.disk_.sessionRecordCount, 0));
+  return layout;
+}
+
+IbtLayout IbtLayout::read(const std::string& path) {
+  std::FILE* f = std::fopen(path.c_str(), "rb");
+  if (f == nullptr) {
+    throw std::runtime_error("ibt: cannot open " + path + ": " + std::strerror(errno));
+  }
+  std::vector<uint8_t> prefix(kPrefixHeaders);
+  if (std::fread(prefix.data(), 1, prefix.size(), f) != prefix.size()) {
+    std::fclose(f);
+    throw std::runtime_error("ibt: " + path + " is truncated");
+  }
+  IrsdkHeader h;
+  std::memcpy(&h, prefix.data(), sizeof(h));
+  const size_t want = static_cast<size_t>(std::max(h.varBuf[0].bufOffset, 0));
+  if (want > prefix.size() && want < (64u << 20)) {
+    const size_t have = prefix.size();
+    prefix.resize(want);
+    prefix.resize(have + std::fread(prefix.data() + have, 1, want - have, f));
+  }
+  uint64_t size = 0;
+  if (!file_size(f, size)) {
+    const int error = errno;
+    std::fclose(f);
+    throw std::runtime_error("ibt: cannot size " + path + ": " + std::strerror(error));
+  }
+  std::fclose(f);
+
+  IbtLayout layout = parse(prefix.data(), prefix.size());
+  layout.clamp_record_count(size);
+  return layout;
+}
+
+void IbtLayout::clamp_record_count(uint64_t file_size) {
+  const uint64_t available =
+      file_size > records_offset() ? (file_size - records_offset()) / record_size() : 0;
+  if (record_count_ == 0 || record_count_ > available) {
+    record_count_ = static_cast<size_t>(available);
+  }
+}
+
+int IbtLayout::find_var(std::string_view name) const {
+  for (size_t i = 0; i < vars_.size(); ++i) {
+    if (fixed_string(vars_[i].name, kIrsdkMaxString) == name) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+IbtFile IbtFile::open(const std::string& path) {
+  IbtFile file;
+  file.region_ = MappedRegion::open_read(path);
+  file.layout_ = IbtLayout::parse(file.region_.data(), file.region_.size());
+  file.layout_.clamp_record_count(file.region_.size());
+  return file;
+}
+
+IbtWriter::IbtWriter(const std::string& path, const std::vector<IbtVarSpec>& vars, int tick_rate,
+                     const std::string& session_info) {
+  int32_t row = 0;
+  for (const IbtVarSpec& spec : vars) {
+    IrsdkVarHeader v{};
+    v.type = spec.type;
+    v.count = spec.count;
+    const auto size = static_cast<int32_t>(irsdk_type_size(spec.type));
+    row = (row + size - 1) / size * size;  // natural alignment
+    v.offset = row;
+    row += size * spec.count;
+    std::strncpy(v.name, spec.name.c_str(), kIrsdkMaxString - 1);
+    std::strncpy(v.desc, spec.desc.c_str(), kIrsdkMaxDesc - 1);
+    std::strncpy(v.unit, spec.unit.c_str(), kIrsdkMaxString - 1);
+    vars_.push_back(v);
+  }
+
+  header_.ver = kIrsdkVersion;
+  header_.status = kIrsdkStatusConnected;
+  header_.tickRate = tick_rate;
+  header_.sessionInfoUpdate = 1;
+  header_.numVars = static_cast<int32_t>(vars_.size());
+  header_.varHeaderOffset = static_cast<int32_t>(sizeof(IrsdkHeader) + sizeof(IrsdkDiskSubHeader));
+  header_.sessionInfoOffset =
+      header_.varHeaderOffset + header_.numVars * static_cast<int32_t>(sizeof(IrsdkVarHeader));
+  header_.sessionInfoLen = static_cast<int32_t>(session_info.size() + 1);
+  header_.numBuf = 1;
+  header_.bufLen = (row + 15) / 16 * 16;
+  header_.varBuf[0].bufOffset = (header_.sessionInfoOffset + header_.sessionInfoLen + 15) / 16 * 16;
+
+  file_ = std::fopen(path.c_str(), "wb");
+  if (file_ == nullptr) {
+    throw std::system_error(errno, std::generic_category(), "create " + path);
+  }
+  std::setvbuf(file_, nullptr, _IOFBF, 1 << 20);
+  std::vector<uint8_t> prefix(static_cast<size_t>(header_.varBuf[0].bufOffset), 0);
+  std::memcpy(prefix.data() + header_.varHeaderOffset, vars_.data(), vars_.size() * sizeof(IrsdkVarHeader));
+  std::memcpy(prefix.data() + header_.sessionInfoOffset, session_info.c_str(), session_info.size() + 1);
+  ok_ = std::fwrite(prefix.data(), 1, prefix.size(), file_) == prefix.size();  // headers patched by close()
+}
+
+IbtWriter::~IbtWriter() { close(); }
+
+bool IbtWriter::append(const uint8_t* record) {
+  if (file_ == nullptr) {
+    return false;
+  }
+  ok_ = ok_ && std::fwrite(record, 1, record_size(), file_) == record_size();
+  ++records_;
+  return ok_;
+}
+
+bool IbtWriter::close(int32_t lap_count) {
+  if (file_ == nullptr) {
+    return ok_;
+  }
+  disk_.sessionRecordCount = static_cast<int32_t>(records_);
+  disk_.sessionLapCount = lap_count;
+  disk_.sessionEndTime = header_.tickRate > 0 ? static_cast<double>(records_) / header_.tickRate : 0.0;
+  ok_ = ok_ && std::fseek(file_, 0, SEEK_SET) == 0 &&
+        std::fwrite(&header_, sizeof(header_), 1, file_) == 1 &&
+        std::fwrite(&disk_, sizeof(disk_), 1, file_) == 1;
+  ok_ = std::fclose(file_) == 0 && ok_;
+  file_ = nullptr;
+  return ok_;
+}
+
+}  // namespace trackpro::telemetry
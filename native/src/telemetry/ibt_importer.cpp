@@ -0,0 +1,329 @@
+#include "trackpro/telemetry/ibt_importer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+
+#include "trackpro/common/clock.h"
+#include "trackpro/common/file_io.h"
+#include "trackpro/telemetry/ibt_file.h"
+#include "trackpro/telemetry/lap_segmenter.h"
+
+namespace trackpro::telemetry {
+namespace {
+
+struct Column {
+  ChannelInfo info;
+  int32_t offset = 0;  // in the record
+  IrsdkVarType source = IrsdkVarType::Float;
+};
+
+// Record offsets of the variables the lap segmenter needs; -1 if absent.
+struct SegmentVars {
+  int32_t lap = -1;
+  int32_t session_time = -1;
+  int32_t lap_dist_pct = -1;
+  int32_t on_pit_road = -1;
+  int32_t is_on_track = -1;
+};
+
+struct DecodedChunk {
+  std::vector<uint8_t> buffer;                // raw records, recycled by the reader
+  std::vector<std::vector<uint8_t>> columns;  // typed values per channel
+  std::vector<TelemetrySample> segment;       // segmenter inputs only
+  size_t rows = 0;
+};
+
+ChannelType stored_type(IrsdkVarType type) {
+  switch (type) {
+    case IrsdkVarType::Float:
+      return ChannelType::Float32;
+    case IrsdkVarType::Double:
+      return ChannelType::Float64;
+    default:
+      return ChannelType::Int32;
+  }
+}
+
+// Transposes one column out of `rows` strided records.
+void transpose(const Column& column, const uint8_t* records, size_t record_size, size_t rows,
+               std::vector<uint8_t>& out) {
+  const size_t width = channel_type_size(column.info.type);
+  out.resize(rows * width);
+  const uint8_t* src = records + column.offset;
+  uint8_t* dst = out.data();
+  if (column.source == IrsdkVarType::Bool || column.source == IrsdkVarType::Char) {
+    for (size_t r = 0; r < rows; ++r, src += record_size, dst += 4) {
+      const int32_t v = static_cast<int8_t>(*src);
+      std::memcpy(dst, &v, 4);
+    }
+    return;
+  }
+  for (size_t r = 0; r < rows; ++r, src += record_size, dst += width) {
+    std::memcpy(dst, src, width);
+  }
+}
+
+DecodedChunk decode_chunk(std::vector<uint8_t> buffer, size_t rows, size_t record_size,
+                          const std::vector<Column>& columns, const SegmentVars& vars, double tick_period,
+                          uint64_t first_record) {
+  DecodedChunk chunk;
+  chunk.rows = rows;
+  chunk.columns.resize(columns.size());
+  for (size_t c = 0; c < columns.size(); ++c) {
+    transpose(columns[c], buffer.data(), record_size, rows, chunk.columns[c]);
+  }
+  chunk.segment.resize(rows);
+  for (size_t r = 0; r < rows; ++r) {
+    const uint8_t* record = buffer.data() + r * record_size;
+    TelemetrySample& s = chunk.segment[r];
+    if (vars.session_time >= 0) {
+      std::memcpy(&s.session_time, record + vars.session_time, 8);
+    } else {
+      s.session_time = static_cast<double>(first_record + r) * tick_period;
+    }
+    if (vars.lap >= 0) {
+      std::memcpy(&s.lap, record + vars.lap, 4);
+    }
+    std::memcpy(&s.lap_dist_pct, record + vars.lap_dist_pct, 4);
+    s.on_pit_road = vars.on_pit_road >= 0 && record[vars.on_pit_road] != 0;
+    s.is_on_track = vars.is_on_track < 0 || record[vars.is_on_track] != 0;
+  }
+  chunk.buffer = std::move(buffer);
+  return chunk;
+}
+
+// "Key: value" from the session YAML; good enough for the flat keys used here.
+std::string yaml_value(std::string_view yaml, std::string_view key) {
+  const size_t at = yaml.find(std::string(key) + ":");
+  if (at == std::string_view::npos) {
+    return {};
+  }
+  size_t start = at + key.size() + 1;
+  while (start < yaml.size() && yaml[start] == ' ') {
+    ++start;
+  }
+  const size_t end = std::min(yaml.find('\n', start), yaml.size());
+  return std::string(yaml.substr(start, end - start));
+}
+
+// Holds the lap the segmenter closed during the current push().
+struct ClosedLap : LapListener {
+  void on_lap(const SegmentedLap& lap) override {
+    info = lap.info;
+    closed = true;
+  }
+  LapInfo info;
+  bool closed = false;
+};
+
+}  // namespace
+
+IbtImporter::IbtImporter(IbtImportOptions options) : options_(std::move(options)), pool_(options_.threads) {
+  if (options_.chunk_records == 0) {
+    throw std::invalid_argument("ibt import: chunk_records must be positive");
+  }
+  if (options_.max_chunks_in_flight == 0) {
+    options_.max_chunks_in_flight = 2 * pool_.size();
+  }
+}
+
+IbtImportStats IbtImporter::import(const std::string& ibt_path, const std::string& store_path) {
+  const uint64_t start_ns = now_ns();
+  const IbtLayout layout = IbtLayout::read(ibt_path);
+  const size_t record_size = layout.record_size();
+  const int tick_rate = layout.header().tickRate > 0 ? layout.header().tickRate : 60;
+
+  std::vector<Column> columns;
+  auto add_var = [&](const IrsdkVarHeader& v) {
+    Column c;
+    c.info.name = std::string(v.name, strnlen(v.name, kIrsdkMaxString));
+    c.info.unit = std::string(v.unit, std::min<size_t>(strnlen(v.unit, kIrsdkMaxString), 15));
+    c.info.type = stored_type(v.type);
+    c.offset = v.offset;
+    c.source = v.type;
+    columns.push_back(std::move(c));
+  };
+  if (options_.channels.empty()) {
+    for (const IrsdkVarHeader& v : layout.vars()) {
+      if (v.count == 1) {
+        add_var(v);
+      }
+    }
+  } else {
+    for (const std::string& name : options_.channels) {
+      const int index = layout.find_var(name);
+      if (index >= 0 && layout.vars()[static_cast<size_t>(index)].count == 1) {
+        add_var(layout.vars()[static_cast<size_t>(index)]);
+      }
+    }
+  }
+  if (columns.empty()) {
+    throw std::runtime_error("ibt import: no channels to import from " + ibt_path);
+  }
+  auto var_offset = [&](const char* name, IrsdkVarType type) {
+    const int index = layout.find_var(name);
+    return index >= 0 && layout.vars()[static_cast<size_t>(index)].type == type
+               ? layout.vars()[static_cast<size_t>(index)].offset
+               : -1;
+  };
+  SegmentVars vars;
+  vars.lap = var_offset("Lap", IrsdkVarType::Int);
+  vars.session_time = var_offset("SessionTime", IrsdkVarType::Double);
+  vars.lap_dist_pct = var_offset("LapDistPct", IrsdkVarType::Float);
+  vars.on_pit_road = var_offset("OnPitRoad", IrsdkVarType::Bool);
+  vars.is_on_track = var_offset("IsOnTrack", IrsdkVarType::Bool);
+  if (vars.lap_dist_pct < 0) {
+    throw std::runtime_error("ibt import: " + ibt_path + " has no LapDistPct");
+  }
+
+  std::vector<ChannelInfo> channels;
+  for (const Column& c : columns) {
+    channels.push_back(c.info);
+  }
+  LapStoreMetadata metadata;
+  metadata.track = yaml_value(layout.session_info(), "TrackName");
+  metadata.car = yaml_value(layout.session_info(), "CarPath");
+  metadata.driver = yaml_value(layout.session_info(), "UserName");
+  metadata.session_start_unix = layout.disk_header().sessionStartDate;
+  LapStoreWriter writer(store_path, channels, metadata);
+
+  std::FILE* file = std::fopen(ibt_path.c_str(), "rb");
+  if (file == nullptr) {
+    throw std::system_error(errno, std::generic_category(), "open " + ibt_path);
+  }
+  std::setvbuf(file, nullptr, _IONBF, 0);  // whole chunks go straight into our buffers
+  if (!seek_file(file, layout.records_offset())) {
+    const int error = errno;
+    std::fclose(file);
+    throw std::runtime_error("ibt import: cannot seek to the records of " + ibt_path + ": " + std::strerror(error));
+  }
+
+  IbtImportStats stats;
+  const size_t total_records = layout.record_count();
+  const double tick_period = 1.0 / tick_rate;
+  std::deque<std::future<DecodedChunk>> decoding;
+  std::deque<std::future<EncodedLap>> encoding;
+  std::vector<std::vector<uint8_t>> free_buffers;
+  ClosedLap closed;
+  LapSegmenterOptions segmenter_options;
+  segmenter_options.sector_splits = parse_sector_splits(layout.session_info());
+  segmenter_options.sample_rate_hz = static_cast<float>(tick_rate);
+  LapSegmenter segmenter(closed, segmenter_options);
+  std::vector<std::vector<uint8_t>> lap_columns(columns.size());
+  uint64_t next_record = 0;
+  bool write_ok = true;
+
+  auto write_ready = [&](bool wait_all) {
+    while (!encoding.empty()) {
+      const bool must_wait = wait_all || encoding.size() > pool_.size();
+      if (!must_wait && encoding.front().wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        break;
+      }
+      write_ok = writer.write_lap(encoding.front().get()) && write_ok;
+      encoding.pop_front();
+      ++stats.laps;
+    }
+  };
+
+  auto finish_lap = [&](const LapInfo& info) {
+    auto moved = std::make_shared<std::vector<std::vector<uint8_t>>>(std::move(lap_columns));
+    lap_columns.assign(columns.size(), {});
+    encoding.push_back(pool_.submit([&channels, info, moved] {
+      std::vector<const void*> pointers;
+      for (const auto& c : *moved) {
+        pointers.push_back(c.data());
+      }
+      return encode_lap(channels, info, pointers);
+    }));
+    write_ready(false);
+  };
+
+  auto append_rows = [&](const DecodedChunk& chunk, size_t begin, size_t end) {
+    for (size_t c = 0; c < columns.size() && begin < end; ++c) {
+      const size_t width = channel_type_size(columns[c].info.type);
+      const uint8_t* src = chunk.columns[c].data();
+      lap_columns[c].insert(lap_columns[c].end(), src + begin * width, src + end * width);
+    }
+  };
+
+  // Rows go to the lap in progress in runs; the segmenter decides where runs
+  // end. Rows outside any lap (pit box, tow) are dropped.
+  auto consume = [&](DecodedChunk chunk) {
+    size_t run_start = 0;
+    for (size_t r = 0; r < chunk.rows; ++r) {
+      const bool was_timing = segmenter.lap_in_progress();
+      segmenter.push(chunk.segment[r]);
+      const bool lap_closed = closed.closed;
+      if (lap_closed) {
+        closed.closed = false;
+        append_rows(chunk, run_start, r);
+        finish_lap(closed.info);
+      }
+      if (segmenter.lap_in_progress() && (lap_closed || !was_timing)) {
+        run_start = r;
+      }
+    }
+    if (segmenter.lap_in_progress()) {
+      append_rows(chunk, run_start, chunk.rows);
+    }
+    free_buffers.push_back(std::move(chunk.buffer));
+  };
+
+  while (next_record < total_records || !decoding.empty()) {
+    while (next_record < total_records && decoding.size() < options_.max_chunks_in_flight) {
+      const size_t rows = static_cast<size_t>(std::min<uint64_t>(options_.chunk_records, total_records - next_record));
+      std::vector<uint8_t> buffer;
+      if (!free_buffers.empty()) {
+        buffer = std::move(free_buffers.back());
+        free_buffers.pop_back();
+      }
+      buffer.resize(rows * record_size);
+      const size_t got = std::fread(buffer.data(), 1, buffer.size(), file);
+      stats.bytes_read += got;
+      if (got != buffer.size()) {
+        std::fclose(file);
+        // Queued tasks reference this frame; let them finish before unwinding.
+        for (auto& f : decoding) {
+          f.wait();
+        }
+        for (auto& f : encoding) {
+          f.wait();
+        }
+        throw std::runtime_error("ibt import: " + ibt_path + " truncated at record " + std::to_string(next_record));
+      }
+      decoding.push_back(pool_.submit(
+          [buffer = std::move(buffer), rows, record_size, &columns, &vars, tick_period,
+           first = next_record]() mutable {
+            return decode_chunk(std::move(buffer), rows, record_size, columns, vars, tick_period, first);
+          }));
+      next_record += rows;
+    }
+    consume(decoding.front().get());
+    decoding.pop_front();
+  }
+  std::fclose(file);
+  stats.records = next_record;
+
+  // The session ended mid-lap.
+  segmenter.finish();
+  if (closed.closed) {
+    finish_lap(closed.info);
+  }
+  write_ready(true);
+  write_ok = writer.close() && write_ok;
+  if (!write_ok) {
+    throw std::runtime_error("ibt import: failed writing " + store_path);
+  }
+  stats.bytes_written = std::filesystem::file_size(store_path);
+  stats.seconds = static_cast<double>(now_ns() - start_ns) / 1e9;
+  return stats;
+}
+
+}  // namespace trackpro::telemetry
@@ -0,0 +1,133 @@
+#include "trackpro/telemetry/ibt_replay_producer.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "trackpro/common/clock.h"
+#include "trackpro/common/realtime.h"
+
+namespace trackpro::telemetry {
+namespace {
+
+constexpr size_t kRowAlignment = 64;
+
+size_t align_up(size_t value, size_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+}  // namespace
+
+IbtReplayProducer::IbtReplayProducer(std::shared_ptr<const IbtFile> file, const std::string& region_path,
+                                     int num_buffers)
+    : file_(std::move(file)), num_buffers_(num_buffers) {
+  if (file_ == nullptr || num_buffers < 2 || num_buffers > kIrsdkMaxBufs) {
+    throw std::invalid_argument("ibt replay: need a file and 2..4 buffers");
+  }
+  const IbtLayout& layout = file_->layout();
+  const std::string& info = layout.session_info();
+  const size_t vars_offset = align_up(sizeof(IrsdkHeader), 16);
+  const size_t info_offset = vars_offset + layout.vars().size() * sizeof(IrsdkVarHeader);
+  const size_t info_len = align_up(info.size() + 1, 16);
+  const size_t rows_offset = align_up(info_offset + info_len, kRowAlignment);
+  const size_t row_stride = align_up(layout.record_size(), kRowAlignment);
+  const size_t total = rows_offset + row_stride * static_cast<size_t>(num_buffers);
+
+#if defined(_WIN32)
+  region_ = MappedRegion::create_named(region_path, total);
+#else
+  region_ = MappedRegion::create(region_path, total);
+#endif
+  uint8_t* base = region_.mutable_data();
+  std::memset(base, 0, total);
+  std::memcpy(base + vars_offset, layout.vars().data(), layout.vars().size() * sizeof(IrsdkVarHeader));
+  std::memcpy(base + info_offset, info.data(), info.size());
+
+  header_ = reinterpret_cast<IrsdkHeader*>(base);
+  header_->ver = kIrsdkVersion;
+  header_->tickRate = layout.header().tickRate;
+  header_->sessionInfoUpdate = 1;
+  header_->sessionInfoLen = static_cast<int32_t>(info_len);
+  header_->sessionInfoOffset = static_cast<int32_t>(info_offset);
+  header_->numVars = static_cast<int32_t>(layout.vars().size());
+  header_->varHeaderOffset = static_cast<int32_t>(vars_offset);
+  header_->numBuf = num_buffers;
+  header_->bufLen = static_cast<int32_t>(layout.record_size());
+  for (int i = 0; i < num_buffers; ++i) {
+    header_->varBuf[i].tickCount = -1;
+    header_->varBuf[i].bufOffset = static_cast<int32_t>(rows_offset + row_stride * static_cast<size_t>(i));
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+  header_->status = kIrsdkStatusConnected;
+}
+
+IbtReplayProducer::~IbtReplayProducer() {
+  stop();
+  if (header_ != nullptr) {
+    disconnect();
+  }
+}
+
+bool IbtReplayProducer::step(bool loop) {
+  const IbtLayout& layout = file_->layout();
+  if (next_record_ >= layout.record_count()) {
+    if (!loop || layout.record_count() == 0) {
+      return false;
+    }
+    next_record_ = 0;
+  }
+  IrsdkVarBuf& slot = header_->varBuf[tick_ % num_buffers_];
+  // Invalidate first so a reader still holding this row sees it change.
+  volatile int32_t* tick_count = &slot.tickCount;
+  *tick_count = -1;
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(region_.mutable_data() + slot.bufOffset, file_->record(next_record_), layout.record_size());
+  std::atomic_thread_fence(std::memory_order_release);
+  *tick_count = tick_;
+  ++tick_;
+  ++next_record_;
+  published_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+void IbtReplayProducer::start(double speed, bool loop) {
+  if (running_.exchange(true)) {
+    return;
+  }
+  thread_ = std::thread([this, speed, loop] { run(speed, loop); });
+}
+
+void IbtReplayProducer::stop() {
+  running_.store(false);
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void IbtReplayProducer::disconnect() {
+  std::atomic_thread_fence(std::memory_order_release);
+  header_->status = 0;
+}
+
+void IbtReplayProducer::run(double speed, bool loop) {
+  set_current_thread_name("tp-ibt-replay");
+  const int rate = file_->layout().header().tickRate > 0 ? file_->layout().header().tickRate : 60;
+  const uint64_t period_ns = speed > 0.0 ? static_cast<uint64_t>(kNanosPerSecond / (rate * speed)) : 0;
+  uint64_t deadline = now_ns();
+  while (running_.load(std::memory_order_relaxed)) {
+    if (!step(loop)) {
+      break;
+    }
+    if (period_ns != 0) {
+      deadline += period_ns;
+      const uint64_t now = now_ns();
+      if (now >= deadline) {
+        // Descheduled past a tick: carry on a period from now, as the sim's
+        // frame loop would, instead of publishing the missed ticks back to
+        // back faster than any reader of the ring can follow.
+        deadline = now + period_ns;
+      }
+      sleep_until_ns(deadline);
+    }
+  }
+  running_.store(false);
+}
+
+}  // namespace trackpro::telemetry
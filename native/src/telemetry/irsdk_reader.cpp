@@ -0,0 +1,175 @@
+#include "trackpro/telemetry/irsdk_reader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+
+#include "trackpro/common/clock.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+
+namespace trackpro::telemetry {
+namespace {
+
+int32_t load_acquire(const volatile int32_t* p) {
+  const int32_t v = *p;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return v;
+}
+
+std::string_view var_name(const IrsdkVarHeader& h) {
+  return std::string_view(h.name, strnlen(h.name, kIrsdkMaxString));
+}
+
+// True if every element of the variable lies inside a row of `buf_len` bytes.
+bool var_fits(const IrsdkVarHeader& h, int32_t buf_len) {
+  const size_t size = irsdk_type_size(h.type);
+  if (size == 0 || h.offset < 0 || h.count < 1) {
+    return false;
+  }
+  return static_cast<size_t>(h.offset) + size * static_cast<size_t>(h.count) <= static_cast<size_t>(buf_len);
+}
+
+}  // namespace
+
+bool IrsdkFrame::still_valid() const {
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return tick_slot != nullptr && *tick_slot == tick;
+}
+
+IrsdkReader::IrsdkReader(MappedRegion region) : region_(std::move(region)) {
+  if (region_.size() < sizeof(IrsdkHeader)) {
+    throw std::invalid_argument("irsdk region is smaller than its header");
+  }
+}
+
+bool IrsdkReader::layout_is_current() const {
+  const IrsdkHeader* h = header();
+  return h->numVars == indexed_num_vars_ && h->varHeaderOffset == indexed_var_offset_ &&
+         h->bufLen == indexed_buf_len_;
+}
+
+bool IrsdkReader::reindex() {
+  const IrsdkHeader* h = header();
+  index_.clear();
+  indexed_num_vars_ = -1;
+  const size_t end = static_cast<size_t>(h->varHeaderOffset) +
+                     static_cast<size_t>(std::max(h->numVars, 0)) * sizeof(IrsdkVarHeader);
+  if (h->numVars <= 0 || h->varHeaderOffset <= 0 || end > region_.size() || h->bufLen <= 0 ||
+      h->numBuf < 1 || h->numBuf > kIrsdkMaxBufs) {
+    return false;
+  }
+  const auto* vars = reinterpret_cast<const IrsdkVarHeader*>(region_.data() + h->varHeaderOffset);
+  index_.reserve(static_cast<size_t>(h->numVars));
+  for (int32_t i = 0; i < h->numVars; ++i) {
+    // A corrupt or truncated table must not hand out offsets past the row.
+    if (!var_fits(vars[i], h->bufLen)) {
+      ++counters_.rejected_vars;
+      continue;
+    }
+    index_.emplace_back(var_name(vars[i]), &vars[i]);
+  }
+  std::sort(index_.begin(), index_.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+  indexed_num_vars_ = h->numVars;
+  indexed_var_offset_ = h->varHeaderOffset;
+  indexed_buf_len_ = h->bufLen;
+  ++layout_revision_;
+  ++counters_.layout_changes;
+  last_tick_ = -1;
+  return true;
+}
+
+const IrsdkVarHeader* IrsdkReader::find(std::string_view name) const {
+  auto it = std::lower_bound(index_.begin(), index_.end(), name,
+                             [](const auto& entry, std::string_view n) { return entry.first < n; });
+  return it != index_.end() && it->first == name ? it->second : nullptr;
+}
+
+std::string_view IrsdkReader::session_info() const {
+  const IrsdkHeader* h = header();
+  if (h->sessionInfoOffset <= 0 || h->sessionInfoLen <= 0 ||
+      static_cast<size_t>(h->sessionInfoOffset) + static_cast<size_t>(h->sessionInfoLen) > region_.size()) {
+    return {};
+  }
+  const char* text = reinterpret_cast<const char*>(region_.data() + h->sessionInfoOffset);
+  return std::string_view(text, strnlen(text, static_cast<size_t>(h->sessionInfoLen)));
+}
+
+IrsdkPoll IrsdkReader::poll(IrsdkFrame& frame) {
+  const IrsdkHeader* h = header();
+  if ((load_acquire(&h->status) & kIrsdkStatusConnected) == 0) {
+    // A restart or car change can bring a different table of the same
+    // shape: always reindex on reconnect.
+    last_tick_ = -1;
+    indexed_num_vars_ = -1;
+    return IrsdkPoll::Disconnected;
+  }
+  if (!layout_is_current() && !reindex()) {
+    return IrsdkPoll::Disconnected;
+  }
+  session_info_update_ = h->sessionInfoUpdate;
+
+  int latest = 0;
+  int32_t latest_tick = load_acquire(&h->varBuf[0].tickCount);
+  for (int i = 1; i < h->numBuf; ++i) {
+    const int32_t t = load_acquire(&h->varBuf[i].tickCount);
+    if (t > latest_tick) {
+      latest_tick = t;
+      latest = i;
+    }
+  }
+  if (latest_tick == last_tick_) {
+    return IrsdkPoll::NoNewData;
+  }
+  const int32_t offset = h->varBuf[latest].bufOffset;
+  if (offset <= 0 || static_cast<size_t>(offset) + static_cast<size_t>(h->bufLen) > region_.size()) {
+    return IrsdkPoll::Disconnected;
+  }
+  if (last_tick_ >= 0 && latest_tick > last_tick_ + 1) {
+    counters_.skipped_ticks += static_cast<uint64_t>(latest_tick - last_tick_ - 1);
+  }
+  last_tick_ = latest_tick;
+  ++counters_.frames;
+
+  frame.row = region_.data() + offset;
+  frame.tick = latest_tick;
+  frame.tick_slot = &h->varBuf[latest].tickCount;
+  return IrsdkPoll::NewFrame;
+}
+
+IrsdkPoll IrsdkReader::wait_for_frame(IrsdkFrame& frame, uint64_t timeout_ns) {
+  const uint64_t deadline = now_ns() + timeout_ns;
+#if defined(_WIN32)
+  // The sim creates the event, so until it has run, retry the open on every
+  // wait. Shared by all readers and kept for the life of the process.
+  static std::atomic<HANDLE> shared_event{nullptr};
+  HANDLE event = shared_event.load(std::memory_order_acquire);
+  if (event == nullptr) {
+    event = OpenEventA(SYNCHRONIZE, FALSE, kIrsdkDataValidEventName);
+    HANDLE expected = nullptr;
+    if (event != nullptr && !shared_event.compare_exchange_strong(expected, event, std::memory_order_acq_rel)) {
+      CloseHandle(event);
+      event = expected;
+    }
+  }
+#endif
+  for (;;) {
+    const IrsdkPoll result = poll(frame);
+    const uint64_t now = now_ns();
+    if (result == IrsdkPoll::NewFrame || now >= deadline) {
+      return result;
+    }
+#if defined(_WIN32)
+    if (event != nullptr) {
+      WaitForSingleObject(event, static_cast<DWORD>((deadline - now) / kNanosPerMilli + 1));
+      continue;
+    }
+#endif
+    sleep_until_ns(std::min(deadline, now + 200 * kNanosPerMicro), 20 * kNanosPerMicro);
+  }
+}
+
+}  // namespace trackpro::telemetry
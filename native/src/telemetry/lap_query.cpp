@@ -0,0 +1,347 @@
+#include "trackpro/telemetry/lap_query.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include "trackpro/common/byte_io.h"
+
+namespace trackpro::telemetry {
+namespace {
+
+constexpr char kMagic[4] = {'T', 'P', 'Z', 'I'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeaderSize = 36;
+constexpr float kInf = std::numeric_limits<float>::infinity();
+
+uint32_t float_bits(float v) {
+  uint32_t bits;
+  std::memcpy(&bits, &v, sizeof(bits));
+  return bits;
+}
+
+float bits_float(uint64_t bits) {
+  const auto b = static_cast<uint32_t>(bits);
+  float v;
+  std::memcpy(&v, &b, sizeof(v));
+  return v;
+}
+
+enum class Verdict : uint8_t { False, True, Unknown };
+
+Verdict compare(const ChannelPredicate& p, double v) {
+  const bool holds = p.compare == Compare::Greater ? v > p.value : v < p.value;
+  return holds ? Verdict::True : Verdict::False;
+}
+
+// The aggregate lies in [lo, hi]; decide the predicate if that interval is
+// entirely on one side of the value.
+Verdict compare_bounds(const ChannelPredicate& p, double lo, double hi) {
+  if (p.compare == Compare::Greater) {
+    return lo > p.value ? Verdict::True : (hi <= p.value ? Verdict::False : Verdict::Unknown);
+  }
+  return hi < p.value ? Verdict::True : (lo >= p.value ? Verdict::False : Verdict::Unknown);
+}
+
+// Bounds on a ranged aggregate from the zone maps. Zones overlapping the
+// range cover at least its samples; zones wholly inside it cover at most
+// them. Zone 0 and the last zone are open-ended, so never wholly inside.
+Verdict zone_verdict(const LapZoneIndex& index, size_t lap, size_t channel, const ChannelPredicate& p) {
+  const float zone = index.zone_m();
+  const auto last = static_cast<long long>(index.zone_count()) - 1;
+  const long long z0 = std::clamp(static_cast<long long>(std::floor(p.from_m / zone)), 0LL, last);
+  const long long z1 = std::clamp(static_cast<long long>(std::ceil(p.to_m / zone)) - 1, 0LL, last);
+  float over_min = kInf;
+  float over_max = -kInf;
+  float in_min = kInf;
+  float in_max = -kInf;
+  for (long long z = z0; z <= z1; ++z) {
+    const float lo = index.zone_min(lap, channel, static_cast<size_t>(z));
+    const float hi = index.zone_max(lap, channel, static_cast<size_t>(z));
+    over_min = std::min(over_min, lo);
+    over_max = std::max(over_max, hi);
+    const bool inside = z > 0 && z < last && static_cast<float>(z) * zone >= p.from_m &&
+                        static_cast<float>(z + 1) * zone <= p.to_m;
+    if (inside) {
+      in_min = std::min(in_min, lo);
+      in_max = std::max(in_max, hi);
+    }
+  }
+  if (over_min > over_max) {
+    return Verdict::False;  // no samples in range
+  }
+  return p.aggregate == Aggregate::Min ? compare_bounds(p, over_min, in_min) : compare_bounds(p, in_max, over_max);
+}
+
+}  // namespace
+
+LapZoneIndex::LapZoneIndex(double track_length_m, std::vector<std::string> channels, float zone_m)
+    : length_(track_length_m), channels_(std::move(channels)), zone_m_(zone_m) {
+  if (!(track_length_m > 0.0) || !(zone_m > 0.0f)) {
+    throw std::invalid_argument("LapZoneIndex: track length and zone size must be positive");
+  }
+  // One extra zone catches samples past the nominal length.
+  zones_ = static_cast<size_t>(std::ceil(track_length_m / zone_m)) + 1;
+}
+
+int LapZoneIndex::find_channel(const std::string& name) const {
+  const auto it = std::find(channels_.begin(), channels_.end(), name);
+  return it == channels_.end() ? -1 : static_cast<int>(it - channels_.begin());
+}
+
+size_t LapZoneIndex::update(const LapStore& store, ThreadPool* pool) {
+  if (store.lap_count() <= laps_) {
+    return 0;
+  }
+  const int distance = store.find_channel("LapDist");
+  if (distance < 0) {
+    throw std::invalid_argument("LapZoneIndex needs a LapDist channel");
+  }
+  std::vector<int> columns;
+  for (const std::string& name : channels_) {
+    columns.push_back(store.find_channel(name));
+  }
+  const size_t first = laps_;
+  const size_t added = store.lap_count() - first;
+  cells_.resize(store.lap_count() * channels_.size() * zones_, Cell{kInf, -kInf});
+  if (pool == nullptr) {
+    for (size_t i = 0; i < added; ++i) {
+      index_lap(store, columns, distance, first + i);
+    }
+  } else {
+    parallel_for(*pool, added, 16, [&](size_t i) { index_lap(store, columns, distance, first + i); });
+  }
+  laps_ = store.lap_count();
+  return added;
+}
+
+void LapZoneIndex::index_lap(const LapStore& store, const std::vector<int>& columns, int distance, size_t lap) {
+  std::vector<float> d;
+  if (!store.read(lap, static_cast<size_t>(distance), d)) {
+    return;
+  }
+  std::vector<uint32_t> zone(d.size());
+  const auto last = static_cast<long long>(zones_) - 1;
+  for (size_t i = 0; i < d.size(); ++i) {
+    zone[i] = static_cast<uint32_t>(std::clamp(static_cast<long long>(std::floor(d[i] / zone_m_)), 0LL, last));
+  }
+  std::vector<float> values;
+  for (size_t c = 0; c < columns.size(); ++c) {
+    if (columns[c] < 0 || !store.read(lap, static_cast<size_t>(columns[c]), values) || values.size() != d.size()) {
+      continue;
+    }
+    Cell* cells = &cells_[cell(lap, c, 0)];
+    for (size_t i = 0; i < values.size(); ++i) {
+      Cell& z = cells[zone[i]];
+      z.min = std::min(z.min, values[i]);
+      z.max = std::max(z.max, values[i]);
+    }
+  }
+}
+
+bool LapZoneIndex::save(const std::string& path) const {
+  size_t names = 0;
+  for (const std::string& n : channels_) {
+    names += 2 + n.size();
+  }
+  std::vector<uint8_t> buf(kHeaderSize + names + cells_.size() * 8);
+  uint8_t* p = buf.data();
+  std::memcpy(p, kMagic, 4);
+  put_u32(p + 4, kVersion);
+  put_u32(p + 8, static_cast<uint32_t>(channels_.size()));
+  put_u32(p + 12, static_cast<uint32_t>(zones_));
+  put_u64(p + 16, laps_);
+  put_u32(p + 24, float_bits(zone_m_));
+  uint64_t length_bits;
+  std::memcpy(&length_bits, &length_, sizeof(length_bits));
+  put_u64(p + 28, length_bits);
+  p += kHeaderSize;
+  for (const std::string& n : channels_) {
+    put_u16(p, static_cast<uint16_t>(n.size()));
+    std::memcpy(p + 2, n.data(), n.size());
+    p += 2 + n.size();
+  }
+  for (const Cell& c : cells_) {
+    put_u32(p, float_bits(c.min));
+    put_u32(p + 4, float_bits(c.max));
+    p += 8;
+  }
+  const std::string tmp = path + ".tmp";
+  std::FILE* f = std::fopen(tmp.c_str(), "wb");
+  if (f == nullptr) {
+    return false;
+  }
+  const bool ok = std::fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+  if (std::fclose(f) != 0 || !ok) {
+    std::remove(tmp.c_str());
+    return false;
+  }
+  return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+LapZoneIndex LapZoneIndex::load(const std::string& path) {
+  std::FILE* f = std::fopen(path.c_str(), "rb");
+  if (f == nullptr) {
+    throw std::runtime_error("cannot open zone index " + path + ": " + std::strerror(errno));
+  }
+  std::vector<uint8_t> buf;
+  uint8_t chunk[65536];
+  for (size_t n; (n = std::fread(chunk, 1, sizeof(chunk), f)) > 0;) {
+    buf.insert(buf.end(), chunk, chunk + n);
+  }
+  std::fclose(f);
+  if (buf.size() < kHeaderSize || std::memcmp(buf.data(), kMagic, 4) != 0 || get_le(buf.data() + 4, 4) != kVersion) {
+    throw std::runtime_error(path + " is not a TrackPro zone index");
+  }
+  const uint8_t* p = buf.data();
+  const uint8_t* end = buf.data() + buf.size();
+  const auto channel_count = static_cast<size_t>(get_le(p + 8, 4));
+  const auto zones = static_cast<size_t>(get_le(p + 12, 4));
+  const auto laps = static_cast<size_t>(get_le(p + 16, 8));
+  const float zone_m = bits_float(get_le(p + 24, 4));
+  const uint64_t length_bits = get_le(p + 28, 8);
+  double length;
+  std::memcpy(&length, &length_bits, sizeof(length));
+  p += kHeaderSize;
+  std::vector<std::string> channels;
+  for (size_t c = 0; c < channel_count; ++c) {
+    if (end - p < 2 || static_cast<size_t>(end - p) < 2 + get_le(p, 2)) {
+      throw std::runtime_error(path + ": truncated zone index");
+    }
+    const auto n = static_cast<size_t>(get_le(p, 2));
+    channels.emplace_back(reinterpret_cast<const char*>(p + 2), n);
+    p += 2 + n;
+  }
+  LapZoneIndex index(length, std::move(channels), zone_m);
+  if (index.zones_ != zones || static_cast<size_t>(end - p) != laps * channel_count * zones * 8) {
+    throw std::runtime_error(path + ": truncated zone index");
+  }
+  index.laps_ = laps;
+  index.cells_.resize(laps * channel_count * zones);
+  for (Cell& c : index.cells_) {
+    c.min = bits_float(get_le(p, 4));
+    c.max = bits_float(get_le(p + 4, 4));
+    p += 8;
+  }
+  return index;
+}
+
+QueryResult run_query(const std::vector<QuerySource>& sources, const LapQuery& query, ThreadPool* pool) {
+  QueryResult result;
+  QueryStats& stats = result.stats;
+  for (size_t s = 0; s < sources.size(); ++s) {
+    const LapStore& store = *sources[s].store;
+    const LapZoneIndex* index = sources[s].index;
+    const size_t laps = store.lap_count();
+    stats.laps += laps;
+    if ((!query.track.empty() && store.metadata().track != query.track) ||
+        (!query.car.empty() && store.metadata().car != query.car)) {
+      stats.pruned_metadata += laps;
+      continue;
+    }
+
+    // Resolve channels once per store. A predicate on a channel the store
+    // lacks can never hold.
+    const int distance = store.find_channel("LapDist");
+    std::vector<int> store_channel;
+    std::vector<int> zone_channel;
+    bool satisfiable = true;
+    for (const ChannelPredicate& p : query.where) {
+      store_channel.push_back(store.find_channel(p.channel));
+      zone_channel.push_back(index != nullptr ? index->find_channel(p.channel) : -1);
+      const bool ranged = p.to_m > p.from_m;
+      satisfiable = satisfiable && store_channel.back() >= 0 && (!ranged || distance >= 0);
+    }
+    if (!satisfiable) {
+      stats.decided_by_stats += laps;
+      continue;
+    }
+
+    // Per lap: 0 pruned by metadata, 1 decided by statistics, 2 decoded;
+    // plus the verdict and decoded chunk count.
+    struct Outcome {
+      uint8_t stage;
+      bool match;
+      uint16_t chunks;
+    };
+    std::vector<Outcome> outcome(laps);
+    auto evaluate = [&](size_t lap) {
+      Outcome& out = outcome[lap];
+      const LapInfo info = store.lap(lap);
+      if ((info.flags & query.require_flags) != query.require_flags || (info.flags & query.exclude_flags) != 0 ||
+          info.lap_time_s < query.min_lap_time_s || info.lap_time_s > query.max_lap_time_s) {
+        out = {0, false, 0};
+        return;
+      }
+      std::vector<size_t> unknown;
+      for (size_t i = 0; i < query.where.size(); ++i) {
+        const ChannelPredicate& p = query.where[i];
+        Verdict v = Verdict::Unknown;
+        if (p.to_m <= p.from_m) {
+          const ChunkStats st = store.chunk(lap, static_cast<size_t>(store_channel[i]));
+          v = compare(p, p.aggregate == Aggregate::Min ? st.min : st.max);
+        } else if (zone_channel[i] >= 0 && lap < index->lap_count()) {
+          v = zone_verdict(*index, lap, static_cast<size_t>(zone_channel[i]), p);
+        }
+        if (v == Verdict::False) {
+          out = {1, false, 0};
+          return;
+        }
+        if (v == Verdict::Unknown) {
+          unknown.push_back(i);
+        }
+      }
+      if (unknown.empty()) {
+        out = {1, true, 0};
+        return;
+      }
+      std::vector<float> d;
+      std::vector<float> values;
+      uint16_t chunks = 1;
+      bool match = store.read(lap, static_cast<size_t>(distance), d);
+      for (size_t k = 0; match && k < unknown.size(); ++k) {
+        const ChannelPredicate& p = query.where[unknown[k]];
+        ++chunks;
+        if (!store.read(lap, static_cast<size_t>(store_channel[unknown[k]]), values) || values.size() != d.size()) {
+          match = false;
+          break;
+        }
+        float agg = p.aggregate == Aggregate::Min ? kInf : -kInf;
+        bool any = false;
+        for (size_t i = 0; i < d.size(); ++i) {
+          if (d[i] >= p.from_m && d[i] < p.to_m) {
+            agg = p.aggregate == Aggregate::Min ? std::min(agg, values[i]) : std::max(agg, values[i]);
+            any = true;
+          }
+        }
+        match = any && compare(p, agg) == Verdict::True;
+      }
+      out = {2, match, chunks};
+    };
+    if (pool == nullptr) {
+      for (size_t lap = 0; lap < laps; ++lap) {
+        evaluate(lap);
+      }
+    } else {
+      parallel_for(*pool, laps, 64, evaluate);
+    }
+
+    for (size_t lap = 0; lap < laps; ++lap) {
+      const Outcome& o = outcome[lap];
+      stats.pruned_metadata += o.stage == 0 ? 1 : 0;
+      stats.decided_by_stats += o.stage == 1 ? 1 : 0;
+      stats.decoded_laps += o.stage == 2 ? 1 : 0;
+      stats.decoded_chunks += o.chunks;
+      if (o.match) {
+        result.hits.push_back({static_cast<uint32_t>(s), static_cast<uint32_t>(lap)});
+      }
+    }
+  }
+  return result;
+}
+
+}  // namespace trackpro::telemetry
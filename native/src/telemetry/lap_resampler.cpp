@@ -0,0 +1,119 @@
+#include "trackpro/telemetry/lap_resampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "trackpro/common/simd4.h"
+
+namespace trackpro::telemetry {
+namespace {
+
+// Grid points processed per channel before moving to the next channel, so
+// the plan stays in L1 while every channel uses it.
+constexpr size_t kBlock = 512;
+
+void apply_range(const int32_t* index, const float* weight, size_t begin, size_t end, const float* channel,
+                 float* out) {
+  size_t g = begin;
+  for (; g + 4 <= end; g += 4) {
+    simd::Vec4 lo;
+    simd::Vec4 hi;
+    simd::gather_pairs(channel, index + g, lo, hi);
+    simd::store(out + g, lo + simd::load(weight + g) * (hi - lo));
+  }
+  for (; g < end; ++g) {
+    const float a = channel[index[g]];
+    out[g] = a + weight[g] * (channel[index[g] + 1] - a);
+  }
+}
+
+}  // namespace
+
+DistanceResampler::DistanceResampler(double track_length_m, double step_m)
+    : length_(track_length_m), step_(step_m) {
+  if (!(track_length_m > 0.0) || !(step_m > 0.0)) {
+    throw std::invalid_argument("resampler: track length and step must be positive");
+  }
+  points_ = static_cast<size_t>(std::floor(track_length_m / step_m)) + 1;
+  const size_t padded = (points_ + 3) / 4 * 4;
+  index_.assign(padded, 0);
+  weight_.assign(padded, 0.0f);
+}
+
+bool DistanceResampler::plan(const float* distance, size_t count) {
+  if (count < 2) {
+    return false;
+  }
+  monotonic_.resize(count);
+  // Ticks before the line belong just below zero, not at the end of the lap,
+  // where they would hold the running maximum for the whole lap.
+  const size_t lagging = lagging_lap_start(distance, count, length_);
+  const auto length = static_cast<float>(length_);
+  float running = lagging > 0 ? distance[0] - length : distance[0];
+  for (size_t i = 0; i < count; ++i) {
+    running = std::max(running, i < lagging ? distance[i] - length : distance[i]);
+    monotonic_[i] = running;
+  }
+  const float* d = monotonic_.data();
+  const auto last_segment = static_cast<int32_t>(count - 2);
+
+  // Merge walk: grid points and samples both ascend.
+  int32_t seg = 0;
+  for (size_t g = 0; g < points_; ++g) {
+    const auto x = static_cast<float>(static_cast<double>(g) * step_);
+    while (seg < last_segment && d[seg + 1] <= x) {
+      ++seg;
+    }
+    const float span = d[seg + 1] - d[seg];
+    const float w = span > 0.0f ? (x - d[seg]) / span : 0.0f;
+    index_[g] = seg;
+    weight_[g] = std::clamp(w, 0.0f, 1.0f);
+  }
+  return true;
+}
+
+void DistanceResampler::apply(const float* channel, float* out) const {
+  apply_range(index_.data(), weight_.data(), 0, points_, channel, out);
+}
+
+void DistanceResampler::apply(const double* channel, double* out) const {
+  for (size_t g = 0; g < points_; ++g) {
+    const double a = channel[index_[g]];
+    out[g] = a + weight_[g] * (channel[index_[g] + 1] - a);
+  }
+}
+
+void DistanceResampler::apply(const std::vector<const float*>& channels, const std::vector<float*>& out) const {
+  for (size_t begin = 0; begin < points_; begin += kBlock) {
+    const size_t end = std::min(points_, begin + kBlock);
+    for (size_t c = 0; c < channels.size(); ++c) {
+      apply_range(index_.data(), weight_.data(), begin, end, channels[c], out[c]);
+    }
+  }
+}
+
+size_t lagging_lap_start(const float* distance, size_t count, double track_length_m) {
+  const auto half = static_cast<float>(track_length_m * 0.5);
+  for (size_t i = 0; i + 1 < count; ++i) {
+    if (!(distance[i] > half)) {
+      return 0;
+    }
+    if (distance[i] - distance[i + 1] > half) {
+      return i + 1;
+    }
+  }
+  return 0;
+}
+
+void subtract(const float* a, const float* b, float* out, size_t count) {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    simd::store(out + i, simd::load(a + i) - simd::load(b + i));
+  }
+  for (; i < count; ++i) {
+    out[i] = a[i] - b[i];
+  }
+}
+
+}  // namespace trackpro::telemetry
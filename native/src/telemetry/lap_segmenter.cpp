@@ -0,0 +1,154 @@
+#include "trackpro/telemetry/lap_segmenter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+namespace trackpro::telemetry {
+
+const char* lap_end_name(LapEnd end) {
+  switch (end) {
+    case LapEnd::Completed:
+      return "completed";
+    case LapEnd::Reset:
+      return "reset";
+    case LapEnd::SessionEnd:
+      return "session-end";
+  }
+  return "?";
+}
+
+LapSegmenter::LapSegmenter(LapListener& listener, LapSegmenterOptions options)
+    : listener_(listener), options_(std::move(options)) {
+  std::sort(options_.sector_splits.begin(), options_.sector_splits.end());
+  options_.sector_splits.erase(std::remove_if(options_.sector_splits.begin(), options_.sector_splits.end(),
+                                              [](float s) { return !(s > 0.0f && s < 1.0f); }),
+                               options_.sector_splits.end());
+  if (options_.sector_splits.size() + 1 > static_cast<size_t>(kMaxSectors)) {
+    throw std::invalid_argument("lap segmenter: too many sectors");
+  }
+}
+
+void LapSegmenter::start_lap(const TelemetrySample& sample, double start_time, uint32_t flags) {
+  timing_ = true;
+  lap_ = SegmentedLap();
+  lap_.info.lap_number = sample.lap;
+  lap_.info.sample_rate_hz = options_.sample_rate_hz;
+  lap_.info.start_session_time = start_time;
+  lap_.info.flags = flags;
+  lap_.first_sample = index_;
+  next_sector_ = 0;
+  sector_start_ = start_time;
+  listener_.on_lap_start(lap_.info);
+}
+
+void LapSegmenter::close_lap(double end_time, LapEnd end) {
+  timing_ = false;
+  lap_.end = end;
+  lap_.end_session_time = end_time;
+  lap_.info.lap_time_s = end_time - lap_.info.start_session_time;
+  lap_.info.sample_count = static_cast<uint32_t>(index_ - lap_.first_sample);
+  if (end == LapEnd::Completed) {
+    lap_.sector_times[static_cast<size_t>(lap_.sector_count++)] = end_time - sector_start_;
+    listener_.on_sector({lap_.info.lap_number, next_sector_, end_time - sector_start_, end_time});
+    if ((lap_.info.flags & (kLapOutLap | kLapInLap | kLapIncomplete)) == 0) {
+      lap_.info.flags |= kLapValid;
+    }
+  } else {
+    lap_.info.flags |= kLapIncomplete;
+  }
+  listener_.on_lap(lap_);
+}
+
+void LapSegmenter::push(const TelemetrySample& s) {
+  if (!have_previous_) {
+    have_previous_ = true;
+    previous_ = s;
+    if (s.is_on_track && !s.on_pit_road) {
+      // Joined mid-lap: keep the data, but the lap start was never seen.
+      start_lap(s, s.session_time, kLapIncomplete);
+    }
+    ++index_;
+    return;
+  }
+  const TelemetrySample& p = previous_;
+
+  if (!s.is_on_track) {
+    if (timing_) {
+      close_lap(s.session_time, LapEnd::Reset);
+    }
+  } else if (p.is_on_track) {
+    const float w = options_.wrap_window;
+    const float dp = s.lap_dist_pct - p.lap_dist_pct;
+    const bool crossed = p.lap_dist_pct > 1.0f - w && s.lap_dist_pct < w;
+    const bool crossed_backwards = p.lap_dist_pct < w && s.lap_dist_pct > 1.0f - w;
+    const double dt = s.session_time - p.session_time;
+
+    if (crossed_backwards || (!crossed && std::fabs(dp) > options_.reset_jump_pct)) {
+      if (timing_) {
+        close_lap(s.session_time, LapEnd::Reset);
+      }
+    } else {
+      if (timing_ && s.on_pit_road && !p.on_pit_road) {
+        lap_.info.flags |= kLapInLap;
+      }
+      // Sector lines passed since the previous tick (normally at most one).
+      if (timing_ && !crossed && dp > 0.0f) {
+        while (next_sector_ < static_cast<int>(options_.sector_splits.size()) &&
+               s.lap_dist_pct >= options_.sector_splits[static_cast<size_t>(next_sector_)]) {
+          const float split = options_.sector_splits[static_cast<size_t>(next_sector_)];
+          if (p.lap_dist_pct >= split) {
+            ++next_sector_;  // lap started past this split (out lap)
+            continue;
+          }
+          const double t = p.session_time + dt * (split - p.lap_dist_pct) / dp;
+          lap_.sector_times[static_cast<size_t>(lap_.sector_count++)] = t - sector_start_;
+          listener_.on_sector({lap_.info.lap_number, next_sector_, t - sector_start_, t});
+          sector_start_ = t;
+          ++next_sector_;
+        }
+      }
+      if (crossed) {
+        const double before = 1.0 - p.lap_dist_pct;
+        const double t = p.session_time + dt * before / (before + s.lap_dist_pct);
+        if (timing_) {
+          close_lap(t, LapEnd::Completed);
+        }
+        start_lap(s, t, s.on_pit_road ? kLapOutLap : 0u);
+      } else if (!timing_ && p.on_pit_road && !s.on_pit_road) {
+        start_lap(s, s.session_time, kLapOutLap);
+        // Sectors already behind the pit exit are not timed.
+        while (next_sector_ < static_cast<int>(options_.sector_splits.size()) &&
+               s.lap_dist_pct >= options_.sector_splits[static_cast<size_t>(next_sector_)]) {
+          ++next_sector_;
+        }
+        sector_start_ = s.session_time;
+      }
+    }
+  }
+  previous_ = s;
+  ++index_;
+}
+
+void LapSegmenter::finish() {
+  if (timing_) {
+    close_lap(previous_.session_time, LapEnd::SessionEnd);
+  }
+}
+
+std::vector<float> parse_sector_splits(std::string_view yaml) {
+  std::vector<float> splits;
+  constexpr std::string_view kKey = "SectorStartPct:";
+  for (size_t at = yaml.find(kKey); at != std::string_view::npos; at = yaml.find(kKey, at + kKey.size())) {
+    const std::string value(yaml.substr(at + kKey.size(), 24));
+    const float pct = std::strtof(value.c_str(), nullptr);
+    if (pct > 0.0f && pct < 1.0f) {
+      splits.push_back(pct);
+    }
+  }
+  return splits;
+}
+
+}  // namespace trackpro::telemetry
@@ -0,0 +1,499 @@
+#include "trackpro/telemetry/lap_store.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include "trackpro/common/file_io.h"
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace trackpro::telemetry {
+namespace {
+
+constexpr char kMagic[4] = {'T', 'P', 'L', 'S'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeaderSize = 64;
+// Header field holding the end of the committed trailer. 0 means "the end of
+// the file", which is how stores from before the pointer existed and stores
+// that were never committed read.
+constexpr size_t kCommittedEndOffset = 8;
+
+#pragma pack(push, 4)
+
+struct StoredChannel {
+  char name[32];
+  char unit[16];
+  uint8_t type;
+  uint8_t pad[15];
+};
+
+struct StoredLap {
+  int32_t lap_number;
+  uint32_t sample_count;
+  uint32_t flags;
+  float sample_rate_hz;
+  double lap_time_s;
+  double start_session_time;
+};
+
+struct StoredChunk {
+  uint64_t offset;
+  uint32_t size;
+  uint8_t codec;
+  uint8_t pad[3];
+  double min;
+  double max;
+};
+
+struct Trailer {
+  uint64_t directory_offset;
+  uint32_t channel_count;
+  uint32_t lap_count;
+  uint32_t metadata_size;
+  uint32_t version;
+  char magic[4];
+  uint32_t pad;
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(StoredChannel) == 64, "lap store channel entry");
+static_assert(sizeof(StoredLap) == 32, "lap store lap entry");
+static_assert(sizeof(StoredChunk) == 32, "lap store chunk entry");
+static_assert(sizeof(Trailer) == 32, "lap store trailer");
+
+// Flushes stdio and waits for the data to reach the disk.
+bool sync(std::FILE* f) {
+  if (std::fflush(f) != 0) {
+    return false;
+  }
+#if defined(_WIN32)
+  return _commit(_fileno(f)) == 0;
+#else
+  return fsync(fileno(f)) == 0;
+#endif
+}
+
+std::string fixed_string(const char* s, size_t max) { return std::string(s, strnlen(s, max)); }
+
+template <typename T>
+void column_range(const T* v, size_t n, double& lo, double& hi) {
+  T mn = std::numeric_limits<T>::max();
+  T mx = std::numeric_limits<T>::lowest();
+  for (size_t i = 0; i < n; ++i) {
+    mn = std::min(mn, v[i]);
+    mx = std::max(mx, v[i]);
+  }
+  lo = n != 0 ? static_cast<double>(mn) : 0.0;
+  hi = n != 0 ? static_cast<double>(mx) : 0.0;
+}
+
+std::string format_metadata(const LapStoreMetadata& m) {
+  std::ostringstream out;
+  out << "track=" << m.track << "\ncar=" << m.car << "\ndriver=" << m.driver
+      << "\nsession_start=" << m.session_start_unix << "\n";
+  return out.str();
+}
+
+LapStoreMetadata parse_metadata(std::string_view text) {
+  LapStoreMetadata m;
+  while (!text.empty()) {
+    const size_t eol = std::min(text.find('\n'), text.size());
+    const std::string_view line = text.substr(0, eol);
+    text.remove_prefix(std::min(eol + 1, text.size()));
+    const size_t eq = line.find('=');
+    if (eq == std::string_view::npos) {
+      continue;
+    }
+    const std::string_view key = line.substr(0, eq);
+    const std::string value(line.substr(eq + 1));
+    if (key == "track") {
+      m.track = value;
+    } else if (key == "car") {
+      m.car = value;
+    } else if (key == "driver") {
+      m.driver = value;
+    } else if (key == "session_start") {
+      m.session_start_unix = std::strtoll(value.c_str(), nullptr, 10);
+    }
+  }
+  return m;
+}
+
+// Validated view of a store's directory, shared by LapStore::open and
+// LapStoreWriter::append_to.
+struct Directory {
+  Trailer trailer;
+  const uint8_t* channels;
+  const uint8_t* laps;
+  const uint8_t* chunks;
+  std::string_view metadata;
+};
+
+Directory parse_directory(const uint8_t* data, size_t size) {
+  if (size < kHeaderSize + sizeof(Trailer) || std::memcmp(data, kMagic, 4) != 0) {
+    throw std::runtime_error("lap store: not a .tpl file");
+  }
+  // Anything past the committed end is a lap being written (or one whose
+  // writer crashed) and is ignored.
+  uint64_t committed;
+  std::memcpy(&committed, data + kCommittedEndOffset, sizeof(committed));
+  if (committed == 0) {
+    committed = size;
+  }
+  if (committed < kHeaderSize + sizeof(Trailer) || committed > size) {
+    throw std::runtime_error("lap store: committed end out of range");
+  }
+  size = static_cast<size_t>(committed);
+  Directory d;
+  std::memcpy(&d.trailer, data + size - sizeof(Trailer), sizeof(Trailer));
+  const Trailer& t = d.trailer;
+  if (std::memcmp(t.magic, kMagic, 4) != 0) {
+    throw std::runtime_error("lap store: missing trailer (writer did not commit)");
+  }
+  if (t.version != kVersion) {
+    throw std::runtime_error("lap store: unsupported version");
+  }
+  const uint64_t dir_size = uint64_t{t.channel_count} * sizeof(StoredChannel) +
+                            uint64_t{t.lap_count} * sizeof(StoredLap) +
+                            uint64_t{t.lap_count} * t.channel_count * sizeof(StoredChunk) + t.metadata_size;
+  if (t.directory_offset < kHeaderSize || t.directory_offset + dir_size + sizeof(Trailer) != size) {
+    throw std::runtime_error("lap store: directory out of range");
+  }
+  d.channels = data + t.directory_offset;
+  d.laps = d.channels + size_t{t.channel_count} * sizeof(StoredChannel);
+  d.chunks = d.laps + size_t{t.lap_count} * sizeof(StoredLap);
+  d.metadata = std::string_view(
+      reinterpret_cast<const char*>(d.chunks + size_t{t.lap_count} * t.channel_count * sizeof(StoredChunk)),
+      t.metadata_size);
+  return d;
+}
+
+ChannelInfo channel_from(const StoredChannel& s) {
+  ChannelInfo c;
+  c.name = fixed_string(s.name, sizeof(s.name));
+  c.unit = fixed_string(s.unit, sizeof(s.unit));
+  c.type = static_cast<ChannelType>(s.type);
+  return c;
+}
+
+LapInfo lap_from(const StoredLap& s) {
+  LapInfo lap;
+  lap.lap_number = s.lap_number;
+  lap.sample_count = s.sample_count;
+  lap.flags = s.flags;
+  lap.sample_rate_hz = s.sample_rate_hz;
+  lap.lap_time_s = s.lap_time_s;
+  lap.start_session_time = s.start_session_time;
+  return lap;
+}
+
+ChunkStats chunk_from(const StoredChunk& s) {
+  ChunkStats c;
+  c.codec = static_cast<ColumnCodec>(s.codec);
+  c.encoded_bytes = s.size;
+  c.min = s.min;
+  c.max = s.max;
+  return c;
+}
+
+}  // namespace
+
+EncodedLap encode_lap(const std::vector<ChannelInfo>& channels, const LapInfo& info,
+                      const std::vector<const void*>& columns) {
+  if (columns.size() != channels.size()) {
+    throw std::invalid_argument("lap store: one column per channel required");
+  }
+  EncodedLap lap;
+  lap.info = info;
+  lap.chunks.resize(channels.size());
+  lap.chunk_starts.resize(channels.size());
+  const size_t n = info.sample_count;
+  for (size_t c = 0; c < channels.size(); ++c) {
+    ChunkStats& stats = lap.chunks[c];
+    switch (channels[c].type) {
+      case ChannelType::Float32:
+        column_range(static_cast<const float*>(columns[c]), n, stats.min, stats.max);
+        break;
+      case ChannelType::Float64:
+        column_range(static_cast<const double*>(columns[c]), n, stats.min, stats.max);
+        break;
+      case ChannelType::Int32:
+        column_range(static_cast<const int32_t*>(columns[c]), n, stats.min, stats.max);
+        break;
+    }
+    const size_t start = lap.bytes.size();
+    lap.chunk_starts[c] = static_cast<uint32_t>(start);
+    stats.codec = encode_column(channels[c].type, columns[c], n, lap.bytes);
+    stats.encoded_bytes = static_cast<uint32_t>(lap.bytes.size() - start);
+  }
+  return lap;
+}
+
+LapStoreWriter::LapStoreWriter(const std::string& path, std::vector<ChannelInfo> channels,
+                               LapStoreMetadata metadata)
+    : path_(path), channels_(std::move(channels)), metadata_(std::move(metadata)) {
+  if (channels_.empty()) {
+    throw std::invalid_argument("lap store: no channels");
+  }
+  for (const ChannelInfo& c : channels_) {
+    if (c.name.empty() || c.name.size() >= sizeof(StoredChannel::name) ||
+        c.unit.size() >= sizeof(StoredChannel::unit)) {
+      throw std::invalid_argument("lap store: bad channel name or unit '" + c.name + "'");
+    }
+  }
+  file_ = std::fopen(path.c_str(), "w+b");
+  if (file_ == nullptr) {
+    throw std::system_error(errno, std::generic_category(), "create " + path);
+  }
+  uint8_t header[kHeaderSize] = {};
+  std::memcpy(header, kMagic, 4);
+  std::memcpy(header + 4, &kVersion, sizeof(kVersion));
+  ok_ = std::fwrite(header, 1, sizeof(header), file_) == sizeof(header);
+  end_ = kHeaderSize;
+  dirty_ = true;  // even an empty store gets a directory
+}
+
+LapStoreWriter LapStoreWriter::append_to(const std::string& path) {
+  LapStoreWriter writer;
+  {
+    const MappedRegion region = MappedRegion::open_read(path);
+    const Directory d = parse_directory(region.data(), region.size());
+    for (uint32_t c = 0; c < d.trailer.channel_count; ++c) {
+      StoredChannel s;
+      std::memcpy(&s, d.channels + c * sizeof(s), sizeof(s));
+      writer.channels_.push_back(channel_from(s));
+    }
+    for (uint32_t l = 0; l < d.trailer.lap_count; ++l) {
+      StoredLap s;
+      std::memcpy(&s, d.laps + l * sizeof(s), sizeof(s));
+      writer.laps_.push_back(lap_from(s));
+    }
+    const size_t chunk_count = size_t{d.trailer.lap_count} * d.trailer.channel_count;
+    for (size_t i = 0; i < chunk_count; ++i) {
+      StoredChunk s;
+      std::memcpy(&s, d.chunks + i * sizeof(s), sizeof(s));
+      writer.chunks_.push_back({s.offset, chunk_from(s)});
+    }
+    writer.metadata_ = parse_metadata(d.metadata);
+    // New laps go after the committed trailer, over any uncommitted tail.
+    uint64_t committed;
+    std::memcpy(&committed, region.data() + kCommittedEndOffset, sizeof(committed));
+    writer.end_ = committed != 0 ? committed : region.size();
+  }
+  writer.path_ = path;
+  writer.file_ = std::fopen(path.c_str(), "r+b");
+  if (writer.file_ == nullptr) {
+    throw std::system_error(errno, std::generic_category(), "open " + path);
+  }
+  return writer;
+}
+
+LapStoreWriter::LapStoreWriter(LapStoreWriter&& other) noexcept
+    : path_(std::move(other.path_)),
+      file_(std::exchange(other.file_, nullptr)),
+      end_(other.end_),
+      channels_(std::move(other.channels_)),
+      metadata_(std::move(other.metadata_)),
+      laps_(std::move(other.laps_)),
+      chunks_(std::move(other.chunks_)),
+      ok_(other.ok_),
+      dirty_(other.dirty_) {}
+
+LapStoreWriter::~LapStoreWriter() { close(); }
+
+bool LapStoreWriter::add_lap(const LapInfo& info, const std::vector<const void*>& columns) {
+  return write_lap(encode_lap(channels_, info, columns));
+}
+
+bool LapStoreWriter::write_lap(const EncodedLap& lap) {
+  if (file_ == nullptr || !ok_ || lap.chunks.size() != channels_.size()) {
+    return false;
+  }
+  if (!seek_file(file_, end_) ||
+      std::fwrite(lap.bytes.data(), 1, lap.bytes.size(), file_) != lap.bytes.size()) {
+    ok_ = false;
+    return false;
+  }
+  for (size_t c = 0; c < channels_.size(); ++c) {
+    chunks_.push_back({end_ + lap.chunk_starts[c], lap.chunks[c]});
+  }
+  end_ += lap.bytes.size();
+  laps_.push_back(lap.info);
+  dirty_ = true;
+  return true;
+}
+
+bool LapStoreWriter::commit() {
+  if (file_ == nullptr || !ok_) {
+    return false;
+  }
+  if (!dirty_) {
+    return true;
+  }
+  std::vector<uint8_t> dir;
+  auto put = [&dir](const auto& value) {
+    const auto* p = reinterpret_cast<const uint8_t*>(&value);
+    dir.insert(dir.end(), p, p + sizeof(value));
+  };
+  for (const ChannelInfo& c : channels_) {
+    StoredChannel s{};
+    std::memcpy(s.name, c.name.data(), c.name.size());
+    std::memcpy(s.unit, c.unit.data(), c.unit.size());
+    s.type = static_cast<uint8_t>(c.type);
+    put(s);
+  }
+  for (const LapInfo& l : laps_) {
+    put(StoredLap{l.lap_number, l.sample_count, l.flags, l.sample_rate_hz, l.lap_time_s, l.start_session_time});
+  }
+  for (const ChunkRef& c : chunks_) {
+    StoredChunk s{};
+    s.offset = c.offset;
+    s.size = c.stats.encoded_bytes;
+    s.codec = static_cast<uint8_t>(c.stats.codec);
+    s.min = c.stats.min;
+    s.max = c.stats.max;
+    put(s);
+  }
+  const std::string meta = format_metadata(metadata_);
+  dir.insert(dir.end(), meta.begin(), meta.end());
+
+  Trailer t{};
+  t.directory_offset = end_;
+  t.channel_count = static_cast<uint32_t>(channels_.size());
+  t.lap_count = static_cast<uint32_t>(laps_.size());
+  t.metadata_size = static_cast<uint32_t>(meta.size());
+  t.version = kVersion;
+  std::memcpy(t.magic, kMagic, 4);
+  put(t);
+
+  // The new chunks and directory land after the committed trailer and are on
+  // disk before the header points at them, so a crash at any point leaves
+  // the previous commit intact. The old directory becomes dead space.
+  const uint64_t committed = end_ + dir.size();
+  ok_ = seek_file(file_, end_) && std::fwrite(dir.data(), 1, dir.size(), file_) == dir.size() && sync(file_) &&
+        seek_file(file_, kCommittedEndOffset) && std::fwrite(&committed, 1, sizeof(committed), file_) == sizeof(committed) &&
+        sync(file_);
+  end_ = committed;
+  dirty_ = !ok_;
+  return ok_;
+}
+
+bool LapStoreWriter::close() {
+  if (file_ == nullptr) {
+    return ok_;
+  }
+  commit();
+  ok_ = std::fclose(file_) == 0 && ok_;
+  file_ = nullptr;
+  return ok_;
+}
+
+LapStore LapStore::open(const std::string& path) {
+  LapStore store;
+  store.region_ = MappedRegion::open_read(path);
+  const Directory d = parse_directory(store.region_.data(), store.region_.size());
+  for (uint32_t c = 0; c < d.trailer.channel_count; ++c) {
+    StoredChannel s;
+    std::memcpy(&s, d.channels + c * sizeof(s), sizeof(s));
+    store.channels_.push_back(channel_from(s));
+  }
+  store.metadata_ = parse_metadata(d.metadata);
+  store.lap_count_ = d.trailer.lap_count;
+  store.lap_table_ = d.laps;
+  store.chunk_table_ = d.chunks;
+  store.region_.advise_random();
+  return store;
+}
+
+int LapStore::find_channel(std::string_view name) const {
+  for (size_t i = 0; i < channels_.size(); ++i) {
+    if (channels_[i].name == name) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+LapInfo LapStore::lap(size_t index) const {
+  StoredLap s;
+  std::memcpy(&s, lap_table_ + index * sizeof(s), sizeof(s));
+  return lap_from(s);
+}
+
+ChunkStats LapStore::chunk(size_t lap, size_t channel) const {
+  StoredChunk s;
+  std::memcpy(&s, chunk_table_ + (lap * channels_.size() + channel) * sizeof(s), sizeof(s));
+  return chunk_from(s);
+}
+
+bool LapStore::decode(size_t lap, size_t channel, void* out) const {
+  if (lap >= lap_count_ || channel >= channels_.size()) {
+    return false;
+  }
+  StoredChunk s;
+  std::memcpy(&s, chunk_table_ + (lap * channels_.size() + channel) * sizeof(s), sizeof(s));
+  if (s.offset < kHeaderSize || s.offset + s.size > region_.size()) {
+    return false;
+  }
+  return decode_column(static_cast<ColumnCodec>(s.codec), channels_[channel].type, region_.data() + s.offset,
+                       s.size, this->lap(lap).sample_count, out);
+}
+
+template <typename T>
+bool LapStore::read_converted(size_t lap, size_t channel, std::vector<T>& out) const {
+  if (lap >= lap_count_ || channel >= channels_.size()) {
+    return false;
+  }
+  const size_t n = this->lap(lap).sample_count;
+  out.resize(n);
+  switch (channels_[channel].type) {
+    case ChannelType::Float32:
+      if constexpr (std::is_same_v<T, float>) {
+        return decode(lap, channel, out.data());
+      } else {
+        std::vector<float> tmp(n);
+        const bool ok = decode(lap, channel, tmp.data());
+        std::copy(tmp.begin(), tmp.end(), out.begin());
+        return ok;
+      }
+    case ChannelType::Float64:
+      if constexpr (std::is_same_v<T, double>) {
+        return decode(lap, channel, out.data());
+      } else {
+        std::vector<double> tmp(n);
+        const bool ok = decode(lap, channel, tmp.data());
+        std::transform(tmp.begin(), tmp.end(), out.begin(), [](double v) { return static_cast<T>(v); });
+        return ok;
+      }
+    case ChannelType::Int32: {
+      std::vector<int32_t> tmp(n);
+      const bool ok = decode(lap, channel, tmp.data());
+      std::transform(tmp.begin(), tmp.end(), out.begin(), [](int32_t v) { return static_cast<T>(v); });
+      return ok;
+    }
+  }
+  return false;
+}
+
+bool LapStore::read(size_t lap, size_t channel, std::vector<float>& out) const {
+  return read_converted(lap, channel, out);
+}
+
+bool LapStore::read(size_t lap, size_t channel, std::vector<double>& out) const {
+  return read_converted(lap, channel, out);
+}
+
+}  // namespace trackpro::telemetry
@@ -0,0 +1,87 @@
+#include "trackpro/telemetry/live_dashboard.h"
+
+#include <stdexcept>
+#include <utility>
+
+#include "trackpro/common/clock.h"
+#include "trackpro/common/frame_pacer.h"
+#include "trackpro/common/realtime.h"
+
+namespace trackpro::telemetry {
+
+std::vector<DashboardChannel> default_dashboard_channels() {
+  return {
+      {"Speed", &TelemetrySample::speed},
+      {"RPM", &TelemetrySample::rpm},
+      {"Throttle", &TelemetrySample::throttle},
+      {"Brake", &TelemetrySample::brake},
+      {"SteeringWheelAngle", &TelemetrySample::steering},
+  };
+}
+
+LiveDashboard::LiveDashboard(TelemetryCapture& capture, DashboardRenderer& renderer, LiveDashboardOptions options)
+    : capture_(capture), renderer_(renderer), options_(std::move(options)), history_(options_.channels.size()) {
+  if (!(options_.max_fps > 0.0)) {
+    throw std::invalid_argument("LiveDashboard max_fps must be positive");
+  }
+}
+
+LiveDashboard::~LiveDashboard() { stop(); }
+
+bool LiveDashboard::frame(uint64_t frame_start_ns) {
+  if (!capture_.update()) {
+    idle_frames_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  const CaptureSnapshot& snap = capture_.snapshot();
+  const SampleLog& log = capture_.log();
+  for (; ingested_ < snap.samples; ++ingested_) {
+    const TelemetrySample& s = log[ingested_];
+    for (size_t c = 0; c < history_.size(); ++c) {
+      history_[c].append(s.*options_.channels[c].field);
+    }
+  }
+  samples_.store(ingested_, std::memory_order_relaxed);
+
+  const uint64_t n = frames_.load(std::memory_order_relaxed);
+  renderer_.render(DashboardView{snap, options_.channels, history_, n, frame_start_ns});
+  frames_.store(n + 1, std::memory_order_relaxed);
+  return true;
+}
+
+void LiveDashboard::start() {
+  if (running_.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  thread_ = std::thread([this] { run(); });
+}
+
+void LiveDashboard::stop() {
+  running_.store(false, std::memory_order_release);
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+LiveDashboardCounters LiveDashboard::counters() const {
+  LiveDashboardCounters c;
+  c.frames = frames_.load(std::memory_order_relaxed);
+  c.idle_frames = idle_frames_.load(std::memory_order_relaxed);
+  c.dropped_frames = dropped_frames_.load(std::memory_order_relaxed);
+  c.samples = samples_.load(std::memory_order_relaxed);
+  return c;
+}
+
+void LiveDashboard::run() {
+  set_current_thread_name("tp-dashboard");
+  if (options_.background) {
+    background_.store(demote_current_thread_background(), std::memory_order_release);
+  }
+  FramePacer pacer(options_.max_fps);
+  while (running_.load(std::memory_order_acquire)) {
+    frame(pacer.wait());
+    dropped_frames_.store(pacer.dropped_frames(), std::memory_order_relaxed);
+  }
+}
+
+}  // namespace trackpro::telemetry
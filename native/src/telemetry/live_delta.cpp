@@ -0,0 +1,112 @@
+#include "trackpro/telemetry/live_delta.h"
+
+namespace trackpro::telemetry {
+namespace {
+
+// Ten minutes at 360 Hz; reserved up front so recording the lap never
+// reallocates on the capture thread.
+constexpr size_t kTraceReserve = 360 * 600;
+
+}  // namespace
+
+LiveDelta::LiveDelta() {
+  trace_distance_.reserve(kTraceReserve);
+  trace_elapsed_.reserve(kTraceReserve);
+}
+
+void LiveDelta::set_reference(std::shared_ptr<const ReferenceLap> reference) {
+  std::lock_guard<std::mutex> lock(pending_writer_);
+  pending_state_.reference = std::move(reference);
+  ++pending_state_.reference_generation;
+  pending_.write_buffer() = pending_state_;
+  pending_.publish();
+}
+
+void LiveDelta::set_best(std::shared_ptr<const ReferenceLap> best) {
+  std::lock_guard<std::mutex> lock(pending_writer_);
+  pending_state_.best = std::move(best);
+  ++pending_state_.best_generation;
+  pending_.write_buffer() = pending_state_;
+  pending_.publish();
+}
+
+void LiveDelta::take_pending() {
+  if (!pending_.update()) {
+    return;
+  }
+  const References& r = pending_.read_buffer();
+  if (r.reference_generation != reference_generation_) {
+    reference_generation_ = r.reference_generation;
+    reference_ = r.reference;
+    reference_hint_ = 0;
+  }
+  if (r.best_generation != best_generation_) {
+    best_generation_ = r.best_generation;
+    best_ = r.best;
+    best_hint_ = 0;
+  }
+}
+
+void LiveDelta::on_lap_start(const LapInfo& lap) {
+  timing_ = true;
+  lap_ = lap.lap_number;
+  lap_start_ = lap.start_session_time;
+  trace_distance_.clear();
+  trace_elapsed_.clear();
+  trace_truncated_ = false;
+}
+
+void LiveDelta::on_lap(const SegmentedLap& lap) {
+  timing_ = false;
+  if (trace_truncated_) {
+    ++truncated_laps_;
+    return;
+  }
+  const bool faster = best_ == nullptr || lap.info.lap_time_s < best_->lap_time();
+  if ((lap.info.flags & kLapValid) != 0 && faster && trace_distance_.size() >= 2) {
+    // Copies the trace; happens once per personal best, not per tick.
+    best_ = std::make_shared<const ReferenceLap>(trace_distance_, trace_elapsed_, lap.info.lap_time_s);
+    best_hint_ = 0;
+  }
+}
+
+void LiveDelta::update(const TelemetrySample& sample) {
+  take_pending();
+  DeltaSnapshot snap;
+  snap.sequence = ++sequence_;
+  snap.lap = timing_ ? lap_ : sample.lap;
+  snap.lap_dist_m = sample.lap_dist;
+  snap.timing = timing_;
+  snap.has_best = best_ != nullptr;
+  snap.has_reference = reference_ != nullptr;
+  snap.truncated_laps = truncated_laps_;
+  if (best_ != nullptr) {
+    snap.best_lap_s = static_cast<float>(best_->lap_time());
+  }
+  if (timing_) {
+    const double elapsed = sample.session_time - lap_start_;
+    if (trace_distance_.size() < trace_distance_.capacity()) {
+      trace_distance_.push_back(sample.lap_dist);
+      trace_elapsed_.push_back(static_cast<float>(elapsed));
+    } else {
+      trace_truncated_ = true;
+    }
+    snap.elapsed_s = static_cast<float>(elapsed);
+    if (best_ != nullptr) {
+      snap.delta_best_s = static_cast<float>(elapsed - best_->time_at(sample.lap_dist, best_hint_));
+      snap.predicted_lap_s = snap.best_lap_s + snap.delta_best_s;
+    }
+    if (reference_ != nullptr) {
+      snap.delta_reference_s = static_cast<float>(elapsed - reference_->time_at(sample.lap_dist, reference_hint_));
+    }
+  }
+  published_.store(snap);
+}
+
+DeltaSnapshot LiveDelta::snapshot() const {
+  DeltaSnapshot snap;
+  published_.load(snap);
+  return snap;
+}
+
+}  // namespace trackpro::telemetry
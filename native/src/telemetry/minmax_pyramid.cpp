@@ -0,0 +1,191 @@
+#include "trackpro/telemetry/minmax_pyramid.h"
+
+#include <algorithm>
+
+#include "trackpro/common/simd4.h"
+
+namespace trackpro::telemetry {
+namespace {
+
+inline void merge(MinMax& into, float v) {
+  into.min = std::min(into.min, v);
+  into.max = std::max(into.max, v);
+}
+
+inline void merge(MinMax& into, const MinMax& v) {
+  into.min = std::min(into.min, v.min);
+  into.max = std::max(into.max, v.max);
+}
+
+// Level 1 straight from samples: eight samples per entry, two Vec4s each.
+void reduce_samples(const float* values, size_t count, std::vector<MinMax>& out) {
+  constexpr size_t F = MinMaxPyramid::kFanout;
+  static_assert(F == 8, "reduce_samples is written for a fanout of 8");
+  out.resize((count + F - 1) / F);
+  size_t i = 0;
+  size_t o = 0;
+  for (; i + F <= count; i += F, ++o) {
+    const simd::Vec4 a = simd::load(values + i);
+    const simd::Vec4 b = simd::load(values + i + 4);
+    alignas(16) float lo[4];
+    alignas(16) float hi[4];
+    simd::store(lo, simd::min(a, b));
+    simd::store(hi, simd::max(a, b));
+    out[o] = {std::min(std::min(lo[0], lo[1]), std::min(lo[2], lo[3])),
+              std::max(std::max(hi[0], hi[1]), std::max(hi[2], hi[3]))};
+  }
+  if (i < count) {
+    MinMax tail{values[i], values[i]};
+    for (++i; i < count; ++i) {
+      merge(tail, values[i]);
+    }
+    out[o] = tail;
+  }
+}
+
+void reduce_level(const std::vector<MinMax>& in, std::vector<MinMax>& out) {
+  constexpr size_t F = MinMaxPyramid::kFanout;
+  out.resize((in.size() + F - 1) / F);
+  for (size_t o = 0; o < out.size(); ++o) {
+    const size_t begin = o * F;
+    const size_t end = std::min(in.size(), begin + F);
+    MinMax m = in[begin];
+    for (size_t i = begin + 1; i < end; ++i) {
+      merge(m, in[i]);
+    }
+    out[o] = m;
+  }
+}
+
+size_t level_capacity(size_t samples, size_t level) {
+  size_t n = samples;
+  for (size_t k = 0; k <= level; ++k) {
+    n = (n + MinMaxPyramid::kFanout - 1) / MinMaxPyramid::kFanout;
+  }
+  return n;
+}
+
+}  // namespace
+
+MinMaxPyramid MinMaxPyramid::build(const float* values, size_t count) {
+  MinMaxPyramid p;
+  p.samples_.assign(values, values + count);
+  if (count <= 1) {
+    return p;
+  }
+  p.levels_.emplace_back();
+  reduce_samples(values, count, p.levels_.back());
+  while (p.levels_.back().size() > 1) {
+    std::vector<MinMax> next;
+    reduce_level(p.levels_.back(), next);
+    p.levels_.push_back(std::move(next));
+  }
+  return p;
+}
+
+void MinMaxPyramid::append(float value) {
+  samples_.push_back(value);
+  const size_t n = samples_.size();
+  if (n == 1) {
+    return;
+  }
+  // Index of the new sample's entry at each level: (n-1) / F^(k+1).
+  size_t index = n - 1;
+  for (size_t k = 0;; ++k) {
+    index /= kFanout;
+    if (k == levels_.size()) {
+      // Level k is needed once level k-1 (or the samples) has two entries.
+      levels_.emplace_back();
+      levels_[k].reserve(level_capacity(reserved_, k));
+      if (k == 0) {
+        levels_[0].push_back({samples_[0], samples_[0]});
+      } else {
+        levels_[k].push_back(levels_[k - 1][0]);
+      }
+    }
+    std::vector<MinMax>& level = levels_[k];
+    if (index == level.size()) {
+      level.push_back({value, value});
+    } else {
+      merge(level[index], value);
+    }
+    if (level.size() == 1) {
+      break;
+    }
+  }
+}
+
+void MinMaxPyramid::reserve(size_t samples) {
+  reserved_ = std::max(reserved_, samples);
+  samples_.reserve(samples);
+  for (size_t k = 0; k < levels_.size(); ++k) {
+    levels_[k].reserve(level_capacity(samples, k));
+  }
+}
+
+void MinMaxPyramid::clear() {
+  samples_.clear();
+  levels_.clear();
+  reserved_ = 0;
+}
+
+MinMax MinMaxPyramid::range(size_t begin, size_t end) const {
+  MinMax m{samples_[begin], samples_[begin]};
+  if (end - begin <= 2 * kFanout) {
+    for (size_t i = begin + 1; i < end; ++i) {
+      merge(m, samples_[i]);
+    }
+    return m;
+  }
+  // Samples up to the first and from the last kFanout boundary.
+  size_t lo = begin;
+  size_t hi = end;
+  while (lo < hi && lo % kFanout != 0) {
+    merge(m, samples_[lo++]);
+  }
+  while (lo < hi && hi % kFanout != 0 && hi != samples_.size()) {
+    merge(m, samples_[--hi]);
+  }
+  if (lo >= hi) {
+    return m;
+  }
+  // [lo, hi) is aligned (or ends at the partial last entry); climb.
+  lo /= kFanout;
+  hi = (hi + kFanout - 1) / kFanout;
+  for (size_t k = 0; k < levels_.size(); ++k) {
+    const std::vector<MinMax>& level = levels_[k];
+    const bool last_level = k + 1 == levels_.size();
+    while (lo < hi && (lo % kFanout != 0 || last_level)) {
+      merge(m, level[lo++]);
+    }
+    while (lo < hi && hi % kFanout != 0 && hi != level.size()) {
+      merge(m, level[--hi]);
+    }
+    if (lo >= hi) {
+      break;
+    }
+    lo /= kFanout;
+    hi = (hi + kFanout - 1) / kFanout;
+  }
+  return m;
+}
+
+void MinMaxPyramid::columns(size_t begin, size_t end, size_t pixels, MinMax* out) const {
+  const double per_pixel = static_cast<double>(end - begin) / static_cast<double>(pixels);
+  for (size_t p = 0; p < pixels; ++p) {
+    const size_t a = begin + static_cast<size_t>(static_cast<double>(p) * per_pixel);
+    size_t b = begin + static_cast<size_t>(static_cast<double>(p + 1) * per_pixel);
+    b = std::min(std::max(b, a + 1), end);
+    out[p] = range(std::min(a, end - 1), b);
+  }
+}
+
+size_t MinMaxPyramid::memory_bytes() const {
+  size_t bytes = samples_.capacity() * sizeof(float);
+  for (const auto& level : levels_) {
+    bytes += level.capacity() * sizeof(MinMax);
+  }
+  return bytes;
+}
+
+}  // namespace trackpro::telemetry
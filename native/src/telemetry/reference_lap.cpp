@@ -0,0 +1,82 @@
+#include "trackpro/telemetry/reference_lap.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "trackpro/telemetry/lap_resampler.h"
+#include "trackpro/telemetry/lap_store.h"
+
+namespace trackpro::telemetry {
+
+ReferenceLap::ReferenceLap(std::vector<float> distance_m, std::vector<float> elapsed_s, double lap_time_s)
+    : distance_(std::move(distance_m)), elapsed_(std::move(elapsed_s)), lap_time_(lap_time_s) {
+  if (distance_.size() < 2 || distance_.size() != elapsed_.size()) {
+    throw std::invalid_argument("reference lap: need at least two (distance, time) samples");
+  }
+  // Ticks that still carry the previous lap's distance sit just before the
+  // line; without the unwrap the running maximum would pin the whole lap there.
+  const float length = *std::max_element(distance_.begin(), distance_.end());
+  const size_t lagging = lagging_lap_start(distance_.data(), distance_.size(), length);
+  for (size_t i = 0; i < lagging; ++i) {
+    distance_[i] -= length;
+  }
+  for (size_t i = 1; i < distance_.size(); ++i) {
+    distance_[i] = std::max(distance_[i], distance_[i - 1]);
+  }
+}
+
+ReferenceLap ReferenceLap::from_store(const LapStore& store, size_t lap) {
+  const int dist = store.find_channel("LapDist");
+  const int session_time = store.find_channel("SessionTime");
+  const int lap_time = store.find_channel("LapCurrentLapTime");
+  if (dist < 0 || (session_time < 0 && lap_time < 0)) {
+    throw std::runtime_error("reference lap: store lacks LapDist and a time channel");
+  }
+  std::vector<float> distance;
+  std::vector<float> elapsed;
+  if (!store.read(lap, static_cast<size_t>(dist), distance)) {
+    throw std::runtime_error("reference lap: cannot read LapDist");
+  }
+  const LapInfo info = store.lap(lap);
+  if (session_time >= 0) {
+    std::vector<double> t;
+    store.read(lap, static_cast<size_t>(session_time), t);
+    elapsed.resize(t.size());
+    std::transform(t.begin(), t.end(), elapsed.begin(),
+                   [&](double v) { return static_cast<float>(v - info.start_session_time); });
+  } else {
+    store.read(lap, static_cast<size_t>(lap_time), elapsed);
+  }
+  return ReferenceLap(std::move(distance), std::move(elapsed), info.lap_time_s);
+}
+
+double ReferenceLap::time_at(double distance_m, size_t& hint) const {
+  const auto d = static_cast<float>(distance_m);
+  const size_t last = distance_.size() - 1;
+  if (d <= distance_[0]) {
+    hint = 0;
+    return elapsed_[0];
+  }
+  if (d >= distance_[last]) {
+    // Past the last sample: close the gap to the line at the last segment's
+    // pace, never beyond the recorded lap time.
+    hint = last - 1;
+    const float span = distance_[last] - distance_[last - 1];
+    const double pace = span > 0.0f ? (elapsed_[last] - elapsed_[last - 1]) / span : 0.0;
+    return std::min(lap_time_, elapsed_[last] + (d - distance_[last]) * pace);
+  }
+  size_t i = hint;
+  if (i >= last || !(distance_[i] <= d && d < distance_[i + 1])) {
+    if (i + 2 <= last && distance_[i + 1] <= d && d < distance_[i + 2]) {
+      ++i;
+    } else {
+      i = static_cast<size_t>(std::upper_bound(distance_.begin(), distance_.end(), d) - distance_.begin()) - 1;
+    }
+  }
+  hint = i;
+  const float span = distance_[i + 1] - distance_[i];
+  const float w = span > 0.0f ? (d - distance_[i]) / span : 0.0f;
+  return elapsed_[i] + w * (elapsed_[i + 1] - elapsed_[i]);
+}
+
+}  // namespace trackpro::telemetry
@@ -0,0 +1,27 @@
+#include "trackpro/telemetry/sample_log.h"
+
+namespace trackpro::telemetry {
+
+SampleLog::SampleLog(size_t max_samples) : blocks_((max_samples + kBlockSamples - 1) / kBlockSamples) {
+  if (!blocks_.empty()) {
+    blocks_[0].reset(new TelemetrySample[kBlockSamples]);
+  }
+}
+
+bool SampleLog::append(const TelemetrySample& sample) {
+  const size_t n = size_.load(std::memory_order_relaxed);
+  const size_t block = n / kBlockSamples;
+  if (block >= blocks_.size()) {
+    return false;
+  }
+  if (!blocks_[block]) {
+    // Once every kBlockSamples ticks (11 s at 360 Hz). Readers cannot reach
+    // the new block until the release store below.
+    blocks_[block].reset(new TelemetrySample[kBlockSamples]);
+  }
+  blocks_[block][n % kBlockSamples] = sample;
+  size_.store(n + 1, std::memory_order_release);
+  return true;
+}
+
+}  // namespace trackpro::telemetry
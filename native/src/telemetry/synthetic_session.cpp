@@ -0,0 +1,287 @@
+#include "trackpro/telemetry/synthetic_session.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "trackpro/telemetry/ibt_file.h"
+
+namespace trackpro::telemetry {
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kEarthRadius = 6371000.0;
+constexpr double kMaxSpeed = 85.0;       // m/s
+constexpr double kLateralGrip = 22.0;    // m/s^2
+constexpr double kAcceleration = 5.0;    // m/s^2
+constexpr double kBraking = 15.0;        // m/s^2
+constexpr double kSteeringRatio = 14.0;
+constexpr double kWheelbase = 2.7;       // m
+constexpr double kSlipPerG = 0.02;       // rad of body slip per g of lateral acceleration
+constexpr double kGravity = 9.81;        // m/s^2
+
+double wrap_angle(double a) {
+  while (a > kPi) a -= 2.0 * kPi;
+  while (a < -kPi) a += 2.0 * kPi;
+  return a;
+}
+
+}  // namespace
+
+SyntheticTrack SyntheticTrack::build(double length_m, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> phase(0.0, 2.0 * kPi);
+  struct Harmonic {
+    int k;
+    double amplitude;
+    double phase;
+  };
+  const Harmonic harmonics[] = {{3, 0.20, phase(rng)}, {5, 0.08, phase(rng)}, {9, 0.035, phase(rng)},
+                                {13, 0.02, phase(rng)}, {17, 0.01, phase(rng)}};
+
+  // Star-shaped closed curve in polar form, then rescaled to the requested
+  // length and resampled uniformly by arc length.
+  constexpr size_t kRaw = 16384;
+  std::vector<double> rx(kRaw + 1), ry(kRaw + 1), arc(kRaw + 1, 0.0);
+  for (size_t i = 0; i <= kRaw; ++i) {
+    const double theta = 2.0 * kPi * static_cast<double>(i) / kRaw;
+    double r = 1.0;
+    for (const Harmonic& h : harmonics) {
+      r += h.amplitude * std::sin(h.k * theta + h.phase);
+    }
+    rx[i] = r * std::cos(theta);
+    ry[i] = r * std::sin(theta);
+    if (i > 0) {
+      arc[i] = arc[i - 1] + std::hypot(rx[i] - rx[i - 1], ry[i] - ry[i - 1]);
+    }
+  }
+  const double scale = length_m / arc[kRaw];
+
+  SyntheticTrack t;
+  t.length_m = length_m;
+  const size_t n = std::max<size_t>(16, static_cast<size_t>(std::lround(length_m / 2.0)));
+  t.step_m = length_m / static_cast<double>(n);
+  t.x.resize(n);
+  t.y.resize(n);
+  size_t seg = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const double target = static_cast<double>(i) * t.step_m / scale;
+    while (seg + 1 < kRaw && arc[seg + 1] < target) {
+      ++seg;
+    }
+    const double f = (target - arc[seg]) / std::max(arc[seg + 1] - arc[seg], 1e-12);
+    t.x[i] = scale * (rx[seg] + f * (rx[seg + 1] - rx[seg]));
+    t.y[i] = scale * (ry[seg] + f * (ry[seg + 1] - ry[seg]));
+  }
+
+  t.heading.resize(n);
+  for (size_t i = 0; i < n; ++i) {
+    const size_t next = (i + 1) % n;
+    const size_t prev = (i + n - 1) % n;
+    t.heading[i] = std::atan2(t.y[next] - t.y[prev], t.x[next] - t.x[prev]);
+  }
+  std::vector<double> raw_curvature(n);
+  for (size_t i = 0; i < n; ++i) {
+    const size_t next = (i + 1) % n;
+    const size_t prev = (i + n - 1) % n;
+    raw_curvature[i] = wrap_angle(t.heading[next] - t.heading[prev]) / (2.0 * t.step_m);
+  }
+  t.curvature.assign(n, 0.0);
+  constexpr int kSmooth = 4;
+  for (size_t i = 0; i < n; ++i) {
+    double acc = 0.0;
+    for (int k = -kSmooth; k <= kSmooth; ++k) {
+      acc += raw_curvature[(i + n + static_cast<size_t>(k + static_cast<int>(n))) % n];
+    }
+    t.curvature[i] = acc / (2 * kSmooth + 1);
+  }
+
+  // Grip-limited corner speeds, then acceleration and braking limits. Two
+  // laps of each pass let the limits carry across the start line.
+  t.speed.resize(n);
+  for (size_t i = 0; i < n; ++i) {
+    t.speed[i] = std::min(kMaxSpeed, std::sqrt(kLateralGrip / std::max(std::fabs(t.curvature[i]), 1e-6)));
+  }
+  for (int pass = 0; pass < 2; ++pass) {
+    for (size_t i = 0; i < n; ++i) {
+      const size_t next = (i + 1) % n;
+      t.speed[next] = std::min(t.speed[next], std::sqrt(t.speed[i] * t.speed[i] + 2.0 * kAcceleration * t.step_m));
+    }
+  }
+  for (int pass = 0; pass < 2; ++pass) {
+    for (size_t j = n; j-- > 0;) {
+      const size_t next = (j + 1) % n;
+      t.speed[j] = std::min(t.speed[j], std::sqrt(t.speed[next] * t.speed[next] + 2.0 * kBraking * t.step_m));
+    }
+  }
+  return t;
+}
+
+double SyntheticTrack::at(const std::vector<double>& channel, double d) const {
+  const size_t n = channel.size();
+  double pos = std::fmod(d, length_m);
+  if (pos < 0.0) {
+    pos += length_m;
+  }
+  pos /= step_m;
+  const size_t i = static_cast<size_t>(pos) % n;
+  const double f = pos - std::floor(pos);
+  return channel[i] + f * (channel[(i + 1) % n] - channel[i]);
+}
+
+SyntheticSession::SyntheticSession(SyntheticSessionOptions options)
+    : options_(options),
+      track_(SyntheticTrack::build(options.track_length_m, options.seed)),
+      rng_(options.seed * 7919u + 1u),
+      pace_(1.0, options.lap_time_spread) {
+  state_.lap = 1;
+  pace_factor_ = std::clamp(pace_(rng_), 0.9, 1.1);
+  previous_speed_ = static_cast<float>(track_.speed[0] * pace_factor_);
+}
+
+void SyntheticSession::next(TelemetrySample& out) {
+  const double dt = 1.0 / options_.tick_rate;
+  TelemetrySample& s = state_;
+
+  const double v = track_.at(track_.speed, distance_) * pace_factor_;
+  const double accel = (v - previous_speed_) / dt;
+  previous_speed_ = static_cast<float>(v);
+
+  s.speed = static_cast<float>(v);
+  if (accel < -1.0) {
+    s.brake = static_cast<float>(std::clamp(-accel / kBraking, 0.0, 1.0));
+    s.throttle = 0.0f;
+  } else if (accel > 0.3) {
+    s.brake = 0.0f;
+    s.throttle = static_cast<float>(std::clamp(0.6 + accel / kAcceleration * 0.4, 0.0, 1.0));
+  } else {
+    s.brake = 0.0f;
+    s.throttle = static_cast<float>(v >= kMaxSpeed * pace_factor_ - 0.5 ? 1.0 : 0.45);
+  }
+  const double kappa = track_.at(track_.curvature, distance_);
+  s.steering = static_cast<float>(std::atan(kWheelbase * kappa) * kSteeringRatio);
+
+  static constexpr double kGearTop[] = {18, 30, 42, 54, 66, 1e9};
+  int gear = 0;
+  while (v > kGearTop[gear]) {
+    ++gear;
+  }
+  const double low = gear == 0 ? 0.0 : kGearTop[gear - 1];
+  const double high = gear == 5 ? 90.0 : kGearTop[gear];
+  s.gear = gear + 1;
+  s.rpm = static_cast<float>(3500.0 + 4000.0 * std::clamp((v - low) / (high - low), 0.0, 1.0));
+
+  const double x = track_.at(track_.x, distance_);
+  const double y = track_.at(track_.y, distance_);
+  const double heading = track_.at(track_.heading, distance_);
+  const double lat0 = options_.origin_lat * kPi / 180.0;
+  s.lat = options_.origin_lat + (y / kEarthRadius) * 180.0 / kPi;
+  s.lon = options_.origin_lon + (x / (kEarthRadius * std::cos(lat0))) * 180.0 / kPi;
+  // VelocityX/Y are in the car's frame, as iRacing reports them. The car
+  // points slightly into the corner (a small slip angle growing with lateral
+  // g), so both components are non-zero in a turn.
+  const double slip = kSlipPerG * v * v * kappa / kGravity;
+  s.yaw = static_cast<float>(heading + slip);
+  s.velocity_x = static_cast<float>(v * std::cos(slip));
+  s.velocity_y = static_cast<float>(-v * std::sin(slip));
+
+  s.lap_dist = static_cast<float>(distance_);
+  s.lap_dist_pct = static_cast<float>(distance_ / track_.length_m);
+  s.lap_current_lap_time = static_cast<float>(s.session_time - lap_start_time_);
+  out = s;
+
+  // Advance to the next tick.
+  s.session_time += dt;
+  ++s.session_tick;
+  distance_ += v * dt;
+  if (distance_ >= track_.length_m) {
+    distance_ -= track_.length_m;
+    lap_start_time_ = s.session_time - distance_ / std::max(v, 1.0);
+    ++s.lap;
+    pace_factor_ = std::clamp(pace_(rng_), 0.9, 1.1);
+  }
+}
+
+size_t write_synthetic_ibt(const std::string& path, double seconds,
+                           const SyntheticSessionOptions& options, int filler_vars) {
+  std::vector<IbtVarSpec> vars = {
+      {"SessionTime", IrsdkVarType::Double, 1, "s", "Seconds since session start"},
+      {"SessionTick", IrsdkVarType::Int, 1, "", "Current update number"},
+      {"Lap", IrsdkVarType::Int, 1, "", "Laps started count"},
+      {"LapDistPct", IrsdkVarType::Float, 1, "%", "Percentage distance around lap"},
+      {"LapDist", IrsdkVarType::Float, 1, "m", "Meters traveled from S/F this lap"},
+      {"LapCurrentLapTime", IrsdkVarType::Float, 1, "s", "Estimate of current lap time"},
+      {"Speed", IrsdkVarType::Float, 1, "m/s", "GPS vehicle speed"},
+      {"RPM", IrsdkVarType::Float, 1, "revs/min", "Engine rpm"},
+      {"Gear", IrsdkVarType::Int, 1, "", "-1=reverse 0=neutral 1..n=current gear"},
+      {"Throttle", IrsdkVarType::Float, 1, "%", "0=off throttle to 1=full throttle"},
+      {"Brake", IrsdkVarType::Float, 1, "%", "0=brake released to 1=max pedal force"},
+      {"Clutch", IrsdkVarType::Float, 1, "%", "0=disengaged to 1=fully engaged"},
+      {"SteeringWheelAngle", IrsdkVarType::Float, 1, "rad", "Steering wheel angle"},
+      {"Lat", IrsdkVarType::Double, 1, "deg", "Latitude in decimal degrees"},
+      {"Lon", IrsdkVarType::Double, 1, "deg", "Longitude in decimal degrees"},
+      {"VelocityX", IrsdkVarType::Float, 1, "m/s", "X velocity, car frame (forward)"},
+      {"VelocityY", IrsdkVarType::Float, 1, "m/s", "Y velocity, car frame (left)"},
+      {"Yaw", IrsdkVarType::Float, 1, "rad", "Yaw orientation"},
+      {"OnPitRoad", IrsdkVarType::Bool, 1, "", "Is the player car on pit road"},
+      {"IsOnTrack", IrsdkVarType::Bool, 1, "", "1=Car on track physics running"},
+      {"CarIdxLapDistPct", IrsdkVarType::Float, 64, "%", "Percentage distance around lap by car index"},
+  };
+  const size_t named = vars.size();
+  for (int i = 0; i < filler_vars; ++i) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "Aux%03d", i);
+    vars.push_back({name, IrsdkVarType::Float, 1, "", "Auxiliary channel"});
+  }
+
+  const std::string session_info =
+      "---\nWeekendInfo:\n TrackName: synthetic\n TrackID: 9999\n TrackLength: " +
+      std::to_string(options.track_length_m / 1000.0) +
+      " km\nDriverInfo:\n DriverCarIdx: 0\n Drivers:\n - CarIdx: 0\n   CarPath: synthetic_gt3\n   CarID: 999\n...\n";
+  IbtWriter writer(path, vars, options.tick_rate, session_info);
+  std::vector<uint8_t> row(writer.record_size(), 0);
+  auto put = [&](size_t var, const void* value, size_t bytes) {
+    std::memcpy(row.data() + writer.offset(var), value, bytes);
+  };
+
+  SyntheticSession session(options);
+  TelemetrySample s;
+  const size_t ticks = static_cast<size_t>(seconds * options.tick_rate);
+  for (size_t i = 0; i < ticks; ++i) {
+    session.next(s);
+    put(0, &s.session_time, 8);
+    put(1, &s.session_tick, 4);
+    put(2, &s.lap, 4);
+    put(3, &s.lap_dist_pct, 4);
+    put(4, &s.lap_dist, 4);
+    put(5, &s.lap_current_lap_time, 4);
+    put(6, &s.speed, 4);
+    put(7, &s.rpm, 4);
+    put(8, &s.gear, 4);
+    put(9, &s.throttle, 4);
+    put(10, &s.brake, 4);
+    put(11, &s.clutch, 4);
+    put(12, &s.steering, 4);
+    put(13, &s.lat, 8);
+    put(14, &s.lon, 8);
+    put(15, &s.velocity_x, 4);
+    put(16, &s.velocity_y, 4);
+    put(17, &s.yaw, 4);
+    row[static_cast<size_t>(writer.offset(18))] = s.on_pit_road;
+    row[static_cast<size_t>(writer.offset(19))] = s.is_on_track;
+    for (int car = 0; car < 64; ++car) {
+      const float pct = std::fmod(s.lap_dist_pct + 0.0137f * static_cast<float>(car), 1.0f);
+      std::memcpy(row.data() + writer.offset(20) + car * 4, &pct, 4);
+    }
+    for (size_t v = named; v < vars.size(); ++v) {
+      const float aux = s.speed * 0.001f * static_cast<float>(v);
+      put(v, &aux, 4);
+    }
+    writer.append(row.data());
+  }
+  writer.close(s.lap);
+  return ticks;
+}
+
+}  // namespace trackpro::telemetry
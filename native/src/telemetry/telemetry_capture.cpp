@@ -0,0 +1,81 @@
+#include "trackpro/telemetry/telemetry_capture.h"
+
+#include <stdexcept>
+#include <utility>
+
+#include "trackpro/common/clock.h"
+#include "trackpro/common/realtime.h"
+
+namespace trackpro::telemetry {
+
+TelemetryCapture::TelemetryCapture(std::unique_ptr<TelemetrySource> source, TelemetryCaptureOptions options)
+    : source_(std::move(source)), options_(options), log_(options.max_samples) {
+  if (!source_) {
+    throw std::invalid_argument("TelemetryCapture requires a source");
+  }
+}
+
+TelemetryCapture::~TelemetryCapture() { stop(); }
+
+void TelemetryCapture::add_listener(CaptureListener& listener) {
+  if (running()) {
+    throw std::logic_error("TelemetryCapture listeners must be added before start()");
+  }
+  listeners_.push_back(&listener);
+}
+
+void TelemetryCapture::start() {
+  if (running_.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  thread_ = std::thread([this] { run(); });
+}
+
+void TelemetryCapture::stop() {
+  running_.store(false, std::memory_order_release);
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+TelemetryCaptureCounters TelemetryCapture::counters() const {
+  TelemetryCaptureCounters c;
+  c.samples = samples_.load(std::memory_order_relaxed);
+  c.source_dropped = source_dropped_.load(std::memory_order_relaxed);
+  c.log_full = log_full_.load(std::memory_order_relaxed);
+  return c;
+}
+
+void TelemetryCapture::run() {
+  set_current_thread_name("tp-capture");
+  pin_current_thread(options_.cpu);
+  realtime_.store(promote_current_thread_realtime(options_.realtime_priority), std::memory_order_release);
+
+  TelemetrySample sample;
+  uint64_t sequence = 0;
+  while (running_.load(std::memory_order_acquire)) {
+    if (!source_->next(sample, now_ns() + options_.idle_timeout_ns)) {
+      source_dropped_.store(source_->dropped(), std::memory_order_relaxed);
+      continue;
+    }
+    const uint64_t captured = now_ns();
+    if (!log_.append(sample)) {
+      log_full_.fetch_add(1, std::memory_order_relaxed);
+    }
+    for (CaptureListener* listener : listeners_) {
+      listener->on_sample(sample);
+    }
+
+    CaptureSnapshot& snap = snapshots_.write_buffer();
+    snap.sequence = ++sequence;
+    snap.samples = log_.size();
+    snap.latest = sample;
+    snap.capture_ns = captured;
+    snapshots_.publish();
+
+    samples_.store(sequence, std::memory_order_relaxed);
+    source_dropped_.store(source_->dropped(), std::memory_order_relaxed);
+  }
+}
+
+}  // namespace trackpro::telemetry
@@ -0,0 +1,84 @@
+#include "trackpro/telemetry/telemetry_source.h"
+
+#include <utility>
+
+#include "trackpro/common/clock.h"
+
+namespace trackpro::telemetry {
+namespace {
+
+template <typename T>
+void read(const IrsdkVar<T>& var, const IrsdkFrame& frame, T& out) {
+  if (var.bound()) {
+    out = var.get(frame);
+  }
+}
+
+}  // namespace
+
+IrsdkTelemetrySource::IrsdkTelemetrySource(MappedRegion region) : reader_(std::move(region)) {}
+
+void IrsdkTelemetrySource::bind() {
+  vars_.session_time = reader_.var<double>("SessionTime");
+  vars_.session_tick = reader_.var<int32_t>("SessionTick");
+  vars_.lap = reader_.var<int32_t>("Lap");
+  vars_.lap_dist_pct = reader_.var<float>("LapDistPct");
+  vars_.lap_dist = reader_.var<float>("LapDist");
+  vars_.lap_current_lap_time = reader_.var<float>("LapCurrentLapTime");
+  vars_.speed = reader_.var<float>("Speed");
+  vars_.rpm = reader_.var<float>("RPM");
+  vars_.gear = reader_.var<int32_t>("Gear");
+  vars_.throttle = reader_.var<float>("Throttle");
+  vars_.brake = reader_.var<float>("Brake");
+  vars_.clutch = reader_.var<float>("Clutch");
+  vars_.steering = reader_.var<float>("SteeringWheelAngle");
+  vars_.lat = reader_.var<double>("Lat");
+  vars_.lon = reader_.var<double>("Lon");
+  vars_.velocity_x = reader_.var<float>("VelocityX");
+  vars_.velocity_y = reader_.var<float>("VelocityY");
+  vars_.yaw = reader_.var<float>("Yaw");
+  vars_.on_pit_road = reader_.var<bool>("OnPitRoad");
+  vars_.is_on_track = reader_.var<bool>("IsOnTrack");
+  bound_revision_ = reader_.layout_revision();
+  bound_ = true;
+}
+
+bool IrsdkTelemetrySource::next(TelemetrySample& sample, uint64_t deadline_ns) {
+  const uint64_t now = now_ns();
+  IrsdkFrame frame;
+  if (reader_.wait_for_frame(frame, deadline_ns > now ? deadline_ns - now : 0) != IrsdkPoll::NewFrame) {
+    return false;
+  }
+  if (!bound_ || bound_revision_ != reader_.layout_revision()) {
+    bind();
+  }
+  TelemetrySample s;
+  read(vars_.session_time, frame, s.session_time);
+  read(vars_.session_tick, frame, s.session_tick);
+  read(vars_.lap, frame, s.lap);
+  read(vars_.lap_dist_pct, frame, s.lap_dist_pct);
+  read(vars_.lap_dist, frame, s.lap_dist);
+  read(vars_.lap_current_lap_time, frame, s.lap_current_lap_time);
+  read(vars_.speed, frame, s.speed);
+  read(vars_.rpm, frame, s.rpm);
+  read(vars_.gear, frame, s.gear);
+  read(vars_.throttle, frame, s.throttle);
+  read(vars_.brake, frame, s.brake);
+  read(vars_.clutch, frame, s.clutch);
+  read(vars_.steering, frame, s.steering);
+  read(vars_.lat, frame, s.lat);
+  read(vars_.lon, frame, s.lon);
+  read(vars_.velocity_x, frame, s.velocity_x);
+  read(vars_.velocity_y, frame, s.velocity_y);
+  read(vars_.yaw, frame, s.yaw);
+  read(vars_.on_pit_road, frame, s.on_pit_road);
+  read(vars_.is_on_track, frame, s.is_on_track);
+  if (!frame.still_valid()) {
+    ++torn_;
+    return false;
+  }
+  sample = s;
+  return true;
+}
+
+}  // namespace trackpro::telemetry
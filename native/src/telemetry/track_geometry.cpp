@@ -0,0 +1,41 @@
+#include "trackpro/telemetry/track_geometry.h"
+
+#include <cmath>
+
+namespace trackpro::telemetry {
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kEarthRadius = 6371000.0;
+
+}  // namespace
+
+LocalProjection::LocalProjection(double origin_lat, double origin_lon)
+    : origin_lat_(origin_lat),
+      origin_lon_(origin_lon),
+      metres_per_deg_lat_(kEarthRadius * kPi / 180.0),
+      metres_per_deg_lon_(kEarthRadius * kPi / 180.0 * std::cos(origin_lat * kPi / 180.0)) {}
+
+Point2 LocalProjection::to_local(double lat, double lon) const {
+  return {static_cast<float>((lon - origin_lon_) * metres_per_deg_lon_),
+          static_cast<float>((lat - origin_lat_) * metres_per_deg_lat_)};
+}
+
+void LocalProjection::to_geo(Point2 p, double& lat, double& lon) const {
+  lat = origin_lat_ + p.y / metres_per_deg_lat_;
+  lon = origin_lon_ + p.x / metres_per_deg_lon_;
+}
+
+double cumulative_distance(PolylineView line, bool closed, std::vector<float>& out) {
+  out.assign(line.count + (closed && line.count > 0 ? 1 : 0), 0.0f);
+  double total = 0.0;
+  for (size_t i = 1; i < out.size(); ++i) {
+    const Point2 a = line.points[i - 1];
+    const Point2 b = line.points[i % line.count];
+    total += std::hypot(static_cast<double>(b.x - a.x), static_cast<double>(b.y - a.y));
+    out[i] = static_cast<float>(total);
+  }
+  return total;
+}
+
+}  // namespace trackpro::telemetry
@@ -0,0 +1,249 @@
+#include "trackpro/telemetry/track_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace trackpro::telemetry {
+namespace {
+
+// Keeps sparse tracks (or a stray far-away point) from allocating a huge grid.
+constexpr size_t kMaxCells = 1u << 22;
+
+}  // namespace
+
+SegmentGrid::SegmentGrid(const std::vector<PolylineView>& lines, float cell_m, bool closed) {
+  if (!(cell_m > 0.0f)) {
+    throw std::invalid_argument("SegmentGrid cell size must be positive");
+  }
+  line_start_.push_back(0);
+  for (size_t l = 0; l < lines.size(); ++l) {
+    const PolylineView& line = lines[l];
+    const auto first = static_cast<uint32_t>(points_.size());
+    points_.insert(points_.end(), line.points, line.points + line.count);
+    for (size_t i = 1; i < line.count; ++i) {
+      segments_.push_back({first + static_cast<uint32_t>(i - 1), first + static_cast<uint32_t>(i),
+                           static_cast<uint32_t>(l)});
+    }
+    if (closed && line.count > 2) {
+      segments_.push_back({first + static_cast<uint32_t>(line.count - 1), first, static_cast<uint32_t>(l)});
+    }
+    line_start_.push_back(static_cast<uint32_t>(points_.size()));
+  }
+  if (points_.empty()) {
+    return;
+  }
+
+  float max_x = points_[0].x;
+  float max_y = points_[0].y;
+  min_x_ = max_x;
+  min_y_ = max_y;
+  for (const Point2& p : points_) {
+    min_x_ = std::min(min_x_, p.x);
+    min_y_ = std::min(min_y_, p.y);
+    max_x = std::max(max_x, p.x);
+    max_y = std::max(max_y, p.y);
+  }
+  cell_ = cell_m;
+  while ((static_cast<double>(max_x - min_x_) / cell_ + 1.0) * (static_cast<double>(max_y - min_y_) / cell_ + 1.0) >
+         static_cast<double>(kMaxCells)) {
+    cell_ *= 2.0f;
+  }
+  cols_ = static_cast<int>((max_x - min_x_) / cell_) + 1;
+  rows_ = static_cast<int>((max_y - min_y_) / cell_) + 1;
+
+  // Two passes over each segment's cell rectangle: count, then fill.
+  cell_start_.assign(static_cast<size_t>(cols_) * static_cast<size_t>(rows_) + 1, 0);
+  auto for_each_cell = [&](const Segment& s, auto&& fn) {
+    const Point2 a = points_[s.a];
+    const Point2 b = points_[s.b];
+    const int x0 = cell_x(std::min(a.x, b.x));
+    const int x1 = cell_x(std::max(a.x, b.x));
+    const int y0 = cell_y(std::min(a.y, b.y));
+    const int y1 = cell_y(std::max(a.y, b.y));
+    for (int y = y0; y <= y1; ++y) {
+      for (int x = x0; x <= x1; ++x) {
+        fn(static_cast<size_t>(y) * static_cast<size_t>(cols_) + static_cast<size_t>(x));
+      }
+    }
+  };
+  for (const Segment& s : segments_) {
+    for_each_cell(s, [&](size_t cell) { ++cell_start_[cell + 1]; });
+  }
+  for (size_t c = 1; c < cell_start_.size(); ++c) {
+    cell_start_[c] += cell_start_[c - 1];
+  }
+  cells_.resize(cell_start_.back());
+  std::vector<uint32_t> fill(cell_start_.begin(), cell_start_.end() - 1);
+  for (size_t i = 0; i < segments_.size(); ++i) {
+    const Segment& s = segments_[i];
+    const CellEntry entry{points_[s.a], points_[s.b], static_cast<uint32_t>(i), s.line};
+    for_each_cell(s, [&](size_t cell) { cells_[fill[cell]++] = entry; });
+  }
+}
+
+int SegmentGrid::cell_x(float x) const {
+  return std::clamp(static_cast<int>(std::floor((x - min_x_) / cell_)), 0, cols_ - 1);
+}
+
+int SegmentGrid::cell_y(float y) const {
+  return std::clamp(static_cast<int>(std::floor((y - min_y_) / cell_)), 0, rows_ - 1);
+}
+
+// Tracks squared distance in hit.distance during a search; callers take the
+// square root once at the end.
+void SegmentGrid::measure(const CellEntry& e, Point2 p, SegmentHit& hit) const {
+  const Point2 a = e.a;
+  const Point2 b = e.b;
+  const float dx = b.x - a.x;
+  const float dy = b.y - a.y;
+  const float len2 = dx * dx + dy * dy;
+  float t = len2 > 0.0f ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / len2 : 0.0f;
+  t = std::clamp(t, 0.0f, 1.0f);
+  const float qx = a.x + t * dx;
+  const float qy = a.y + t * dy;
+  const float d2 = (p.x - qx) * (p.x - qx) + (p.y - qy) * (p.y - qy);
+  if (!hit.found || d2 < hit.distance) {
+    const Segment& s = segments_[e.segment];
+    hit.found = true;
+    hit.line = s.line;
+    hit.index = s.a - line_start_[s.line];
+    hit.t = t;
+    hit.distance = d2;
+    hit.point = {qx, qy};
+  }
+}
+
+SegmentHit SegmentGrid::nearest(Point2 p, float max_distance) const {
+  SegmentHit best;
+  if (segments_.empty()) {
+    return best;
+  }
+  const int cx = cell_x(p.x);
+  const int cy = cell_y(p.y);
+  const int max_ring = std::max(cols_, rows_);
+  for (int r = 0; r <= max_ring; ++r) {
+    // Every cell in ring r is at least (r - 1) cells away from p (or from
+    // p's projection onto the grid, which is closer).
+    const float ring_floor = static_cast<float>(r - 1) * cell_;
+    if (r > 0 && ((best.found && ring_floor * ring_floor >= best.distance) || ring_floor > max_distance)) {
+      break;
+    }
+    const int y0 = std::max(cy - r, 0);
+    const int y1 = std::min(cy + r, rows_ - 1);
+    for (int y = y0; y <= y1; ++y) {
+      const bool edge_row = y == cy - r || y == cy + r;
+      const int step = edge_row || r == 0 ? 1 : 2 * r;
+      for (int x = cx - r; x <= cx + r; x += step) {
+        if (x < 0 || x >= cols_) {
+          continue;
+        }
+        const size_t cell = static_cast<size_t>(y) * static_cast<size_t>(cols_) + static_cast<size_t>(x);
+        for (uint32_t i = cell_start_[cell]; i < cell_start_[cell + 1]; ++i) {
+          measure(cells_[i], p, best);
+        }
+      }
+    }
+  }
+  best.distance = std::sqrt(best.distance);
+  if (best.found && best.distance > max_distance) {
+    best.found = false;
+  }
+  return best;
+}
+
+size_t SegmentGrid::nearest_per_line(Point2 p, float radius, std::vector<SegmentHit>& per_line) const {
+  per_line.assign(line_count(), SegmentHit{});
+  if (segments_.empty()) {
+    return 0;
+  }
+  const int x0 = cell_x(p.x - radius);
+  const int x1 = cell_x(p.x + radius);
+  const int y0 = cell_y(p.y - radius);
+  const int y1 = cell_y(p.y + radius);
+  for (int y = y0; y <= y1; ++y) {
+    for (int x = x0; x <= x1; ++x) {
+      const size_t cell = static_cast<size_t>(y) * static_cast<size_t>(cols_) + static_cast<size_t>(x);
+      for (uint32_t i = cell_start_[cell]; i < cell_start_[cell + 1]; ++i) {
+        const CellEntry& e = cells_[i];
+        measure(e, p, per_line[e.line]);
+      }
+    }
+  }
+  size_t hits = 0;
+  for (SegmentHit& hit : per_line) {
+    hit.distance = std::sqrt(hit.distance);
+    if (hit.found && hit.distance > radius) {
+      hit.found = false;
+    }
+    hits += hit.found ? 1 : 0;
+  }
+  return hits;
+}
+
+size_t SegmentGrid::memory_bytes() const {
+  return points_.capacity() * sizeof(Point2) + line_start_.capacity() * sizeof(uint32_t) +
+         segments_.capacity() * sizeof(Segment) + cell_start_.capacity() * sizeof(uint32_t) +
+         cells_.capacity() * sizeof(CellEntry);
+}
+
+TrackIndex::TrackIndex(std::vector<Point2> reference, std::vector<TrackCorner> corners, float cell_m)
+    : reference_(std::move(reference)), corners_(std::move(corners)) {
+  if (reference_.size() < 3) {
+    throw std::invalid_argument("TrackIndex reference line needs at least three points");
+  }
+  const PolylineView view{reference_.data(), reference_.size()};
+  length_ = static_cast<float>(cumulative_distance(view, true, reference_distance_));
+  reference_grid_ = SegmentGrid({view}, cell_m, true);
+  std::sort(corners_.begin(), corners_.end(),
+            [](const TrackCorner& a, const TrackCorner& b) { return a.start_m < b.start_m; });
+}
+
+void TrackIndex::set_laps(const std::vector<PolylineView>& laps, float cell_m) {
+  laps_ = SegmentGrid(laps, cell_m);
+}
+
+ReferenceHit TrackIndex::nearest_on_reference(Point2 p) const {
+  const SegmentHit hit = reference_grid_.nearest(p);
+  ReferenceHit out;
+  if (!hit.found) {
+    return out;
+  }
+  const float d0 = reference_distance_[hit.index];
+  const float d1 = reference_distance_[hit.index + 1];
+  const Point2 a = reference_[hit.index];
+  const Point2 b = reference_[(hit.index + 1) % reference_.size()];
+  const float cross = (b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x);
+  out.found = true;
+  out.distance_m = d0 + hit.t * (d1 - d0);
+  out.offset_m = cross >= 0.0f ? hit.distance : -hit.distance;
+  out.point = hit.point;
+  return out;
+}
+
+const TrackCorner* TrackIndex::corner_at(Point2 p) const {
+  const ReferenceHit hit = nearest_on_reference(p);
+  return hit.found ? corner_at_distance(hit.distance_m) : nullptr;
+}
+
+const TrackCorner* TrackIndex::corner_at_distance(float distance_m) const {
+  if (corners_.empty()) {
+    return nullptr;
+  }
+  auto it = std::upper_bound(corners_.begin(), corners_.end(), distance_m,
+                             [](float d, const TrackCorner& c) { return d < c.start_m; });
+  if (it != corners_.begin()) {
+    const TrackCorner& c = *std::prev(it);
+    if (c.end_m < c.start_m || distance_m <= c.end_m) {
+      return &c;
+    }
+    return nullptr;
+  }
+  // Before the first corner's start: only a corner wrapping past the line
+  // can contain it, and that is the last one.
+  const TrackCorner& last = corners_.back();
+  return last.end_m < last.start_m && distance_m <= last.end_m ? &last : nullptr;
+}
+
+}  // namespace trackpro::telemetry
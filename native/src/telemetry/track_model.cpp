@@ -0,0 +1,619 @@
+#include "trackpro/telemetry/track_model.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <stdexcept>
+#include <utility>
+
+#include "trackpro/common/byte_io.h"
+#include "trackpro/telemetry/lap_resampler.h"
+
+namespace trackpro::telemetry {
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr char kMagic[4] = {'T', 'P', 'T', 'M'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeaderSize = 48;
+
+double wrap_angle(double a) {
+  while (a > kPi) a -= 2.0 * kPi;
+  while (a < -kPi) a += 2.0 * kPi;
+  return a;
+}
+
+// Circular moving average over [i - half, i + half].
+void smooth_circular(std::vector<float>& v, size_t half) {
+  const size_t n = v.size();
+  if (n == 0 || half == 0) {
+    return;
+  }
+  half = std::min(half, (n - 1) / 2);
+  std::vector<double> prefix(n + 1, 0.0);
+  for (size_t i = 0; i < n; ++i) {
+    prefix[i + 1] = prefix[i] + v[i];
+  }
+  const double total = prefix[n];
+  const double width = static_cast<double>(2 * half + 1);
+  for (size_t i = 0; i < n; ++i) {
+    // Sum of the window, wrapping at either end.
+    const auto lo = static_cast<long long>(i) - static_cast<long long>(half);
+    const size_t hi = i + half + 1;
+    double sum;
+    if (lo < 0) {
+      sum = prefix[hi] + (total - prefix[n - static_cast<size_t>(-lo)]);
+    } else if (hi > n) {
+      sum = (total - prefix[static_cast<size_t>(lo)]) + prefix[hi - n];
+    } else {
+      sum = prefix[hi] - prefix[static_cast<size_t>(lo)];
+    }
+    v[i] = static_cast<float>(sum / width);
+  }
+}
+
+void put_f64(uint8_t* p, double v) {
+  uint64_t bits;
+  std::memcpy(&bits, &v, sizeof(bits));
+  put_u64(p, bits);
+}
+
+double get_f64(const uint8_t* p) {
+  const uint64_t bits = get_le(p, 8);
+  double v;
+  std::memcpy(&v, &bits, sizeof(v));
+  return v;
+}
+
+std::vector<TrackCorner> detect_corners(const std::vector<float>& curvature, const std::vector<float>& speed,
+                                        double step, const TrackModelOptions& o) {
+  const size_t n = curvature.size();
+  auto k = [&](size_t i) { return curvature[i % n]; };
+  auto sign = [](float c) { return c >= 0.0f ? 1 : -1; };
+  const auto enter = static_cast<float>(o.corner_enter_curvature);
+  const auto exit = static_cast<float>(o.corner_exit_curvature);
+
+  // Scan one lap starting on a straight so no corner straddles the scan start.
+  size_t s0 = 0;
+  while (s0 < n && std::fabs(curvature[s0]) >= exit) {
+    ++s0;
+  }
+  if (s0 == n) {
+    return {};
+  }
+  struct Region {
+    size_t start;
+    size_t end;
+    int sign;
+  };
+  std::vector<Region> regions;
+  bool open = false;
+  Region current{};
+  for (size_t i = s0; i < s0 + n; ++i) {
+    const float c = k(i);
+    if (open && (std::fabs(c) < exit || sign(c) != current.sign)) {
+      current.end = i;
+      regions.push_back(current);
+      open = false;
+    }
+    if (!open && std::fabs(c) > enter) {
+      // The corner starts where curvature first rose past the exit level.
+      size_t start = i;
+      const size_t floor = regions.empty() ? s0 : regions.back().end;
+      while (start > floor && std::fabs(k(start - 1)) >= exit && sign(k(start - 1)) == sign(c)) {
+        --start;
+      }
+      current = {start, 0, sign(c)};
+      open = true;
+    }
+  }
+  if (open) {
+    current.end = s0 + n;
+    regions.push_back(current);
+  }
+
+  std::vector<TrackCorner> corners;
+  const auto lookback = static_cast<size_t>(150.0 / step);
+  for (const Region& r : regions) {
+    if (static_cast<double>(r.end - r.start) * step < o.min_corner_m) {
+      continue;
+    }
+    size_t apex = r.start;
+    float peak = 0.0f;
+    for (size_t i = r.start; i < r.end; ++i) {
+      peak = std::max(peak, std::fabs(k(i)));
+      if (speed.empty() ? std::fabs(k(i)) > std::fabs(k(apex)) : speed[i % n] < speed[apex % n]) {
+        apex = i;
+      }
+    }
+    if (!speed.empty() && peak < o.kink_curvature) {
+      float entry = 0.0f;
+      for (size_t i = r.start + n - std::min(lookback, n - 1); i <= r.start + n; ++i) {
+        entry = std::max(entry, speed[i % n]);
+      }
+      if (entry > 0.0f && (entry - speed[apex % n]) / entry < o.kink_speed_drop) {
+        continue;
+      }
+    }
+    TrackCorner c;
+    c.start_m = static_cast<float>(static_cast<double>(r.start % n) * step);
+    c.apex_m = static_cast<float>(static_cast<double>(apex % n) * step);
+    c.end_m = static_cast<float>(static_cast<double>(r.end % n) * step);
+    corners.push_back(c);
+  }
+  std::sort(corners.begin(), corners.end(),
+            [](const TrackCorner& a, const TrackCorner& b) { return a.start_m < b.start_m; });
+  for (size_t i = 0; i < corners.size(); ++i) {
+    corners[i].number = static_cast<int>(i) + 1;
+  }
+  return corners;
+}
+
+}  // namespace
+
+void integrate_velocity(const float* velocity_x, const float* velocity_y, const float* yaw, size_t count,
+                        double dt_s, std::vector<Point2>& out) {
+  out.resize(count);
+  if (count == 0) {
+    return;
+  }
+  // Car frame (forward, left) to track frame.
+  std::vector<double> wx(count);
+  std::vector<double> wy(count);
+  for (size_t i = 0; i < count; ++i) {
+    const double c = std::cos(yaw[i]);
+    const double s = std::sin(yaw[i]);
+    wx[i] = velocity_x[i] * c - velocity_y[i] * s;
+    wy[i] = velocity_x[i] * s + velocity_y[i] * c;
+  }
+  std::vector<double> x(count, 0.0);
+  std::vector<double> y(count, 0.0);
+  for (size_t i = 1; i < count; ++i) {
+    // Trapezoidal step.
+    x[i] = x[i - 1] + 0.5 * (wx[i - 1] + wx[i]) * dt_s;
+    y[i] = y[i - 1] + 0.5 * (wy[i - 1] + wy[i]) * dt_s;
+  }
+  // One more step closes the lap; spread that closing error along it.
+  const double end_x = x[count - 1] + wx[count - 1] * dt_s;
+  const double end_y = y[count - 1] + wy[count - 1] * dt_s;
+  for (size_t i = 0; i < count; ++i) {
+    const double f = static_cast<double>(i) / static_cast<double>(count);
+    out[i] = {static_cast<float>(x[i] - f * end_x), static_cast<float>(y[i] - f * end_y)};
+  }
+}
+
+TrackModelBuilder::TrackModelBuilder(std::string track_id, double track_length_m, TrackModelOptions options)
+    : track_id_(std::move(track_id)), length_(track_length_m), options_(options) {
+  if (!(track_length_m > 0.0) || !(options.step_m > 0.0)) {
+    throw std::invalid_argument("TrackModelBuilder: track length and step must be positive");
+  }
+  bins_ = std::max<size_t>(8, static_cast<size_t>(std::lround(track_length_m / options.step_m)));
+  step_ = track_length_m / static_cast<double>(bins_);
+  sum_x_.assign(bins_, 0.0);
+  sum_y_.assign(bins_, 0.0);
+  sum_speed_.assign(bins_, 0.0);
+}
+
+bool TrackModelBuilder::resample(const LapTrace& lap, Resampled& out) const {
+  if (lap.count < 2 || lap.distance[lap.count - 1] - lap.distance[0] < 0.9 * length_) {
+    return false;
+  }
+  // Half a step past the length so the grid has exactly bins_ + 1 points.
+  DistanceResampler resampler(length_ + 0.5 * step_, step_);
+  resampler.plan(lap.distance, lap.count);
+  std::vector<float> px(lap.count);
+  std::vector<float> py(lap.count);
+  for (size_t i = 0; i < lap.count; ++i) {
+    px[i] = lap.position[i].x;
+    py[i] = lap.position[i].y;
+  }
+  out.x.resize(resampler.points());
+  out.y.resize(resampler.points());
+  resampler.apply(px.data(), out.x.data());
+  resampler.apply(py.data(), out.y.data());
+  out.x.resize(bins_);
+  out.y.resize(bins_);
+  out.speed.clear();
+  if (lap.speed != nullptr) {
+    out.speed.resize(resampler.points());
+    resampler.apply(lap.speed, out.speed.data());
+    out.speed.resize(bins_);
+  }
+  return true;
+}
+
+bool TrackModelBuilder::fold(const Resampled& lap) {
+  if (laps_ >= 3) {
+    double sq = 0.0;
+    for (size_t i = 0; i < bins_; ++i) {
+      const double dx = lap.x[i] - sum_x_[i] / laps_;
+      const double dy = lap.y[i] - sum_y_[i] / laps_;
+      sq += dx * dx + dy * dy;
+    }
+    if (std::sqrt(sq / static_cast<double>(bins_)) > options_.outlier_rms_m) {
+      ++rejected_;
+      return false;
+    }
+  }
+  for (size_t i = 0; i < bins_; ++i) {
+    sum_x_[i] += lap.x[i];
+    sum_y_[i] += lap.y[i];
+  }
+  if (!lap.speed.empty()) {
+    for (size_t i = 0; i < bins_; ++i) {
+      sum_speed_[i] += lap.speed[i];
+    }
+    ++speed_laps_;
+  }
+  ++laps_;
+  ++revision_;
+  return true;
+}
+
+bool TrackModelBuilder::add_lap(const LapTrace& lap) {
+  Resampled r;
+  if (!resample(lap, r)) {
+    ++rejected_;
+    return false;
+  }
+  return fold(r);
+}
+
+size_t TrackModelBuilder::add_laps(const std::vector<LapTrace>& laps, ThreadPool* pool) {
+  size_t accepted = 0;
+  if (pool == nullptr) {
+    for (const LapTrace& lap : laps) {
+      accepted += add_lap(lap) ? 1 : 0;
+    }
+    return accepted;
+  }
+  std::vector<std::future<std::pair<bool, Resampled>>> pending;
+  pending.reserve(laps.size());
+  for (const LapTrace& lap : laps) {
+    pending.push_back(pool->submit([this, &lap] {
+      std::pair<bool, Resampled> r;
+      r.first = resample(lap, r.second);
+      return r;
+    }));
+  }
+  for (auto& f : pending) {
+    const std::pair<bool, Resampled> r = f.get();
+    if (!r.first) {
+      ++rejected_;
+    } else if (fold(r.second)) {
+      ++accepted;
+    }
+  }
+  return accepted;
+}
+
+size_t TrackModelBuilder::add_store_laps(const LapStore& store, size_t first_lap, ThreadPool* pool) {
+  const int dist_ch = store.find_channel("LapDist");
+  const int pct_ch = store.find_channel("LapDistPct");
+  const int lat_ch = store.find_channel("Lat");
+  const int lon_ch = store.find_channel("Lon");
+  const int vx_ch = store.find_channel("VelocityX");
+  const int vy_ch = store.find_channel("VelocityY");
+  const int yaw_ch = store.find_channel("Yaw");
+  const int speed_ch = store.find_channel("Speed");
+  const bool gps = lat_ch >= 0 && lon_ch >= 0;
+  if ((dist_ch < 0 && pct_ch < 0) || (!gps && (vx_ch < 0 || vy_ch < 0 || yaw_ch < 0))) {
+    throw std::invalid_argument("lap store has no distance or position channels");
+  }
+
+  std::vector<size_t> laps;
+  for (size_t l = first_lap; l < store.lap_count(); ++l) {
+    if ((store.lap(l).flags & kLapValid) != 0) {
+      laps.push_back(l);
+    }
+  }
+  if (laps.empty()) {
+    return 0;
+  }
+  if (gps && !has_origin_) {
+    std::vector<double> lat;
+    std::vector<double> lon;
+    if (store.read(laps[0], static_cast<size_t>(lat_ch), lat) && store.read(laps[0], static_cast<size_t>(lon_ch), lon) &&
+        !lat.empty()) {
+      projection_ = LocalProjection(lat[0], lon[0]);
+      has_origin_ = true;
+    }
+  }
+
+  // Decode, project and resample in parallel; fold in lap order.
+  auto prepare = [&, this](size_t l) {
+    std::pair<bool, Resampled> r{false, {}};
+    std::vector<float> distance;
+    std::vector<float> speed;
+    std::vector<Point2> position;
+    if (dist_ch >= 0) {
+      store.read(l, static_cast<size_t>(dist_ch), distance);
+    } else {
+      store.read(l, static_cast<size_t>(pct_ch), distance);
+      for (float& d : distance) {
+        d = static_cast<float>(d * length_);
+      }
+    }
+    if (gps) {
+      std::vector<double> lat;
+      std::vector<double> lon;
+      store.read(l, static_cast<size_t>(lat_ch), lat);
+      store.read(l, static_cast<size_t>(lon_ch), lon);
+      position.resize(lat.size());
+      for (size_t i = 0; i < lat.size(); ++i) {
+        position[i] = projection_.to_local(lat[i], lon[i]);
+      }
+    } else {
+      std::vector<float> vx;
+      std::vector<float> vy;
+      std::vector<float> yaw;
+      store.read(l, static_cast<size_t>(vx_ch), vx);
+      store.read(l, static_cast<size_t>(vy_ch), vy);
+      store.read(l, static_cast<size_t>(yaw_ch), yaw);
+      if (vy.size() != vx.size() || yaw.size() != vx.size()) {
+        return r;
+      }
+      const float rate = store.lap(l).sample_rate_hz;
+      integrate_velocity(vx.data(), vy.data(), yaw.data(), vx.size(), rate > 0.0f ? 1.0 / rate : 1.0 / 60.0,
+                         position);
+    }
+    if (speed_ch >= 0) {
+      store.read(l, static_cast<size_t>(speed_ch), speed);
+    }
+    if (position.size() != distance.size() || (!speed.empty() && speed.size() != distance.size())) {
+      return r;
+    }
+    LapTrace trace{distance.data(), position.data(), speed.empty() ? nullptr : speed.data(), distance.size()};
+    r.first = resample(trace, r.second);
+    return r;
+  };
+
+  size_t accepted = 0;
+  auto fold_result = [&](const std::pair<bool, Resampled>& r) {
+    if (!r.first) {
+      ++rejected_;
+    } else if (fold(r.second)) {
+      ++accepted;
+    }
+  };
+  if (pool == nullptr) {
+    for (size_t l : laps) {
+      fold_result(prepare(l));
+    }
+    return accepted;
+  }
+  std::vector<std::future<std::pair<bool, Resampled>>> pending;
+  pending.reserve(laps.size());
+  for (size_t l : laps) {
+    pending.push_back(pool->submit([&prepare, l] { return prepare(l); }));
+  }
+  for (auto& f : pending) {
+    fold_result(f.get());
+  }
+  return accepted;
+}
+
+void TrackModelBuilder::set_projection(const LocalProjection& projection) {
+  if (!has_origin_) {
+    projection_ = projection;
+    has_origin_ = true;
+  }
+}
+
+TrackModel TrackModelBuilder::build() const {
+  TrackModel m;
+  m.track_id = track_id_;
+  m.length_m = length_;
+  m.step_m = step_;
+  m.laps = laps_;
+  m.projection = projection_;
+  if (laps_ == 0) {
+    return m;
+  }
+  const size_t n = bins_;
+  std::vector<float> x(n);
+  std::vector<float> y(n);
+  for (size_t i = 0; i < n; ++i) {
+    x[i] = static_cast<float>(sum_x_[i] / laps_);
+    y[i] = static_cast<float>(sum_y_[i] / laps_);
+  }
+  const auto half = static_cast<size_t>(std::lround(options_.smoothing_m / step_ / 2.0));
+  smooth_circular(x, half);
+  smooth_circular(y, half);
+  m.centerline.resize(n);
+  for (size_t i = 0; i < n; ++i) {
+    m.centerline[i] = {x[i], y[i]};
+  }
+
+  std::vector<double> heading(n);
+  for (size_t i = 0; i < n; ++i) {
+    const size_t prev = (i + n - 1) % n;
+    const size_t next = (i + 1) % n;
+    heading[i] = std::atan2(static_cast<double>(y[next] - y[prev]), static_cast<double>(x[next] - x[prev]));
+  }
+  m.curvature.resize(n);
+  for (size_t i = 0; i < n; ++i) {
+    const double dh = wrap_angle(heading[(i + 1) % n] - heading[(i + n - 1) % n]);
+    m.curvature[i] = static_cast<float>(dh / (2.0 * step_));
+  }
+  smooth_circular(m.curvature, half);
+
+  if (speed_laps_ > 0) {
+    m.speed.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+      m.speed[i] = static_cast<float>(sum_speed_[i] / speed_laps_);
+    }
+  }
+  m.corners = detect_corners(m.curvature, m.speed, step_, options_);
+  return m;
+}
+
+bool TrackModelBuilder::save(const std::string& path) const {
+  std::vector<uint8_t> buf(kHeaderSize + 2 + track_id_.size() + bins_ * 24);
+  uint8_t* p = buf.data();
+  std::memcpy(p, kMagic, 4);
+  put_u32(p + 4, kVersion);
+  put_u32(p + 8, static_cast<uint32_t>(bins_));
+  put_u32(p + 12, laps_);
+  put_u32(p + 16, speed_laps_);
+  put_u32(p + 20, rejected_);
+  put_f64(p + 24, length_);
+  put_f64(p + 32, has_origin_ ? projection_.origin_lat() : NAN);
+  put_f64(p + 40, has_origin_ ? projection_.origin_lon() : NAN);
+  p += kHeaderSize;
+  put_u16(p, static_cast<uint16_t>(track_id_.size()));
+  std::memcpy(p + 2, track_id_.data(), track_id_.size());
+  p += 2 + track_id_.size();
+  for (size_t i = 0; i < bins_; ++i, p += 24) {
+    put_f64(p, sum_x_[i]);
+    put_f64(p + 8, sum_y_[i]);
+    put_f64(p + 16, sum_speed_[i]);
+  }
+
+  // Write beside the target and rename, so a crash never leaves half a file.
+  const std::string tmp = path + ".tmp";
+  std::FILE* f = std::fopen(tmp.c_str(), "wb");
+  if (f == nullptr) {
+    return false;
+  }
+  const bool ok = std::fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+  if (std::fclose(f) != 0 || !ok) {
+    std::remove(tmp.c_str());
+    return false;
+  }
+  return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+TrackModelBuilder TrackModelBuilder::load(const std::string& path, TrackModelOptions options) {
+  std::FILE* f = std::fopen(path.c_str(), "rb");
+  if (f == nullptr) {
+    throw std::runtime_error("cannot open track model " + path + ": " + std::strerror(errno));
+  }
+  std::vector<uint8_t> buf;
+  uint8_t chunk[65536];
+  for (size_t n; (n = std::fread(chunk, 1, sizeof(chunk), f)) > 0;) {
+    buf.insert(buf.end(), chunk, chunk + n);
+  }
+  std::fclose(f);
+  if (buf.size() < kHeaderSize + 2 || std::memcmp(buf.data(), kMagic, 4) != 0) {
+    throw std::runtime_error(path + " is not a TrackPro track model");
+  }
+  const uint8_t* p = buf.data();
+  if (get_le(p + 4, 4) != kVersion) {
+    throw std::runtime_error(path + ": unsupported track model version");
+  }
+  const auto bins = static_cast<size_t>(get_le(p + 8, 4));
+  const double length = get_f64(p + 24);
+  const double lat = get_f64(p + 32);
+  const double lon = get_f64(p + 40);
+  const auto id_size = static_cast<size_t>(get_le(p + kHeaderSize, 2));
+  if (buf.size() != kHeaderSize + 2 + id_size + bins * 24 || !(length > 0.0)) {
+    throw std::runtime_error(path + ": truncated track model");
+  }
+  TrackModelBuilder b(std::string(reinterpret_cast<const char*>(p + kHeaderSize + 2), id_size), length, options);
+  if (b.bins_ != bins) {
+    // Saved with a different step: the sums cannot be reused.
+    throw std::runtime_error(path + ": track model grid does not match the options");
+  }
+  b.laps_ = static_cast<uint32_t>(get_le(p + 12, 4));
+  b.speed_laps_ = static_cast<uint32_t>(get_le(p + 16, 4));
+  b.rejected_ = static_cast<uint32_t>(get_le(p + 20, 4));
+  if (!std::isnan(lat)) {
+    b.projection_ = LocalProjection(lat, lon);
+    b.has_origin_ = true;
+  }
+  p += kHeaderSize + 2 + id_size;
+  for (size_t i = 0; i < bins; ++i, p += 24) {
+    b.sum_x_[i] = get_f64(p);
+    b.sum_y_[i] = get_f64(p + 8);
+    b.sum_speed_[i] = get_f64(p + 16);
+  }
+  b.revision_ = b.laps_;
+  return b;
+}
+
+TrackModelCache::TrackModelCache(std::string directory, TrackModelOptions options)
+    : directory_(std::move(directory)), options_(options) {}
+
+std::string TrackModelCache::path_for(const std::string& track_id) const {
+  std::string name = track_id;
+  for (char& c : name) {
+    const bool safe = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' ||
+                      c == '_' || c == '.';
+    if (!safe) {
+      c = '_';
+    }
+  }
+  return directory_ + "/" + name + ".tpm";
+}
+
+TrackModelCache::Entry& TrackModelCache::entry(const std::string& track_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_[track_id];
+}
+
+TrackModelBuilder& TrackModelCache::builder(Entry& e, const std::string& track_id, double track_length_m) const {
+  if (!e.builder) {
+    try {
+      auto loaded = std::make_unique<TrackModelBuilder>(TrackModelBuilder::load(path_for(track_id), options_));
+      if (std::fabs(loaded->length() - track_length_m) <= 0.01 * track_length_m) {
+        e.builder = std::move(loaded);
+      }
+    } catch (const std::runtime_error&) {
+      // Missing or unreadable: start over.
+    }
+    if (!e.builder) {
+      e.builder = std::make_unique<TrackModelBuilder>(track_id, track_length_m, options_);
+    }
+  }
+  return *e.builder;
+}
+
+TrackModelCache::Entry* TrackModelCache::find(const std::string& track_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(track_id);
+  return it == entries_.end() ? nullptr : &it->second;
+}
+
+bool TrackModelCache::add_lap(const std::string& track_id, double track_length_m, const LapTrace& lap) {
+  Entry& e = entry(track_id);
+  std::lock_guard<std::mutex> lock(e.mutex);
+  return builder(e, track_id, track_length_m).add_lap(lap);
+}
+
+size_t TrackModelCache::add_store_laps(const std::string& track_id, double track_length_m, const LapStore& store,
+                                       size_t first_lap, ThreadPool* pool) {
+  Entry& e = entry(track_id);
+  std::lock_guard<std::mutex> lock(e.mutex);
+  return builder(e, track_id, track_length_m).add_store_laps(store, first_lap, pool);
+}
+
+std::shared_ptr<const TrackModel> TrackModelCache::model(const std::string& track_id) {
+  Entry* e = find(track_id);
+  if (e == nullptr) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(e->mutex);
+  if (!e->builder || e->builder->laps() == 0) {
+    return nullptr;
+  }
+  if (!e->model || e->model_revision != e->builder->revision()) {
+    e->model = std::make_shared<const TrackModel>(e->builder->build());
+    e->model_revision = e->builder->revision();
+  }
+  return e->model;
+}
+
+bool TrackModelCache::save(const std::string& track_id) {
+  Entry* e = find(track_id);
+  if (e == nullptr) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(e->mutex);
+  return e->builder && e->builder->save(path_for(track_id));
+}
+
+}  // namespace trackpro::telemetry
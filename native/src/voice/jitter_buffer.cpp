@@ -0,0 +1,333 @@
+#include "trackpro/voice/jitter_buffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace trackpro::voice {
+namespace {
+
+constexpr size_t kMinLag = 120;  // 2.5 ms, 400 Hz
+constexpr size_t kMaxLag = 480;  // 10 ms, 100 Hz
+constexpr size_t kWindow = 240;  // samples compared per lag
+constexpr size_t kFade = 120;    // cross-fade from concealment into real audio
+constexpr uint32_t kBaseWindow = 100;  // packets per base-delay window (2 s)
+constexpr float kStretchScore = 0.6f;  // periodicity needed to stretch voiced audio
+constexpr float kSilenceRms = 1e-3f;   // below this anything may be cut or repeated
+constexpr double kLevelSmoothing = 1.0 / 8.0;  // buffer level filter, ~160 ms
+const float kConcealDecay = std::pow(0.5f, 1.0f / static_cast<float>(kVoiceFrameSamples));
+
+uint64_t samples_to_ns(size_t samples) {
+  return static_cast<uint64_t>(samples) * kNanosPerSecond / kVoiceSampleRate;
+}
+
+float correlation(const float* a, const float* b, size_t n, size_t stride) {
+  float ab = 0.0f;
+  float aa = 0.0f;
+  float bb = 0.0f;
+  for (size_t i = 0; i < n; i += stride) {
+    ab += a[i] * b[i];
+    aa += a[i] * a[i];
+    bb += b[i] * b[i];
+  }
+  return aa > 0.0f && bb > 0.0f ? ab / std::sqrt(aa * bb) : 0.0f;
+}
+
+// Pitch period: the lag at which a[0, kWindow) best matches the same signal
+// `lag` samples later (direction +1) or earlier (-1). Coarse search on every
+// fourth lag and second sample, then refined around the best.
+size_t best_lag(const float* a, int direction, float& score) {
+  auto at = [&](size_t lag) { return correlation(a, a + direction * static_cast<ptrdiff_t>(lag), kWindow, 1); };
+  size_t best = kMinLag;
+  float best_score = -2.0f;
+  for (size_t lag = kMinLag; lag <= kMaxLag; lag += 4) {
+    const float s = correlation(a, a + direction * static_cast<ptrdiff_t>(lag), kWindow, 2);
+    if (s > best_score) {
+      best_score = s;
+      best = lag;
+    }
+  }
+  const size_t coarse = best;
+  best_score = -2.0f;
+  for (size_t lag = std::max(kMinLag, coarse - 3); lag <= std::min(kMaxLag, coarse + 3); ++lag) {
+    const float s = at(lag);
+    if (s > best_score) {
+      best_score = s;
+      best = lag;
+    }
+  }
+  score = best_score;
+  return best;
+}
+
+float rms(const float* x, size_t n) {
+  float sum = 0.0f;
+  for (size_t i = 0; i < n; ++i) {
+    sum += x[i] * x[i];
+  }
+  return std::sqrt(sum / static_cast<float>(n));
+}
+
+// out[i] blends from a[i] to b[i] over n samples.
+void cross_fade(const float* a, const float* b, float* out, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    const float w = static_cast<float>(i) / static_cast<float>(n);
+    out[i] = a[i] * (1.0f - w) + b[i] * w;
+  }
+}
+
+}  // namespace
+
+JitterBuffer::JitterBuffer(JitterBufferOptions options)
+    : options_(options),
+      bin_ns_(std::max<uint64_t>(1, options.max_delay_ns / kBins)),
+      target_ns_(std::clamp(2 * kVoiceFrameNs, options.min_delay_ns, options.max_delay_ns)) {}
+
+uint64_t JitterBuffer::record_delay(uint32_t sequence, uint64_t arrival_ns) {
+  if (!have_origin_) {
+    have_origin_ = true;
+    origin_ns_ = arrival_ns;
+    origin_sequence_ = sequence;
+  }
+  const int64_t sent = static_cast<int64_t>(static_cast<int32_t>(sequence - origin_sequence_)) *
+                       static_cast<int64_t>(kVoiceFrameNs);
+  const int64_t relative = static_cast<int64_t>(arrival_ns - origin_ns_) - sent;
+  window_min_ = window_packets_ == 0 ? relative : std::min(window_min_, relative);
+  if (total_ == 0.0) {
+    previous_min_ = relative;
+  }
+  const int64_t base = std::min(window_min_, previous_min_);
+  if (++window_packets_ == kBaseWindow) {
+    previous_min_ = window_min_;
+    window_packets_ = 0;
+  }
+
+  const auto jitter = static_cast<uint64_t>(relative - base);
+  histogram_[std::min<size_t>(static_cast<size_t>(jitter / bin_ns_), kBins - 1)] += weight_;
+  total_ += weight_;
+  // Growing the weight of new samples instead of decaying old ones keeps
+  // this O(1); renormalise before it overflows.
+  weight_ /= options_.forget;
+  if (weight_ > 1e12) {
+    for (double& h : histogram_) {
+      h /= weight_;
+    }
+    total_ /= weight_;
+    weight_ = 1.0;
+  }
+
+  const double want = options_.quantile * total_;
+  double sum = 0.0;
+  size_t bin = 0;
+  for (; bin + 1 < kBins; ++bin) {
+    sum += histogram_[bin];
+    if (sum >= want) {
+      break;
+    }
+  }
+  target_ns_ = std::clamp((bin + 1) * bin_ns_ + kVoiceFrameNs, options_.min_delay_ns, options_.max_delay_ns);
+  return jitter;
+}
+
+void JitterBuffer::push(uint32_t sequence, const uint8_t* payload, size_t size, uint64_t arrival_ns) {
+  if (size > kMaxPayload) {
+    return;
+  }
+  const uint64_t jitter = record_delay(sequence, arrival_ns);
+  if (rebase_) {
+    rebase_ = false;
+    next_ = sequence;
+  }
+  const auto ahead = static_cast<int32_t>(sequence - next_);
+  if (ahead < 0) {
+    ++counters_.late;
+    return;
+  }
+  if (static_cast<size_t>(ahead) >= kSlots) {
+    // Far beyond what the buffer spans: start over from this packet.
+    for (Slot& s : slots_) {
+      s.full = false;
+    }
+    next_ = sequence;
+    playing_ = false;
+    ++counters_.resyncs;
+  }
+  Slot& slot = slots_[sequence % kSlots];
+  if (slot.full && slot.sequence == sequence) {
+    ++counters_.duplicates;
+    return;
+  }
+  slot.sequence = sequence;
+  slot.full = true;
+  slot.size = static_cast<uint16_t>(size);
+  slot.jitter_ns = jitter;
+  std::memcpy(slot.data, payload, size);
+}
+
+size_t JitterBuffer::queued_frames(uint32_t from) const {
+  // Up to and including the newest frame held, gaps counted: a missing
+  // frame still takes its 20 ms of playout, concealed.
+  size_t n = 0;
+  for (const Slot& s : slots_) {
+    const auto ahead = static_cast<int32_t>(s.sequence - from);
+    if (s.full && ahead >= 0) {
+      n = std::max(n, static_cast<size_t>(ahead) + 1);
+    }
+  }
+  return n;
+}
+
+uint64_t JitterBuffer::buffered_ns() const {
+  return samples_to_ns(pending_size_) + queued_frames(next_) * kVoiceFrameNs;
+}
+
+void JitterBuffer::append(const float* samples, size_t length, const PlayoutInfo& info) {
+  std::memcpy(pending_.data() + pending_size_, samples, length * sizeof(float));
+  pending_size_ += length;
+  chunks_[chunk_count_++] = {info, static_cast<uint32_t>(length)};
+}
+
+void JitterBuffer::conceal(float* out, size_t length, bool advance) {
+  const size_t lag = conceal_lag_;
+  const float* period = history_.data() + kHistory - lag;
+  float gain = concealing_ > options_.max_conceal_frames ? 0.0f : conceal_gain_;
+  const float decay = concealing_ > 1 ? kConcealDecay : 1.0f;
+  size_t phase = conceal_phase_;
+  for (size_t i = 0; i < length; ++i) {
+    out[i] = period[phase] * gain;
+    phase = phase + 1 == lag ? 0 : phase + 1;
+    gain *= decay;
+  }
+  if (advance) {
+    conceal_phase_ = static_cast<uint32_t>(phase);
+    conceal_gain_ = gain;
+  }
+}
+
+void JitterBuffer::produce() {
+  if (!playing_) {
+    // A first frame that arrived late has already spent part of the target
+    // in flight; waiting the full target on top would add that lateness to
+    // the whole talk spurt.
+    const size_t ready = rebase_ ? 0 : queued_frames(next_);
+    if (ready == 0 || ready * kVoiceFrameNs + slots_[next_ % kSlots].jitter_ns < target_ns_) {
+      std::fill(frame_.begin(), frame_.begin() + kVoiceFrameSamples, 0.0f);
+      append(frame_.data(), kVoiceFrameSamples, PlayoutInfo{});
+      ++counters_.silent;
+      return;
+    }
+    playing_ = true;
+    concealing_ = 0;
+    level_ns_ = -1.0;
+  }
+
+  float* x = frame_.data();
+  Slot& slot = slots_[next_ % kSlots];
+  const bool present = slot.full && slot.sequence == next_;
+  slot.full = false;
+  if (present && options_.decode(slot.data, slot.size, x)) {
+    size_t n = kVoiceFrameSamples;
+    if (concealing_ > 0) {
+      float tail[kFade];
+      conceal(tail, kFade, false);
+      cross_fade(tail, x, x, kFade);
+    }
+    concealing_ = 0;
+
+    // Audio in hand once this frame is queued, against the target. The raw
+    // level swings with every packet's jitter; stretching follows a
+    // smoothed level so it does not chase them.
+    const auto level = static_cast<double>(samples_to_ns(pending_size_ + n) +
+                                           queued_frames(next_ + 1) * kVoiceFrameNs);
+    level_ns_ = level_ns_ < 0.0 ? level : level_ns_ + (level - level_ns_) * kLevelSmoothing;
+    const auto target = static_cast<double>(target_ns_);
+    float score = 0.0f;
+    if (level_ns_ > target + static_cast<double>(kVoiceFrameNs) || level_ns_ < target) {
+      const bool silent = rms(x, n) < kSilenceRms;
+      const size_t lag = silent ? kMaxLag : best_lag(x, +1, score);
+      if (silent || score >= kStretchScore) {
+        const auto stretch = static_cast<double>(samples_to_ns(lag));
+        if (level_ns_ > target) {
+          // Shorten: the first period fades into the second, which is dropped.
+          cross_fade(x, x + lag, x, lag);
+          std::memmove(x + lag, x + 2 * lag, (n - 2 * lag) * sizeof(float));
+          n -= lag;
+          level_ns_ -= stretch;
+          ++counters_.accelerated;
+        } else {
+          // Lengthen: repeat one period, fading from the second back into
+          // the first so both seams stay continuous.
+          std::memmove(x + 2 * lag, x + lag, (n - lag) * sizeof(float));
+          cross_fade(x + 2 * lag, x, x + lag, lag);
+          n += lag;
+          level_ns_ += stretch;
+          ++counters_.expanded;
+        }
+      }
+    }
+
+    if (n >= kHistory) {
+      std::memcpy(history_.data(), x + n - kHistory, kHistory * sizeof(float));
+    } else {
+      std::memmove(history_.data(), history_.data() + n, (kHistory - n) * sizeof(float));
+      std::memcpy(history_.data() + kHistory - n, x, n * sizeof(float));
+    }
+    PlayoutInfo info;
+    info.voiced = true;
+    info.sequence = next_;
+    append(x, n, info);
+    ++next_;
+    return;
+  }
+
+  // Missing (lost, late or undecodable): continue the last pitch period.
+  if (concealing_ == 0) {
+    float score = 0.0f;
+    conceal_lag_ = static_cast<uint32_t>(best_lag(history_.data() + kHistory - kWindow, -1, score));
+    conceal_phase_ = 0;
+    conceal_gain_ = 1.0f;
+  }
+  ++concealing_;
+  conceal(x, kVoiceFrameSamples, true);
+  ++counters_.concealed;
+  PlayoutInfo info;
+  info.voiced = true;
+  info.concealed = true;
+  info.sequence = next_;
+  append(x, kVoiceFrameSamples, info);
+  ++next_;
+
+  // Nothing left at all after a full concealment run: the talker stopped.
+  if (concealing_ >= options_.max_conceal_frames &&
+      std::none_of(slots_.begin(), slots_.end(), [](const Slot& s) { return s.full; })) {
+    playing_ = false;
+    rebase_ = true;
+  }
+}
+
+PlayoutInfo JitterBuffer::pull(float* out) {
+  while (pending_size_ < kVoiceFrameSamples) {
+    produce();
+  }
+  PlayoutInfo info = chunks_[0].info;
+  if (info.voiced) {
+    info.offset = static_cast<uint32_t>(chunk_consumed_ * kVoiceFrameSamples / chunks_[0].length);
+  }
+  std::memcpy(out, pending_.data(), kVoiceFrameSamples * sizeof(float));
+  pending_size_ -= kVoiceFrameSamples;
+  std::memmove(pending_.data(), pending_.data() + kVoiceFrameSamples, pending_size_ * sizeof(float));
+  for (size_t left = kVoiceFrameSamples; left > 0;) {
+    const size_t take = std::min<size_t>(left, chunks_[0].length - chunk_consumed_);
+    chunk_consumed_ += take;
+    left -= take;
+    if (chunk_consumed_ == chunks_[0].length) {
+      std::copy(chunks_.begin() + 1, chunks_.begin() + static_cast<ptrdiff_t>(chunk_count_), chunks_.begin());
+      --chunk_count_;
+      chunk_consumed_ = 0;
+    }
+  }
+  ++counters_.frames;
+  return info;
+}
+
+}  // namespace trackpro::voice
@@ -0,0 +1,28 @@
+#include "trackpro/voice/packet_pool.h"
+
+#include <stdexcept>
+
+namespace trackpro::voice {
+
+PacketPool::PacketPool(size_t capacity) : packets_(capacity) {
+  if (capacity == 0) {
+    throw std::invalid_argument("PacketPool capacity must be non-zero");
+  }
+  free_.reserve(capacity);
+  for (size_t i = capacity; i-- > 0;) {
+    free_.push_back(&packets_[i]);
+  }
+}
+
+Packet* PacketPool::acquire() {
+  if (free_.empty()) {
+    return nullptr;
+  }
+  Packet* packet = free_.back();
+  free_.pop_back();
+  return packet;
+}
+
+void PacketPool::release(Packet* packet) { free_.push_back(packet); }
+
+}  // namespace trackpro::voice
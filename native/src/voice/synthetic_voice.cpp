@@ -0,0 +1,112 @@
+#include "trackpro/voice/synthetic_voice.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace trackpro::voice {
+namespace {
+
+constexpr float kPi = 3.14159265f;
+constexpr float kRate = static_cast<float>(kVoiceSampleRate);
+
+// F1-F3 of five vowels, Hz.
+constexpr float kVowels[5][3] = {
+    {730, 1090, 2440}, {270, 2290, 3010}, {300, 870, 2240}, {530, 1840, 2480}, {570, 840, 2410}};
+constexpr float kBandwidth[3] = {90, 110, 170};
+// Makes up for the resonators' loss so syllable peaks land near `level`.
+constexpr float kLoudness = 50.0f;
+
+uint64_t exponential_samples(std::mt19937& rng, double mean_s) {
+  std::exponential_distribution<double> d(1.0 / mean_s);
+  return static_cast<uint64_t>(std::max(0.2, d(rng)) * kVoiceSampleRate);
+}
+
+}  // namespace
+
+SyntheticVoice::SyntheticVoice(SyntheticVoiceOptions options) : options_(options), rng_(options.seed) {
+  spurt_left_ = exponential_samples(rng_, options_.mean_talk_s);
+  start_syllable();
+}
+
+void SyntheticVoice::start_syllable() {
+  std::uniform_int_distribution<int> vowel(0, 4);
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  const float* f = kVowels[vowel(rng_)];
+  for (int k = 0; k < 3; ++k) {
+    Resonator& r = formants_[k];
+    const float radius = std::exp(-kPi * kBandwidth[k] / kRate);
+    r.a1 = 2.0f * radius * std::cos(2.0f * kPi * f[k] / kRate);
+    r.a2 = radius * radius;
+    r.gain = 1.0f - radius;
+  }
+  voiced_length_ = static_cast<uint32_t>((0.12f + 0.18f * unit(rng_)) * kRate);
+  syllable_length_ = voiced_length_ + static_cast<uint32_t>((0.02f + 0.06f * unit(rng_)) * kRate);
+  syllable_left_ = syllable_length_;
+  pitch_ = 90.0f + 130.0f * unit(rng_);
+  pitch_glide_ = (unit(rng_) - 0.5f) * 40.0f / static_cast<float>(voiced_length_);
+}
+
+void SyntheticVoice::next(float* out) {
+  std::normal_distribution<float> breath(0.0f, 0.02f);
+  for (size_t i = 0; i < kVoiceFrameSamples; ++i) {
+    if (spurt_left_ == 0) {
+      talking_ = options_.mean_pause_s <= 0.0 || !talking_;
+      spurt_left_ = exponential_samples(rng_, talking_ ? options_.mean_talk_s : options_.mean_pause_s);
+    }
+    --spurt_left_;
+    if (syllable_left_ == 0) {
+      start_syllable();
+    }
+    const uint32_t t = syllable_length_ - syllable_left_--;
+    float excitation = 0.0f;
+    float envelope = 0.0f;
+    if (talking_ && t < voiced_length_) {
+      envelope = std::sin(kPi * static_cast<float>(t) / static_cast<float>(voiced_length_));
+      phase_ += (pitch_ + pitch_glide_ * static_cast<float>(t)) / kRate;
+      if (phase_ >= 1.0f) {
+        phase_ -= 1.0f;
+        excitation = 1.0f;
+      }
+      excitation += breath(rng_);
+    }
+    float y = excitation;
+    for (Resonator& r : formants_) {
+      y = r.run(y);
+    }
+    out[i] = std::clamp(y * envelope * options_.level * kLoudness, -1.0f, 1.0f);
+  }
+}
+
+SyntheticEngineNoise::SyntheticEngineNoise(SyntheticEngineOptions options) : options_(options), rng_(options.seed) {}
+
+void SyntheticEngineNoise::add(float* out) {
+  constexpr int kOrders = 8;
+  constexpr double kLap = 30.0;  // braking zones repeat every lap
+  std::normal_distribution<float> white(0.0f, 1.0f);
+  const double dt = 1.0 / kRate;
+  for (size_t i = 0; i < kVoiceFrameSamples; ++i) {
+    // Revs climb 5000 -> 8500 through each gear; the throttle lifts for a
+    // second and a half in each of three corners a lap.
+    const double in_gear = std::fmod(t_, options_.gear_s) / options_.gear_s;
+    const double lap = std::fmod(t_, kLap);
+    const bool lift = std::fmod(lap, 10.0) < 1.5;
+    const double rpm = lift ? 4000.0 : 5000.0 + 3500.0 * in_gear;
+    const float throttle = lift ? 0.35f : 1.0f;
+    const float firing_hz = static_cast<float>(rpm / 60.0 * options_.cylinders / 2.0);
+    phase_ += firing_hz / kRate;
+    phase_ -= std::floor(phase_);
+    float engine = 0.0f;
+    for (int k = 1; k <= kOrders; ++k) {
+      engine += std::sin(2.0f * kPi * phase_ * static_cast<float>(k)) / static_cast<float>(k);
+    }
+    // Rumble: white noise low-passed at ~150 Hz; hiss: high-passed.
+    const float w = white(rng_);
+    rumble_ += (w - rumble_) * 0.02f;
+    hiss_ += (w - hiss_) * 0.7f;
+    const float hiss = w - hiss_;
+    out[i] += options_.level * (0.35f * throttle * engine + 1.5f * rumble_ + 0.08f * hiss);
+    t_ += dt;
+  }
+}
+
+}  // namespace trackpro::voice
@@ -0,0 +1,325 @@
+#include "trackpro/voice/udp_event_loop.h"
+
+#include <arpa/inet.h>
+#include <linux/filter.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include "trackpro/common/clock.h"
+#include "trackpro/common/realtime.h"
+
+namespace trackpro::voice {
+namespace {
+
+enum : uint32_t { kSocketEvent, kTimerEvent, kWakeEvent };
+
+[[noreturn]] void throw_errno(const char* what) { throw std::system_error(errno, std::generic_category(), what); }
+
+void add_to_epoll(int epoll_fd, int fd, uint32_t tag) {
+  epoll_event ev{};
+  ev.events = EPOLLIN;
+  ev.data.u32 = tag;
+  if (::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+    throw_errno("epoll_ctl");
+  }
+}
+
+// Classic BPF for the reuseport group: socket index = payload[offset] %
+// workers. The kernel runs it with the data pointer at the UDP payload; a
+// packet too short to have the byte aborts the program, which returns 0.
+void attach_steering(int fd, int offset, size_t workers) {
+  sock_filter code[] = {
+      {BPF_LD | BPF_B | BPF_ABS, 0, 0, static_cast<uint32_t>(offset)},
+      {BPF_ALU | BPF_MOD | BPF_K, 0, 0, static_cast<uint32_t>(workers)},
+      {BPF_RET | BPF_A, 0, 0, 0},
+  };
+  sock_fprog program{static_cast<unsigned short>(sizeof(code) / sizeof(code[0])), code};
+  if (::setsockopt(fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof(program)) != 0) {
+    throw_errno("SO_ATTACH_REUSEPORT_CBPF");
+  }
+}
+
+}  // namespace
+
+// recvmmsg/sendmmsg descriptors, set up once per worker.
+struct UdpWorker::Batch {
+  explicit Batch(size_t size)
+      : rx(size), rx_msgs(size), rx_iov(size), rx_addr(size), tx_msgs(size), tx_iov(size), tx_addr(size) {
+    for (size_t i = 0; i < size; ++i) {
+      rx_iov[i] = {rx[i].data, kMaxDatagram};
+      rx_msgs[i].msg_hdr.msg_iov = &rx_iov[i];
+      rx_msgs[i].msg_hdr.msg_iovlen = 1;
+      rx_msgs[i].msg_hdr.msg_name = &rx_addr[i];
+      tx_msgs[i].msg_hdr.msg_iov = &tx_iov[i];
+      tx_msgs[i].msg_hdr.msg_iovlen = 1;
+      tx_msgs[i].msg_hdr.msg_name = &tx_addr[i];
+      tx_msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+    }
+  }
+
+  std::vector<Packet> rx;
+  std::vector<mmsghdr> rx_msgs;
+  std::vector<iovec> rx_iov;
+  std::vector<sockaddr_in> rx_addr;
+  std::vector<mmsghdr> tx_msgs;
+  std::vector<iovec> tx_iov;
+  std::vector<sockaddr_in> tx_addr;
+  std::vector<Packet*> queue;  // waiting for sendmmsg
+};
+
+UdpWorker::UdpWorker(size_t index, UdpSocket socket, const UdpEventLoopOptions& options)
+    : index_(index),
+      socket_(std::move(socket)),
+      options_(options),
+      pool_(options.pool_packets),
+      batch_(std::make_unique<Batch>(options.batch)) {
+  batch_->queue.reserve(options.pool_packets);
+  epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+  wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (epoll_fd_ < 0 || wake_fd_ < 0) {
+    throw_errno("epoll/eventfd");
+  }
+  add_to_epoll(epoll_fd_, socket_.fd(), kSocketEvent);
+  add_to_epoll(epoll_fd_, wake_fd_, kWakeEvent);
+  if (options.tick_ns > 0) {
+    timer_fd_ = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timer_fd_ < 0) {
+      throw_errno("timerfd_create");
+    }
+    add_to_epoll(epoll_fd_, timer_fd_, kTimerEvent);
+  }
+}
+
+UdpWorker::~UdpWorker() {
+  for (int fd : {epoll_fd_, timer_fd_, wake_fd_}) {
+    if (fd >= 0) {
+      ::close(fd);
+    }
+  }
+}
+
+bool UdpWorker::send(const UdpAddress& to, const uint8_t* data, size_t size) {
+  Packet* packet = size <= kMaxDatagram ? pool_.acquire() : nullptr;
+  if (packet == nullptr && size <= kMaxDatagram) {
+    flush();
+    packet = pool_.acquire();
+  }
+  if (packet == nullptr) {
+    ++counters_.send_failures;
+    return false;
+  }
+  packet->peer = to;
+  packet->size = static_cast<uint16_t>(size);
+  std::memcpy(packet->data, data, size);
+  batch_->queue.push_back(packet);
+  if (batch_->queue.size() >= options_.batch) {
+    flush();
+  }
+  return true;
+}
+
+void UdpWorker::flush() {
+  Batch& b = *batch_;
+  size_t done = 0;
+  while (done < b.queue.size()) {
+    const size_t count = std::min(options_.batch, b.queue.size() - done);
+    for (size_t i = 0; i < count; ++i) {
+      const Packet& p = *b.queue[done + i];
+      b.tx_addr[i].sin_family = AF_INET;
+      b.tx_addr[i].sin_addr.s_addr = htonl(p.peer.ip);
+      b.tx_addr[i].sin_port = htons(p.peer.port);
+      b.tx_iov[i] = {const_cast<uint8_t*>(p.data), p.size};
+    }
+    const int sent = ::sendmmsg(socket_.fd(), b.tx_msgs.data(), static_cast<unsigned>(count), 0);
+    ++counters_.send_calls;
+    if (sent < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      // The first datagram failed (buffer full, unreachable): drop it and
+      // carry on with the rest, as a lone sendto would.
+      ++counters_.send_failures;
+      ++done;
+      continue;
+    }
+    counters_.sent += static_cast<uint64_t>(sent);
+    done += static_cast<size_t>(sent);
+  }
+  for (Packet* p : b.queue) {
+    pool_.release(p);
+  }
+  b.queue.clear();
+}
+
+void UdpWorker::receive_all(UdpPacketHandler& handler) {
+  Batch& b = *batch_;
+  for (;;) {
+    for (mmsghdr& m : b.rx_msgs) {
+      m.msg_hdr.msg_namelen = sizeof(sockaddr_in);
+    }
+    const int n = ::recvmmsg(socket_.fd(), b.rx_msgs.data(), static_cast<unsigned>(options_.batch), MSG_DONTWAIT,
+                             nullptr);
+    if (n <= 0) {
+      return;
+    }
+    ++counters_.receive_calls;
+    counters_.received += static_cast<uint64_t>(n);
+    const uint64_t now = now_ns();
+    for (int i = 0; i < n; ++i) {
+      Packet& p = b.rx[static_cast<size_t>(i)];
+      p.size = static_cast<uint16_t>(std::min<size_t>(b.rx_msgs[static_cast<size_t>(i)].msg_len, kMaxDatagram));
+      p.peer = {ntohl(b.rx_addr[static_cast<size_t>(i)].sin_addr.s_addr),
+                ntohs(b.rx_addr[static_cast<size_t>(i)].sin_port)};
+      handler.on_packet(*this, p, now);
+    }
+    flush();
+    if (static_cast<size_t>(n) < options_.batch) {
+      return;
+    }
+  }
+}
+
+void UdpWorker::publish() {
+  counters_.cpu_ns = thread_cpu_ns() - cpu_start_ns_;
+  published_.store(counters_);
+}
+
+void UdpWorker::run(UdpPacketHandler& handler, const std::atomic<bool>& running) {
+  char name[16];
+  std::snprintf(name, sizeof(name), "tp-udp-%zu", index_);
+  set_current_thread_name(name);
+  if (options_.pin_workers) {
+    pin_current_thread(static_cast<int>(index_ % std::max(1u, std::thread::hardware_concurrency())));
+  }
+  enable_flush_denormals();
+  if (options_.realtime_priority > 0) {
+    promote_current_thread_realtime(options_.realtime_priority);
+  }
+  cpu_start_ns_ = thread_cpu_ns() - counters_.cpu_ns;
+  if (timer_fd_ >= 0) {
+    itimerspec spec{};
+    spec.it_interval.tv_sec = static_cast<time_t>(options_.tick_ns / kNanosPerSecond);
+    spec.it_interval.tv_nsec = static_cast<long>(options_.tick_ns % kNanosPerSecond);
+    spec.it_value = spec.it_interval;
+    ::timerfd_settime(timer_fd_, 0, &spec, nullptr);
+  }
+
+  epoll_event events[3];
+  while (running.load(std::memory_order_acquire)) {
+    const int n = ::epoll_wait(epoll_fd_, events, 3, -1);
+    if (n < 0) {
+      continue;  // EINTR
+    }
+    ++counters_.wakeups;
+    for (int i = 0; i < n; ++i) {
+      uint64_t value;
+      switch (events[i].data.u32) {
+        case kSocketEvent:
+          receive_all(handler);
+          break;
+        case kTimerEvent:
+          if (::read(timer_fd_, &value, sizeof(value)) == sizeof(value)) {
+            // Missed expirations are not replayed: a late tick is one tick.
+            handler.on_tick(*this, now_ns());
+            ++counters_.ticks;
+            flush();
+          }
+          break;
+        default:
+          if (::read(wake_fd_, &value, sizeof(value)) < 0) {
+            // Already drained by an earlier wakeup.
+          }
+          break;
+      }
+    }
+    publish();
+  }
+  flush();
+  publish();
+}
+
+UdpEventLoop::UdpEventLoop(UdpPacketHandler& handler, UdpEventLoopOptions options)
+    : handler_(handler), options_(options) {
+  if (options_.workers == 0) {
+    options_.workers = std::max(1u, std::thread::hardware_concurrency());
+  }
+  if (options_.batch == 0 || options_.pool_packets == 0) {
+    throw std::invalid_argument("UdpEventLoop batch and pool sizes must be non-zero");
+  }
+  if (options_.steer_offset >= static_cast<int>(kMaxDatagram)) {
+    throw std::invalid_argument("UdpEventLoop steering offset is beyond the largest datagram");
+  }
+  for (size_t i = 0; i < options_.workers; ++i) {
+    // The first socket picks the port; the rest join its reuseport group,
+    // in order, so group index i is worker i.
+    UdpSocket socket(i == 0 ? options_.address : UdpAddress{options_.address.ip, address_.port}, true);
+    socket.set_buffer_sizes(options_.socket_buffer_bytes);
+    if (i == 0) {
+      address_ = socket.local_address();
+    }
+    workers_.push_back(std::unique_ptr<UdpWorker>(new UdpWorker(i, std::move(socket), options_)));
+  }
+  if (options_.steer_offset >= 0) {
+    attach_steering(workers_[0]->socket_.fd(), options_.steer_offset, workers_.size());
+  }
+}
+
+UdpEventLoop::~UdpEventLoop() { stop(); }
+
+void UdpEventLoop::start() {
+  if (running_.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  for (auto& worker : workers_) {
+    UdpWorker* w = worker.get();
+    w->thread_ = std::thread([this, w] { w->run(handler_, running_); });
+  }
+}
+
+void UdpEventLoop::stop() {
+  running_.store(false, std::memory_order_release);
+  for (auto& worker : workers_) {
+    const uint64_t one = 1;
+    if (::write(worker->wake_fd_, &one, sizeof(one)) < 0) {
+      // eventfd only fails when the counter would overflow: already woken.
+    }
+    if (worker->thread_.joinable()) {
+      worker->thread_.join();
+    }
+  }
+}
+
+UdpEventLoopCounters UdpEventLoop::counters(size_t worker) const {
+  UdpEventLoopCounters c;
+  workers_.at(worker)->published_.load(c);
+  return c;
+}
+
+UdpEventLoopCounters UdpEventLoop::counters() const {
+  UdpEventLoopCounters sum;
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    const UdpEventLoopCounters c = counters(i);
+    sum.received += c.received;
+    sum.sent += c.sent;
+    sum.send_failures += c.send_failures;
+    sum.receive_calls += c.receive_calls;
+    sum.send_calls += c.send_calls;
+    sum.wakeups += c.wakeups;
+    sum.ticks += c.ticks;
+    sum.cpu_ns += c.cpu_ns;
+  }
+  return sum;
+}
+
+}  // namespace trackpro::voice
@@ -0,0 +1,113 @@
+#include "trackpro/voice/udp_socket.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <ctime>
+#include <system_error>
+
+#include "trackpro/common/clock.h"
+
+namespace trackpro::voice {
+namespace {
+
+sockaddr_in to_sockaddr(const UdpAddress& a) {
+  sockaddr_in s{};
+  s.sin_family = AF_INET;
+  s.sin_addr.s_addr = htonl(a.ip);
+  s.sin_port = htons(a.port);
+  return s;
+}
+
+}  // namespace
+
+UdpSocket::UdpSocket(UdpAddress address, bool reuse_port) {
+  fd_ = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd_ < 0) {
+    throw std::system_error(errno, std::generic_category(), "socket");
+  }
+  const int one = 1;
+  if (reuse_port && ::setsockopt(fd_, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) != 0) {
+    const int err = errno;
+    ::close(fd_);
+    throw std::system_error(err, std::generic_category(), "SO_REUSEPORT");
+  }
+  const sockaddr_in s = to_sockaddr(address);
+  if (::bind(fd_, reinterpret_cast<const sockaddr*>(&s), sizeof(s)) != 0) {
+    const int err = errno;
+    ::close(fd_);
+    throw std::system_error(err, std::generic_category(), "bind");
+  }
+}
+
+UdpSocket::~UdpSocket() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+}
+
+UdpSocket::UdpSocket(UdpSocket&& other) noexcept : fd_(other.fd_) { other.fd_ = -1; }
+
+UdpSocket& UdpSocket::operator=(UdpSocket&& other) noexcept {
+  if (this != &other) {
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+    fd_ = other.fd_;
+    other.fd_ = -1;
+  }
+  return *this;
+}
+
+UdpAddress UdpSocket::local_address() const {
+  sockaddr_in s{};
+  socklen_t len = sizeof(s);
+  ::getsockname(fd_, reinterpret_cast<sockaddr*>(&s), &len);
+  return {ntohl(s.sin_addr.s_addr), ntohs(s.sin_port)};
+}
+
+void UdpSocket::set_buffer_sizes(int bytes) {
+  ::setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &bytes, sizeof(bytes));
+  ::setsockopt(fd_, SOL_SOCKET, SO_SNDBUF, &bytes, sizeof(bytes));
+}
+
+bool UdpSocket::send_to(const UdpAddress& to, const uint8_t* data, size_t size) {
+  const sockaddr_in s = to_sockaddr(to);
+  return ::sendto(fd_, data, size, 0, reinterpret_cast<const sockaddr*>(&s), sizeof(s)) ==
+         static_cast<ssize_t>(size);
+}
+
+long UdpSocket::receive(uint8_t* data, size_t capacity, UdpAddress* from, uint64_t deadline_ns) {
+  for (;;) {
+    sockaddr_in s{};
+    socklen_t len = sizeof(s);
+    const ssize_t n = ::recvfrom(fd_, data, capacity, 0, reinterpret_cast<sockaddr*>(&s), &len);
+    if (n >= 0) {
+      if (from != nullptr) {
+        *from = {ntohl(s.sin_addr.s_addr), ntohs(s.sin_port)};
+      }
+      return static_cast<long>(n);
+    }
+    if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+      return -1;
+    }
+    const uint64_t now = now_ns();
+    if (now >= deadline_ns) {
+      return -1;
+    }
+    const uint64_t remaining = deadline_ns - now;
+    timespec timeout;
+    timeout.tv_sec = static_cast<time_t>(remaining / kNanosPerSecond);
+    timeout.tv_nsec = static_cast<long>(remaining % kNanosPerSecond);
+    pollfd pfd{fd_, POLLIN, 0};
+    if (::ppoll(&pfd, 1, &timeout, nullptr) <= 0) {
+      return -1;
+    }
+  }
+}
+
+}  // namespace trackpro::voice
@@ -0,0 +1,79 @@
+#include "trackpro/voice/voice_activity.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace trackpro::voice {
+namespace {
+
+constexpr float kPi = 3.14159265f;
+constexpr float kRate = static_cast<float>(kVoiceSampleRate);
+// Speech band edges. Below 500 Hz is mostly the engine's firing frequency and
+// road rumble (one-pole, so vowel F1 still counts), above 4 kHz mostly wind
+// and tyre hiss.
+constexpr float kHighPassHz = 500.0f;
+constexpr float kLowPassHz = 4000.0f;
+// Weight of each voiced frame in the talker's running speech level.
+constexpr float kSpeechLevelWeight = 0.05f;
+
+}  // namespace
+
+VoiceActivityDetector::VoiceActivityDetector(VoiceActivityOptions options)
+    : options_(options),
+      low_pass_(1.0f - std::exp(-2.0f * kPi * kLowPassHz / kRate)),
+      high_pass_(1.0f / (1.0f + 2.0f * kPi * kHighPassHz / kRate)) {
+  if (options_.floor_rise_db < 0.0f || options_.floor_rise_voiced_db < 0.0f) {
+    throw std::invalid_argument("VoiceActivityDetector floor rise rates must not be negative");
+  }
+}
+
+bool VoiceActivityDetector::process(const float* pcm) {
+  // Band energy through a one-pole low-pass then a one-pole high-pass.
+  float lp = lp_state_;
+  float hp = hp_state_;
+  float hp_in = hp_input_;
+  float sum = 0.0f;
+  for (size_t i = 0; i < kVoiceFrameSamples; ++i) {
+    lp += (pcm[i] - lp) * low_pass_;
+    hp = high_pass_ * (hp + lp - hp_in);
+    hp_in = lp;
+    sum += hp * hp;
+  }
+  // Digital silence would otherwise decay the states into denormals, which
+  // are many times slower on the threads that do not flush them.
+  constexpr float kTiny = 1e-20f;
+  lp_state_ = std::fabs(lp) < kTiny ? 0.0f : lp;
+  hp_state_ = std::fabs(hp) < kTiny ? 0.0f : hp;
+  hp_input_ = std::fabs(hp_in) < kTiny ? 0.0f : hp_in;
+  energy_db_ = 10.0f * std::log10(sum / static_cast<float>(kVoiceFrameSamples) + 1e-12f);
+
+  if (!primed_) {
+    floor_db_ = energy_db_;
+    speech_db_ = energy_db_;
+    primed_ = true;
+  }
+  // With the floor this close to the talker, quieter syllables fall under the
+  // engine in the speech band whatever the threshold, so test against a lower
+  // one and hold the whole talk spurt rather than each syllable.
+  noisy_ = speech_db_ - floor_db_ < options_.noisy_margin_db;
+  const float threshold_db = noisy_ ? options_.noisy_threshold_db : options_.threshold_db;
+  const bool voiced = energy_db_ > options_.silence_db && energy_db_ > floor_db_ + threshold_db;
+  if (voiced) {
+    speech_db_ += (energy_db_ - speech_db_) * kSpeechLevelWeight;
+  }
+  if (energy_db_ < floor_db_) {
+    floor_db_ = energy_db_;
+  } else {
+    floor_db_ += std::min(energy_db_ - floor_db_, voiced ? options_.floor_rise_voiced_db : options_.floor_rise_db);
+  }
+  if (voiced) {
+    hangover_ = noisy_ ? options_.noisy_hangover_frames : options_.hangover_frames;
+  } else if (hangover_ > 0) {
+    --hangover_;
+  }
+  active_ = voiced || hangover_ > 0;
+  return active_;
+}
+
+}  // namespace trackpro::voice
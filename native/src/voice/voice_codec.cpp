@@ -0,0 +1,94 @@
+#include "trackpro/voice/voice_codec.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "trackpro/common/byte_io.h"
+
+namespace trackpro::voice {
+namespace {
+
+constexpr int kStepTable[89] = {
+    7,     8,     9,     10,    11,    12,    13,    14,    16,    17,    19,    21,    23,    25,    28,
+    31,    34,    37,    41,    45,    50,    55,    60,    66,    73,    80,    88,    97,    107,   118,
+    130,   143,   157,   173,   190,   209,   230,   253,   279,   307,   337,   371,   408,   449,   494,
+    544,   598,   658,   724,   796,   876,   963,   1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+    2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,
+    9493,  10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767};
+
+constexpr int kIndexTable[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+// Applies one 4-bit code to the predictor state; shared by both directions
+// so the encoder tracks exactly what the decoder will reconstruct.
+void step(int code, int& predictor, int& index) {
+  const int s = kStepTable[index];
+  int diff = s >> 3;
+  if ((code & 4) != 0) {
+    diff += s;
+  }
+  if ((code & 2) != 0) {
+    diff += s >> 1;
+  }
+  if ((code & 1) != 0) {
+    diff += s >> 2;
+  }
+  predictor = std::clamp((code & 8) != 0 ? predictor - diff : predictor + diff, -32768, 32767);
+  index = std::clamp(index + kIndexTable[code & 7], 0, 88);
+}
+
+int to_pcm16(float v) { return static_cast<int>(std::lrint(std::clamp(v, -1.0f, 1.0f) * 32767.0f)); }
+
+}  // namespace
+
+size_t AdpcmEncoder::encode(const float* pcm, uint8_t* out) {
+  put_u16(out, static_cast<uint16_t>(static_cast<int16_t>(predictor_)));
+  out[2] = static_cast<uint8_t>(index_);
+  out[3] = 0;
+  uint8_t* p = out + 4;
+  for (size_t i = 0; i < kVoiceFrameSamples; i += 2) {
+    int codes[2];
+    for (int k = 0; k < 2; ++k) {
+      const int s = kStepTable[index_];
+      int delta = to_pcm16(pcm[i + static_cast<size_t>(k)]) - predictor_;
+      int code = 0;
+      if (delta < 0) {
+        code = 8;
+        delta = -delta;
+      }
+      if (delta >= s) {
+        code |= 4;
+        delta -= s;
+      }
+      if (delta >= s >> 1) {
+        code |= 2;
+        delta -= s >> 1;
+      }
+      if (delta >= s >> 2) {
+        code |= 1;
+      }
+      step(code, predictor_, index_);
+      codes[k] = code;
+    }
+    *p++ = static_cast<uint8_t>(codes[0] | (codes[1] << 4));
+  }
+  return kAdpcmFrameBytes;
+}
+
+bool adpcm_decode(const uint8_t* data, size_t size, float* pcm) {
+  if (size != kAdpcmFrameBytes || data[2] > 88) {
+    return false;
+  }
+  int predictor = static_cast<int16_t>(get_le(data, 2));
+  int index = data[2];
+  const uint8_t* p = data + 4;
+  constexpr float kScale = 1.0f / 32768.0f;
+  for (size_t i = 0; i < kVoiceFrameSamples; i += 2, ++p) {
+    step(*p & 0x0F, predictor, index);
+    pcm[i] = static_cast<float>(predictor) * kScale;
+    step(*p >> 4, predictor, index);
+    pcm[i + 1] = static_cast<float>(predictor) * kScale;
+  }
+  return true;
+}
+
+}  // namespace trackpro::voice
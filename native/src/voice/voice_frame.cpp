@@ -0,0 +1,68 @@
+#include "trackpro/voice/voice_frame.h"
+
+#include "trackpro/common/byte_io.h"
+
+namespace trackpro::voice {
+namespace {
+
+uint64_t rotl(uint64_t x, int b) { return (x << b) | (x >> (64 - b)); }
+
+void sip_round(uint64_t& v0, uint64_t& v1, uint64_t& v2, uint64_t& v3) {
+  v0 += v1;
+  v1 = rotl(v1, 13) ^ v0;
+  v0 = rotl(v0, 32);
+  v2 += v3;
+  v3 = rotl(v3, 16) ^ v2;
+  v0 += v3;
+  v3 = rotl(v3, 21) ^ v0;
+  v2 += v1;
+  v1 = rotl(v1, 17) ^ v2;
+  v2 = rotl(v2, 32);
+}
+
+}  // namespace
+
+uint64_t voice_join_token(const VoiceSessionKey& key, uint32_t stream) {
+  uint64_t v0 = key.k0 ^ 0x736f6d6570736575ULL;
+  uint64_t v1 = key.k1 ^ 0x646f72616e646f6dULL;
+  uint64_t v2 = key.k0 ^ 0x6c7967656e657261ULL;
+  uint64_t v3 = key.k1 ^ 0x7465646279746573ULL;
+  // The message is the stream id's 4 little-endian bytes: one final block.
+  const uint64_t block = uint64_t{4} << 56 | stream;
+  v3 ^= block;
+  sip_round(v0, v1, v2, v3);
+  sip_round(v0, v1, v2, v3);
+  v0 ^= block;
+  v2 ^= 0xff;
+  for (int i = 0; i < 4; ++i) {
+    sip_round(v0, v1, v2, v3);
+  }
+  return v0 ^ v1 ^ v2 ^ v3;
+}
+
+void write_voice_header(const VoicePacketHeader& header, uint8_t* out) {
+  put_u32(out, header.stream);
+  put_u32(out + 4, header.sequence);
+  put_u64(out + 8, header.capture_ns);
+  out[16] = header.flags;
+  out[17] = header.group;
+  out[18] = 0;
+  out[19] = 0;
+}
+
+bool parse_voice_packet(const uint8_t* data, size_t size, VoicePacketHeader& header, const uint8_t*& payload,
+                        size_t& payload_size) {
+  if (size < kVoiceHeaderSize) {
+    return false;
+  }
+  header.stream = static_cast<uint32_t>(get_le(data, 4));
+  header.sequence = static_cast<uint32_t>(get_le(data + 4, 4));
+  header.capture_ns = get_le(data + 8, 8);
+  header.flags = data[16];
+  header.group = data[17];
+  payload = data + kVoiceHeaderSize;
+  payload_size = size - kVoiceHeaderSize;
+  return true;
+}
+
+}  // namespace trackpro::voice
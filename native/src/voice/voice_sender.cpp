@@ -0,0 +1,44 @@
+#include "trackpro/voice/voice_sender.h"
+
+#include "trackpro/common/byte_io.h"
+
+namespace trackpro::voice {
+
+VoiceSender::VoiceSender(VoiceSenderOptions options) : options_(options), vad_(options.vad) {}
+
+size_t VoiceSender::process(const float* pcm, uint64_t capture_ns, uint8_t* out) {
+  ++counters_.frames;
+  // With push-to-talk the key decides and the detector is not run at all.
+  transmitting_ = options_.mode == TransmitMode::PushToTalk ? talk_key_ : vad_.process(pcm);
+
+  VoicePacketHeader header;
+  header.stream = options_.stream;
+  header.sequence = sequence_++;
+  header.capture_ns = capture_ns;
+  header.group = options_.group;
+  size_t size = 0;
+  const bool must_join = options_.join_token != 0 && !joined_;
+  if (transmitting_ && !must_join) {
+    write_voice_header(header, out);
+    size = kVoiceHeaderSize + encoder_.encode(pcm, out + kVoiceHeaderSize);
+    ++counters_.encoded;
+  } else {
+    ++counters_.suppressed;
+    if (must_join || (options_.keepalive_frames > 0 && since_sent_ + 1 >= options_.keepalive_frames)) {
+      size = kVoiceHeaderSize;
+      if (options_.join_token != 0) {
+        header.flags |= kVoiceFlagJoin;
+        put_u64(out + kVoiceHeaderSize, options_.join_token);
+        size += kVoiceJoinTokenSize;
+        joined_ = true;
+      }
+      write_voice_header(header, out);
+      ++counters_.keepalives;
+    }
+  }
+  since_sent_ = size > 0 ? 0 : since_sent_ + 1;
+  counters_.bytes += size;
+  return size;
+}
+
+}  // namespace trackpro::voice
@@ -0,0 +1,284 @@
+#include "trackpro/voice/voice_server.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "trackpro/common/byte_io.h"
+#include "trackpro/common/simd4.h"
+
+namespace trackpro::voice {
+namespace {
+
+constexpr uint64_t kExpiryPeriodNs = kNanosPerSecond;
+constexpr size_t kPacketBytes = kVoiceHeaderSize + kAdpcmFrameBytes;
+
+static_assert(kVoiceFrameSamples % 4 == 0, "mix kernels work in 4-sample vectors");
+
+// acc += x
+void mix_add(float* acc, const float* x) {
+  for (size_t i = 0; i < kVoiceFrameSamples; i += 4) {
+    simd::store(acc + i, simd::load(acc + i) + simd::load(x + i));
+  }
+}
+
+// out = clamp(sum - own); `own` may be null.
+void mix_out(float* out, const float* sum, const float* own) {
+  const simd::Vec4 lo = simd::splat(-1.0f);
+  const simd::Vec4 hi = simd::splat(1.0f);
+  for (size_t i = 0; i < kVoiceFrameSamples; i += 4) {
+    simd::Vec4 v = simd::load(sum + i);
+    if (own != nullptr) {
+      v = v - simd::load(own + i);
+    }
+    simd::store(out + i, simd::min(simd::max(v, lo), hi));
+  }
+}
+
+}  // namespace
+
+struct VoiceServer::Client {
+  uint32_t stream = 0;
+  uint8_t group = 0;
+  UdpAddress address;
+  uint64_t last_seen_ns = 0;
+
+  // Mix mode. The jitter buffer is created with the first audio frame, so
+  // listen-only clients cost nothing per tick.
+  std::unique_ptr<JitterBuffer> jitter;
+  uint64_t origin_capture_ns = 0;  // capture time of origin_sequence, sender clock
+  uint64_t origin_arrival_ns = 0;  // when origin_sequence arrived, server clock
+  uint32_t origin_sequence = 0;
+  bool voiced = false;  // contributed to this tick's mix
+  AdpcmEncoder encoder;  // this client's mix-minus
+  std::array<float, kVoiceFrameSamples> pcm{};
+};
+
+VoiceServer::VoiceServer(VoiceServerOptions options) : options_(options) {
+  if (options_.max_clients == 0) {
+    throw std::invalid_argument("VoiceServer needs room for at least one client");
+  }
+}
+
+VoiceServer::~VoiceServer() = default;
+
+VoiceServer::Client* VoiceServer::find_or_join(const VoicePacketHeader& header, const uint8_t* payload,
+                                               size_t payload_size, const UdpAddress& from, uint64_t now_ns) {
+  const uint32_t stream = header.stream;
+  const uint8_t group = header.group;
+  if (stream == kVoiceServerStream) {
+    ++counters_.spoofed;  // would look like the server's own mixes
+    return nullptr;
+  }
+  bool join = false;
+  if (options_.require_join && (header.flags & kVoiceFlagJoin) != 0) {
+    join = payload_size == kVoiceJoinTokenSize &&
+           get_le(payload, kVoiceJoinTokenSize) == voice_join_token(options_.session_key, stream);
+    if (!join) {
+      ++counters_.spoofed;
+      return nullptr;
+    }
+  }
+  const auto it = index_.find(stream);
+  Client* client = nullptr;
+  if (it != index_.end()) {
+    client = clients_[it->second].get();
+    // A stream is bound to the address it joined from. Anyone else claiming
+    // its id is ignored, so a peer cannot redirect another driver's audio.
+    // A client whose address changes rejoins with its token at once, or
+    // without tokens once the old entry expires.
+    if (client->address != from) {
+      if (!join) {
+        ++counters_.spoofed;
+        return nullptr;
+      }
+      client->address = from;
+    }
+    if (client->group != group) {
+      leave_group(*client);
+      client->group = group;
+      groups_[group].push_back(client);
+    }
+  } else {
+    if (options_.require_join && !join) {
+      ++counters_.spoofed;
+      return nullptr;
+    }
+    if (clients_.size() >= options_.max_clients) {
+      ++counters_.rejected;
+      return nullptr;
+    }
+    auto joined = std::make_unique<Client>();
+    joined->stream = stream;
+    joined->group = group;
+    joined->address = from;
+    client = joined.get();
+    index_.emplace(stream, clients_.size());
+    clients_.push_back(std::move(joined));
+    groups_[group].push_back(client);
+    ++counters_.joined;
+  }
+  client->last_seen_ns = now_ns;
+  return client;
+}
+
+void VoiceServer::leave_group(Client& client) {
+  std::vector<Client*>& members = groups_[client.group];
+  const auto it = std::find(members.begin(), members.end(), &client);
+  if (it != members.end()) {
+    *it = members.back();
+    members.pop_back();
+  }
+}
+
+void VoiceServer::expire(uint64_t now_ns) {
+  for (size_t i = 0; i < clients_.size();) {
+    Client& client = *clients_[i];
+    if (now_ns - client.last_seen_ns <= options_.client_timeout_ns) {
+      ++i;
+      continue;
+    }
+    leave_group(client);
+    index_.erase(client.stream);
+    if (i + 1 != clients_.size()) {
+      clients_[i] = std::move(clients_.back());
+      index_[clients_[i]->stream] = i;
+    }
+    clients_.pop_back();
+    ++counters_.expired;
+  }
+  counters_.clients = clients_.size();
+}
+
+void VoiceServer::send(const UdpAddress& to, const uint8_t* data, size_t size, VoicePacketSink& out) {
+  if (out.send(to, data, size)) {
+    ++counters_.sent;
+  } else {
+    ++counters_.send_failures;
+  }
+}
+
+void VoiceServer::receive(const UdpAddress& from, const uint8_t* data, size_t size, uint64_t now_ns,
+                          VoicePacketSink& out) {
+  VoicePacketHeader header;
+  const uint8_t* payload = nullptr;
+  size_t payload_size = 0;
+  if (!parse_voice_packet(data, size, header, payload, payload_size)) {
+    ++counters_.malformed;
+    return;
+  }
+  Client* client = find_or_join(header, payload, payload_size, from, now_ns);
+  if (client == nullptr) {
+    return;
+  }
+  ++counters_.received;
+  counters_.clients = clients_.size();
+  if (payload_size == 0 || (header.flags & kVoiceFlagJoin) != 0) {
+    return;  // keepalive
+  }
+
+  if (options_.mode == VoiceServerMode::Forward) {
+    for (Client* member : groups_[header.group]) {
+      if (member != client) {
+        send(member->address, data, size, out);
+        ++counters_.forwarded;
+      }
+    }
+    return;
+  }
+
+  if (!client->jitter) {
+    client->jitter = std::make_unique<JitterBuffer>(options_.jitter);
+    client->origin_capture_ns = header.capture_ns;
+    client->origin_arrival_ns = now_ns;
+    client->origin_sequence = header.sequence;
+  }
+  client->jitter->push(header.sequence, payload, payload_size, now_ns);
+}
+
+void VoiceServer::mix_group(uint8_t group, VoicePacketSink& out) {
+  std::vector<Client*>& members = groups_[group];
+  std::fill(sum_.begin(), sum_.end(), 0.0f);
+  size_t voices = 0;
+  size_t listeners = 0;
+  // Talkers' capture times come from their own clocks, so which voice is
+  // oldest is decided on the server clock, from when each stream started
+  // arriving; the header then carries that talker's own capture time.
+  uint64_t oldest_arrival = UINT64_MAX;
+  uint64_t oldest_capture = 0;
+  for (Client* member : members) {
+    member->voiced = false;
+    if (member->jitter) {
+      const PlayoutInfo info = member->jitter->pull(member->pcm.data());
+      if (info.voiced) {
+        member->voiced = true;
+        mix_add(sum_.data(), member->pcm.data());
+        ++voices;
+        // Stream time of the played audio since the origin frame.
+        const auto frames = static_cast<int64_t>(static_cast<int32_t>(info.sequence - member->origin_sequence));
+        const int64_t played = frames * static_cast<int64_t>(kVoiceFrameNs) +
+                               static_cast<int64_t>(static_cast<uint64_t>(info.offset) * kNanosPerSecond /
+                                                    kVoiceSampleRate);
+        const auto arrival = static_cast<uint64_t>(static_cast<int64_t>(member->origin_arrival_ns) + played);
+        if (arrival < oldest_arrival) {
+          oldest_arrival = arrival;
+          oldest_capture = static_cast<uint64_t>(static_cast<int64_t>(member->origin_capture_ns) + played);
+        }
+      }
+    }
+    listeners += member->voiced ? 0 : 1;
+  }
+  if (voices == 0) {
+    return;  // silence is not sent
+  }
+  ++counters_.mixes;
+
+  VoicePacketHeader header;
+  header.stream = kVoiceServerStream;
+  header.sequence = group_sequences_[group]++;
+  header.capture_ns = oldest_capture;
+  header.flags = kVoiceFlagMixed;
+  header.group = group;
+  uint8_t packet[kPacketBytes];
+  write_voice_header(header, packet);
+
+  // Everyone who is not talking hears the same mix: encode it once.
+  if (listeners > 0) {
+    mix_out(scratch_.data(), sum_.data(), nullptr);
+    const size_t size = kVoiceHeaderSize + group_encoders_[group].encode(scratch_.data(), packet + kVoiceHeaderSize);
+    ++counters_.encodes;
+    for (Client* member : members) {
+      if (!member->voiced) {
+        send(member->address, packet, size, out);
+      }
+    }
+  }
+  // Talkers get the mix minus their own voice, which is empty for a lone
+  // talker.
+  if (voices > 1) {
+    for (Client* member : members) {
+      if (member->voiced) {
+        mix_out(scratch_.data(), sum_.data(), member->pcm.data());
+        const size_t size = kVoiceHeaderSize + member->encoder.encode(scratch_.data(), packet + kVoiceHeaderSize);
+        ++counters_.encodes;
+        send(member->address, packet, size, out);
+      }
+    }
+  }
+}
+
+void VoiceServer::tick(uint64_t now_ns, VoicePacketSink& out) {
+  if (now_ns - last_expiry_ns_ >= kExpiryPeriodNs) {
+    last_expiry_ns_ = now_ns;
+    expire(now_ns);
+  }
+  if (options_.mode != VoiceServerMode::Mix) {
+    return;
+  }
+  for (size_t g = 0; g < groups_.size(); ++g) {
+    if (!groups_[g].empty()) {
+      mix_group(static_cast<uint8_t>(g), out);
+    }
+  }
+}
+
+}  // namespace trackpro::voice
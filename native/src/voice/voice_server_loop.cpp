@@ -0,0 +1,74 @@
+#include "trackpro/voice/voice_server_loop.h"
+
+namespace trackpro::voice {
+namespace {
+
+UdpEventLoopOptions server_loop_options(UdpEventLoopOptions options) {
+  options.tick_ns = kVoiceFrameNs;
+  options.steer_offset = static_cast<int>(kVoiceGroupOffset);
+  return options;
+}
+
+class WorkerSink : public VoicePacketSink {
+ public:
+  explicit WorkerSink(UdpWorker& worker) : worker_(worker) {}
+  bool send(const UdpAddress& to, const uint8_t* data, size_t size) override { return worker_.send(to, data, size); }
+
+ private:
+  UdpWorker& worker_;
+};
+
+}  // namespace
+
+struct VoiceServerLoop::Shard {
+  explicit Shard(const VoiceServerOptions& options) : server(options) {}
+  VoiceServer server;
+  SeqLock<VoiceServerCounters> published;
+};
+
+VoiceServerLoop::VoiceServerLoop(VoiceServerOptions server, UdpEventLoopOptions loop)
+    : loop_(*this, server_loop_options(loop)) {
+  for (size_t i = 0; i < loop_.workers(); ++i) {
+    shards_.push_back(std::make_unique<Shard>(server));
+  }
+}
+
+VoiceServerLoop::~VoiceServerLoop() { loop_.stop(); }
+
+void VoiceServerLoop::on_packet(UdpWorker& worker, const Packet& packet, uint64_t now_ns) {
+  WorkerSink sink(worker);
+  shards_[worker.index()]->server.receive(packet.peer, packet.data, packet.size, now_ns, sink);
+}
+
+void VoiceServerLoop::on_tick(UdpWorker& worker, uint64_t now_ns) {
+  Shard& shard = *shards_[worker.index()];
+  WorkerSink sink(worker);
+  shard.server.tick(now_ns, sink);
+  shard.published.store(shard.server.counters());
+}
+
+VoiceServerCounters VoiceServerLoop::counters() const {
+  VoiceServerCounters sum;
+  for (const auto& shard : shards_) {
+    VoiceServerCounters c;
+    if (!shard->published.load(c)) {
+      continue;
+    }
+    sum.received += c.received;
+    sum.malformed += c.malformed;
+    sum.rejected += c.rejected;
+    sum.spoofed += c.spoofed;
+    sum.forwarded += c.forwarded;
+    sum.mixes += c.mixes;
+    sum.encodes += c.encodes;
+    sum.sent += c.sent;
+    sum.send_failures += c.send_failures;
+    sum.joined += c.joined;
+    sum.expired += c.expired;
+    sum.clients += c.clients;
+  }
+  sum.cpu_ns = loop_.counters().cpu_ns;
+  return sum;
+}
+
+}  // namespace trackpro::voice